@@ -0,0 +1,47 @@
+# ######################################################################################################################
+#
+# Library: PCTK
+#
+# Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+#
+# License: MIT License
+#
+# Permission is hereby granted, free of charge, to any person obtaining
+# a copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# ######################################################################################################################
+
+# We can't create the same interface imported target multiple times, CMake will complain if we do
+# that. This can happen if the find_package call is done in multiple different subdirectories.
+if(TARGET WrapLibuv::WrapLibuv)
+    set(WrapLibuv_FOUND ON)
+    return()
+endif()
+
+find_path(LIBUV_INCLUDE_DIR NAMES uv.h)
+find_library(LIBUV_LIBRARY NAMES uv libuv)
+mark_as_advanced(LIBUV_INCLUDE_DIR LIBUV_LIBRARY)
+
+if(LIBUV_INCLUDE_DIR AND LIBUV_LIBRARY)
+    add_library(WrapLibuv::WrapLibuv INTERFACE IMPORTED)
+    target_include_directories(WrapLibuv::WrapLibuv INTERFACE ${LIBUV_INCLUDE_DIR})
+    target_link_libraries(WrapLibuv::WrapLibuv INTERFACE ${LIBUV_LIBRARY})
+    set(WrapLibuv_FOUND ON)
+else()
+    set(WrapLibuv_FOUND OFF)
+endif()
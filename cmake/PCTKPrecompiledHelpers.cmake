@@ -53,6 +53,21 @@ function(pctk_update_precompiled_header target precompiled_header)
 endfunction()
 
 
+#-----------------------------------------------------------------------------------------------------------------------
+#-----------------------------------------------------------------------------------------------------------------------
+function(pctk_update_precompiled_header_with_library target library)
+    if(TARGET "${library}")
+        get_target_property(target_type "${library}" TYPE)
+        if(NOT target_type STREQUAL "INTERFACE_LIBRARY")
+            get_target_property(header "${library}" MODULE_HEADER)
+            if(header)
+                pctk_update_precompiled_header("${target}" "${header}")
+            endif()
+        endif()
+    endif()
+endfunction()
+
+
 #-----------------------------------------------------------------------------------------------------------------------
 #-----------------------------------------------------------------------------------------------------------------------
 function(pctk_update_ignore_pch_source target sources)
@@ -45,10 +45,15 @@ pctk_configure_feature("ENABLE_VALGRIND" PUBLIC
     CONDITION ON)
 
 
-# libuv for io backend
+# libuv for io backend, opt in with -DINPUT_PCTK_FEATURE_LIBUV_BACKEND=ON
+pctk_find_package(WrapLibuv PROVIDED_TARGETS WrapLibuv::WrapLibuv MODULE_NAME PCTKCore)
 pctk_configure_feature("LIBUV_BACKEND" PUBLIC
     LABEL "Enable this to build libuv as the backend"
-    CONDITION OFF)
+    AUTODETECT OFF
+    CONDITION WrapLibuv_FOUND)
+if(INPUT_PCTK_FEATURE_LIBUV_BACKEND AND NOT WrapLibuv_FOUND)
+    message(FATAL_ERROR "LIBUV_BACKEND was requested but libuv was not found, set LIBUV_INCLUDE_DIR and LIBUV_LIBRARY.")
+endif()
 
 # icu (International Component for Unicode) feature
 pctk_configure_feature("ICU" PUBLIC
@@ -102,10 +107,11 @@ pctk_configure_compile_test(STDCXX_THREAD
     CODE
     "#include <thread>
     #include <mutex>
+    #include <future>
     int main(void)
     {
-        std::thread trd；
-        std::future fue;
+        std::thread trd;
+        std::future<int> fue;
         std::mutex mux;
         return 0;
     }")
@@ -520,10 +526,19 @@ pctk_configure_compile_test_symbol(PTHREAD_COND_TIMEDWAIT_RELATIVE_NP
 # pthread_getname_np
 pctk_configure_compile_test_symbol(PTHREAD_GETNAME_NP
     SYMBOL "pthread_getname_np"
+    FLAGS "-D_GNU_SOURCE"
     LIBRARIES ${CMAKE_THREAD_LIBS_INIT}
     INCLUDE_FILES "pthread.h"
     LABEL "Check pthread_getname_np symbol.")
 
+# pthread_setname_np
+pctk_configure_compile_test_symbol(PTHREAD_SETNAME_NP
+    SYMBOL "pthread_setname_np"
+    FLAGS "-D_GNU_SOURCE"
+    LIBRARIES ${CMAKE_THREAD_LIBS_INIT}
+    INCLUDE_FILES "pthread.h"
+    LABEL "Check pthread_setname_np symbol.")
+
 pctk_configure_definition("PCTK_HAS_STPCPY" PUBLIC VALUE ${TEST_STPCPY})
 pctk_configure_definition("PCTK_HAS_STRCPY" PUBLIC VALUE ${TEST_STRCPY})
 pctk_configure_definition("PCTK_HAS_STRCPY_S" PUBLIC VALUE ${TEST_STRCPY_S})
@@ -561,6 +576,7 @@ pctk_configure_definition("PCTK_HAS_PTHREAD_ATTR_SETINHERITSCHED" PUBLIC VALUE $
 pctk_configure_definition("PCTK_HAS_PTHREAD_CONDATTR_SETCLOCK" PUBLIC VALUE ${TEST_PTHREAD_CONDATTR_SETCLOCK})
 pctk_configure_definition("PCTK_HAS_PTHREAD_COND_TIMEDWAIT_RELATIVE_NP" PUBLIC VALUE ${TEST_PTHREAD_COND_TIMEDWAIT_RELATIVE_NP})
 pctk_configure_definition("PCTK_HAS_PTHREAD_GETNAME_NP" PUBLIC VALUE ${TEST_PTHREAD_GETNAME_NP})
+pctk_configure_definition("PCTK_HAS_PTHREAD_SETNAME_NP" PUBLIC VALUE ${TEST_PTHREAD_SETNAME_NP})
 
 
 # stdint.h
@@ -648,7 +664,6 @@ pctk_configure_compile_test(INT64_IS_LONG_TYPE
     "#if defined(_AIX) && !defined(__GNUC__)
     #pragma options langlvl=stdc99
     #endif
-    #pragma GCC diagnostic error \"-Wincompatible-pointer-types\"
     #include <stdint.h>
     #include <stdio.h>
     int main(void)
@@ -665,7 +680,6 @@ pctk_configure_compile_test(INT64_IS_LONG_LONG_TYPE
     "#if defined(_AIX) && !defined(__GNUC__)
     #pragma options langlvl=stdc99
     #endif
-    #pragma GCC diagnostic error \"-Wincompatible-pointer-types\"
     #include <stdint.h>
     #include <stdio.h>
     int main(void)
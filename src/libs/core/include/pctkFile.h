@@ -0,0 +1 @@
+#include "../source/io/pctkFile.h"
@@ -0,0 +1 @@
+#include "../source/tools/pctkHashMap.h"
@@ -0,0 +1 @@
+#include "../source/io/pctkMappedFile.h"
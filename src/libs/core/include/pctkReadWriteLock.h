@@ -0,0 +1 @@
+#include "../source/thread/pctkReadWriteLock.h"
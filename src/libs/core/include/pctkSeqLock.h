@@ -0,0 +1 @@
+#include "../source/thread/pctkSeqLock.h"
@@ -0,0 +1 @@
+#include "../source/kernel/pctkSteadyClock.h"
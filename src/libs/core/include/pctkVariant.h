@@ -0,0 +1 @@
+#include "../source/tools/pctkVariant.h"
@@ -620,6 +620,18 @@
 #   endif
 #endif
 
+/* C++20 features, detected through the standard feature test macros on every compiler */
+#if PCTK_CC_STDCXX_20 && defined(__cpp_impl_coroutine) && defined(__has_include)
+#   if __has_include(<coroutine>)
+#       define PCTK_CC_FEATURE_COROUTINES 1
+#   endif
+#endif
+
+/* RTTI is on unless turned off with -fno-rtti or /GR- */
+#if defined(__cpp_rtti) || defined(__GXX_RTTI) || defined(_CPPRTTI)
+#   define PCTK_CC_FEATURE_RTTI 1
+#endif
+
 // Don't break code that is already using Q_COMPILER_DEFAULT_DELETE_MEMBERS
 #if PCTK_CC_FEATURE_DEFAULT_MEMBERS && PCTK_CC_FEATURE_DELETE_MEMBERS
 #   define PCTK_CC_FEATURE__DEFAULT_DELETE_MEMBERS 1
@@ -679,6 +691,10 @@
 #   define PCTK_CC_FEATURE_CLASS_ENUM 0
 #endif
 
+#ifndef PCTK_CC_FEATURE_COROUTINES
+#   define PCTK_CC_FEATURE_COROUTINES 0
+#endif
+
 #ifndef PCTK_CC_FEATURE_DEFAULT_MEMBERS
 #   define PCTK_CC_FEATURE_DEFAULT_MEMBERS 0
 #endif
@@ -743,6 +759,10 @@
 #   define PCTK_CC_FEATURE_REF_QUALIFIERS 0
 #endif
 
+#ifndef PCTK_CC_FEATURE_RTTI
+#   define PCTK_CC_FEATURE_RTTI 0
+#endif
+
 #ifndef PCTK_CC_FEATURE_RVALUE_REFS
 #   define PCTK_CC_FEATURE_RVALUE_REFS 0
 #endif
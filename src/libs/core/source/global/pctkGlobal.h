@@ -29,6 +29,7 @@
 #include <pctkLimits.h>
 #include <pctkSystem.h>
 #include <pctkCompiler.h>
+#include <pctkProcessor.h>
 #include <pctkCoreConfig.h>
 #include <pctkPreprocessor.h>
 
@@ -371,4 +371,29 @@
 #   endif
 #endif
 
+/*
+   Size in bytes of the L1 data cache line, i.e. the granularity of false sharing. Values are the common line size
+   of each family; Apple silicon and POWER use 128 byte lines, s390 uses 256. Can be overridden on the command line.
+   The value actually reported by the running CPU is available from CacheLine::runtimeSize() in pctkCacheLine.h.
+*/
+#ifndef PCTK_CACHELINE_SIZE
+#   if defined(PCTK_PROCESSOR_X86)
+#       define PCTK_CACHELINE_SIZE 64
+#   elif defined(PCTK_PROCESSOR_ARM_64) && defined(__APPLE__)
+#       define PCTK_CACHELINE_SIZE 128
+#   elif defined(PCTK_PROCESSOR_ARM)
+#       define PCTK_CACHELINE_SIZE 64
+#   elif defined(PCTK_PROCESSOR_POWER)
+#       define PCTK_CACHELINE_SIZE 128
+#   elif defined(PCTK_PROCESSOR_S390)
+#       define PCTK_CACHELINE_SIZE 256
+#   elif defined(PCTK_PROCESSOR_IA64)
+#       define PCTK_CACHELINE_SIZE 128
+#   elif defined(PCTK_PROCESSOR_MIPS) || defined(PCTK_PROCESSOR_SH)
+#       define PCTK_CACHELINE_SIZE 32
+#   else
+#       define PCTK_CACHELINE_SIZE 64
+#   endif
+#endif
+
 #endif //_PCTKPROCESSOR_H_
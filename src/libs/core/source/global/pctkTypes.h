@@ -120,6 +120,10 @@ typedef unsigned long long pctk_uint64_t;
 #   endif
 #endif
 
+#if PCTK_HAS_UINT128_T
+typedef __uint128_t pctk_uint128_t;
+#endif
+
 #if PCTK_HAS_CHAR8_T
 typedef char8_t             pctk_unichar8_t;
 #else
@@ -0,0 +1,493 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include <pctkDirectoryIterator.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <system_error>
+
+#if defined(PCTK_OS_UNIX)
+#   include <dirent.h>
+#   include <fcntl.h>
+#   include <fnmatch.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+#if defined(PCTK_OS_LINUX)
+#   include <sys/syscall.h>
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+static const std::size_t DirectoryBufferSize = 32 * 1024;
+
+#if defined(PCTK_OS_LINUX)
+/* The record getdents64 fills the buffer with, glibc only declares it from 2.30 on. */
+struct LinuxDirent64
+{
+    pctk_uint64_t d_ino;
+    pctk_int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+#endif
+
+#if defined(PCTK_OS_UNIX)
+static void throwDirectoryError(int error, const std::string &what)
+{
+    throw std::system_error(error, std::generic_category(), what);
+}
+
+static DirectoryEntry::Type entryType(unsigned char type) PCTK_NOEXCEPT
+{
+#   if defined(DT_UNKNOWN)
+    switch (type)
+    {
+        case DT_REG:
+            return DirectoryEntry::File;
+        case DT_DIR:
+            return DirectoryEntry::Directory;
+        case DT_LNK:
+            return DirectoryEntry::Symlink;
+        case DT_UNKNOWN:
+            return DirectoryEntry::Unknown;
+        default:
+            return DirectoryEntry::Other;
+    }
+#   else
+    PCTK_UNUSED(type);
+    return DirectoryEntry::Unknown;
+#   endif
+}
+
+static DirectoryEntry::Type modeType(mode_t mode) PCTK_NOEXCEPT
+{
+    if (S_ISREG(mode))
+    {
+        return DirectoryEntry::File;
+    }
+    if (S_ISDIR(mode))
+    {
+        return DirectoryEntry::Directory;
+    }
+    if (S_ISLNK(mode))
+    {
+        return DirectoryEntry::Symlink;
+    }
+    return DirectoryEntry::Other;
+}
+#endif
+} // namespace detail
+
+DirectoryEntry::Type DirectoryEntry::type() const
+{
+#if defined(PCTK_OS_UNIX)
+    if (Unknown == m_type && m_name)
+    {
+        struct stat buffer;
+        if (0 == ::fstatat(m_fd, m_name, &buffer, AT_SYMLINK_NOFOLLOW))
+        {
+            m_type = detail::modeType(buffer.st_mode);
+        }
+    }
+#endif
+    return m_type;
+}
+
+std::string DirectoryEntry::relativePath() const
+{
+    std::string path(m_iterator->m_relative);
+    path.append(m_name, m_nameLength);
+    return path;
+}
+
+std::string DirectoryEntry::path() const
+{
+    std::string path(m_iterator->m_root);
+    if (!path.empty() && '/' != path[path.size() - 1])
+    {
+        path += '/';
+    }
+    path += m_iterator->m_relative;
+    path.append(m_name, m_nameLength);
+    return path;
+}
+
+DirectoryIterator::DirectoryIterator(const std::string &path, int options)
+    : m_root(path), m_options(options), m_maxDepth(-1), m_recursive(false), m_descend(false)
+{
+    this->open(path);
+}
+
+DirectoryIterator::DirectoryIterator(int directoryFd, const std::string &path, int options)
+    : m_root(path), m_options(options), m_maxDepth(-1), m_recursive(false), m_descend(false)
+{
+    m_entry.m_iterator = this;
+#if defined(PCTK_OS_LINUX)
+    if (!this->push(directoryFd, true))
+    {
+        detail::throwDirectoryError(errno, "DirectoryIterator: cannot read " + path);
+    }
+#elif defined(PCTK_OS_UNIX)
+    /* closedir() closes the fd it was opened on, the stream gets its own */
+    const int fd = ::dup(directoryFd);
+    if (fd < 0 || !this->push(fd))
+    {
+        detail::throwDirectoryError(errno, "DirectoryIterator: cannot read " + path);
+    }
+#else
+    PCTK_UNUSED(directoryFd);
+    detail::throwDirectoryError((int) std::errc::function_not_supported, "DirectoryIterator: " + path);
+#endif
+}
+
+DirectoryIterator::DirectoryIterator(const std::string &path, int options, bool recursive)
+    : m_root(path), m_options(options), m_maxDepth(-1), m_recursive(recursive), m_descend(false)
+{
+    this->open(path);
+}
+
+DirectoryIterator::~DirectoryIterator()
+{
+    while (!m_levels.empty())
+    {
+        this->pop();
+    }
+    for (Vector<char *>::size_type i = 0; i < m_buffers.size(); ++i)
+    {
+        std::free(m_buffers[i]);
+    }
+}
+
+void DirectoryIterator::open(const std::string &path)
+{
+    m_entry.m_iterator = this;
+#if defined(PCTK_OS_UNIX)
+    const int fd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        detail::throwDirectoryError(errno, "DirectoryIterator: cannot open " + path);
+    }
+    if (!this->push(fd))
+    {
+        detail::throwDirectoryError(errno, "DirectoryIterator: cannot open " + path);
+    }
+#else
+    detail::throwDirectoryError((int) std::errc::function_not_supported, "DirectoryIterator: " + path);
+#endif
+}
+
+bool DirectoryIterator::next()
+{
+#if defined(PCTK_OS_UNIX)
+    if (m_descend)
+    {
+        m_descend = false;
+        this->descend();
+    }
+    while (!m_levels.empty())
+    {
+        detail::DirectoryLevel &level = m_levels[m_levels.size() - 1];
+        if (!this->read(level))
+        {
+            this->pop();
+            continue;
+        }
+        if ((m_options & SkipHidden) && '.' == m_entry.m_name[0])
+        {
+            continue;
+        }
+        if (!m_excludes.empty() && this->matches(m_excludes))
+        {
+            continue;
+        }
+        m_descend = this->walksInto();
+        const bool skipped = (m_options & SkipDirectories) && (m_descend || m_entry.isDirectory());
+        const bool listed = !skipped && (m_includes.empty() || this->matches(m_includes));
+        if (listed)
+        {
+            return true;
+        }
+        if (m_descend)
+        {
+            /* not listed itself, its contents may be */
+            m_descend = false;
+            this->descend();
+        }
+    }
+    m_entry.m_name = PCTK_NULLPTR;
+    m_entry.m_nameLength = 0;
+#endif
+    return false;
+}
+
+bool DirectoryIterator::push(int fd, bool borrowed)
+{
+#if defined(PCTK_OS_UNIX)
+    detail::DirectoryLevel level;
+    std::memset(&level, 0, sizeof(level));
+    level.fd = fd;
+    level.borrowed = borrowed;
+    level.relativeLength = m_relative.size();
+    if (m_options & FollowSymlinks)
+    {
+        struct stat buffer;
+        if (0 != ::fstat(fd, &buffer))
+        {
+            const int error = errno;
+            if (!borrowed)
+            {
+                ::close(fd);
+            }
+            errno = error;
+            return false;
+        }
+        level.device = (pctk_uint64_t) buffer.st_dev;
+        level.inode = (pctk_uint64_t) buffer.st_ino;
+    }
+#   if defined(PCTK_OS_LINUX)
+    const Vector<char *>::size_type depth = m_levels.size();
+    if (depth == m_buffers.size())
+    {
+        char *buffer = static_cast<char *>(std::malloc(detail::DirectoryBufferSize));
+        if (!buffer)
+        {
+            if (!borrowed)
+            {
+                ::close(fd);
+            }
+            throw std::bad_alloc();
+        }
+        m_buffers.push_back(buffer);
+    }
+    level.buffer = m_buffers[depth];
+#   else
+    DIR *stream = ::fdopendir(fd);
+    if (!stream)
+    {
+        const int error = errno;
+        ::close(fd);
+        errno = error;
+        return false;
+    }
+    level.stream = stream;
+#   endif
+    m_levels.push_back(level);
+    return true;
+#else
+    PCTK_UNUSED(fd);
+    PCTK_UNUSED(borrowed);
+    return false;
+#endif
+}
+
+void DirectoryIterator::pop() PCTK_NOEXCEPT
+{
+#if defined(PCTK_OS_UNIX)
+    detail::DirectoryLevel &level = m_levels[m_levels.size() - 1];
+    if (level.stream)
+    {
+        ::closedir(static_cast<DIR *>(level.stream));
+    }
+    else if (!level.borrowed)
+    {
+        ::close(level.fd);
+    }
+    m_relative.resize(level.relativeLength);
+    m_levels.pop_back();
+#endif
+}
+
+void DirectoryIterator::descend()
+{
+#if defined(PCTK_OS_UNIX)
+    const int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC | (m_options & FollowSymlinks ? 0 : O_NOFOLLOW);
+    const int fd = ::openat(m_entry.m_fd, m_entry.m_name, flags);
+    int error = fd < 0 ? errno : 0;
+    if (0 == error && !this->push(fd))
+    {
+        error = errno;
+    }
+    if (0 != error)
+    {
+        /* removed or replaced since it was listed */
+        if (ENOENT == error || ENOTDIR == error || ELOOP == error)
+        {
+            return;
+        }
+        if ((EACCES == error || EPERM == error) && (m_options & SkipPermissionDenied))
+        {
+            return;
+        }
+        detail::throwDirectoryError(error, "DirectoryIterator: cannot open " + m_entry.path());
+    }
+    if (m_options & FollowSymlinks)
+    {
+        const detail::DirectoryLevel &child = m_levels[m_levels.size() - 1];
+        for (Vector<detail::DirectoryLevel>::size_type i = 0; i + 1 < m_levels.size(); ++i)
+        {
+            if (m_levels[i].device == child.device && m_levels[i].inode == child.inode)
+            {
+                /* a link back to a directory that is being walked */
+                this->pop();
+                return;
+            }
+        }
+    }
+    m_relative.append(m_entry.m_name, m_entry.m_nameLength);
+    m_relative += '/';
+#endif
+}
+
+bool DirectoryIterator::read(detail::DirectoryLevel &level)
+{
+#if defined(PCTK_OS_LINUX)
+    for (;;)
+    {
+        if (level.position >= level.size)
+        {
+            if (level.end)
+            {
+                return false;
+            }
+            const long count = ::syscall(SYS_getdents64, level.fd, level.buffer, detail::DirectoryBufferSize);
+            if (count < 0)
+            {
+                if (EINTR == errno)
+                {
+                    continue;
+                }
+                detail::throwDirectoryError(errno, "DirectoryIterator: cannot read " + m_root + "/" + m_relative);
+            }
+            if (0 == count)
+            {
+                level.end = true;
+                return false;
+            }
+            level.position = 0;
+            level.size = (std::size_t) count;
+        }
+        const detail::LinuxDirent64 *record
+            = reinterpret_cast<const detail::LinuxDirent64 *>(level.buffer + level.position);
+        level.position += record->d_reclen;
+        const char *name = record->d_name;
+        if ('.' == name[0] && ('\0' == name[1] || ('.' == name[1] && '\0' == name[2])))
+        {
+            continue;
+        }
+        m_entry.m_name = name;
+        m_entry.m_nameLength = std::strlen(name);
+        m_entry.m_inode = record->d_ino;
+        m_entry.m_type = detail::entryType(record->d_type);
+        m_entry.m_fd = level.fd;
+        m_entry.m_depth = (int) m_levels.size() - 1;
+        return true;
+    }
+#elif defined(PCTK_OS_UNIX)
+    for (;;)
+    {
+        errno = 0;
+        const struct dirent *record = ::readdir(static_cast<DIR *>(level.stream));
+        if (!record)
+        {
+            if (0 != errno)
+            {
+                detail::throwDirectoryError(errno, "DirectoryIterator: cannot read " + m_root + "/" + m_relative);
+            }
+            return false;
+        }
+        const char *name = record->d_name;
+        if ('.' == name[0] && ('\0' == name[1] || ('.' == name[1] && '\0' == name[2])))
+        {
+            continue;
+        }
+        m_entry.m_name = name;
+        m_entry.m_nameLength = std::strlen(name);
+        m_entry.m_inode = (pctk_uint64_t) record->d_ino;
+#   if defined(DT_UNKNOWN)
+        m_entry.m_type = detail::entryType(record->d_type);
+#   else
+        m_entry.m_type = DirectoryEntry::Unknown;
+#   endif
+        m_entry.m_fd = level.fd;
+        m_entry.m_depth = (int) m_levels.size() - 1;
+        return true;
+    }
+#else
+    PCTK_UNUSED(level);
+    return false;
+#endif
+}
+
+bool DirectoryIterator::matches(const std::vector<std::string> &patterns) const PCTK_NOEXCEPT
+{
+#if defined(PCTK_OS_UNIX)
+    for (std::size_t i = 0; i < patterns.size(); ++i)
+    {
+        if (0 == ::fnmatch(patterns[i].c_str(), m_entry.m_name, 0))
+        {
+            return true;
+        }
+    }
+#else
+    PCTK_UNUSED(patterns);
+#endif
+    return false;
+}
+
+bool DirectoryIterator::walksInto() const
+{
+    if (!m_recursive || (m_maxDepth >= 0 && m_entry.m_depth >= m_maxDepth))
+    {
+        return false;
+    }
+    const DirectoryEntry::Type type = m_entry.type();
+    if (DirectoryEntry::Directory == type)
+    {
+        return true;
+    }
+#if defined(PCTK_OS_UNIX)
+    if (DirectoryEntry::Symlink == type && (m_options & FollowSymlinks))
+    {
+        struct stat buffer;
+        return 0 == ::fstatat(m_entry.m_fd, m_entry.m_name, &buffer, 0) && S_ISDIR(buffer.st_mode);
+    }
+#endif
+    return false;
+}
+
+RecursiveDirectoryIterator::RecursiveDirectoryIterator(const std::string &path, int options)
+    : DirectoryIterator(path, options, true)
+{
+}
+
+PCTK_END_NAMESPACE
@@ -0,0 +1,235 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#ifndef _PCTKDIRECTORYITERATOR_H
+#define _PCTKDIRECTORYITERATOR_H
+
+#include <pctkGlobal.h>
+#include <pctkVector.h>
+
+#include <string>
+#include <vector>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* One open directory of a walk, read in batches into a buffer kept per depth. */
+struct DirectoryLevel
+{
+    int fd;
+    /* DIR stream where getdents64 is not available */
+    void *stream;
+    char *buffer;
+    std::size_t position;
+    std::size_t size;
+    /* length of the relative path to restore once the level is left */
+    std::size_t relativeLength;
+    pctk_uint64_t device;
+    pctk_uint64_t inode;
+    bool end;
+    /* fd belongs to the caller and is not closed */
+    bool borrowed;
+};
+} // namespace detail
+
+class DirectoryIterator;
+
+/**
+ * @brief The entry a DirectoryIterator stands on. name() points into the iterator's read buffer and, like
+ * directoryFd(), stays valid until the iterator moves on. No path is built unless path() is asked for.
+ */
+class PCTK_CORE_API DirectoryEntry
+{
+public:
+    enum Type
+    {
+        Unknown = 0,
+        File,
+        Directory,
+        Symlink,
+        Other
+    };
+
+    DirectoryEntry()
+        : m_name(PCTK_NULLPTR), m_nameLength(0), m_inode(0), m_fd(-1), m_depth(0), m_type(Unknown),
+          m_iterator(PCTK_NULLPTR)
+    {
+    }
+
+    const char *name() const PCTK_NOEXCEPT { return m_name; }
+    std::size_t nameLength() const PCTK_NOEXCEPT { return m_nameLength; }
+
+    /**
+     * @brief The type the directory listing reported, a symbolic link is not followed. Filesystems that leave the
+     * type out cost one fstatat() relative to directoryFd() on the first call.
+     */
+    Type type() const;
+
+    bool isFile() const { return File == this->type(); }
+    bool isDirectory() const { return Directory == this->type(); }
+    bool isSymlink() const { return Symlink == this->type(); }
+
+    pctk_uint64_t inode() const PCTK_NOEXCEPT { return m_inode; }
+
+    /**
+     * @brief Fd of the directory holding the entry, for openat(), fstatat() and unlinkat() on name().
+     */
+    int directoryFd() const PCTK_NOEXCEPT { return m_fd; }
+
+    /**
+     * @brief 0 for entries of the directory the walk started in.
+     */
+    int depth() const PCTK_NOEXCEPT { return m_depth; }
+
+    /**
+     * @brief Path relative to the directory the walk started in, allocates.
+     */
+    std::string relativePath() const;
+
+    /**
+     * @brief The starting path joined with relativePath(), allocates.
+     */
+    std::string path() const;
+
+private:
+    friend class DirectoryIterator;
+
+    const char *m_name;
+    std::size_t m_nameLength;
+    pctk_uint64_t m_inode;
+    int m_fd;
+    int m_depth;
+    mutable Type m_type;
+    const DirectoryIterator *m_iterator;
+};
+
+/**
+ * @brief Streaming listing of one directory, without "." and "..", in the order the filesystem returns entries.
+ * On Linux entries are read with getdents64 into a 32 KiB buffer, elsewhere through readdir(). Only the starting
+ * directory is opened by path, see RecursiveDirectoryIterator for walks below it.
+ *
+ * Include and exclude patterns are fnmatch() patterns on the entry name. An entry matching an exclude pattern is
+ * skipped, if any include pattern is set an entry must match one of them. Errors throw std::system_error.
+ */
+class PCTK_CORE_API DirectoryIterator
+{
+public:
+    enum Option
+    {
+        NoOption = 0x0,
+        /* skip names starting with a dot */
+        SkipHidden = 0x1,
+        /* list directories only to walk them, never as entries */
+        SkipDirectories = 0x2,
+        /* walk through symbolic links to directories, a link back into the walk is not followed */
+        FollowSymlinks = 0x4,
+        /* leave out subdirectories that cannot be opened for lack of permission instead of throwing */
+        SkipPermissionDenied = 0x8
+    };
+
+    explicit DirectoryIterator(const std::string &path, int options = NoOption);
+
+    /**
+     * @brief Lists the directory open on directoryFd, which stays owned by the caller and must outlive the iterator.
+     * path is what rootPath() and DirectoryEntry::path() report, it is not opened.
+     */
+    DirectoryIterator(int directoryFd, const std::string &path, int options = NoOption);
+    virtual ~DirectoryIterator();
+
+    void addIncludePattern(const std::string &pattern) { m_includes.push_back(pattern); }
+    void addExcludePattern(const std::string &pattern) { m_excludes.push_back(pattern); }
+
+    /**
+     * @brief Moves to the next entry, returns false once the listing is exhausted.
+     */
+    bool next();
+
+    const DirectoryEntry &entry() const PCTK_NOEXCEPT { return m_entry; }
+
+    const std::string &rootPath() const PCTK_NOEXCEPT { return m_root; }
+
+protected:
+    DirectoryIterator(const std::string &path, int options, bool recursive);
+
+    /* the current entry is not walked into */
+    void skipCurrent() PCTK_NOEXCEPT { m_descend = false; }
+    void setMaxDepth(int depth) PCTK_NOEXCEPT { m_maxDepth = depth; }
+    int maxDepth() const PCTK_NOEXCEPT { return m_maxDepth; }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(DirectoryIterator)
+
+    friend class DirectoryEntry;
+
+    void open(const std::string &path);
+    bool push(int fd, bool borrowed = false);
+    void pop() PCTK_NOEXCEPT;
+    void descend();
+    bool read(detail::DirectoryLevel &level);
+    bool matches(const std::vector<std::string> &patterns) const PCTK_NOEXCEPT;
+    bool walksInto() const;
+
+    Vector<detail::DirectoryLevel> m_levels;
+    Vector<char *> m_buffers;
+    std::string m_root;
+    /* relative path of the directory being read, with a trailing separator */
+    std::string m_relative;
+    std::vector<std::string> m_includes;
+    std::vector<std::string> m_excludes;
+    DirectoryEntry m_entry;
+    int m_options;
+    int m_maxDepth;
+    bool m_recursive;
+    bool m_descend;
+};
+
+/**
+ * @brief Depth first walk below a directory, a directory is listed before its contents.
+ * Directories are opened with openat() relative to their parent, the walk keeps one fd per level and no native
+ * recursion, so trees of any depth and size are walked in constant memory per level. Directories excluded by a
+ * pattern are not entered, directories left out by the include patterns or SkipDirectories still are.
+ */
+class PCTK_CORE_API RecursiveDirectoryIterator : public DirectoryIterator
+{
+public:
+    explicit RecursiveDirectoryIterator(const std::string &path, int options = NoOption);
+
+    /**
+     * @brief Does not enter the current entry, if it is a directory.
+     */
+    void skipChildren() PCTK_NOEXCEPT { this->skipCurrent(); }
+
+    /**
+     * @brief Entries deeper than depth are not listed, 0 lists the starting directory only, -1 has no limit.
+     */
+    void setMaxDepth(int depth) PCTK_NOEXCEPT { DirectoryIterator::setMaxDepth(depth); }
+    int maxDepth() const PCTK_NOEXCEPT { return DirectoryIterator::maxDepth(); }
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKDIRECTORYITERATOR_H
@@ -0,0 +1,821 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include <pctkFile.h>
+#include <pctkPlatformDefs.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <utility>
+
+#if defined(PCTK_OS_UNIX)
+#   include <fcntl.h>
+#   include <sys/stat.h>
+#   include <sys/uio.h>
+#   include <unistd.h>
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* writev() takes at most IOV_MAX pieces, 16 keeps the gathered vector on the stack */
+static const int FileMaxVectors = 16;
+
+static void throwFileError(int error, const char *what)
+{
+    throw std::system_error(error, std::generic_category(), what);
+}
+
+static std::size_t alignUp(std::size_t size) PCTK_NOEXCEPT
+{
+    return (size + File::DirectAlignment - 1) & ~(File::DirectAlignment - 1);
+}
+
+#if defined(PCTK_OS_UNIX)
+/* outside the class, where PCTK_OPEN may expand to a bare open() that would otherwise find File::open() */
+static int openFile(const std::string &path, int flags) PCTK_NOEXCEPT
+{
+    return PCTK_OPEN(path.c_str(), flags, 0666);
+}
+
+static PCTK_OFF_T seekFile(int fd, PCTK_OFF_T offset, int whence)
+{
+    const PCTK_OFF_T position = PCTK_LSEEK(fd, offset, whence);
+    if (position < 0)
+    {
+        throwFileError(errno, "File: lseek");
+    }
+    return position;
+}
+
+static int nativeAdvice(File::Advice advice) PCTK_NOEXCEPT
+{
+    switch (advice)
+    {
+        case File::Sequential:
+            return POSIX_FADV_SEQUENTIAL;
+        case File::Random:
+            return POSIX_FADV_RANDOM;
+        case File::WillNeed:
+            return POSIX_FADV_WILLNEED;
+        case File::DontNeed:
+            return POSIX_FADV_DONTNEED;
+        case File::NoReuse:
+            return POSIX_FADV_NOREUSE;
+        default:
+            return POSIX_FADV_NORMAL;
+    }
+}
+#endif
+} // namespace detail
+
+const std::size_t File::DefaultBufferSize;
+const std::size_t File::DirectAlignment;
+
+File::File() PCTK_NOEXCEPT
+    : m_buffer(PCTK_NULLPTR), m_capacity(0), m_begin(0), m_end(0), m_pending(0), m_fd(-1), m_mode(ReadOnly)
+    , m_options(0), m_direct(false), m_unsynced(false)
+{
+}
+
+File::File(const std::string &path, Mode mode, int options, std::size_t bufferSize)
+    : m_buffer(PCTK_NULLPTR), m_capacity(0), m_begin(0), m_end(0), m_pending(0), m_fd(-1), m_mode(ReadOnly)
+    , m_options(0), m_direct(false), m_unsynced(false)
+{
+    this->open(path, mode, options, bufferSize);
+}
+
+File::File(File &&other) PCTK_NOEXCEPT
+    : m_buffer(other.m_buffer), m_capacity(other.m_capacity), m_begin(other.m_begin), m_end(other.m_end)
+    , m_pending(other.m_pending), m_fd(other.m_fd), m_mode(other.m_mode), m_options(other.m_options)
+    , m_direct(other.m_direct), m_unsynced(other.m_unsynced)
+{
+    other.m_buffer = PCTK_NULLPTR;
+    other.m_capacity = other.m_begin = other.m_end = other.m_pending = 0;
+    other.m_fd = -1;
+    other.m_direct = false;
+    other.m_unsynced = false;
+}
+
+File &File::operator=(File &&other) PCTK_NOEXCEPT
+{
+    if (this != &other)
+    {
+        try
+        {
+            this->close();
+        }
+        catch (...)
+        {
+        }
+        std::swap(m_buffer, other.m_buffer);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_begin, other.m_begin);
+        std::swap(m_end, other.m_end);
+        std::swap(m_pending, other.m_pending);
+        std::swap(m_fd, other.m_fd);
+        std::swap(m_mode, other.m_mode);
+        std::swap(m_options, other.m_options);
+        std::swap(m_direct, other.m_direct);
+        std::swap(m_unsynced, other.m_unsynced);
+    }
+    return *this;
+}
+
+File::~File()
+{
+    try
+    {
+        this->close();
+    }
+    catch (...)
+    {
+    }
+}
+
+void File::open(const std::string &path, Mode mode, int options, std::size_t bufferSize)
+{
+    this->close();
+#if defined(PCTK_OS_UNIX)
+    int flags = O_CLOEXEC | (ReadOnly == mode ? O_RDONLY : WriteOnly == mode ? O_WRONLY : O_RDWR);
+    if (ReadOnly != mode)
+    {
+        flags |= (options & Create ? O_CREAT : 0) | (options & Truncate ? O_TRUNC : 0)
+                 | (options & Append ? O_APPEND : 0);
+    }
+    int fd = -1;
+    bool direct = false;
+#   if defined(O_DIRECT)
+    /* appends land at the end of the file, which is rarely on a block boundary */
+    if ((options & Direct) && !(ReadOnly != mode && (options & Append)))
+    {
+        fd = detail::openFile(path, flags | O_DIRECT);
+        if (fd < 0 && EINVAL != errno)
+        {
+            detail::throwFileError(errno, "File: cannot open");
+        }
+        direct = fd >= 0;
+    }
+#   endif
+    if (fd < 0)
+    {
+        fd = detail::openFile(path, flags);
+        if (fd < 0)
+        {
+            detail::throwFileError(errno, "File: cannot open");
+        }
+    }
+    m_fd = fd;
+    m_mode = mode;
+    m_options = options;
+    m_direct = direct;
+    /* whole blocks keep O_DIRECT transfers aligned and cost nothing otherwise */
+    m_capacity = detail::alignUp(bufferSize > 0 ? bufferSize : 1);
+#else
+    PCTK_UNUSED(path);
+    PCTK_UNUSED(mode);
+    PCTK_UNUSED(options);
+    PCTK_UNUSED(bufferSize);
+    detail::throwFileError((int) std::errc::function_not_supported, "File: not supported on this platform");
+#endif
+}
+
+void File::close()
+{
+    if (m_fd < 0)
+    {
+        return;
+    }
+    try
+    {
+        this->flushBuffer(true);
+    }
+    catch (...)
+    {
+        this->release();
+        throw;
+    }
+    this->release();
+}
+
+pctk_int64_t File::size() const
+{
+#if defined(PCTK_OS_UNIX)
+    PCTK_STATBUF status;
+    if (0 != PCTK_FSTAT(m_fd, &status))
+    {
+        detail::throwFileError(errno, "File: fstat");
+    }
+    return (pctk_int64_t) status.st_size;
+#else
+    detail::throwFileError(EBADF, "File: fstat");
+    return 0;
+#endif
+}
+
+pctk_int64_t File::position() const
+{
+#if defined(PCTK_OS_UNIX)
+    const PCTK_OFF_T offset = detail::seekFile(m_fd, 0, SEEK_CUR);
+    return (pctk_int64_t) offset - (pctk_int64_t) (m_end - m_begin) + (pctk_int64_t) m_pending;
+#else
+    detail::throwFileError(EBADF, "File: lseek");
+    return 0;
+#endif
+}
+
+void File::seek(pctk_int64_t position)
+{
+    this->flushBuffer(true);
+    m_begin = m_end = 0;
+#if defined(PCTK_OS_UNIX)
+    if (m_direct && 0 != (position & (pctk_int64_t) (DirectAlignment - 1)))
+    {
+        if (WriteOnly == m_mode)
+        {
+            this->disableDirect();
+        }
+        else
+        {
+            /* read the block the position falls into and skip its head */
+            const pctk_int64_t block = position & ~(pctk_int64_t) (DirectAlignment - 1);
+            detail::seekFile(m_fd, (PCTK_OFF_T) block, SEEK_SET);
+            this->fill();
+            m_begin = std::min(m_end, (std::size_t) (position - block));
+            return;
+        }
+    }
+    detail::seekFile(m_fd, (PCTK_OFF_T) position, SEEK_SET);
+#else
+    PCTK_UNUSED(position);
+#endif
+}
+
+Span<const char> File::peek(std::size_t count)
+{
+    this->flushBuffer(true);
+    while (m_end - m_begin < count && 0 != this->fill())
+    {
+    }
+    return Span<const char>(m_buffer + m_begin, m_end - m_begin);
+}
+
+void File::consume(std::size_t count) PCTK_NOEXCEPT
+{
+    m_begin += std::min(count, m_end - m_begin);
+}
+
+Span<const char> File::read(std::size_t maximum)
+{
+    this->flushBuffer(true);
+    if (m_begin == m_end)
+    {
+        this->fill();
+    }
+    const Span<const char> view(m_buffer + m_begin, std::min(maximum, m_end - m_begin));
+    m_begin += view.size();
+    return view;
+}
+
+std::size_t File::read(char *data, std::size_t size)
+{
+    this->flushBuffer(true);
+    std::size_t done = std::min(size, m_end - m_begin);
+    if (done > 0)
+    {
+        std::memcpy(data, m_buffer + m_begin, done);
+        m_begin += done;
+    }
+    while (done < size)
+    {
+        const std::size_t remaining = size - done;
+#if defined(PCTK_OS_UNIX)
+        if (!m_direct && remaining >= m_capacity)
+        {
+            /* the caller's memory takes the request, the buffer whatever follows it, in one call */
+            this->allocate();
+            m_begin = m_end = 0;
+            struct iovec vectors[2];
+            vectors[0].iov_base = data + done;
+            vectors[0].iov_len = remaining;
+            vectors[1].iov_base = m_buffer;
+            vectors[1].iov_len = m_capacity;
+            ssize_t count;
+            while ((count = ::readv(m_fd, vectors, 2)) < 0 && EINTR == errno)
+            {
+            }
+            if (count < 0)
+            {
+                detail::throwFileError(errno, "File: readv");
+            }
+            if (0 == count)
+            {
+                break;
+            }
+            if ((std::size_t) count > remaining)
+            {
+                m_end = (std::size_t) count - remaining;
+                count = (ssize_t) remaining;
+            }
+            done += (std::size_t) count;
+            continue;
+        }
+#endif
+        if (0 == this->fill())
+        {
+            break;
+        }
+        const std::size_t count = std::min(remaining, m_end - m_begin);
+        std::memcpy(data + done, m_buffer + m_begin, count);
+        m_begin += count;
+        done += count;
+    }
+    return done;
+}
+
+Span<const char> File::readLine(char delimiter)
+{
+    this->flushBuffer(true);
+    std::size_t scanned = 0;
+    do
+    {
+        const std::size_t available = m_end - m_begin;
+        if (available > scanned)
+        {
+            const char *line = m_buffer + m_begin;
+            const void *found = std::memchr(line + scanned, delimiter, available - scanned);
+            if (found)
+            {
+                const std::size_t length = (std::size_t) (static_cast<const char *>(found) - line) + 1;
+                m_begin += length;
+                return Span<const char>(line, length);
+            }
+            scanned = available;
+        }
+    }
+    while (0 != this->fill());
+    const Span<const char> rest(m_buffer + m_begin, m_end - m_begin);
+    m_begin = m_end;
+    return rest;
+}
+
+void File::write(const char *data, std::size_t size)
+{
+    if (0 == size)
+    {
+        return;
+    }
+    this->dropReadBuffer();
+    this->allocate();
+    if (size <= m_capacity - m_pending)
+    {
+        std::memcpy(m_buffer + m_pending, data, size);
+        m_pending += size;
+        return;
+    }
+    if (!m_direct)
+    {
+        Span<const char> pieces[2] = {Span<const char>(m_buffer, m_pending), Span<const char>(data, size)};
+        this->writeBuffer(pieces, 2);
+        return;
+    }
+    /* the caller's memory is not aligned for O_DIRECT, whole buffers go out instead */
+    while (size > 0)
+    {
+        const std::size_t count = std::min(size, m_capacity - m_pending);
+        std::memcpy(m_buffer + m_pending, data, count);
+        m_pending += count;
+        data += count;
+        size -= count;
+        if (m_capacity == m_pending)
+        {
+            this->flushBuffer(false);
+        }
+    }
+}
+
+void File::write(const Span<const char> *pieces, std::size_t count)
+{
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        total += pieces[i].size();
+    }
+    this->dropReadBuffer();
+    this->allocate();
+    if (m_direct || total <= m_capacity - m_pending)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            this->write(pieces[i]);
+        }
+        return;
+    }
+    /* the first batch starts with the pending buffer, empty once it went out */
+    Span<const char> vectors[detail::FileMaxVectors];
+    vectors[0] = Span<const char>(m_buffer, m_pending);
+    int used = 1;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (pieces[i].empty())
+        {
+            continue;
+        }
+        vectors[used++] = pieces[i];
+        if (detail::FileMaxVectors == used)
+        {
+            this->writeBuffer(vectors, used);
+            vectors[0] = Span<const char>(m_buffer, m_pending);
+            used = 1;
+        }
+    }
+    if (used > 1)
+    {
+        this->writeBuffer(vectors, used);
+    }
+}
+
+std::size_t File::readAt(pctk_int64_t offset, char *data, std::size_t size)
+{
+    this->flushBuffer(true);
+    std::size_t done = 0;
+#if defined(PCTK_OS_UNIX)
+    while (done < size)
+    {
+        const ssize_t count = ::pread(m_fd, data + done, size - done, (off_t) (offset + (pctk_int64_t) done));
+        if (count < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            detail::throwFileError(errno, "File: pread");
+        }
+        if (0 == count)
+        {
+            break;
+        }
+        done += (std::size_t) count;
+    }
+#else
+    PCTK_UNUSED(offset);
+    PCTK_UNUSED(data);
+    PCTK_UNUSED(size);
+#endif
+    return done;
+}
+
+void File::writeAt(pctk_int64_t offset, const char *data, std::size_t size)
+{
+    this->flushBuffer(true);
+    /* buffered reads may cover the range */
+    this->dropReadBuffer();
+#if defined(PCTK_OS_UNIX)
+    std::size_t done = 0;
+    while (done < size)
+    {
+        const ssize_t count = ::pwrite(m_fd, data + done, size - done, (off_t) (offset + (pctk_int64_t) done));
+        if (count < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            detail::throwFileError(errno, "File: pwrite");
+        }
+        m_unsynced = true;
+        done += (std::size_t) count;
+    }
+#else
+    PCTK_UNUSED(offset);
+    PCTK_UNUSED(data);
+    PCTK_UNUSED(size);
+#endif
+}
+
+void File::flush()
+{
+    this->flushBuffer(true);
+}
+
+void File::sync()
+{
+#if defined(PCTK_OS_LINUX) && defined(RWF_DSYNC)
+    if (m_pending > 0 && !m_direct && !m_unsynced)
+    {
+        struct iovec vector;
+        vector.iov_base = m_buffer;
+        vector.iov_len = m_pending;
+        int error = 0;
+        while (vector.iov_len > 0)
+        {
+            /* offset -1 writes at the file position and moves it, as writev() does */
+            const ssize_t count = ::pwritev2(m_fd, &vector, 1, -1, RWF_DSYNC);
+            if (count < 0)
+            {
+                if (EINTR == errno)
+                {
+                    continue;
+                }
+                /* without pwritev2() or RWF_DSYNC in the kernel the rest goes the portable way */
+                error = ENOSYS == errno || EOPNOTSUPP == errno ? 0 : errno;
+                break;
+            }
+            vector.iov_base = static_cast<char *>(vector.iov_base) + count;
+            vector.iov_len -= (std::size_t) count;
+        }
+        std::memmove(m_buffer, vector.iov_base, vector.iov_len);
+        m_pending = vector.iov_len;
+        if (0 != error)
+        {
+            detail::throwFileError(error, "File: pwritev2");
+        }
+        if (0 == m_pending)
+        {
+            return;
+        }
+    }
+#endif
+    this->flushBuffer(true);
+#if defined(PCTK_OS_LINUX)
+    const int result = ::fdatasync(m_fd);
+#elif defined(PCTK_OS_UNIX)
+    const int result = ::fsync(m_fd);
+#else
+    const int result = 0;
+#endif
+    if (0 != result)
+    {
+        detail::throwFileError(errno, "File: fsync");
+    }
+    m_unsynced = false;
+}
+
+bool File::advise(Advice advice, pctk_int64_t offset, pctk_int64_t length) PCTK_NOEXCEPT
+{
+#if defined(PCTK_OS_LINUX)
+    return m_fd >= 0 && 0 == ::posix_fadvise(m_fd, (off_t) offset, (off_t) length, detail::nativeAdvice(advice));
+#else
+    PCTK_UNUSED(advice);
+    PCTK_UNUSED(offset);
+    PCTK_UNUSED(length);
+    return false;
+#endif
+}
+
+void File::allocate()
+{
+    if (m_buffer)
+    {
+        return;
+    }
+#if defined(PCTK_OS_UNIX)
+    void *buffer = PCTK_NULLPTR;
+    if (0 != ::posix_memalign(&buffer, DirectAlignment, m_capacity))
+    {
+        throw std::bad_alloc();
+    }
+    m_buffer = static_cast<char *>(buffer);
+#else
+    throw std::bad_alloc();
+#endif
+}
+
+void File::grow()
+{
+    const std::size_t capacity = m_capacity;
+    char *buffer = m_buffer;
+    m_buffer = PCTK_NULLPTR;
+    m_capacity *= 2;
+    try
+    {
+        this->allocate();
+    }
+    catch (...)
+    {
+        m_buffer = buffer;
+        m_capacity = capacity;
+        throw;
+    }
+    std::memcpy(m_buffer + m_begin, buffer + m_begin, m_end - m_begin);
+    std::free(buffer);
+}
+
+std::size_t File::fill()
+{
+    this->allocate();
+    this->compact();
+    if (m_capacity == m_end)
+    {
+        this->grow();
+    }
+#if defined(PCTK_OS_UNIX)
+    ssize_t count;
+    while ((count = ::read(m_fd, m_buffer + m_end, m_capacity - m_end)) < 0)
+    {
+        if (EINTR == errno)
+        {
+            continue;
+        }
+        if (EINVAL == errno && m_direct)
+        {
+            /* the filesystem took the O_DIRECT open but not the transfer */
+            this->disableDirect();
+            continue;
+        }
+        detail::throwFileError(errno, "File: read");
+    }
+    m_end += (std::size_t) count;
+    if (m_direct && 0 != ((std::size_t) count & (DirectAlignment - 1)))
+    {
+        /* a short read left the file position unaligned */
+        this->disableDirect();
+    }
+    return (std::size_t) count;
+#else
+    return 0;
+#endif
+}
+
+void File::compact() PCTK_NOEXCEPT
+{
+    const std::size_t kept = m_end - m_begin;
+    /* with O_DIRECT the kept bytes end on a block boundary, where the next read lands */
+    const std::size_t target = m_direct ? detail::alignUp(kept) - kept : 0;
+    if (0 == kept)
+    {
+        m_begin = m_end = 0;
+    }
+    else if (m_begin != target)
+    {
+        std::memmove(m_buffer + target, m_buffer + m_begin, kept);
+        m_begin = target;
+        m_end = target + kept;
+    }
+}
+
+void File::dropReadBuffer()
+{
+    const std::size_t unread = m_end - m_begin;
+    m_begin = m_end = 0;
+#if defined(PCTK_OS_UNIX)
+    if (unread > 0)
+    {
+        /* step back over what was read ahead, so the next write lands at position() */
+        const PCTK_OFF_T position = detail::seekFile(m_fd, -(PCTK_OFF_T) unread, SEEK_CUR);
+        if (m_direct && 0 != (position & (PCTK_OFF_T) (DirectAlignment - 1)))
+        {
+            this->disableDirect();
+        }
+    }
+#endif
+}
+
+void File::flushBuffer(bool all)
+{
+    if (0 == m_pending)
+    {
+        return;
+    }
+    const std::size_t aligned = m_direct ? m_pending & ~(DirectAlignment - 1) : m_pending;
+    if (aligned > 0)
+    {
+        Span<const char> piece(m_buffer, aligned);
+        this->writeBuffer(&piece, 1);
+    }
+    if (all && m_pending > 0)
+    {
+        /* an unaligned tail cannot go out with O_DIRECT */
+        this->disableDirect();
+        Span<const char> piece(m_buffer, m_pending);
+        this->writeBuffer(&piece, 1);
+    }
+}
+
+/* Writes pieces, the first of which is a head of the pending buffer. What writeVector() left of that piece stays
+ * pending together with the rest of the buffer, when it throws as well. */
+void File::writeBuffer(Span<const char> *pieces, int count)
+{
+    const char *end = m_buffer + m_pending;
+    try
+    {
+        this->writeVector(pieces, count);
+    }
+    catch (...)
+    {
+        m_pending = (std::size_t) (end - pieces[0].data());
+        std::memmove(m_buffer, pieces[0].data(), m_pending);
+        throw;
+    }
+    m_pending = (std::size_t) (end - pieces[0].data());
+    std::memmove(m_buffer, pieces[0].data(), m_pending);
+}
+
+void File::writeVector(Span<const char> *pieces, int count)
+{
+#if defined(PCTK_OS_UNIX)
+    struct iovec vectors[detail::FileMaxVectors];
+    int first = 0;
+    while (first < count)
+    {
+        const int batch = std::min(count - first, detail::FileMaxVectors);
+        for (int i = 0; i < batch; ++i)
+        {
+            vectors[i].iov_base = const_cast<char *>(pieces[first + i].data());
+            vectors[i].iov_len = pieces[first + i].size();
+        }
+        ssize_t written = ::writev(m_fd, vectors, batch);
+        if (written < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            if (EINVAL == errno && m_direct)
+            {
+                /* the filesystem took the O_DIRECT open but not the transfer */
+                this->disableDirect();
+                continue;
+            }
+            detail::throwFileError(errno, "File: writev");
+        }
+        m_unsynced = true;
+        /* drop what went out, emptied pieces keep pointing past their end, a short write resumes inside a piece */
+        while (first < count && (std::size_t) written >= pieces[first].size())
+        {
+            written -= (ssize_t) pieces[first].size();
+            pieces[first] = pieces[first].subspan(pieces[first].size());
+            ++first;
+        }
+        if (first < count && written > 0)
+        {
+            pieces[first] = pieces[first].subspan((std::size_t) written);
+            if (m_direct)
+            {
+                this->disableDirect();
+            }
+        }
+    }
+#else
+    PCTK_UNUSED(pieces);
+    PCTK_UNUSED(count);
+#endif
+}
+
+void File::disableDirect()
+{
+#if defined(PCTK_OS_UNIX) && defined(O_DIRECT)
+    if (m_direct)
+    {
+        const int flags = ::fcntl(m_fd, F_GETFL);
+        if (flags < 0 || 0 != ::fcntl(m_fd, F_SETFL, flags & ~O_DIRECT))
+        {
+            detail::throwFileError(errno, "File: fcntl");
+        }
+    }
+#endif
+    m_direct = false;
+}
+
+void File::release() PCTK_NOEXCEPT
+{
+#if defined(PCTK_OS_UNIX)
+    ::close(m_fd);
+#endif
+    std::free(m_buffer);
+    m_buffer = PCTK_NULLPTR;
+    m_capacity = m_begin = m_end = m_pending = 0;
+    m_fd = -1;
+    m_direct = false;
+    m_unsynced = false;
+}
+
+PCTK_END_NAMESPACE
@@ -0,0 +1,214 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#ifndef _PCTKFILE_H
+#define _PCTKFILE_H
+
+#include <pctkGlobal.h>
+#include <pctkSpan.h>
+
+#include <string>
+
+PCTK_BEGIN_NAMESPACE
+
+/**
+ * @brief A file read and written through one buffer. Reads hand out views into that buffer instead of copying into
+ * the caller's memory, small writes are gathered in it and go out with one writev() together with the write that
+ * overflows it. readAt() and writeAt() work at an explicit offset and leave the stream position alone.
+ * Errors throw std::system_error, buffered bytes a failing write did not get out stay buffered for the next flush.
+ *
+ * Views returned by peek(), read() and readLine() stay valid until the next call on the File.
+ */
+class PCTK_CORE_API File
+{
+public:
+    enum Mode
+    {
+        ReadOnly,
+        WriteOnly,
+        ReadWrite
+    };
+
+    enum Option
+    {
+        NoOption = 0x0,
+        /* create the file if it does not exist */
+        Create = 0x1,
+        /* truncate the file to 0 bytes when it is opened */
+        Truncate = 0x2,
+        /* every write goes to the end of the file */
+        Append = 0x4,
+        /* bypass the page cache with O_DIRECT for large sequential streams (Linux). The stream falls back to the page
+         * cache from the first unaligned position on, and entirely with Append or where the filesystem refuses
+         * O_DIRECT. */
+        Direct = 0x8
+    };
+
+    enum Advice
+    {
+        Normal,
+        /* read ahead aggressively */
+        Sequential,
+        /* no read ahead */
+        Random,
+        /* start reading the range in now */
+        WillNeed,
+        /* the range is not needed soon, its cached pages may be dropped */
+        DontNeed,
+        /* the range is read once */
+        NoReuse
+    };
+
+    static const std::size_t DefaultBufferSize = 64 * 1024;
+    /* offsets, sizes and buffer addresses of O_DIRECT transfers are multiples of this */
+    static const std::size_t DirectAlignment = 4096;
+
+    File() PCTK_NOEXCEPT;
+    explicit File(const std::string &path, Mode mode = ReadOnly, int options = NoOption,
+                  std::size_t bufferSize = DefaultBufferSize);
+    File(File &&other) PCTK_NOEXCEPT;
+    File &operator=(File &&other) PCTK_NOEXCEPT;
+    /**
+     * @brief Flushes and closes, a failing flush is lost. Call close() to see it.
+     */
+    ~File();
+
+    /**
+     * @brief Opens path, closing whatever was open before.
+     */
+    void open(const std::string &path, Mode mode = ReadOnly, int options = NoOption,
+              std::size_t bufferSize = DefaultBufferSize);
+    /**
+     * @brief Flushes buffered writes and closes the file, which is closed even if the flush throws.
+     */
+    void close();
+
+    bool isOpen() const PCTK_NOEXCEPT { return m_fd >= 0; }
+    Mode mode() const PCTK_NOEXCEPT { return m_mode; }
+    int handle() const PCTK_NOEXCEPT { return m_fd; }
+    /**
+     * @brief Whether transfers currently bypass the page cache.
+     */
+    bool isDirect() const PCTK_NOEXCEPT { return m_direct; }
+
+    /**
+     * @brief The size of the file, not counting writes still buffered.
+     */
+    pctk_int64_t size() const;
+    /**
+     * @brief The stream position, counting buffered reads and writes.
+     */
+    pctk_int64_t position() const;
+    void seek(pctk_int64_t position);
+
+    /**
+     * @brief Buffers at least count bytes, fewer only at the end of the file, and returns everything buffered without
+     * consuming it. The buffer grows if count exceeds it.
+     */
+    Span<const char> peek(std::size_t count = 1);
+    /**
+     * @brief Consumes count bytes of what peek() returned.
+     */
+    void consume(std::size_t count) PCTK_NOEXCEPT;
+    /**
+     * @brief Consumes and returns up to maximum buffered bytes, refilling the buffer when it is empty. Empty at the end
+     * of the file.
+     */
+    Span<const char> read(std::size_t maximum);
+    /**
+     * @brief Copies up to size bytes into data, returns fewer only at the end of the file. Large reads land in data
+     * directly, with one readv() that refills the buffer too.
+     */
+    std::size_t read(char *data, std::size_t size);
+    /**
+     * @brief Consumes and returns the next line including its delimiter, the last line may lack it. Empty at the end
+     * of the file. The buffer grows to hold lines longer than it.
+     */
+    Span<const char> readLine(char delimiter = '\n');
+
+    void write(const char *data, std::size_t size);
+    void write(Span<const char> data) { this->write(data.data(), data.size()); }
+    /**
+     * @brief Writes the pieces in order, one writev() for all of them and the buffer when they do not fit it.
+     */
+    void write(const Span<const char> *pieces, std::size_t count);
+
+    /**
+     * @brief Reads up to size bytes at offset with pread(), returns fewer only at the end of the file.
+     */
+    std::size_t readAt(pctk_int64_t offset, char *data, std::size_t size);
+    /**
+     * @brief Writes size bytes at offset with pwrite(), after the writes already buffered.
+     */
+    void writeAt(pctk_int64_t offset, const char *data, std::size_t size);
+
+    /**
+     * @brief Writes the buffered bytes out.
+     */
+    void flush();
+    /**
+     * @brief Flushes and waits until the data is on the device. On Linux, when nothing went out since the last
+     * sync(), the buffered bytes go out with pwritev2(RWF_DSYNC), which saves the separate fdatasync().
+     */
+    void sync();
+
+    /**
+     * @brief posix_fadvise() for [offset, offset + length), a length of 0 runs to the end of the file. Returns false if
+     * the hint was refused or is not supported, never throws.
+     */
+    bool advise(Advice advice, pctk_int64_t offset = 0, pctk_int64_t length = 0) PCTK_NOEXCEPT;
+
+private:
+    PCTK_DISABLE_COPY(File)
+
+    void allocate();
+    void grow();
+    std::size_t fill();
+    void compact() PCTK_NOEXCEPT;
+    void dropReadBuffer();
+    void flushBuffer(bool all);
+    void writeBuffer(Span<const char> *pieces, int count);
+    void writeVector(Span<const char> *pieces, int count);
+    void disableDirect();
+    void release() PCTK_NOEXCEPT;
+
+    char *m_buffer;
+    std::size_t m_capacity;
+    /* buffered reads are [m_begin, m_end), buffered writes [0, m_pending), never both */
+    std::size_t m_begin;
+    std::size_t m_end;
+    std::size_t m_pending;
+    int m_fd;
+    Mode m_mode;
+    int m_options;
+    bool m_direct;
+    /* bytes went out since the last sync(), RWF_DSYNC would only cover its own range */
+    bool m_unsynced;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKFILE_H
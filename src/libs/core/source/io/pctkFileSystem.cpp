@@ -55,9 +55,12 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <stdexcept>
+#include <vector>
+
 PCTK_BEGIN_NAMESPACE
 
-FileSystemPrivate::FileSystemPrivate(FileSystem *q) : q_ptr(q)
+FileSystemPrivate::FileSystemPrivate(FileSystem *q) : q_ptr(q), statCache(PCTK_NULLPTR)
 {
 }
 
@@ -102,6 +105,11 @@ std::vector<std::string> splitString(const std::string &str, const std::string &
     return token;
 }
 
+FileStatus queryStatus(StatCache *cache, const std::string &path)
+{
+    return cache ? cache->status(path) : FileStatus::query(path);
+}
+
 };
 
 FileSystem::~FileSystem()
@@ -177,56 +185,68 @@ std::string FileSystem::getCurrentWorkingDirectory()
 
 bool FileSystem::exists(const std::string &path)
 {
-#if defined(PCTK_OS_UNIX)
-    PCTK_STATBUF s;
-    errno = 0;
-    if (PCTK_STAT(path.c_str(), &s)) {
-        if (detail::notFoundCError(errno)) {
-            return false;
-        } else {
-            throw std::invalid_argument(Error::getLastCErrorStr());
-        }
+    std::error_code error;
+    const bool result = this->exists(path, error);
+    if (error) {
+        throw std::invalid_argument(error.message());
     }
-#else
-    std::wstring wpath(ToWString(path));
-    DWORD attr(::GetFileAttributesW(wpath.c_str()));
-    if (attr == INVALID_FILE_ATTRIBUTES) {
-        if (not_found_win32_error(::GetLastError())) {
-            return false;
-        } else {
-            throw std::invalid_argument(GetLastWin32ErrorStr());
-        }
-    }
-#endif
-    return true;
+    return result;
 }
 
 bool FileSystem::isDirectory(const std::string &path)
 {
-    PCTK_STATBUF s;
-    errno = 0;
-    if (PCTK_STAT(path.c_str(), &s)) {
-        if (detail::notFoundCError(errno)) {
-            return false;
-        } else {
-            throw std::invalid_argument(Error::getLastCErrorStr());
-        }
+    std::error_code error;
+    const bool result = this->isDirectory(path, error);
+    if (error) {
+        throw std::invalid_argument(error.message());
     }
-    return S_ISDIR(s.st_mode);
+    return result;
 }
 
 bool FileSystem::isFile(const std::string &path)
 {
-    PCTK_STATBUF s;
-    errno = 0;
-    if (PCTK_STAT(path.c_str(), &s)) {
-        if (detail::notFoundCError(errno)) {
-            return false;
-        } else {
-            throw std::invalid_argument(Error::getLastCErrorStr());
-        }
+    std::error_code error;
+    const bool result = this->isFile(path, error);
+    if (error) {
+        throw std::invalid_argument(error.message());
     }
-    return S_ISREG(s.st_mode);
+    return result;
+}
+
+bool FileSystem::exists(const std::string &path, std::error_code &error)
+{
+    PCTK_D(FileSystem);
+    const FileStatus status = detail::queryStatus(d->statCache, path);
+    error = status.error();
+    return status.exists();
+}
+
+bool FileSystem::isDirectory(const std::string &path, std::error_code &error)
+{
+    PCTK_D(FileSystem);
+    const FileStatus status = detail::queryStatus(d->statCache, path);
+    error = status.error();
+    return status.isDirectory();
+}
+
+bool FileSystem::isFile(const std::string &path, std::error_code &error)
+{
+    PCTK_D(FileSystem);
+    const FileStatus status = detail::queryStatus(d->statCache, path);
+    error = status.error();
+    return status.isFile();
+}
+
+void FileSystem::setStatCache(StatCache *cache)
+{
+    PCTK_D(FileSystem);
+    d->statCache = cache;
+}
+
+StatCache *FileSystem::statCache() const
+{
+    PCTK_D(const FileSystem);
+    return d->statCache;
 }
 
 bool FileSystem::isRelative(const std::string &path)
@@ -28,9 +28,11 @@
 #include <pctkGlobal.h>
 
 #include <string>
+#include <system_error>
 
 PCTK_BEGIN_NAMESPACE
 
+class StatCache;
 class FileSystemPrivate;
 
 /**
@@ -76,6 +78,22 @@ public:
      */
     bool isFile(const std::string &path);
 
+    /**
+     * @brief Non-throwing exists(), isDirectory() and isFile(). A missing path returns false with error cleared, any
+     * other failure returns false and sets error.
+     */
+    bool exists(const std::string &path, std::error_code &error);
+    bool isDirectory(const std::string &path, std::error_code &error);
+    bool isFile(const std::string &path, std::error_code &error);
+
+    /**
+     * @brief Routes exists(), isDirectory() and isFile() through cache.
+     * @param cache the cache to consult, not owned and must outlive its use here, PCTK_NULLPTR detaches it so the
+     * filesystem is queried again
+     */
+    void setStatCache(StatCache *cache);
+    StatCache *statCache() const;
+
     /**
      * @brief
      * @param path
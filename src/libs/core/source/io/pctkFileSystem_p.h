@@ -26,6 +26,7 @@
 #define _PCTKFILESYSTEM_P_H
 
 #include <pctkFileSystem.h>
+#include <pctkStatCache.h>
 
 PCTK_BEGIN_NAMESPACE
 
@@ -36,6 +37,7 @@ public:
     virtual ~FileSystemPrivate();
 
     FileSystem * const q_ptr;
+    StatCache *statCache;
 
 private:
 };
@@ -0,0 +1,765 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include <pctkFileTree.h>
+#include <pctkDirectoryIterator.h>
+#include <pctkMutex.h>
+#include <pctkThreadPool.h>
+#include <pctkVector.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#if defined(PCTK_OS_UNIX)
+#   include <fcntl.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+#if defined(PCTK_OS_LINUX)
+#   include <linux/fs.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+#if defined(PCTK_OS_UNIX)
+namespace detail
+{
+/* workers publish their counts to FileTreeProgress after this many entries */
+static const pctk_uint64_t FileTreeProgressBatch = 4096;
+static const std::size_t FileTreeCopyBufferSize = 128 * 1024;
+static const int FileTreeDirectoryFlags = O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC;
+
+/* One directory of the tree. pending counts the directory's own listing plus every child directory that has not
+ * finished yet, the directory is finished (removed, or given its final mode) once it drops to zero. */
+struct FileTreeNode
+{
+    FileTreeNode(FileTreeNode *parent, const char *name, std::size_t length)
+        : parent(parent), fd(-1), targetFd(-1), mode(0), created(false), pending(1), kept(0)
+    {
+        if (parent)
+        {
+            this->name.assign(name, length);
+            this->path.reserve(parent->path.size() + length + 1);
+            this->path = parent->path;
+            this->path += this->name;
+            this->path += '/';
+        }
+    }
+
+    std::string directoryPath() const { return path.empty() ? path : path.substr(0, path.size() - 1); }
+
+    FileTreeNode *parent;
+    std::string name;
+    /* relative path with a trailing separator, for error reports */
+    std::string path;
+    int fd;
+    /* copyTree(): the destination directory and the mode it gets once its contents are copied */
+    int targetFd;
+    mode_t mode;
+    bool created;
+    AtomicInt pending;
+    /* removeAll(): something below could not be removed or the operation was cancelled, keep the directory */
+    AtomicInt kept;
+};
+
+struct FileTreeOperation
+{
+    enum Kind
+    {
+        Remove,
+        Copy
+    };
+
+    FileTreeOperation(Kind kind, const FileTree::Options &options)
+        : kind(kind), flags(options.flags), pool(PCTK_NULLPTR), maxErrors(options.maxErrors), targetDevice(0),
+          targetInode(0), active(0), finished(0)
+    {
+        progress = options.progress ? options.progress : &ownProgress;
+        startEntries = progress->entries();
+        startBytes = progress->bytes();
+        startErrors = progress->errors();
+        if (!(flags & FileTree::SingleThreaded))
+        {
+            ThreadPool *candidate = options.pool ? options.pool : ThreadPool::globalInstance();
+            /* blocking one of the pool's workers on work queued behind it could starve the pool */
+            if (!candidate->isWorkerThread())
+            {
+                pool = candidate;
+            }
+        }
+    }
+
+    void fail(const std::string &path, const char *operation, int error)
+    {
+        progress->m_errors.fetchAndAddRelaxed(1);
+        LockGuard<Mutex> lock(errorLock);
+        if (errors.size() < maxErrors)
+        {
+            FileTreeError entry;
+            entry.path = path;
+            entry.operation = operation;
+            entry.error = std::error_code(error, std::generic_category());
+            errors.push_back(entry);
+        }
+    }
+
+    void count(pctk_uint64_t entries, pctk_uint64_t bytes) PCTK_NOEXCEPT
+    {
+        if (entries)
+        {
+            progress->m_entries.fetchAndAddRelaxed(entries);
+        }
+        if (bytes)
+        {
+            progress->m_bytes.fetchAndAddRelaxed(bytes);
+        }
+    }
+
+    void start(FileTreeNode *root)
+    {
+        if (pool)
+        {
+            this->spawn(root);
+            for (int value = active.loadAcquire(); 0 != value; value = active.loadAcquire())
+            {
+                active.wait(value);
+            }
+            /* the last task may still be inside notifyAll(), the operation must outlive it */
+            while (0 == finished.loadAcquire())
+            {
+                std::this_thread::yield();
+            }
+            return;
+        }
+        queue.push_back(root);
+        while (!queue.empty())
+        {
+            FileTreeNode *node = queue.back();
+            queue.pop_back();
+            this->execute(node);
+        }
+    }
+
+    void spawn(FileTreeNode *node)
+    {
+        if (!pool)
+        {
+            queue.push_back(node);
+            return;
+        }
+        active.fetchAndAddRelaxed(1);
+        try
+        {
+            pool->submit([this, node]() {
+                this->execute(node);
+                if (1 == this->active.fetchAndSubOrdered(1))
+                {
+                    this->active.notifyAll();
+                    this->finished.storeRelease(1);
+                }
+            });
+        }
+        catch (const std::bad_alloc &)
+        {
+            active.fetchAndSubRelaxed(1);
+            this->execute(node);
+        }
+    }
+
+    void execute(FileTreeNode *node)
+    {
+        if (progress->isCancelled())
+        {
+            node->kept.store(1);
+        }
+        else if (node->fd >= 0 || this->open(node))
+        {
+            this->list(node);
+        }
+        this->release(node);
+    }
+
+    bool open(FileTreeNode *node)
+    {
+        node->fd = ::openat(node->parent->fd, node->name.c_str(), FileTreeDirectoryFlags);
+        if (node->fd < 0)
+        {
+            /* gone since it was listed, nothing left to do */
+            if (ENOENT != errno)
+            {
+                this->fail(node->directoryPath(), "open", errno);
+                node->kept.store(1);
+            }
+            return false;
+        }
+        if (Remove == kind)
+        {
+            return true;
+        }
+        struct stat status;
+        if (0 != ::fstat(node->fd, &status))
+        {
+            this->fail(node->directoryPath(), "open", errno);
+            return false;
+        }
+        node->mode = status.st_mode & 07777;
+        /* writable until its contents are copied, the source mode is applied when the directory finishes */
+        if (0 == ::mkdirat(node->parent->targetFd, node->name.c_str(), 0700))
+        {
+            node->created = true;
+        }
+        else if (EEXIST != errno)
+        {
+            this->fail(node->directoryPath(), "mkdir", errno);
+            return false;
+        }
+        node->targetFd = ::openat(node->parent->targetFd, node->name.c_str(), FileTreeDirectoryFlags);
+        if (node->targetFd < 0)
+        {
+            this->fail(node->directoryPath(), "open", errno);
+            return false;
+        }
+        return true;
+    }
+
+    void list(FileTreeNode *node)
+    {
+        pctk_uint64_t entries = 0;
+        pctk_uint64_t bytes = 0;
+        try
+        {
+            DirectoryIterator iterator(node->fd, node->path);
+            while (iterator.next())
+            {
+                const DirectoryEntry &entry = iterator.entry();
+                if (entry.isDirectory())
+                {
+                    if (Copy == kind && this->isTarget(node, entry))
+                    {
+                        /* the destination lies inside the source, do not copy it into itself */
+                        continue;
+                    }
+                    FileTreeNode *child = new FileTreeNode(node, entry.name(), entry.nameLength());
+                    node->pending.fetchAndAddRelaxed(1);
+                    this->spawn(child);
+                }
+                else if (Remove == kind)
+                {
+                    this->removeEntry(node, entry, entries);
+                }
+                else
+                {
+                    this->copyEntry(node, entry, entries, bytes);
+                }
+                if (entries >= FileTreeProgressBatch)
+                {
+                    this->count(entries, bytes);
+                    entries = 0;
+                    bytes = 0;
+                }
+                if (progress->isCancelled())
+                {
+                    node->kept.store(1);
+                    break;
+                }
+            }
+        }
+        catch (const std::system_error &error)
+        {
+            this->fail(node->directoryPath(), "read", error.code().value());
+            node->kept.store(1);
+        }
+        catch (const std::bad_alloc &)
+        {
+            this->fail(node->directoryPath(), "read", ENOMEM);
+            node->kept.store(1);
+        }
+        this->count(entries, bytes);
+    }
+
+    bool isTarget(const FileTreeNode *node, const DirectoryEntry &entry) const
+    {
+        if (entry.inode() != targetInode)
+        {
+            return false;
+        }
+        struct stat status;
+        return 0 == ::fstatat(node->fd, entry.name(), &status, AT_SYMLINK_NOFOLLOW)
+               && (pctk_uint64_t) status.st_dev == targetDevice && (pctk_uint64_t) status.st_ino == targetInode;
+    }
+
+    void removeEntry(FileTreeNode *node, const DirectoryEntry &entry, pctk_uint64_t &entries)
+    {
+        if (0 == ::unlinkat(node->fd, entry.name(), 0))
+        {
+            ++entries;
+        }
+        else if (ENOENT != errno)
+        {
+            this->fail(node->path + entry.name(), "unlink", errno);
+            node->kept.store(1);
+        }
+    }
+
+    void copyEntry(FileTreeNode *node, const DirectoryEntry &entry, pctk_uint64_t &entries, pctk_uint64_t &bytes)
+    {
+        const char *operation = "copy";
+        int error = 0;
+        switch (entry.type())
+        {
+            case DirectoryEntry::File:
+                error = copyFile(node->fd, entry.name(), node->targetFd, entry.name(), flags, bytes, operation);
+                break;
+            case DirectoryEntry::Symlink:
+                error = copyLink(node->fd, entry.name(), node->targetFd, entry.name(), flags, operation);
+                break;
+            case DirectoryEntry::Unknown:
+                /* could not even be stat'ed, it is gone */
+                return;
+            default:
+                error = (int) std::errc::not_supported;
+                break;
+        }
+        if (0 == error)
+        {
+            ++entries;
+        }
+        else if (ENOENT != error || 0 != std::strcmp(operation, "open"))
+        {
+            this->fail(node->path + entry.name(), operation, error);
+        }
+    }
+
+    void release(FileTreeNode *node)
+    {
+        /* iterative, finishing the last child of a deep chain must not recurse once per level */
+        while (node && 1 == node->pending.fetchAndSubOrdered(1))
+        {
+            FileTreeNode *parent = node->parent;
+            this->finish(node);
+            node = parent;
+        }
+    }
+
+    void finish(FileTreeNode *node)
+    {
+        const bool opened = node->fd >= 0;
+        if (opened)
+        {
+            ::close(node->fd);
+        }
+        if (Remove == kind)
+        {
+            if (node->kept.load())
+            {
+                if (node->parent)
+                {
+                    node->parent->kept.store(1);
+                }
+            }
+            else if (opened)
+            {
+                const int result = node->parent
+                                   ? ::unlinkat(node->parent->fd, node->name.c_str(), AT_REMOVEDIR)
+                                   : ::unlinkat(AT_FDCWD, rootPath.c_str(), AT_REMOVEDIR);
+                if (0 == result)
+                {
+                    this->count(1, 0);
+                }
+                else if (ENOENT != errno)
+                {
+                    this->fail(node->directoryPath(), "rmdir", errno);
+                    if (node->parent)
+                    {
+                        node->parent->kept.store(1);
+                    }
+                }
+            }
+        }
+        else if (node->targetFd >= 0)
+        {
+            if (node->created && 0 != ::fchmod(node->targetFd, node->mode))
+            {
+                this->fail(node->directoryPath(), "mkdir", errno);
+            }
+            ::close(node->targetFd);
+            this->count(1, 0);
+        }
+        delete node;
+    }
+
+    FileTreeResult result()
+    {
+        FileTreeResult result;
+        result.entries = progress->entries() - startEntries;
+        result.bytes = progress->bytes() - startBytes;
+        result.errorCount = progress->errors() - startErrors;
+        result.cancelled = progress->isCancelled();
+        result.errors.swap(errors);
+        return result;
+    }
+
+    static int copyData(int source, int target, int flags, pctk_uint64_t &bytes)
+    {
+#   if defined(PCTK_OS_LINUX)
+        /* a reflink, or copy_file_range() which shares extents itself on filesystems that can, both keep the data
+         * in the kernel. The file offsets are left where they stopped for the fallbacks to continue from. */
+        if (!(flags & FileTree::NoReflink))
+        {
+#       if defined(FICLONE)
+            struct stat status;
+            if (0 == ::ioctl(target, FICLONE, source) && 0 == ::fstat(target, &status))
+            {
+                bytes += (pctk_uint64_t) status.st_size;
+                return 0;
+            }
+#       endif
+#       if defined(SYS_copy_file_range)
+            for (;;)
+            {
+                const long count = ::syscall(SYS_copy_file_range, source, PCTK_NULLPTR, target, PCTK_NULLPTR,
+                                             (std::size_t) 1 << 30, 0u);
+                if (count > 0)
+                {
+                    bytes += (pctk_uint64_t) count;
+                    continue;
+                }
+                if (0 == count)
+                {
+                    return 0;
+                }
+                if (EINTR == errno)
+                {
+                    continue;
+                }
+                /* older kernels, cross filesystem copies or special files */
+                if (EXDEV != errno && EINVAL != errno && ENOSYS != errno && EOPNOTSUPP != errno && EBADF != errno)
+                {
+                    return errno;
+                }
+                break;
+            }
+#       endif
+        }
+#   endif
+        PCTK_UNUSED(flags);
+        char *buffer = static_cast<char *>(std::malloc(FileTreeCopyBufferSize));
+        if (!buffer)
+        {
+            return ENOMEM;
+        }
+        int error = 0;
+        for (;;)
+        {
+            const ssize_t count = ::read(source, buffer, FileTreeCopyBufferSize);
+            if (count < 0)
+            {
+                if (EINTR == errno)
+                {
+                    continue;
+                }
+                error = errno;
+                break;
+            }
+            if (0 == count)
+            {
+                break;
+            }
+            for (ssize_t written = 0; written < count;)
+            {
+                const ssize_t result = ::write(target, buffer + written, (std::size_t) (count - written));
+                if (result < 0)
+                {
+                    if (EINTR == errno)
+                    {
+                        continue;
+                    }
+                    error = errno;
+                    break;
+                }
+                written += result;
+            }
+            if (0 != error)
+            {
+                break;
+            }
+            bytes += (pctk_uint64_t) count;
+        }
+        std::free(buffer);
+        return error;
+    }
+
+    static int copyFile(int sourceDirectory, const char *sourceName, int targetDirectory, const char *targetName,
+                        int flags, pctk_uint64_t &bytes, const char *&operation)
+    {
+        operation = "open";
+        const int source = ::openat(sourceDirectory, sourceName, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+        if (source < 0)
+        {
+            return errno;
+        }
+        struct stat status;
+        if (0 != ::fstat(source, &status))
+        {
+            const int error = errno;
+            ::close(source);
+            return error;
+        }
+        const int targetFlags = O_WRONLY | O_CREAT | O_NOFOLLOW | O_CLOEXEC
+                                | ((flags & FileTree::Overwrite) ? O_TRUNC : O_EXCL);
+        int target = ::openat(targetDirectory, targetName, targetFlags, 0600);
+        if (target < 0 && ELOOP == errno && (flags & FileTree::Overwrite))
+        {
+            /* a link in the way, replace it rather than write through it */
+            if (0 == ::unlinkat(targetDirectory, targetName, 0))
+            {
+                target = ::openat(targetDirectory, targetName, targetFlags, 0600);
+            }
+        }
+        if (target < 0)
+        {
+            const int error = errno;
+            ::close(source);
+            return error;
+        }
+        operation = "copy";
+        int error = copyData(source, target, flags, bytes);
+        if (0 == error && 0 != ::fchmod(target, status.st_mode & 07777))
+        {
+            error = errno;
+        }
+        if (0 != ::close(target) && 0 == error)
+        {
+            error = errno;
+        }
+        ::close(source);
+        if (0 != error)
+        {
+            ::unlinkat(targetDirectory, targetName, 0);
+        }
+        return error;
+    }
+
+    static int copyLink(int sourceDirectory, const char *sourceName, int targetDirectory, const char *targetName,
+                        int flags, const char *&operation)
+    {
+        operation = "open";
+        char target[4096];
+        const ssize_t length = ::readlinkat(sourceDirectory, sourceName, target, sizeof(target));
+        if (length < 0)
+        {
+            return errno;
+        }
+        if ((std::size_t) length == sizeof(target))
+        {
+            return ENAMETOOLONG;
+        }
+        target[length] = '\0';
+        operation = "symlink";
+        if (0 == ::symlinkat(target, targetDirectory, targetName))
+        {
+            return 0;
+        }
+        if (EEXIST == errno && (flags & FileTree::Overwrite) && 0 == ::unlinkat(targetDirectory, targetName, 0)
+            && 0 == ::symlinkat(target, targetDirectory, targetName))
+        {
+            return 0;
+        }
+        return errno;
+    }
+
+    Kind kind;
+    int flags;
+    ThreadPool *pool;
+    FileTreeProgress *progress;
+    FileTreeProgress ownProgress;
+    std::size_t maxErrors;
+    pctk_uint64_t startEntries;
+    pctk_uint64_t startBytes;
+    pctk_uint64_t startErrors;
+    /* removeAll() root, removed by path as there is no parent fd for it */
+    std::string rootPath;
+    pctk_uint64_t targetDevice;
+    pctk_uint64_t targetInode;
+    /* tasks submitted to the pool and not finished, finished is set after the last one woke the caller */
+    AtomicInt active;
+    AtomicInt finished;
+    /* directories not listed yet when running in the calling thread */
+    Vector<FileTreeNode *> queue;
+    Mutex errorLock;
+    std::vector<FileTreeError> errors;
+};
+} // namespace detail
+
+FileTreeResult FileTree::removeAll(const std::string &path, const Options &options)
+{
+    detail::FileTreeOperation operation(detail::FileTreeOperation::Remove, options);
+    struct stat status;
+    if (0 != ::lstat(path.c_str(), &status))
+    {
+        if (ENOENT != errno)
+        {
+            operation.fail(std::string(), "open", errno);
+        }
+        return operation.result();
+    }
+    if (!S_ISDIR(status.st_mode))
+    {
+        if (0 == ::unlink(path.c_str()))
+        {
+            operation.count(1, 0);
+        }
+        else
+        {
+            operation.fail(std::string(), "unlink", errno);
+        }
+        return operation.result();
+    }
+    detail::FileTreeNode *root = new detail::FileTreeNode(PCTK_NULLPTR, PCTK_NULLPTR, 0);
+    root->fd = ::open(path.c_str(), detail::FileTreeDirectoryFlags);
+    if (root->fd < 0)
+    {
+        operation.fail(std::string(), "open", errno);
+        delete root;
+        return operation.result();
+    }
+    operation.rootPath = path;
+    operation.start(root);
+    return operation.result();
+}
+
+FileTreeResult FileTree::copyTree(const std::string &source, const std::string &destination, const Options &options)
+{
+    detail::FileTreeOperation operation(detail::FileTreeOperation::Copy, options);
+    struct stat status;
+    if (0 != ::lstat(source.c_str(), &status))
+    {
+        operation.fail(std::string(), "open", errno);
+        return operation.result();
+    }
+    if (!S_ISDIR(status.st_mode))
+    {
+        const char *failed = "copy";
+        pctk_uint64_t bytes = 0;
+        int error = (int) std::errc::not_supported;
+        if (S_ISREG(status.st_mode))
+        {
+            error = detail::FileTreeOperation::copyFile(AT_FDCWD, source.c_str(), AT_FDCWD, destination.c_str(),
+                                                        operation.flags, bytes, failed);
+        }
+        else if (S_ISLNK(status.st_mode))
+        {
+            error = detail::FileTreeOperation::copyLink(AT_FDCWD, source.c_str(), AT_FDCWD, destination.c_str(),
+                                                        operation.flags, failed);
+        }
+        if (0 == error)
+        {
+            operation.count(1, bytes);
+        }
+        else
+        {
+            operation.fail(std::string(), failed, error);
+        }
+        return operation.result();
+    }
+
+    detail::FileTreeNode *root = new detail::FileTreeNode(PCTK_NULLPTR, PCTK_NULLPTR, 0);
+    root->mode = status.st_mode & 07777;
+    root->fd = ::open(source.c_str(), detail::FileTreeDirectoryFlags);
+    if (root->fd < 0)
+    {
+        operation.fail(std::string(), "open", errno);
+        delete root;
+        return operation.result();
+    }
+    const char *failed = PCTK_NULLPTR;
+    if (0 == ::mkdir(destination.c_str(), 0700))
+    {
+        root->created = true;
+    }
+    else if (EEXIST != errno)
+    {
+        failed = "mkdir";
+    }
+    if (!failed)
+    {
+        /* the destination itself may be a link to the directory to copy into */
+        root->targetFd = ::open(destination.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (root->targetFd < 0 || 0 != ::fstat(root->targetFd, &status))
+        {
+            failed = "open";
+        }
+    }
+    if (failed)
+    {
+        operation.fail(std::string(), failed, errno);
+        if (root->targetFd >= 0)
+        {
+            ::close(root->targetFd);
+        }
+        ::close(root->fd);
+        delete root;
+        return operation.result();
+    }
+    operation.targetDevice = (pctk_uint64_t) status.st_dev;
+    operation.targetInode = (pctk_uint64_t) status.st_ino;
+    operation.start(root);
+    return operation.result();
+}
+#else
+static FileTreeResult fileTreeNotSupported()
+{
+    FileTreeResult result;
+    FileTreeError error;
+    error.operation = "open";
+    error.error = std::make_error_code(std::errc::function_not_supported);
+    result.errors.push_back(error);
+    result.errorCount = 1;
+    return result;
+}
+
+FileTreeResult FileTree::removeAll(const std::string &path, const Options &options)
+{
+    PCTK_UNUSED(path);
+    PCTK_UNUSED(options);
+    return fileTreeNotSupported();
+}
+
+FileTreeResult FileTree::copyTree(const std::string &source, const std::string &destination, const Options &options)
+{
+    PCTK_UNUSED(source);
+    PCTK_UNUSED(destination);
+    PCTK_UNUSED(options);
+    return fileTreeNotSupported();
+}
+#endif
+
+PCTK_END_NAMESPACE
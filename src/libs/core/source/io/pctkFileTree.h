@@ -0,0 +1,162 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#ifndef _PCTKFILETREE_H
+#define _PCTKFILETREE_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+
+#include <string>
+#include <vector>
+#include <system_error>
+
+PCTK_BEGIN_NAMESPACE
+
+class ThreadPool;
+
+namespace detail
+{
+struct FileTreeOperation;
+} // namespace detail
+
+/**
+ * @brief Counters of a running FileTree operation. Any thread may read them or call cancel() while it runs.
+ * Workers publish their counts once per directory and every few thousand entries, not once per entry.
+ */
+class PCTK_CORE_API FileTreeProgress
+{
+public:
+    FileTreeProgress() : m_entries(0), m_bytes(0), m_errors(0), m_cancelled(0) {}
+
+    /**
+     * @brief Files, links and directories removed or copied so far.
+     */
+    pctk_uint64_t entries() const PCTK_NOEXCEPT { return m_entries.load(); }
+
+    /**
+     * @brief File contents copied so far, 0 for removals.
+     */
+    pctk_uint64_t bytes() const PCTK_NOEXCEPT { return m_bytes.load(); }
+
+    pctk_uint64_t errors() const PCTK_NOEXCEPT { return m_errors.load(); }
+
+    /**
+     * @brief Asks the operation to stop. Directories are not listed any further and the ones already entered are
+     * left in place, whatever was removed or copied stays so.
+     */
+    void cancel() PCTK_NOEXCEPT { m_cancelled.storeRelease(1); }
+    bool isCancelled() const PCTK_NOEXCEPT { return 0 != m_cancelled.loadAcquire(); }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(FileTreeProgress)
+
+    friend struct detail::FileTreeOperation;
+
+    AtomicInteger<pctk_uint64_t> m_entries;
+    AtomicInteger<pctk_uint64_t> m_bytes;
+    AtomicInteger<pctk_uint64_t> m_errors;
+    AtomicInt m_cancelled;
+};
+
+struct FileTreeError
+{
+    /* path relative to the root of the operation, empty for the root itself */
+    std::string path;
+    /* the call that failed: "open", "read", "unlink", "rmdir", "mkdir", "copy" or "symlink" */
+    const char *operation;
+    std::error_code error;
+};
+
+struct FileTreeResult
+{
+    FileTreeResult() : entries(0), bytes(0), errorCount(0), cancelled(false) {}
+
+    bool ok() const PCTK_NOEXCEPT { return 0 == errorCount && !cancelled; }
+
+    pctk_uint64_t entries;
+    pctk_uint64_t bytes;
+    /* every error, errors holds the first Options::maxErrors of them */
+    pctk_uint64_t errorCount;
+    bool cancelled;
+    std::vector<FileTreeError> errors;
+};
+
+/**
+ * @brief Recursive removal and copy of directory trees, fanned out over a ThreadPool one directory per task.
+ * Every directory is opened with openat() relative to its parent and listed with a DirectoryIterator on that fd,
+ * entries are removed with unlinkat() and created with mkdirat()/openat() relative to the directory fds, so no
+ * path is built and resolved per entry. Symbolic links are never followed, they are removed or copied as links.
+ *
+ * Errors do not abort the operation, they are collected into the result and the rest of the tree is processed.
+ * A directory whose contents could not all be removed is kept. Nothing throws except std::bad_alloc.
+ */
+class PCTK_CORE_API FileTree
+{
+public:
+    enum Option
+    {
+        NoOption = 0x0,
+        /* process the tree in the calling thread */
+        SingleThreaded = 0x1,
+        /* copyTree() replaces files and links that exist in the destination instead of reporting EEXIST */
+        Overwrite = 0x2,
+        /* copyTree() always copies file contents, never shares extents with the source through a reflink */
+        NoReflink = 0x4
+    };
+
+    struct Options
+    {
+        Options() : flags(NoOption), pool(PCTK_NULLPTR), progress(PCTK_NULLPTR), maxErrors(1024) {}
+
+        int flags;
+        /* pool the directories fan out over, PCTK_NULLPTR for ThreadPool::globalInstance(). Called from one of the
+         * pool's own workers the operation runs in that worker, as with SingleThreaded. */
+        ThreadPool *pool;
+        /* optional counters to watch or cancel the operation from another thread */
+        FileTreeProgress *progress;
+        /* errors kept in FileTreeResult::errors, later ones are only counted */
+        std::size_t maxErrors;
+    };
+
+    /**
+     * @brief Removes path and, if it is a directory, everything below it. A path that does not exist is not an
+     * error. Directories are removed bottom up as soon as their last child is gone.
+     */
+    static FileTreeResult removeAll(const std::string &path, const Options &options = Options());
+
+    /**
+     * @brief Copies the file, link or directory tree at source to destination, permissions are kept. Existing
+     * destination directories are merged into. On Linux files are cloned with a reflink where the filesystem
+     * supports it and copied in the kernel with copy_file_range() otherwise, read()/write() is the fallback.
+     */
+    static FileTreeResult copyTree(const std::string &source, const std::string &destination,
+                                   const Options &options = Options());
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKFILETREE_H
@@ -0,0 +1,347 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include <pctkMappedFile.h>
+#include <pctkPlatformDefs.h>
+
+#include <cerrno>
+#include <limits>
+#include <system_error>
+#include <utility>
+
+#if defined(PCTK_OS_UNIX)
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* PMD size with 4 KiB pages on x86-64 and arm64 */
+static const std::size_t MappedFileHugePageSize = 2 * 1024 * 1024;
+
+static void throwMappedFileError(int error, const std::string &what)
+{
+    throw std::system_error(error, std::generic_category(), what);
+}
+
+#if defined(PCTK_OS_UNIX)
+/* outside the class, where PCTK_OPEN may expand to a bare open() that would otherwise find MappedFile::open() */
+static int openFile(const std::string &path, int flags) PCTK_NOEXCEPT
+{
+    return PCTK_OPEN(path.c_str(), flags, 0666);
+}
+
+static std::size_t pageSize() PCTK_NOEXCEPT
+{
+    static const long size = ::sysconf(_SC_PAGESIZE);
+    return size > 0 ? (std::size_t) size : 4096;
+}
+
+#   if defined(PCTK_OS_LINUX)
+/* Reserves room for the alignment with an inaccessible anonymous mapping, places the file mapping over its aligned
+ * part and hands the slack on either side back. */
+static void *mapAligned(std::size_t size, int protection, int flags, int fd) PCTK_NOEXCEPT
+{
+    const std::size_t reserved = size + MappedFileHugePageSize;
+    char *reservation = static_cast<char *>(
+        ::mmap(PCTK_NULLPTR, reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+    if (MAP_FAILED == (void *) reservation)
+    {
+        return MAP_FAILED;
+    }
+    char *aligned = reinterpret_cast<char *>(((pctk_uintptr_t) reservation + MappedFileHugePageSize - 1)
+                                             & ~(pctk_uintptr_t) (MappedFileHugePageSize - 1));
+    void *address = PCTK_MMAP(aligned, size, protection, flags | MAP_FIXED, fd, 0);
+    if (MAP_FAILED == address)
+    {
+        ::munmap(reservation, reserved);
+        return MAP_FAILED;
+    }
+    if (aligned > reservation)
+    {
+        ::munmap(reservation, (std::size_t) (aligned - reservation));
+    }
+    char *mappedEnd = aligned + ((size + pageSize() - 1) & ~(pageSize() - 1));
+    if (mappedEnd < reservation + reserved)
+    {
+        ::munmap(mappedEnd, (std::size_t) (reservation + reserved - mappedEnd));
+    }
+    return address;
+}
+#   endif
+
+static int nativeAdvice(MappedFile::Advice advice) PCTK_NOEXCEPT
+{
+    switch (advice)
+    {
+        case MappedFile::Sequential:
+            return MADV_SEQUENTIAL;
+        case MappedFile::Random:
+            return MADV_RANDOM;
+        case MappedFile::WillNeed:
+            return MADV_WILLNEED;
+        case MappedFile::DontNeed:
+            return MADV_DONTNEED;
+        default:
+            return MADV_NORMAL;
+    }
+}
+#endif
+} // namespace detail
+
+MappedFile::MappedFile() PCTK_NOEXCEPT : m_data(PCTK_NULLPTR), m_size(0), m_fd(-1), m_mode(ReadOnly), m_options(0)
+{
+}
+
+MappedFile::MappedFile(const std::string &path, Mode mode, int options)
+    : m_data(PCTK_NULLPTR), m_size(0), m_fd(-1), m_mode(ReadOnly), m_options(0)
+{
+    this->open(path, mode, options);
+}
+
+MappedFile::MappedFile(MappedFile &&other) PCTK_NOEXCEPT
+    : m_data(other.m_data), m_size(other.m_size), m_fd(other.m_fd), m_mode(other.m_mode), m_options(other.m_options)
+{
+    other.m_data = PCTK_NULLPTR;
+    other.m_size = 0;
+    other.m_fd = -1;
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) PCTK_NOEXCEPT
+{
+    if (this != &other)
+    {
+        this->close();
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_fd, other.m_fd);
+        std::swap(m_mode, other.m_mode);
+        std::swap(m_options, other.m_options);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    this->close();
+}
+
+void MappedFile::open(const std::string &path, Mode mode, int options)
+{
+    this->close();
+#if defined(PCTK_OS_UNIX)
+    int flags = O_CLOEXEC | (ReadWrite == mode ? O_RDWR : O_RDONLY);
+    if (ReadWrite == mode)
+    {
+        flags |= (options & Create ? O_CREAT : 0) | (options & Truncate ? O_TRUNC : 0);
+    }
+    const int fd = detail::openFile(path, flags);
+    if (fd < 0)
+    {
+        detail::throwMappedFileError(errno, "MappedFile: cannot open " + path);
+    }
+    PCTK_STATBUF status;
+    int error = 0 == PCTK_FSTAT(fd, &status) ? 0 : errno;
+    if (0 == error && !S_ISREG(status.st_mode))
+    {
+        error = (int) std::errc::invalid_argument;
+    }
+    if (0 == error && (pctk_uint64_t) status.st_size > (pctk_uint64_t) std::numeric_limits<std::size_t>::max())
+    {
+        error = (int) std::errc::file_too_large;
+    }
+    if (0 != error)
+    {
+        ::close(fd);
+        detail::throwMappedFileError(error, "MappedFile: cannot map " + path);
+    }
+    m_fd = fd;
+    m_mode = mode;
+    m_options = options;
+    try
+    {
+        this->map((std::size_t) status.st_size);
+    }
+    catch (...)
+    {
+        this->close();
+        throw;
+    }
+#else
+    PCTK_UNUSED(mode);
+    PCTK_UNUSED(options);
+    detail::throwMappedFileError((int) std::errc::function_not_supported, "MappedFile: " + path);
+#endif
+}
+
+void MappedFile::close() PCTK_NOEXCEPT
+{
+    this->unmap();
+#if defined(PCTK_OS_UNIX)
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+    }
+#endif
+    m_fd = -1;
+}
+
+bool MappedFile::advise(Advice advice, std::size_t offset, std::size_t length) PCTK_NOEXCEPT
+{
+#if defined(PCTK_OS_UNIX)
+    if (!m_data || offset >= m_size)
+    {
+        return false;
+    }
+    const std::size_t begin = offset & ~(detail::pageSize() - 1);
+    const std::size_t end = length >= m_size - offset ? m_size : offset + length;
+    return 0 == ::madvise(m_data + begin, end - begin, detail::nativeAdvice(advice));
+#else
+    PCTK_UNUSED(advice);
+    PCTK_UNUSED(offset);
+    PCTK_UNUSED(length);
+    return false;
+#endif
+}
+
+void MappedFile::resize(std::size_t size)
+{
+    if (ReadWrite != m_mode || m_fd < 0)
+    {
+        detail::throwMappedFileError(EBADF, "MappedFile: resize needs a file mapped ReadWrite");
+    }
+#if defined(PCTK_OS_UNIX)
+    if (size > m_size && 0 != PCTK_FTRUNCATE(m_fd, (PCTK_OFF_T) size))
+    {
+        detail::throwMappedFileError(errno, "MappedFile: cannot grow the file");
+    }
+    if (size != m_size)
+    {
+#   if defined(PCTK_OS_LINUX)
+        if (m_data && size > 0)
+        {
+            void *address = ::mremap(m_data, m_size, size, MREMAP_MAYMOVE);
+            if (MAP_FAILED == address)
+            {
+                detail::throwMappedFileError(errno, "MappedFile: cannot remap");
+            }
+            m_data = static_cast<char *>(address);
+            m_size = size;
+            if ((m_options & HugePages) && size >= detail::MappedFileHugePageSize)
+            {
+                ::madvise(m_data, m_size, MADV_HUGEPAGE);
+            }
+        }
+        else
+#   endif
+        {
+            this->unmap();
+            this->map(size);
+        }
+    }
+    /* shrink the file only once nothing maps the cut off part, touching it would raise SIGBUS */
+    if (0 != PCTK_FTRUNCATE(m_fd, (PCTK_OFF_T) size))
+    {
+        detail::throwMappedFileError(errno, "MappedFile: cannot shrink the file");
+    }
+#endif
+}
+
+void MappedFile::sync(bool async)
+{
+    if (ReadWrite != m_mode || m_fd < 0)
+    {
+        detail::throwMappedFileError(EBADF, "MappedFile: sync needs a file mapped ReadWrite");
+    }
+#if defined(PCTK_OS_UNIX)
+    if (m_data && 0 != ::msync(m_data, m_size, async ? MS_ASYNC : MS_SYNC))
+    {
+        detail::throwMappedFileError(errno, "MappedFile: msync");
+    }
+#else
+    PCTK_UNUSED(async);
+#endif
+}
+
+void MappedFile::map(std::size_t size)
+{
+#if defined(PCTK_OS_UNIX)
+    if (0 == size)
+    {
+        /* mmap() refuses empty mappings, an empty file maps to nothing */
+        return;
+    }
+    const int protection = PROT_READ | (ReadWrite == m_mode ? PROT_WRITE : 0);
+    int flags = MAP_SHARED;
+#   if defined(PCTK_OS_LINUX)
+    if (m_options & Populate)
+    {
+        flags |= MAP_POPULATE;
+    }
+    const bool huge = (m_options & HugePages) && size >= detail::MappedFileHugePageSize;
+    void *address = huge ? detail::mapAligned(size, protection, flags, m_fd) : MAP_FAILED;
+#   else
+    void *address = MAP_FAILED;
+#   endif
+    if (MAP_FAILED == address)
+    {
+        address = PCTK_MMAP(PCTK_NULLPTR, size, protection, flags, m_fd, 0);
+    }
+    if (MAP_FAILED == address)
+    {
+        detail::throwMappedFileError(errno, "MappedFile: mmap");
+    }
+    m_data = static_cast<char *>(address);
+    m_size = size;
+#   if defined(PCTK_OS_LINUX)
+    if (huge)
+    {
+        /* a hint, refused where the kernel has no huge pages for this kind of mapping */
+        ::madvise(m_data, m_size, MADV_HUGEPAGE);
+    }
+#   endif
+#else
+    PCTK_UNUSED(size);
+#endif
+}
+
+void MappedFile::unmap() PCTK_NOEXCEPT
+{
+#if defined(PCTK_OS_UNIX)
+    if (m_data)
+    {
+        ::munmap(m_data, m_size);
+    }
+#endif
+    m_data = PCTK_NULLPTR;
+    m_size = 0;
+}
+
+PCTK_END_NAMESPACE
@@ -0,0 +1,143 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#ifndef _PCTKMAPPEDFILE_H
+#define _PCTKMAPPEDFILE_H
+
+#include <pctkGlobal.h>
+#include <pctkSpan.h>
+
+#include <string>
+
+PCTK_BEGIN_NAMESPACE
+
+/**
+ * @brief A file mapped into memory, its contents are read and written in place without copies through read() or
+ * fread() buffers and paged in lazily on first access. ReadWrite mappings are shared, stores reach the file.
+ * Errors throw std::system_error. Pointers and views into the mapping are invalidated by resize() and close().
+ *
+ * Reading past the end of a file another process has truncated raises SIGBUS, as with any mapping.
+ */
+class PCTK_CORE_API MappedFile
+{
+public:
+    enum Mode
+    {
+        ReadOnly,
+        ReadWrite
+    };
+
+    enum Option
+    {
+        NoOption = 0x0,
+        /* ReadWrite: create the file if it does not exist */
+        Create = 0x1,
+        /* ReadWrite: truncate the file to 0 bytes when it is opened */
+        Truncate = 0x2,
+        /* fault every page in when mapping, instead of on first access (Linux) */
+        Populate = 0x4,
+        /* align mappings of 2 MiB and more to 2 MiB and ask for transparent huge pages, so the page cache may back
+         * them with huge pages where the filesystem supports it (Linux, a hint) */
+        HugePages = 0x8
+    };
+
+    enum Advice
+    {
+        Normal,
+        /* read ahead aggressively and drop pages soon after they were accessed */
+        Sequential,
+        /* no read ahead */
+        Random,
+        /* start reading the range in now */
+        WillNeed,
+        /* the range is not needed soon, its pages may be dropped */
+        DontNeed
+    };
+
+    MappedFile() PCTK_NOEXCEPT;
+    explicit MappedFile(const std::string &path, Mode mode = ReadOnly, int options = NoOption);
+    MappedFile(MappedFile &&other) PCTK_NOEXCEPT;
+    MappedFile &operator=(MappedFile &&other) PCTK_NOEXCEPT;
+    ~MappedFile();
+
+    /**
+     * @brief Maps path, closing whatever was mapped before. An empty file is open with a null data().
+     */
+    void open(const std::string &path, Mode mode = ReadOnly, int options = NoOption);
+    void close() PCTK_NOEXCEPT;
+
+    bool isOpen() const PCTK_NOEXCEPT { return m_fd >= 0; }
+    Mode mode() const PCTK_NOEXCEPT { return m_mode; }
+
+    const char *data() const PCTK_NOEXCEPT { return m_data; }
+
+    /**
+     * @brief The mapping for writing, PCTK_NULLPTR unless the file is mapped ReadWrite.
+     */
+    char *writableData() const PCTK_NOEXCEPT { return ReadWrite == m_mode ? m_data : PCTK_NULLPTR; }
+
+    std::size_t size() const PCTK_NOEXCEPT { return m_size; }
+
+    Span<const char> view() const PCTK_NOEXCEPT { return Span<const char>(m_data, m_size); }
+    Span<char> writableView() const PCTK_NOEXCEPT
+    {
+        return Span<char>(this->writableData(), ReadWrite == m_mode ? m_size : 0);
+    }
+
+    /**
+     * @brief Tells the kernel how the bytes [offset, offset + length) will be accessed, the range is widened to whole
+     * pages. The default length runs to the end of the file. Returns false if the hint was refused, never throws.
+     */
+    bool advise(Advice advice, std::size_t offset = 0, std::size_t length = ~std::size_t(0)) PCTK_NOEXCEPT;
+
+    /**
+     * @brief Sets the file size with ftruncate() and grows or shrinks the mapping to match, with mremap() on Linux, so
+     * the pages already mapped stay in place. The mapping may move, data() is to be read again afterwards.
+     * ReadWrite only.
+     */
+    void resize(std::size_t size);
+
+    /**
+     * @brief Writes modified pages back to the file, waiting for the writes unless async is set. ReadWrite only.
+     */
+    void sync(bool async = false);
+
+private:
+    PCTK_DISABLE_COPY(MappedFile)
+
+    void map(std::size_t size);
+    void unmap() PCTK_NOEXCEPT;
+
+    char *m_data;
+    std::size_t m_size;
+    int m_fd;
+    Mode m_mode;
+    int m_options;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKMAPPEDFILE_H
@@ -0,0 +1,693 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include <pctkStatCache.h>
+#include <pctkPlatformDefs.h>
+#include <pctkSteadyClock.h>
+#include <pctkThreadPool.h>
+#include <pctkVector.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#if defined(PCTK_OS_UNIX)
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+#if defined(PCTK_OS_WIN)
+#   ifndef WIN32_LEAN_AND_MEAN
+#       define WIN32_LEAN_AND_MEAN
+#   endif
+#   include <windows.h>
+#endif
+#if defined(PCTK_OS_LINUX)
+#   include <sys/inotify.h>
+#   include <sys/syscall.h>
+#   include <sys/sysmacros.h>
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* misses queried by one statMany() task, and the least number of misses worth fanning out */
+static const std::size_t StatCacheBatchSize = 32;
+static const std::size_t StatCacheParallelThreshold = 2 * StatCacheBatchSize;
+
+#if defined(PCTK_OS_LINUX) && defined(SYS_statx)
+/* The kernel's struct statx, glibc only declares it from 2.28 on. */
+struct LinuxStatxTimestamp
+{
+    pctk_int64_t tv_sec;
+    pctk_uint32_t tv_nsec;
+    pctk_int32_t reserved;
+};
+
+struct LinuxStatx
+{
+    pctk_uint32_t stx_mask;
+    pctk_uint32_t stx_blksize;
+    pctk_uint64_t stx_attributes;
+    pctk_uint32_t stx_nlink;
+    pctk_uint32_t stx_uid;
+    pctk_uint32_t stx_gid;
+    pctk_uint16_t stx_mode;
+    pctk_uint16_t spare0;
+    pctk_uint64_t stx_ino;
+    pctk_uint64_t stx_size;
+    pctk_uint64_t stx_blocks;
+    pctk_uint64_t stx_attributes_mask;
+    LinuxStatxTimestamp stx_atime;
+    LinuxStatxTimestamp stx_btime;
+    LinuxStatxTimestamp stx_ctime;
+    LinuxStatxTimestamp stx_mtime;
+    pctk_uint32_t stx_rdev_major;
+    pctk_uint32_t stx_rdev_minor;
+    pctk_uint32_t stx_dev_major;
+    pctk_uint32_t stx_dev_minor;
+    pctk_uint64_t spare2[14];
+};
+
+/* STATX_TYPE | STATX_MODE | STATX_MTIME | STATX_INO | STATX_SIZE */
+static const unsigned int StatxMask = 0x1 | 0x2 | 0x40 | 0x100 | 0x200;
+
+/* cleared once the kernel turns out to predate statx() */
+static AtomicInt statxAvailable(1);
+#endif
+
+#if defined(PCTK_OS_UNIX)
+static FileStatus::Type modeType(unsigned int mode) PCTK_NOEXCEPT
+{
+    if (S_ISREG(mode))
+    {
+        return FileStatus::File;
+    }
+    return S_ISDIR(mode) ? FileStatus::Directory : FileStatus::Other;
+}
+#endif
+
+#if defined(PCTK_OS_WIN)
+/* Every way GetFileAttributesExW() reports a path that is not there. */
+static bool notFound(DWORD error) PCTK_NOEXCEPT
+{
+    return ERROR_FILE_NOT_FOUND == error || ERROR_PATH_NOT_FOUND == error
+           || ERROR_INVALID_NAME == error      // "//foo"
+           || ERROR_INVALID_DRIVE == error     // USB card reader with no card inserted
+           || ERROR_NOT_READY == error         // CD/DVD drive with no disc inserted
+           || ERROR_INVALID_PARAMETER == error // ":sys:stat.h"
+           || ERROR_BAD_PATHNAME == error      // "//nosuch" on Win64
+           || ERROR_BAD_NETPATH == error;      // "//nosuch" on Win32
+}
+
+/* The UTF-8 path as the wide string the W functions take, the Win32 error on failure. */
+static DWORD widePath(const std::string &path, std::wstring &wide) PCTK_NOEXCEPT
+{
+    if (path.empty())
+    {
+        return ERROR_PATH_NOT_FOUND;
+    }
+    const int length = ::MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, path.data(), (int) path.size(),
+                                             PCTK_NULLPTR, 0);
+    if (length <= 0)
+    {
+        return ::GetLastError();
+    }
+    try
+    {
+        wide.resize((std::size_t) length);
+    }
+    catch (...)
+    {
+        return ERROR_NOT_ENOUGH_MEMORY;
+    }
+    ::MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, path.data(), (int) path.size(), &wide[0], length);
+    return ERROR_SUCCESS;
+}
+#else
+static bool notFound(int error) PCTK_NOEXCEPT
+{
+#if defined(PCTK_OS_UNIX)
+    return ENOENT == error || ENOTDIR == error;
+#else
+    return ENOENT == error;
+#endif
+}
+#endif
+
+#if defined(PCTK_OS_LINUX)
+/* Splits path into the directory spelling inotify watches and checks that "<directory>/<name>" gives the spelling
+ * back, false for paths an event could not be mapped back to, such as "a//b", "a/." or "a/". A path without a
+ * directory part has the empty spelling, watched as ".". */
+static bool watchedDirectory(const std::string &path, std::string &directory)
+{
+    const std::string::size_type slash = path.rfind('/');
+    const char *name = path.c_str() + (std::string::npos == slash ? 0 : slash + 1);
+    if ('\0' == name[0] || 0 == std::strcmp(name, ".") || 0 == std::strcmp(name, ".."))
+    {
+        return false;
+    }
+    if (std::string::npos == slash)
+    {
+        directory.clear();
+        return true;
+    }
+    if (slash > 0 && '/' == path[slash - 1])
+    {
+        return false;
+    }
+    directory.assign(path, 0, 0 == slash ? 1 : slash);
+    return true;
+}
+
+static std::string watchedPath(const std::string &directory, const char *name)
+{
+    if (directory.empty())
+    {
+        return name;
+    }
+    std::string path(directory);
+    if ('/' != path[path.size() - 1])
+    {
+        path += '/';
+    }
+    path += name;
+    return path;
+}
+#endif
+
+/* Waits for the tasks of one statMany() call, the caller's stack outlives the last task's notify. */
+struct StatBatch
+{
+    StatBatch() : pending(0), finished(0) {}
+
+    void done() PCTK_NOEXCEPT
+    {
+        if (1 == pending.fetchAndSubOrdered(1))
+        {
+            pending.notifyAll();
+            finished.storeRelease(1);
+        }
+    }
+
+    void wait() PCTK_NOEXCEPT
+    {
+        for (int value = pending.loadAcquire(); 0 != value; value = pending.loadAcquire())
+        {
+            pending.wait(value);
+        }
+        while (0 == finished.loadAcquire())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    AtomicInt pending;
+    AtomicInt finished;
+};
+
+/* Ends a miss counted in StatCache::m_querying, on every way out. */
+struct StatCacheQuery
+{
+    explicit StatCacheQuery(AtomicInt &querying) : querying(querying) {}
+    ~StatCacheQuery() { querying.fetchAndSubRelease(1); }
+
+    AtomicInt &querying;
+};
+} // namespace detail
+
+FileStatus FileStatus::query(const std::string &path) PCTK_NOEXCEPT
+{
+    FileStatus status;
+#if defined(PCTK_OS_WIN)
+    std::wstring wide;
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    DWORD error = detail::widePath(path, wide);
+    if (ERROR_SUCCESS == error && !::GetFileAttributesExW(wide.c_str(), GetFileExInfoStandard, &data))
+    {
+        error = ::GetLastError();
+    }
+    if (ERROR_SUCCESS != error)
+    {
+        status.m_error = detail::notFound(error) ? 0 : (int) error;
+        return status;
+    }
+    if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+    {
+        status.m_type = Directory;
+    }
+    else
+    {
+        status.m_type = (data.dwFileAttributes & FILE_ATTRIBUTE_DEVICE) ? Other : File;
+    }
+    status.m_size = ((pctk_uint64_t) data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    /* FILETIME counts 100 nanoseconds from 1601 */
+    const pctk_int64_t ticks = (pctk_int64_t) (((pctk_uint64_t) data.ftLastWriteTime.dwHighDateTime << 32)
+                                               | data.ftLastWriteTime.dwLowDateTime);
+    status.m_modificationTime = (ticks - 116444736000000000LL) * 100;
+    /* what the CRT's stat() makes of the attributes */
+    status.m_permissions = (data.dwFileAttributes & FILE_ATTRIBUTE_READONLY) ? 0444 : 0666;
+    if (Directory == status.m_type)
+    {
+        status.m_permissions |= 0111;
+    }
+    return status;
+#else
+#if defined(PCTK_OS_LINUX) && defined(SYS_statx)
+    if (detail::statxAvailable.load())
+    {
+        detail::LinuxStatx buffer;
+        if (0 == ::syscall(SYS_statx, AT_FDCWD, path.c_str(), 0, detail::StatxMask, &buffer))
+        {
+            status.m_type = detail::modeType(buffer.stx_mode);
+            status.m_size = buffer.stx_size;
+            status.m_modificationTime = buffer.stx_mtime.tv_sec * 1000000000 + buffer.stx_mtime.tv_nsec;
+            status.m_device = (pctk_uint64_t) makedev(buffer.stx_dev_major, buffer.stx_dev_minor);
+            status.m_inode = buffer.stx_ino;
+            status.m_permissions = buffer.stx_mode & 07777;
+            return status;
+        }
+        if (ENOSYS != errno)
+        {
+            status.m_error = detail::notFound(errno) ? 0 : errno;
+            return status;
+        }
+        detail::statxAvailable.store(0);
+    }
+#endif
+    PCTK_STATBUF buffer;
+    if (0 != PCTK_STAT(path.c_str(), &buffer))
+    {
+        status.m_error = detail::notFound(errno) ? 0 : errno;
+        return status;
+    }
+#if defined(PCTK_OS_UNIX)
+    status.m_type = detail::modeType(buffer.st_mode);
+#else
+    status.m_type = (buffer.st_mode & S_IFDIR) ? Directory : ((buffer.st_mode & S_IFREG) ? File : Other);
+#endif
+    status.m_size = (pctk_uint64_t) buffer.st_size;
+#if defined(PCTK_OS_LINUX)
+    status.m_modificationTime = (pctk_int64_t) buffer.st_mtim.tv_sec * 1000000000 + buffer.st_mtim.tv_nsec;
+#else
+    status.m_modificationTime = (pctk_int64_t) buffer.st_mtime * 1000000000;
+#endif
+    status.m_device = (pctk_uint64_t) buffer.st_dev;
+    status.m_inode = (pctk_uint64_t) buffer.st_ino;
+    status.m_permissions = buffer.st_mode & 07777;
+    return status;
+#endif
+}
+
+StatCache::StatCache(const Options &options)
+    : m_options(options), m_notifyFd(-1), m_lastChangesRead(0), m_generation(0), m_clearedGeneration(0),
+      m_querying(0)
+{
+#if defined(PCTK_OS_LINUX)
+    if (options.watch)
+    {
+        /* without inotify the cache still works on the time to live */
+        m_notifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    }
+#endif
+}
+
+StatCache::~StatCache()
+{
+#if defined(PCTK_OS_UNIX)
+    if (m_notifyFd >= 0)
+    {
+        /* drops every watch */
+        ::close(m_notifyFd);
+    }
+#endif
+}
+
+FileStatus StatCache::status(const std::string &path)
+{
+    if (m_notifyFd >= 0)
+    {
+        this->pollChanges();
+    }
+    const pctk_int64_t now = m_options.timeToLiveNSecs > 0 ? SteadyClock::coarseNow().time_since_epoch().count() : 0;
+    FileStatus status;
+    pctk_uint64_t generation;
+    {
+        ReadLocker lock(m_lock);
+        if (this->lookup(path, now, status))
+        {
+            ++m_hits;
+            return status;
+        }
+        /* counted under the lock, an invalidation either precedes the generation or sees the miss in flight */
+        generation = m_generation;
+        m_querying.fetchAndAddRelaxed(1);
+    }
+    detail::StatCacheQuery query(m_querying);
+    ++m_misses;
+
+    /* the watch must be in place before the query, a change in between would go unnoticed otherwise */
+    const bool watched = m_notifyFd >= 0 && this->watch(path);
+    status = FileStatus::query(path);
+    if (this->cacheable(status, watched))
+    {
+        WriteLocker lock(m_lock);
+        if (this->current(path, generation))
+        {
+            this->insert(path, status, this->expiry());
+        }
+    }
+    return status;
+}
+
+std::vector<FileStatus> StatCache::statMany(const std::vector<std::string> &paths)
+{
+    if (m_notifyFd >= 0)
+    {
+        this->pollChanges();
+    }
+    const pctk_int64_t now = m_options.timeToLiveNSecs > 0 ? SteadyClock::coarseNow().time_since_epoch().count() : 0;
+    std::vector<FileStatus> result(paths.size());
+    Vector<std::size_t> missing;
+    pctk_uint64_t generation = 0;
+    {
+        ReadLocker lock(m_lock);
+        for (std::size_t i = 0; i < paths.size(); ++i)
+        {
+            if (!this->lookup(paths[i], now, result[i]))
+            {
+                missing.push_back(i);
+            }
+        }
+        if (!missing.empty())
+        {
+            generation = m_generation;
+            m_querying.fetchAndAddRelaxed(1);
+        }
+    }
+    m_hits += (pctk_int64_t) (paths.size() - missing.size());
+    if (missing.empty())
+    {
+        return result;
+    }
+    detail::StatCacheQuery query(m_querying);
+    m_misses += (pctk_int64_t) missing.size();
+
+    Vector<char> watched;
+    watched.resize(missing.size());
+    for (std::size_t i = 0; i < missing.size(); ++i)
+    {
+        watched[i] = m_notifyFd >= 0 && this->watch(paths[missing[i]]);
+    }
+
+    ThreadPool *pool = PCTK_NULLPTR;
+    if (missing.size() >= detail::StatCacheParallelThreshold)
+    {
+        pool = m_options.pool ? m_options.pool : ThreadPool::globalInstance();
+        if (pool->isWorkerThread() || pool->threadCount() < 2)
+        {
+            pool = PCTK_NULLPTR;
+        }
+    }
+    if (pool)
+    {
+        detail::StatBatch batch;
+        const std::size_t batches = (missing.size() + detail::StatCacheBatchSize - 1) / detail::StatCacheBatchSize;
+        batch.pending.store((int) batches);
+        for (std::size_t first = 0; first < missing.size(); first += detail::StatCacheBatchSize)
+        {
+            const std::size_t last = std::min(first + detail::StatCacheBatchSize, missing.size());
+            pool->submit([&, first, last]() {
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    result[missing[i]] = FileStatus::query(paths[missing[i]]);
+                }
+                batch.done();
+            });
+        }
+        batch.wait();
+    }
+    else
+    {
+        for (std::size_t i = 0; i < missing.size(); ++i)
+        {
+            result[missing[i]] = FileStatus::query(paths[missing[i]]);
+        }
+    }
+
+    const pctk_int64_t expires = this->expiry();
+    WriteLocker lock(m_lock);
+    if (m_entries.size() + missing.size() <= m_options.capacity)
+    {
+        m_entries.reserve(m_entries.size() + missing.size());
+    }
+    for (std::size_t i = 0; i < missing.size(); ++i)
+    {
+        const FileStatus &status = result[missing[i]];
+        if (this->cacheable(status, 0 != watched[i]) && this->current(paths[missing[i]], generation))
+        {
+            this->insert(paths[missing[i]], status, expires);
+        }
+    }
+    return result;
+}
+
+void StatCache::invalidate(const std::string &path)
+{
+    WriteLocker lock(m_lock);
+    ++m_generation;
+    this->invalidateLocked(path);
+}
+
+void StatCache::clear()
+{
+    WriteLocker lock(m_lock);
+    ++m_generation;
+    this->clearLocked();
+}
+
+std::size_t StatCache::size() const
+{
+    ReadLocker lock(m_lock);
+    return m_entries.size();
+}
+
+pctk_int64_t StatCache::expiry() const PCTK_NOEXCEPT
+{
+    if (m_options.timeToLiveNSecs <= 0)
+    {
+        return std::numeric_limits<pctk_int64_t>::max();
+    }
+    return SteadyClock::coarseNow().time_since_epoch().count() + m_options.timeToLiveNSecs;
+}
+
+bool StatCache::lookup(const std::string &path, pctk_int64_t now, FileStatus &status) const
+{
+    HashMap<std::string, detail::StatCacheEntry>::const_iterator iter = m_entries.find(path);
+    if (iter == m_entries.end() || now >= iter->second.expires)
+    {
+        return false;
+    }
+    status = iter->second.status;
+    return true;
+}
+
+bool StatCache::cacheable(const FileStatus &status, bool watched) const PCTK_NOEXCEPT
+{
+    if (status.error())
+    {
+        return false;
+    }
+    /* in watch mode without a time to live an entry nothing can invalidate would be kept forever */
+    return !(m_notifyFd >= 0 && !watched && m_options.timeToLiveNSecs <= 0);
+}
+
+void StatCache::insert(const std::string &path, const FileStatus &status, pctk_int64_t expires)
+{
+    if (m_entries.size() >= m_options.capacity && !m_entries.contains(path))
+    {
+        m_entries.clear();
+    }
+    detail::StatCacheEntry entry;
+    entry.status = status;
+    entry.expires = expires;
+    m_entries.insert_or_assign(path, entry);
+}
+
+bool StatCache::current(const std::string &path, pctk_uint64_t generation) const
+{
+    if (generation < m_clearedGeneration)
+    {
+        return false;
+    }
+    HashMap<std::string, pctk_uint64_t>::const_iterator iter = m_invalidated.find(path);
+    return iter == m_invalidated.end() || iter->second <= generation;
+}
+
+void StatCache::invalidateLocked(const std::string &path)
+{
+    m_entries.erase(path);
+    if (0 == m_querying.loadAcquire())
+    {
+        /* nothing looked up before this generation is left to check against it */
+        m_invalidated.clear();
+    }
+    else if (m_invalidated.size() >= m_options.capacity)
+    {
+        m_invalidated.clear();
+        m_clearedGeneration = m_generation;
+    }
+    else
+    {
+        m_invalidated.insert_or_assign(path, m_generation);
+    }
+}
+
+void StatCache::clearLocked()
+{
+    m_entries.clear();
+    m_invalidated.clear();
+    m_clearedGeneration = m_generation;
+}
+
+bool StatCache::watch(const std::string &path)
+{
+#if defined(PCTK_OS_LINUX)
+    std::string directory;
+    if (!detail::watchedDirectory(path, directory))
+    {
+        return false;
+    }
+    {
+        ReadLocker lock(m_lock);
+        if (m_watches.contains(directory))
+        {
+            return true;
+        }
+    }
+    const pctk_uint32_t events = IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO
+                                 | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+    /* two spellings of one directory share the watch descriptor */
+    const int wd = ::inotify_add_watch(m_notifyFd, directory.empty() ? "." : directory.c_str(), events);
+    if (wd < 0)
+    {
+        /* the directory does not exist, or the watch limit is reached */
+        return false;
+    }
+    WriteLocker lock(m_lock);
+    if (m_watches.try_emplace(directory, wd).second)
+    {
+        m_watchedDirectories[wd].push_back(directory);
+    }
+    return true;
+#else
+    PCTK_UNUSED(path);
+    return false;
+#endif
+}
+
+void StatCache::pollChanges()
+{
+    if (m_options.changeLatencyNSecs > 0)
+    {
+        /* one caller per interval reads, the others are served what the cache holds */
+        const pctk_int64_t now = SteadyClock::coarseNow().time_since_epoch().count();
+        const pctk_int64_t last = m_lastChangesRead.load();
+        if (now - last < m_options.changeLatencyNSecs || !m_lastChangesRead.testAndSetRelaxed(last, now))
+        {
+            return;
+        }
+    }
+    this->readChanges();
+}
+
+void StatCache::readChanges()
+{
+#if defined(PCTK_OS_LINUX)
+    union
+    {
+        struct inotify_event event;
+        char bytes[16 * 1024];
+    } buffer;
+    for (;;)
+    {
+        const ssize_t count = ::read(m_notifyFd, buffer.bytes, sizeof(buffer.bytes));
+        if (count <= 0)
+        {
+            if (count < 0 && EINTR == errno)
+            {
+                continue;
+            }
+            return;
+        }
+        WriteLocker lock(m_lock);
+        ++m_generation;
+        for (ssize_t offset = 0; offset < count;)
+        {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(buffer.bytes + offset);
+            offset += (ssize_t) (sizeof(struct inotify_event) + event->len);
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                this->clearLocked();
+                continue;
+            }
+            HashMap<int, std::vector<std::string> >::iterator iter = m_watchedDirectories.find(event->wd);
+            if (iter == m_watchedDirectories.end())
+            {
+                continue;
+            }
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+            {
+                /* every path below the directory may now resolve differently */
+                this->clearLocked();
+                if (event->mask & IN_IGNORED)
+                {
+                    for (std::size_t i = 0; i < iter->second.size(); ++i)
+                    {
+                        m_watches.erase(iter->second[i]);
+                    }
+                    m_watchedDirectories.erase(event->wd);
+                }
+                continue;
+            }
+            if (event->len)
+            {
+                for (std::size_t i = 0; i < iter->second.size(); ++i)
+                {
+                    this->invalidateLocked(detail::watchedPath(iter->second[i], event->name));
+                }
+            }
+        }
+    }
+#endif
+}
+
+PCTK_END_NAMESPACE
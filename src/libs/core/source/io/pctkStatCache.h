@@ -0,0 +1,220 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#ifndef _PCTKSTATCACHE_H
+#define _PCTKSTATCACHE_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+#include <pctkHashMap.h>
+#include <pctkReadWriteLock.h>
+#include <pctkStripedCounter.h>
+
+#include <string>
+#include <vector>
+#include <system_error>
+
+PCTK_BEGIN_NAMESPACE
+
+class ThreadPool;
+
+/**
+ * @brief Status of a path as stat() sees it, symbolic links followed. A path that does not exist, or runs through
+ * something that is not a directory, is NotFound without an error, any other failure sets error().
+ */
+class PCTK_CORE_API FileStatus
+{
+public:
+    enum Type
+    {
+        NotFound = 0,
+        File,
+        Directory,
+        Other
+    };
+
+    FileStatus()
+        : m_size(0), m_modificationTime(0), m_device(0), m_inode(0), m_permissions(0), m_type(NotFound), m_error(0)
+    {
+    }
+
+    Type type() const PCTK_NOEXCEPT { return m_type; }
+    bool exists() const PCTK_NOEXCEPT { return NotFound != m_type; }
+    bool isFile() const PCTK_NOEXCEPT { return File == m_type; }
+    bool isDirectory() const PCTK_NOEXCEPT { return Directory == m_type; }
+
+    pctk_uint64_t size() const PCTK_NOEXCEPT { return m_size; }
+
+    /**
+     * @brief Last modification in nanoseconds since the Unix epoch.
+     */
+    pctk_int64_t modificationTime() const PCTK_NOEXCEPT { return m_modificationTime; }
+
+    pctk_uint64_t device() const PCTK_NOEXCEPT { return m_device; }
+    pctk_uint64_t inode() const PCTK_NOEXCEPT { return m_inode; }
+    unsigned int permissions() const PCTK_NOEXCEPT { return m_permissions; }
+
+    std::error_code error() const
+    {
+        if (!m_error)
+        {
+            return std::error_code();
+        }
+#if defined(PCTK_OS_WIN)
+        return std::error_code(m_error, std::system_category());
+#else
+        return std::error_code(m_error, std::generic_category());
+#endif
+    }
+
+    /**
+     * @brief Reads the status of path, on Linux with statx() asking for the fields above only, on Windows with
+     * GetFileAttributesExW() on the wide path, which leaves device() and inode() 0. Never throws.
+     */
+    static FileStatus query(const std::string &path) PCTK_NOEXCEPT;
+
+private:
+    pctk_uint64_t m_size;
+    pctk_int64_t m_modificationTime;
+    pctk_uint64_t m_device;
+    pctk_uint64_t m_inode;
+    unsigned int m_permissions;
+    Type m_type;
+    int m_error;
+};
+
+namespace detail
+{
+struct StatCacheEntry
+{
+    FileStatus status;
+    /* SteadyClock nanoseconds the entry is served until */
+    pctk_int64_t expires;
+};
+} // namespace detail
+
+/**
+ * @brief Opt-in cache of FileStatus by path, for code that asks about the same paths over and over, shared by any
+ * number of threads. FileSystem queries go through it once it is set with FileSystem::setStatCache().
+ *
+ * Entries are served for Options::timeToLiveNSecs. With Options::watch the cache also asks inotify for changes in the
+ * directory of every cached path and drops an entry as soon as its name is created, removed, renamed, written or
+ * changes attributes there. Pending changes are read at most once per Options::changeLatencyNSecs, so a hit does
+ * not cost a syscall, and a change is seen by queries made that long after it. A change to an ancestor further up,
+ * such as a renamed grandparent, is not reported and only expires with the time to live. Paths that do not exist are
+ * cached as well, failures other than a missing path are not. Paths are keyed by their spelling, "a/b" and "./a/b"
+ * are two entries.
+ */
+class PCTK_CORE_API StatCache
+{
+public:
+    struct Options
+    {
+        Options()
+            : timeToLiveNSecs(1000000000), watch(false), changeLatencyNSecs(PCTK_NSECS_PER_MSEC), capacity(64 * 1024),
+              pool(PCTK_NULLPTR)
+        {
+        }
+
+        /* how long an entry is served, 0 keeps it until it is invalidated */
+        pctk_int64_t timeToLiveNSecs;
+        /* invalidate through inotify, Linux only, ignored elsewhere */
+        bool watch;
+        /* how often pending inotify changes are read, 0 reads them before every query */
+        pctk_int64_t changeLatencyNSecs;
+        /* entries kept, the cache starts over once it would grow past it */
+        std::size_t capacity;
+        /* pool statMany() fans out over, PCTK_NULLPTR for ThreadPool::globalInstance() */
+        ThreadPool *pool;
+    };
+
+    explicit StatCache(const Options &options = Options());
+    ~StatCache();
+
+    /**
+     * @brief Cached FileStatus::query(path).
+     */
+    FileStatus status(const std::string &path);
+
+    /**
+     * @brief status() of every path in order. The paths missing from the cache are queried in parallel over the
+     * pool once there are enough of them to pay for it, and entered under one lock.
+     */
+    std::vector<FileStatus> statMany(const std::vector<std::string> &paths);
+
+    void invalidate(const std::string &path);
+    void clear();
+
+    std::size_t size() const;
+
+    /**
+     * @brief Returns true if changes are reported by inotify.
+     */
+    bool isWatching() const PCTK_NOEXCEPT { return m_notifyFd >= 0; }
+
+    pctk_int64_t hitCount() const PCTK_NOEXCEPT { return m_hits.sum(); }
+    pctk_int64_t missCount() const PCTK_NOEXCEPT { return m_misses.sum(); }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(StatCache)
+
+    pctk_int64_t expiry() const PCTK_NOEXCEPT;
+    /* callers hold m_lock */
+    bool lookup(const std::string &path, pctk_int64_t now, FileStatus &status) const;
+    bool cacheable(const FileStatus &status, bool watched) const PCTK_NOEXCEPT;
+    /* callers hold m_lock for writing */
+    void insert(const std::string &path, const FileStatus &status, pctk_int64_t expires);
+    bool current(const std::string &path, pctk_uint64_t generation) const;
+    void invalidateLocked(const std::string &path);
+    void clearLocked();
+    bool watch(const std::string &path);
+    void pollChanges();
+    void readChanges();
+
+    Options m_options;
+    mutable ReadWriteLock m_lock;
+    HashMap<std::string, detail::StatCacheEntry> m_entries;
+    /* inotify watch of every watched directory spelling, and the spellings of every watch */
+    HashMap<std::string, int> m_watches;
+    HashMap<int, std::vector<std::string> > m_watchedDirectories;
+    int m_notifyFd;
+    /* coarse SteadyClock nanoseconds of the last readChanges() */
+    AtomicInteger<pctk_int64_t> m_lastChangesRead;
+    /* bumped by every invalidation, guarded by m_lock */
+    pctk_uint64_t m_generation;
+    /* the generation each path was invalidated at while a miss was in flight, and that of the last clear, a miss
+     * that looked up before either does not enter its result for that path */
+    HashMap<std::string, pctk_uint64_t> m_invalidated;
+    pctk_uint64_t m_clearedGeneration;
+    /* misses between their lookup and their insert */
+    AtomicInt m_querying;
+    StripedCounter m_hits;
+    StripedCounter m_misses;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKSTATCACHE_H
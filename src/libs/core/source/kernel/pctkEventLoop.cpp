@@ -0,0 +1,1315 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include <pctkEventLoop.h>
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(PCTK_OS_UNIX)
+#   include <fcntl.h>
+#   include <netinet/in.h>
+#   include <arpa/inet.h>
+#   include <pthread.h>
+#   include <sys/socket.h>
+#   include <unistd.h>
+#endif
+#if defined(PCTK_OS_LINUX)
+#   include <poll.h>
+#   include <sched.h>
+#   include <signal.h>
+#   include <sys/epoll.h>
+#   include <sys/eventfd.h>
+#   include <sys/mman.h>
+#   include <sys/syscall.h>
+#   if defined(__has_include)
+#       if __has_include(<linux/io_uring.h>)
+#           include <linux/io_uring.h>
+#       endif
+#   endif
+#   if defined(IORING_FEAT_EXT_ARG) && defined(IORING_ENTER_EXT_ARG)
+#       define PCTK_EVENTLOOP_HAS_IO_URING 1
+#       ifndef __NR_io_uring_setup
+#           define __NR_io_uring_setup 425
+#       endif
+#       ifndef __NR_io_uring_enter
+#           define __NR_io_uring_enter 426
+#       endif
+#   endif
+#endif
+#ifndef PCTK_EVENTLOOP_HAS_IO_URING
+#   define PCTK_EVENTLOOP_HAS_IO_URING 0
+#endif
+#if PCTK_FEATURE_LIBUV_BACKEND
+#   include <uv.h>
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+static const pctk_uint32_t EventLoopNone = 0xffffffffu;
+
+static void throwErrno(const char *what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+/* The poller behind a loop, owns the wake up mechanism and reports readiness by watch id. */
+class EventLoopBackend
+{
+public:
+    virtual ~EventLoopBackend() {}
+
+    virtual void add(int fd, int events, pctk_uint64_t id) = 0;
+    virtual void modify(int fd, int events, pctk_uint64_t id) = 0;
+    virtual void remove(int fd, pctk_uint64_t id) PCTK_NOEXCEPT = 0;
+    /* appends what became ready within timeoutNSecs to ready, returns early once wakeUp() was called */
+    virtual void wait(pctk_int64_t timeoutNSecs, Vector<EventLoopReady> &ready) = 0;
+    virtual void wakeUp() PCTK_NOEXCEPT = 0;
+};
+
+#if defined(PCTK_OS_LINUX)
+static int createEventFd()
+{
+    const int fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0)
+    {
+        throwErrno("eventfd");
+    }
+    return fd;
+}
+
+static void signalEventFd(int fd) PCTK_NOEXCEPT
+{
+    const pctk_uint64_t one = 1;
+    /* EAGAIN means the counter is saturated, the loop is due to wake anyway */
+    while (::write(fd, &one, sizeof(one)) < 0 && EINTR == errno)
+    {
+    }
+}
+
+static void drainEventFd(int fd) PCTK_NOEXCEPT
+{
+    pctk_uint64_t value;
+    while (::read(fd, &value, sizeof(value)) < 0 && EINTR == errno)
+    {
+    }
+}
+
+/* Rounds up so a timeout never ends before the timer that asked for it is due. */
+static int timeoutMSecs(pctk_int64_t timeoutNSecs) PCTK_NOEXCEPT
+{
+    if (timeoutNSecs < 0)
+    {
+        return -1;
+    }
+    const pctk_int64_t msecs = (timeoutNSecs + PCTK_NSECS_PER_MSEC - 1) / PCTK_NSECS_PER_MSEC;
+    return msecs > std::numeric_limits<int>::max() ? std::numeric_limits<int>::max() : (int) msecs;
+}
+
+class EventLoopEpoll : public EventLoopBackend
+{
+public:
+    EventLoopEpoll() : m_epoll(::epoll_create1(EPOLL_CLOEXEC)), m_wake(-1)
+    {
+        if (m_epoll < 0)
+        {
+            throwErrno("epoll_create1");
+        }
+        try
+        {
+            m_wake = createEventFd();
+            struct epoll_event event;
+            std::memset(&event, 0, sizeof(event));
+            event.events = EPOLLIN;
+            event.data.u64 = 0;
+            if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &event) < 0)
+            {
+                throwErrno("epoll_ctl");
+            }
+        }
+        catch (...)
+        {
+            this->closeAll();
+            throw;
+        }
+    }
+
+    ~EventLoopEpoll() PCTK_OVERRIDE { this->closeAll(); }
+
+    void add(int fd, int events, pctk_uint64_t id) PCTK_OVERRIDE { this->control(EPOLL_CTL_ADD, fd, events, id); }
+
+    void modify(int fd, int events, pctk_uint64_t id) PCTK_OVERRIDE
+    {
+        this->control(EPOLL_CTL_MOD, fd, events, id);
+    }
+
+    void remove(int fd, pctk_uint64_t) PCTK_NOEXCEPT PCTK_OVERRIDE
+    {
+        /* fails harmlessly if the fd was already closed, which removed it from the set */
+        struct epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, &event);
+    }
+
+    void wait(pctk_int64_t timeoutNSecs, Vector<EventLoopReady> &ready) PCTK_OVERRIDE
+    {
+        struct epoll_event events[256];
+        const int count = ::epoll_wait(m_epoll, events, 256, timeoutMSecs(timeoutNSecs));
+        if (count < 0)
+        {
+            if (EINTR != errno)
+            {
+                throwErrno("epoll_wait");
+            }
+            return;
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            if (0 == events[i].data.u64)
+            {
+                drainEventFd(m_wake);
+                continue;
+            }
+            EventLoopReady entry;
+            entry.id = events[i].data.u64;
+            entry.events = (events[i].events & EPOLLIN ? EventLoop::Readable : 0)
+                           | (events[i].events & EPOLLOUT ? EventLoop::Writable : 0)
+                           | (events[i].events & (EPOLLERR | EPOLLHUP) ? EventLoop::Error : 0);
+            ready.push_back(entry);
+        }
+    }
+
+    void wakeUp() PCTK_NOEXCEPT PCTK_OVERRIDE { signalEventFd(m_wake); }
+
+private:
+    void control(int op, int fd, int events, pctk_uint64_t id)
+    {
+        struct epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = (events & EventLoop::Readable ? (pctk_uint32_t) EPOLLIN : 0u)
+                       | (events & EventLoop::Writable ? (pctk_uint32_t) EPOLLOUT : 0u);
+        event.data.u64 = id;
+        if (::epoll_ctl(m_epoll, op, fd, &event) < 0)
+        {
+            throwErrno("epoll_ctl");
+        }
+    }
+
+    void closeAll() PCTK_NOEXCEPT
+    {
+        if (m_wake >= 0)
+        {
+            ::close(m_wake);
+        }
+        if (m_epoll >= 0)
+        {
+            ::close(m_epoll);
+        }
+    }
+
+    int m_epoll;
+    int m_wake;
+};
+#endif
+
+#if PCTK_EVENTLOOP_HAS_IO_URING
+/* user_data of poll removals, whose completions carry nothing of interest */
+static const pctk_uint64_t IoUringIgnore = 0;
+/* user_data of the poll on the wake up eventfd */
+static const pctk_uint64_t IoUringWake = ~(pctk_uint64_t) 0;
+static const unsigned IoUringEntries = 256;
+
+/* Per watch state. Every arming of a poll gets a new token, carried in the upper half of the user_data, so the
+ * completion of a poll that was removed or replaced in the meantime is recognised and dropped. */
+struct IoUringWatch
+{
+    pctk_uint64_t id;
+    int fd;
+    pctk_uint32_t mask;
+    pctk_uint32_t token;
+    pctk_uint8_t registered;
+    pctk_uint8_t armed;
+};
+
+/* io_uring through the raw system calls, liburing is not required. Readiness uses one shot IORING_OP_POLL_ADD
+ * requests that are armed again after the callbacks ran, which keeps level triggered semantics, and every arming,
+ * removal and the wait itself share one io_uring_enter() per iteration. */
+class EventLoopIoUring : public EventLoopBackend
+{
+public:
+    EventLoopIoUring()
+        : m_ring(-1), m_ringMemory(MAP_FAILED), m_ringSize(0), m_sqes(static_cast<struct io_uring_sqe *>(MAP_FAILED)),
+          m_sqesSize(0), m_sqTail(0), m_toSubmit(0), m_wake(-1), m_wakeArmed(false)
+    {
+        struct io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+#   if defined(IORING_SETUP_COOP_TASKRUN)
+        /* the loop enters the kernel every iteration anyway, no need to interrupt it for completions */
+        params.flags = IORING_SETUP_COOP_TASKRUN;
+        m_ring = (int) ::syscall(__NR_io_uring_setup, IoUringEntries, &params);
+        if (m_ring < 0 && EINVAL == errno)
+        {
+            std::memset(&params, 0, sizeof(params));
+            m_ring = (int) ::syscall(__NR_io_uring_setup, IoUringEntries, &params);
+        }
+#   else
+        m_ring = (int) ::syscall(__NR_io_uring_setup, IoUringEntries, &params);
+#   endif
+        if (m_ring < 0)
+        {
+            throwErrno("io_uring_setup");
+        }
+        try
+        {
+            const pctk_uint32_t required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+            if (required != (params.features & required))
+            {
+                throw std::system_error(ENOSYS, std::generic_category(), "io_uring lacks required features");
+            }
+            this->map(params);
+            m_wake = createEventFd();
+            this->armWake();
+            this->enter(0, 0, 0, PCTK_NULLPTR);
+        }
+        catch (...)
+        {
+            this->closeAll();
+            throw;
+        }
+    }
+
+    ~EventLoopIoUring() PCTK_OVERRIDE { this->closeAll(); }
+
+    void add(int fd, int events, pctk_uint64_t id) PCTK_OVERRIDE
+    {
+        const pctk_uint32_t index = (pctk_uint32_t) (id & 0xffffffffu) - 1;
+        if (index >= m_watches.size())
+        {
+            IoUringWatch empty;
+            std::memset(&empty, 0, sizeof(empty));
+            m_watches.resize(index + 1, empty);
+        }
+        IoUringWatch &watch = m_watches[index];
+        watch.id = id;
+        watch.fd = fd;
+        watch.mask = this->pollMask(events);
+        watch.registered = 1;
+        watch.armed = 0;
+        this->arm(index);
+    }
+
+    void modify(int fd, int events, pctk_uint64_t id) PCTK_OVERRIDE
+    {
+        const pctk_uint32_t index = (pctk_uint32_t) (id & 0xffffffffu) - 1;
+        IoUringWatch &watch = m_watches[index];
+        this->disarm(index);
+        watch.fd = fd;
+        watch.mask = this->pollMask(events);
+        this->arm(index);
+    }
+
+    void remove(int, pctk_uint64_t id) PCTK_NOEXCEPT PCTK_OVERRIDE
+    {
+        const pctk_uint32_t index = (pctk_uint32_t) (id & 0xffffffffu) - 1;
+        this->disarm(index);
+        /* the removal goes out with the next wait, until then the poll keeps a closed fd's file open */
+        m_watches[index].registered = 0;
+    }
+
+    void wait(pctk_int64_t timeoutNSecs, Vector<EventLoopReady> &ready) PCTK_OVERRIDE
+    {
+        /* arm() queues whatever finds no room in m_rearm again */
+        m_arming.swap(m_rearm);
+        for (Vector<pctk_uint32_t>::size_type i = 0; i < m_arming.size(); ++i)
+        {
+            const IoUringWatch &watch = m_watches[m_arming[i]];
+            if (watch.registered && !watch.armed)
+            {
+                this->arm(m_arming[i]);
+            }
+        }
+        m_arming.clear();
+        if (!m_wakeArmed)
+        {
+            this->armWake();
+        }
+
+        /* never sleep on polls that could not be armed, the harvest below makes room for them */
+        const bool completed =
+            __atomic_load_n(m_cqHead, __ATOMIC_RELAXED) != __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+        const bool pending = completed || !m_rearm.empty() || !m_wakeArmed;
+        if (0 == timeoutNSecs || pending)
+        {
+            this->enter(m_toSubmit, 0, 0, PCTK_NULLPTR);
+        }
+        else
+        {
+            struct __kernel_timespec ts;
+            struct io_uring_getevents_arg arg;
+            std::memset(&arg, 0, sizeof(arg));
+            arg.sigmask_sz = _NSIG / 8;
+            if (timeoutNSecs > 0)
+            {
+                ts.tv_sec = timeoutNSecs / PCTK_NSECS_PER_SEC;
+                ts.tv_nsec = timeoutNSecs % PCTK_NSECS_PER_SEC;
+                arg.ts = (pctk_uint64_t) (pctk_uintptr_t) &ts;
+            }
+            this->enter(m_toSubmit, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg);
+        }
+        this->harvest(ready);
+    }
+
+    void wakeUp() PCTK_NOEXCEPT PCTK_OVERRIDE { signalEventFd(m_wake); }
+
+private:
+    static pctk_uint32_t pollMask(int events) PCTK_NOEXCEPT
+    {
+        return (events & EventLoop::Readable ? POLLIN : 0) | (events & EventLoop::Writable ? POLLOUT : 0);
+    }
+
+    void map(const struct io_uring_params &params)
+    {
+        const std::size_t sqSize = params.sq_off.array + params.sq_entries * sizeof(pctk_uint32_t);
+        const std::size_t cqSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        m_ringSize = sqSize > cqSize ? sqSize : cqSize;
+        m_ringMemory = ::mmap(PCTK_NULLPTR, m_ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring,
+                              IORING_OFF_SQ_RING);
+        if (MAP_FAILED == m_ringMemory)
+        {
+            throwErrno("mmap");
+        }
+        m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+        m_sqes = static_cast<struct io_uring_sqe *>(::mmap(PCTK_NULLPTR, m_sqesSize, PROT_READ | PROT_WRITE,
+                                                           MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQES));
+        if (MAP_FAILED == (void *) m_sqes)
+        {
+            throwErrno("mmap");
+        }
+        char *base = static_cast<char *>(m_ringMemory);
+        m_sqHead = reinterpret_cast<unsigned *>(base + params.sq_off.head);
+        m_sqTailShared = reinterpret_cast<unsigned *>(base + params.sq_off.tail);
+        m_sqMask = *reinterpret_cast<unsigned *>(base + params.sq_off.ring_mask);
+        m_sqEntries = params.sq_entries;
+        m_sqArray = reinterpret_cast<unsigned *>(base + params.sq_off.array);
+        m_cqHead = reinterpret_cast<unsigned *>(base + params.cq_off.head);
+        m_cqTail = reinterpret_cast<unsigned *>(base + params.cq_off.tail);
+        m_cqMask = *reinterpret_cast<unsigned *>(base + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<struct io_uring_cqe *>(base + params.cq_off.cqes);
+        m_sqTail = *m_sqTailShared;
+    }
+
+    /* Null when the submission queue stays full, the kernel takes nothing while completions back up (EBUSY) or
+     * memory is short (EAGAIN), and only the harvest in wait() gets it going again. */
+    struct io_uring_sqe *nextSqe() PCTK_NOEXCEPT
+    {
+        while (m_sqTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) >= m_sqEntries)
+        {
+            /* the submission queue is full, hand it to the kernel without waiting */
+            const int submitted = this->enter(m_toSubmit, 0, 0, PCTK_NULLPTR);
+            if (0 == submitted || (submitted < 0 && EINTR != errno))
+            {
+                return PCTK_NULLPTR;
+            }
+        }
+        const unsigned index = m_sqTail & m_sqMask;
+        struct io_uring_sqe *sqe = &m_sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        m_sqArray[index] = index;
+        ++m_sqTail;
+        ++m_toSubmit;
+        return sqe;
+    }
+
+    void arm(pctk_uint32_t index)
+    {
+        struct io_uring_sqe *sqe = this->nextSqe();
+        if (PCTK_NULLPTR == sqe)
+        {
+            m_rearm.push_back(index);
+            return;
+        }
+        IoUringWatch &watch = m_watches[index];
+        ++watch.token;
+        watch.armed = 1;
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = watch.fd;
+        sqe->poll32_events = watch.mask;
+        sqe->user_data = ((pctk_uint64_t) watch.token << 32) | (index + 1);
+    }
+
+    void disarm(pctk_uint32_t index) PCTK_NOEXCEPT
+    {
+        IoUringWatch &watch = m_watches[index];
+        if (watch.armed)
+        {
+            /* without room the poll stays in the kernel until it fires, the new token below disowns it */
+            struct io_uring_sqe *sqe = this->nextSqe();
+            if (sqe)
+            {
+                sqe->opcode = IORING_OP_POLL_REMOVE;
+                sqe->fd = -1;
+                sqe->addr = ((pctk_uint64_t) watch.token << 32) | (index + 1);
+                sqe->user_data = IoUringIgnore;
+            }
+            watch.armed = 0;
+        }
+        /* a completion already on its way belongs to the old token */
+        ++watch.token;
+    }
+
+    void armWake() PCTK_NOEXCEPT
+    {
+        struct io_uring_sqe *sqe = this->nextSqe();
+        if (PCTK_NULLPTR == sqe)
+        {
+            return;
+        }
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = m_wake;
+        sqe->poll32_events = POLLIN;
+        sqe->user_data = IoUringWake;
+        m_wakeArmed = true;
+    }
+
+    /* the number of entries the kernel consumed, or -1 with errno set */
+    int enter(unsigned toSubmit, unsigned minComplete, unsigned flags, const struct io_uring_getevents_arg *arg)
+        PCTK_NOEXCEPT
+    {
+        __atomic_store_n(m_sqTailShared, m_sqTail, __ATOMIC_RELEASE);
+        if (0 == toSubmit && 0 == (flags & IORING_ENTER_GETEVENTS))
+        {
+            return 0;
+        }
+        const int result =
+            (int) ::syscall(__NR_io_uring_enter, m_ring, toSubmit, minComplete, flags, arg, arg ? sizeof(*arg) : 0);
+        const int error = errno;
+        /* ETIME is the timeout, EINTR a signal, EBUSY a completion backlog that harvest() clears next, whatever the
+         * kernel did not consume is submitted again by the next call */
+        m_toSubmit = m_sqTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+        errno = error;
+        return result;
+    }
+
+    void harvest(Vector<EventLoopReady> &ready)
+    {
+        unsigned head = *m_cqHead;
+        const unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head)
+        {
+            const struct io_uring_cqe &cqe = m_cqes[head & m_cqMask];
+            if (IoUringWake == cqe.user_data)
+            {
+                drainEventFd(m_wake);
+                m_wakeArmed = false;
+                continue;
+            }
+            if (IoUringIgnore == cqe.user_data)
+            {
+                continue;
+            }
+            const pctk_uint32_t index = (pctk_uint32_t) (cqe.user_data & 0xffffffffu) - 1;
+            if (index >= m_watches.size())
+            {
+                continue;
+            }
+            IoUringWatch &watch = m_watches[index];
+            if (!watch.registered || !watch.armed || watch.token != (pctk_uint32_t) (cqe.user_data >> 32))
+            {
+                continue;
+            }
+            watch.armed = 0;
+            m_rearm.push_back(index);
+            EventLoopReady entry;
+            entry.id = watch.id;
+            if (cqe.res < 0)
+            {
+                entry.events = EventLoop::Error;
+            }
+            else
+            {
+                entry.events = (cqe.res & POLLIN ? EventLoop::Readable : 0)
+                               | (cqe.res & POLLOUT ? EventLoop::Writable : 0)
+                               | (cqe.res & (POLLERR | POLLHUP | POLLNVAL) ? EventLoop::Error : 0);
+            }
+            ready.push_back(entry);
+        }
+        __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    void closeAll() PCTK_NOEXCEPT
+    {
+        if (MAP_FAILED != (void *) m_sqes)
+        {
+            ::munmap(m_sqes, m_sqesSize);
+        }
+        if (MAP_FAILED != m_ringMemory)
+        {
+            ::munmap(m_ringMemory, m_ringSize);
+        }
+        if (m_ring >= 0)
+        {
+            ::close(m_ring);
+        }
+        if (m_wake >= 0)
+        {
+            ::close(m_wake);
+        }
+    }
+
+    int m_ring;
+    void *m_ringMemory;
+    std::size_t m_ringSize;
+    struct io_uring_sqe *m_sqes;
+    std::size_t m_sqesSize;
+    unsigned *m_sqHead;
+    unsigned *m_sqTailShared;
+    unsigned *m_sqArray;
+    unsigned m_sqMask;
+    unsigned m_sqEntries;
+    unsigned *m_cqHead;
+    unsigned *m_cqTail;
+    unsigned m_cqMask;
+    struct io_uring_cqe *m_cqes;
+    /* local submission tail, published to the kernel by enter() */
+    unsigned m_sqTail;
+    unsigned m_toSubmit;
+    int m_wake;
+    bool m_wakeArmed;
+    Vector<IoUringWatch> m_watches;
+    Vector<pctk_uint32_t> m_rearm;
+    Vector<pctk_uint32_t> m_arming;
+};
+#endif
+
+#if PCTK_FEATURE_LIBUV_BACKEND
+static void throwLibuv(int error, const char *what)
+{
+    throw std::system_error(-error, std::generic_category(), std::string(what) + ": " + uv_strerror(error));
+}
+
+/* uv_poll_t first, libuv hands the handle back to the callbacks */
+struct LibuvPoll
+{
+    uv_poll_t handle;
+    pctk_uint64_t id;
+};
+
+class EventLoopLibuv : public EventLoopBackend
+{
+public:
+    EventLoopLibuv() : m_ready(PCTK_NULLPTR)
+    {
+        int error = uv_loop_init(&m_loop);
+        if (error < 0)
+        {
+            throwLibuv(error, "uv_loop_init");
+        }
+        m_loop.data = this;
+        error = uv_async_init(&m_loop, &m_async, &EventLoopLibuv::onAsync);
+        if (error < 0)
+        {
+            uv_loop_close(&m_loop);
+            throwLibuv(error, "uv_async_init");
+        }
+        error = uv_timer_init(&m_loop, &m_timer);
+        if (error < 0)
+        {
+            /* the async handle is closed by the loop, which then runs out of handles */
+            uv_close(reinterpret_cast<uv_handle_t *>(&m_async), PCTK_NULLPTR);
+            uv_run(&m_loop, UV_RUN_DEFAULT);
+            uv_loop_close(&m_loop);
+            throwLibuv(error, "uv_timer_init");
+        }
+    }
+
+    ~EventLoopLibuv() PCTK_OVERRIDE
+    {
+        for (Vector<LibuvPoll *>::size_type i = 0; i < m_polls.size(); ++i)
+        {
+            if (m_polls[i])
+            {
+                uv_close(reinterpret_cast<uv_handle_t *>(&m_polls[i]->handle), &EventLoopLibuv::onClosed);
+            }
+        }
+        uv_close(reinterpret_cast<uv_handle_t *>(&m_async), PCTK_NULLPTR);
+        uv_close(reinterpret_cast<uv_handle_t *>(&m_timer), PCTK_NULLPTR);
+        uv_run(&m_loop, UV_RUN_DEFAULT);
+        uv_loop_close(&m_loop);
+    }
+
+    void add(int fd, int events, pctk_uint64_t id) PCTK_OVERRIDE
+    {
+        const pctk_uint32_t index = (pctk_uint32_t) (id & 0xffffffffu) - 1;
+        if (index >= m_polls.size())
+        {
+            m_polls.resize(index + 1, PCTK_NULLPTR);
+        }
+        LibuvPoll *poll = new LibuvPoll;
+        poll->id = id;
+#   if defined(PCTK_OS_WIN)
+        int error = uv_poll_init_socket(&m_loop, &poll->handle, (uv_os_sock_t) fd);
+#   else
+        int error = uv_poll_init(&m_loop, &poll->handle, fd);
+#   endif
+        if (error < 0)
+        {
+            delete poll;
+            throwLibuv(error, "uv_poll_init");
+        }
+        m_polls[index] = poll;
+        error = uv_poll_start(&poll->handle, this->pollFlags(events), &EventLoopLibuv::onPoll);
+        if (error < 0)
+        {
+            this->remove(fd, id);
+            throwLibuv(error, "uv_poll_start");
+        }
+    }
+
+    void modify(int, int events, pctk_uint64_t id) PCTK_OVERRIDE
+    {
+        LibuvPoll *poll = m_polls[(pctk_uint32_t) (id & 0xffffffffu) - 1];
+        const int error = uv_poll_start(&poll->handle, this->pollFlags(events), &EventLoopLibuv::onPoll);
+        if (error < 0)
+        {
+            throwLibuv(error, "uv_poll_start");
+        }
+    }
+
+    void remove(int, pctk_uint64_t id) PCTK_NOEXCEPT PCTK_OVERRIDE
+    {
+        const pctk_uint32_t index = (pctk_uint32_t) (id & 0xffffffffu) - 1;
+        LibuvPoll *poll = m_polls[index];
+        m_polls[index] = PCTK_NULLPTR;
+        uv_poll_stop(&poll->handle);
+        uv_close(reinterpret_cast<uv_handle_t *>(&poll->handle), &EventLoopLibuv::onClosed);
+    }
+
+    void wait(pctk_int64_t timeoutNSecs, Vector<EventLoopReady> &ready) PCTK_OVERRIDE
+    {
+        m_ready = &ready;
+        if (0 == timeoutNSecs)
+        {
+            uv_run(&m_loop, UV_RUN_NOWAIT);
+        }
+        else
+        {
+            if (timeoutNSecs > 0)
+            {
+                const pctk_uint64_t msecs = (timeoutNSecs + PCTK_NSECS_PER_MSEC - 1) / PCTK_NSECS_PER_MSEC;
+                uv_timer_start(&m_timer, &EventLoopLibuv::onTimer, msecs, 0);
+            }
+            uv_run(&m_loop, UV_RUN_ONCE);
+            uv_timer_stop(&m_timer);
+        }
+        m_ready = PCTK_NULLPTR;
+    }
+
+    void wakeUp() PCTK_NOEXCEPT PCTK_OVERRIDE { uv_async_send(&m_async); }
+
+private:
+    static int pollFlags(int events) PCTK_NOEXCEPT
+    {
+        return (events & EventLoop::Readable ? UV_READABLE : 0) | (events & EventLoop::Writable ? UV_WRITABLE : 0);
+    }
+
+    static void onPoll(uv_poll_t *handle, int status, int events)
+    {
+        EventLoopLibuv *self = static_cast<EventLoopLibuv *>(handle->loop->data);
+        LibuvPoll *poll = reinterpret_cast<LibuvPoll *>(handle);
+        if (self->m_ready)
+        {
+            EventLoopReady entry;
+            entry.id = poll->id;
+            entry.events = status < 0 ? EventLoop::Error
+                                      : ((events & UV_READABLE ? EventLoop::Readable : 0)
+                                         | (events & UV_WRITABLE ? EventLoop::Writable : 0)
+                                         | (events & UV_DISCONNECT ? EventLoop::Error : 0));
+            self->m_ready->push_back(entry);
+        }
+    }
+
+    static void onAsync(uv_async_t *) {}
+    static void onTimer(uv_timer_t *) {}
+    static void onClosed(uv_handle_t *handle) { delete reinterpret_cast<LibuvPoll *>(handle); }
+
+    uv_loop_t m_loop;
+    uv_async_t m_async;
+    uv_timer_t m_timer;
+    Vector<LibuvPoll *> m_polls;
+    Vector<EventLoopReady> *m_ready;
+};
+#endif
+
+static EventLoopBackend *createBackend(EventLoop::Backend &type)
+{
+#if PCTK_FEATURE_LIBUV_BACKEND
+    if (EventLoop::Auto == type)
+    {
+        type = EventLoop::Libuv;
+    }
+#endif
+    switch (type)
+    {
+#if PCTK_FEATURE_LIBUV_BACKEND
+        case EventLoop::Libuv:
+            return new EventLoopLibuv;
+#endif
+#if PCTK_EVENTLOOP_HAS_IO_URING
+        case EventLoop::IoUring:
+            return new EventLoopIoUring;
+#endif
+#if defined(PCTK_OS_LINUX)
+        case EventLoop::Auto:
+            type = EventLoop::Epoll;
+            return new EventLoopEpoll;
+        case EventLoop::Epoll:
+            return new EventLoopEpoll;
+#endif
+        default:
+            break;
+    }
+    throw std::system_error(std::make_error_code(std::errc::function_not_supported), "EventLoop backend");
+}
+
+static thread_local EventLoop *currentLoop = PCTK_NULLPTR;
+
+/* Marks the calling thread as running loop for the lifetime of the scope, nested loops restore the outer one. */
+class EventLoopScope
+{
+public:
+    explicit EventLoopScope(EventLoop *loop) : m_previous(currentLoop) { currentLoop = loop; }
+    ~EventLoopScope() { currentLoop = m_previous; }
+
+private:
+    EventLoop *m_previous;
+};
+
+static int availableCpus(Vector<int> *cpus)
+{
+#if defined(PCTK_OS_LINUX)
+    /* honour affinity masks and cpusets, containers often see more cores than they may use */
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (0 == sched_getaffinity(0, sizeof(set), &set) && CPU_COUNT(&set) > 0)
+    {
+        for (int cpu = 0; cpu < CPU_SETSIZE && cpus; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &set))
+            {
+                cpus->push_back(cpu);
+            }
+        }
+        return CPU_COUNT(&set);
+    }
+#endif
+    const unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? (int) count : 1;
+}
+} // namespace detail
+
+EventLoop::EventLoop(Backend backend)
+    : m_backend(PCTK_NULLPTR), m_backendType(backend), m_freeList(detail::EventLoopNone), m_dispatching(PCTK_NULLPTR),
+      m_postHead(PCTK_NULLPTR), m_postTail(PCTK_NULLPTR), m_wakePending(0), m_quit(0)
+{
+    m_backend = detail::createBackend(m_backendType);
+}
+
+EventLoop::~EventLoop()
+{
+    for (Vector<detail::EventLoopWatch>::size_type i = 0; i < m_watches.size(); ++i)
+    {
+        detail::EventLoopWatch &watch = m_watches[i];
+        if (watch.watcher)
+        {
+            m_backend->remove(watch.fd, ((pctk_uint64_t) watch.generation << 32) | (i + 1));
+            watch.watcher->destroy(watch.watcher);
+            watch.watcher = PCTK_NULLPTR;
+        }
+    }
+    delete m_backend;
+    m_backend = PCTK_NULLPTR;
+    while (this->runPosted())
+    {
+    }
+}
+
+const char *EventLoop::backendName(Backend backend) PCTK_NOEXCEPT
+{
+    switch (backend)
+    {
+        case Epoll:
+            return "epoll";
+        case IoUring:
+            return "io_uring";
+        case Libuv:
+            return "libuv";
+        default:
+            return "auto";
+    }
+}
+
+EventLoop::WatchId EventLoop::addWatch(int fd, int events, detail::EventLoopWatcher *watcher)
+{
+    pctk_uint32_t index = m_freeList;
+    if (detail::EventLoopNone == index)
+    {
+        if (m_watches.size() >= (Vector<detail::EventLoopWatch>::size_type) detail::EventLoopNone)
+        {
+            throw std::length_error("EventLoop: too many watches");
+        }
+        detail::EventLoopWatch watch;
+        std::memset(&watch, 0, sizeof(watch));
+        watch.generation = 1;
+        watch.nextFree = detail::EventLoopNone;
+        m_watches.push_back(watch);
+        index = (pctk_uint32_t) (m_watches.size() - 1);
+    }
+    else
+    {
+        m_freeList = m_watches[index].nextFree;
+        m_watches[index].nextFree = detail::EventLoopNone;
+    }
+    detail::EventLoopWatch &watch = m_watches[index];
+    const WatchId id = ((pctk_uint64_t) watch.generation << 32) | (index + 1);
+    try
+    {
+        m_backend->add(fd, events, id);
+    }
+    catch (...)
+    {
+        this->release(index);
+        throw;
+    }
+    watch.watcher = watcher;
+    watch.fd = fd;
+    watch.events = events & (Readable | Writable);
+    return id;
+}
+
+bool EventLoop::modify(WatchId id, int events)
+{
+    const pctk_uint32_t index = this->lookup(id);
+    if (detail::EventLoopNone == index)
+    {
+        return false;
+    }
+    detail::EventLoopWatch &watch = m_watches[index];
+    events &= Readable | Writable;
+    if (events != watch.events)
+    {
+        m_backend->modify(watch.fd, events, id);
+        watch.events = events;
+    }
+    return true;
+}
+
+bool EventLoop::unwatch(WatchId id)
+{
+    const pctk_uint32_t index = this->lookup(id);
+    if (detail::EventLoopNone == index)
+    {
+        return false;
+    }
+    detail::EventLoopWatcher *watcher = m_watches[index].watcher;
+    m_backend->remove(m_watches[index].fd, id);
+    this->release(index);
+    if (watcher == m_dispatching)
+    {
+        m_dispatching = PCTK_NULLPTR;
+    }
+    else
+    {
+        watcher->destroy(watcher);
+    }
+    return true;
+}
+
+bool EventLoop::restartTimer(TimerId id, pctk_int64_t delayNSecs)
+{
+    const bool restarted = m_timers.restart(id, delayNSecs);
+    if (restarted)
+    {
+        this->timerChanged();
+    }
+    return restarted;
+}
+
+Future<void> EventLoop::after(pctk_int64_t delayNSecs)
+{
+    Future<void> future = m_timers.after(delayNSecs);
+    this->timerChanged();
+    return future;
+}
+
+void EventLoop::wakeUp() PCTK_NOEXCEPT
+{
+    m_backend->wakeUp();
+}
+
+void EventLoop::run()
+{
+    detail::EventLoopScope scope(this);
+    while (!m_quit.loadAcquire())
+    {
+        this->processEvents(-1);
+    }
+    m_quit.storeRelease(0);
+}
+
+std::size_t EventLoop::processEvents(pctk_int64_t timeoutNSecs)
+{
+    detail::EventLoopScope scope(this);
+    const SteadyClock::time_point now = SteadyClock::now();
+    pctk_int64_t timeout = timeoutNSecs;
+    const pctk_int64_t timer = m_timers.nextTimeout(now);
+    if (timer >= 0 && (timeout < 0 || timer < timeout))
+    {
+        timeout = timer;
+    }
+    if (m_wakePending.loadAcquire() || m_quit.loadAcquire())
+    {
+        timeout = 0;
+    }
+
+    m_ready.clear();
+    m_backend->wait(timeout, m_ready);
+    std::size_t count = this->dispatch();
+    count += m_timers.expire();
+    count += this->runPosted();
+    return count;
+}
+
+void EventLoop::quit() PCTK_NOEXCEPT
+{
+    m_quit.storeRelease(1);
+    if (!this->isInLoopThread())
+    {
+        this->wakeUp();
+    }
+}
+
+bool EventLoop::isInLoopThread() const PCTK_NOEXCEPT
+{
+    return this == detail::currentLoop;
+}
+
+EventLoop *EventLoop::current() PCTK_NOEXCEPT
+{
+    return detail::currentLoop;
+}
+
+pctk_uint32_t EventLoop::lookup(WatchId id) const PCTK_NOEXCEPT
+{
+    const pctk_uint64_t slot = id & 0xffffffffu;
+    if (0 == slot || slot > m_watches.size())
+    {
+        return detail::EventLoopNone;
+    }
+    const pctk_uint32_t index = (pctk_uint32_t) (slot - 1);
+    const detail::EventLoopWatch &watch = m_watches[index];
+    if (watch.generation != (pctk_uint32_t) (id >> 32) || PCTK_NULLPTR == watch.watcher)
+    {
+        return detail::EventLoopNone;
+    }
+    return index;
+}
+
+void EventLoop::release(pctk_uint32_t index) PCTK_NOEXCEPT
+{
+    detail::EventLoopWatch &watch = m_watches[index];
+    watch.watcher = PCTK_NULLPTR;
+    watch.fd = -1;
+    watch.events = 0;
+    /* never 0, ids stay distinct from the backends' reserved values */
+    if (0 == ++watch.generation)
+    {
+        watch.generation = 1;
+    }
+    watch.nextFree = m_freeList;
+    m_freeList = index;
+}
+
+void EventLoop::push(detail::ThreadPoolTask *task)
+{
+    {
+        LockGuard<Mutex> locker(m_postLock);
+        if (m_postTail)
+        {
+            m_postTail->next = task;
+        }
+        else
+        {
+            m_postHead = task;
+        }
+        m_postTail = task;
+    }
+    if (0 == m_wakePending.fetchAndStoreRelease(1) && !this->isInLoopThread())
+    {
+        this->wakeUp();
+    }
+}
+
+void EventLoop::timerChanged() PCTK_NOEXCEPT
+{
+    /* the loop may be asleep with a timeout computed before this timer existed */
+    if (!this->isInLoopThread())
+    {
+        this->wakeUp();
+    }
+}
+
+std::size_t EventLoop::dispatch()
+{
+    std::size_t count = 0;
+    for (Vector<detail::EventLoopReady>::size_type i = 0; i < m_ready.size(); ++i)
+    {
+        const pctk_uint32_t index = this->lookup(m_ready[i].id);
+        if (detail::EventLoopNone == index)
+        {
+            continue;
+        }
+        /* callbacks may add watches and grow the slot array, copy what is needed before calling out */
+        const detail::EventLoopWatch &watch = m_watches[index];
+        int events = m_ready[i].events;
+        if (events & Error)
+        {
+            events |= watch.events;
+        }
+        events &= watch.events | Error;
+        if (0 == events)
+        {
+            continue;
+        }
+        detail::EventLoopWatcher *watcher = watch.watcher;
+        m_dispatching = watcher;
+        watcher->invoke(watcher, watch.fd, events);
+        if (PCTK_NULLPTR == m_dispatching)
+        {
+            watcher->destroy(watcher);
+        }
+        m_dispatching = PCTK_NULLPTR;
+        ++count;
+    }
+    m_ready.clear();
+    return count;
+}
+
+std::size_t EventLoop::runPosted() PCTK_NOEXCEPT
+{
+    /* acquire orders the reset before taking the queue, a post that misses this round sees 0 and wakes the loop */
+    if (0 == m_wakePending.fetchAndStoreAcquire(0))
+    {
+        return 0;
+    }
+    detail::ThreadPoolTask *task;
+    {
+        LockGuard<Mutex> locker(m_postLock);
+        task = m_postHead;
+        m_postHead = PCTK_NULLPTR;
+        m_postTail = PCTK_NULLPTR;
+    }
+    std::size_t count = 0;
+    while (task)
+    {
+        detail::ThreadPoolTask *next = task->next;
+        task->invoke(task);
+        task = next;
+        ++count;
+    }
+    return count;
+}
+
+EventLoopGroup::EventLoopGroup(int loopCount) : m_next(0)
+{
+    Options options;
+    options.loopCount = loopCount;
+    this->start(options);
+}
+
+EventLoopGroup::EventLoopGroup(const Options &options) : m_next(0)
+{
+    this->start(options);
+}
+
+EventLoopGroup::~EventLoopGroup()
+{
+    this->stop();
+}
+
+EventLoop *EventLoopGroup::next() PCTK_NOEXCEPT
+{
+    const unsigned int index = (unsigned int) m_next.fetchAndAddRelaxed(1);
+    return m_loops[index % (unsigned int) m_loops.size()];
+}
+
+void EventLoopGroup::start(const Options &options)
+{
+    Vector<int> cpus;
+    const int available = detail::availableCpus(options.pinThreads ? &cpus : PCTK_NULLPTR);
+    const int count = options.loopCount > 0 ? options.loopCount : available;
+    try
+    {
+        m_loops.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            m_loops.push_back(PCTK_NULLPTR);
+            m_loops[i] = new EventLoop(options.backend);
+        }
+        m_threads.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            EventLoop *loop = m_loops[i];
+            std::string name = options.name + "-" + std::to_string(i);
+            const int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+            m_threads.push_back(PCTK_NULLPTR);
+            m_threads[i] = new std::thread([loop, name, cpu]() {
+#if defined(PCTK_OS_LINUX)
+                if (cpu >= 0)
+                {
+                    cpu_set_t set;
+                    CPU_ZERO(&set);
+                    CPU_SET(cpu, &set);
+                    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+                }
+#else
+                PCTK_UNUSED(cpu);
+#endif
+#if defined(PCTK_OS_UNIX) && PCTK_HAS_PTHREAD_SETNAME_NP
+                /* Linux limits thread names to 15 characters */
+                const std::string shortName = name.substr(0, 15);
+#   if defined(PCTK_OS_DARWIN)
+                pthread_setname_np(shortName.c_str());
+#   else
+                pthread_setname_np(pthread_self(), shortName.c_str());
+#   endif
+#else
+                PCTK_UNUSED(name);
+#endif
+                loop->run();
+            });
+        }
+    }
+    catch (...)
+    {
+        this->stop();
+        throw;
+    }
+}
+
+void EventLoopGroup::stop() PCTK_NOEXCEPT
+{
+    for (Vector<EventLoop *>::size_type i = 0; i < m_threads.size(); ++i)
+    {
+        if (m_threads[i])
+        {
+            m_loops[i]->quit();
+            m_threads[i]->join();
+            delete m_threads[i];
+        }
+    }
+    m_threads.clear();
+    for (Vector<EventLoop *>::size_type i = 0; i < m_loops.size(); ++i)
+    {
+        delete m_loops[i];
+    }
+    m_loops.clear();
+}
+
+int EventLoopGroup::listenReusePort(const std::string &address, int port, int backlog)
+{
+#if defined(PCTK_OS_UNIX)
+    struct sockaddr_storage storage;
+    std::memset(&storage, 0, sizeof(storage));
+    socklen_t length;
+    struct sockaddr_in6 *v6 = reinterpret_cast<struct sockaddr_in6 *>(&storage);
+    struct sockaddr_in *v4 = reinterpret_cast<struct sockaddr_in *>(&storage);
+    if (1 == ::inet_pton(AF_INET6, address.c_str(), &v6->sin6_addr))
+    {
+        v6->sin6_family = AF_INET6;
+        v6->sin6_port = htons((pctk_uint16_t) port);
+        length = sizeof(*v6);
+    }
+    else if (1 == ::inet_pton(AF_INET, address.c_str(), &v4->sin_addr))
+    {
+        v4->sin_family = AF_INET;
+        v4->sin_port = htons((pctk_uint16_t) port);
+        length = sizeof(*v4);
+    }
+    else
+    {
+        throw std::system_error(EINVAL, std::generic_category(), "listenReusePort: not a numeric address");
+    }
+
+    const int fd = ::socket(storage.ss_family, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        detail::throwErrno("socket");
+    }
+    const int on = 1;
+    const char *failed = PCTK_NULLPTR;
+    if (::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) < 0)
+    {
+        failed = "setsockopt(SO_REUSEADDR)";
+    }
+#   if defined(SO_REUSEPORT)
+    else if (::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0)
+    {
+        failed = "setsockopt(SO_REUSEPORT)";
+    }
+#   endif
+    else if (::fcntl(fd, F_SETFD, FD_CLOEXEC) < 0 || ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK) < 0)
+    {
+        failed = "fcntl";
+    }
+    else if (::bind(fd, reinterpret_cast<struct sockaddr *>(&storage), length) < 0)
+    {
+        failed = "bind";
+    }
+    else if (::listen(fd, backlog) < 0)
+    {
+        failed = "listen";
+    }
+    if (failed)
+    {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), failed);
+    }
+    return fd;
+#else
+    PCTK_UNUSED(address);
+    PCTK_UNUSED(port);
+    PCTK_UNUSED(backlog);
+    throw std::system_error(std::make_error_code(std::errc::function_not_supported), "listenReusePort");
+#endif
+}
+
+PCTK_END_NAMESPACE
@@ -0,0 +1,319 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#ifndef _PCTKEVENTLOOP_H
+#define _PCTKEVENTLOOP_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+#include <pctkFuture.h>
+#include <pctkMutex.h>
+#include <pctkThreadPool.h>
+#include <pctkTimerWheel.h>
+#include <pctkVector.h>
+
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* Heap node of one fd watch callback, owned by the loop until unwatch(). */
+struct EventLoopWatcher
+{
+    void (*invoke)(EventLoopWatcher *watcher, int fd, int events);
+    void (*destroy)(EventLoopWatcher *watcher);
+};
+
+template<typename F>
+struct EventLoopWatcherImpl : public EventLoopWatcher
+{
+    template<typename U>
+    explicit EventLoopWatcherImpl(U &&f) : func(std::forward<U>(f))
+    {
+        this->invoke = &EventLoopWatcherImpl::run;
+        this->destroy = &EventLoopWatcherImpl::drop;
+    }
+
+    static void run(EventLoopWatcher *watcher, int fd, int events)
+    {
+        static_cast<EventLoopWatcherImpl *>(watcher)->func(fd, events);
+    }
+    static void drop(EventLoopWatcher *watcher) { delete static_cast<EventLoopWatcherImpl *>(watcher); }
+
+    F func;
+};
+
+/* One watch slot, ids name a slot by index and generation so a stale readiness report never reaches a new watch. */
+struct EventLoopWatch
+{
+    EventLoopWatcher *watcher;
+    int fd;
+    int events;
+    pctk_uint32_t generation;
+    pctk_uint32_t nextFree;
+};
+
+struct EventLoopReady
+{
+    pctk_uint64_t id;
+    int events;
+};
+
+class EventLoopBackend;
+} // namespace detail
+
+/**
+ * @brief Single threaded reactor for fd readiness, timers and tasks posted from other threads.
+ * On Linux the loop polls with epoll, or with io_uring on request where the kernel offers it (5.11 or later, not
+ * blocked by seccomp), both woken across threads through an eventfd. io_uring batches all poll arming and the wait
+ * into one system call, but its one shot polls cost more per event than epoll for plain readiness. Builds with
+ * PCTK_FEATURE_LIBUV_BACKEND run Auto loops on libuv instead, which is also the only backend outside Linux.
+ *
+ * Watches are level triggered. watch(), modify() and unwatch() must be called on the loop thread, or before the loop
+ * runs. post(), wakeUp(), quit() and the timer members are thread-safe. Callbacks run on the loop thread and must
+ * not throw.
+ */
+class PCTK_CORE_API EventLoop
+{
+public:
+    enum Backend
+    {
+        /* libuv when built with it, otherwise epoll */
+        Auto = 0,
+        Epoll,
+        IoUring,
+        Libuv
+    };
+
+    enum Event
+    {
+        Readable = 0x1,
+        Writable = 0x2,
+        /* error or hang up, always reported together with the watched directions so a read or write sees it */
+        Error = 0x4
+    };
+
+    /* 0 never names a watch */
+    typedef pctk_uint64_t WatchId;
+    typedef TimerWheel::TimerId TimerId;
+
+    /**
+     * @brief Creates a loop on the given backend, throws std::system_error if that backend is not available here.
+     */
+    explicit EventLoop(Backend backend = Auto);
+
+    /**
+     * @brief Drops fd watches and pending timers, then runs the tasks still posted.
+     */
+    ~EventLoop();
+
+    /**
+     * @brief The backend actually in use, never Auto.
+     */
+    Backend backend() const PCTK_NOEXCEPT { return m_backendType; }
+
+    static const char *backendName(Backend backend) PCTK_NOEXCEPT;
+
+    /**
+     * @brief Calls func(fd, events) while fd is ready for any of events, a mask of Readable and Writable.
+     * func is moved or copied into a heap allocation. Throws std::system_error if the backend rejects fd.
+     */
+    template<typename F>
+    WatchId watch(int fd, int events, F &&func)
+    {
+        typedef detail::EventLoopWatcherImpl<typename std::decay<F>::type> Watcher;
+        Watcher *watcher = new Watcher(std::forward<F>(func));
+        try
+        {
+            return this->addWatch(fd, events, watcher);
+        }
+        catch (...)
+        {
+            delete watcher;
+            throw;
+        }
+    }
+
+    /**
+     * @brief Changes the events a watch waits for, returns false if id is not watched.
+     */
+    bool modify(WatchId id, int events);
+
+    /**
+     * @brief Stops watching, the callback is destroyed even when it is the one calling unwatch().
+     * Must come before the fd is closed. Returns false if id is not watched.
+     */
+    bool unwatch(WatchId id);
+
+    /**
+     * @brief Runs func() on the loop thread once delayNSecs nanoseconds have passed.
+     */
+    template<typename F>
+    TimerId startTimer(pctk_int64_t delayNSecs, F &&func)
+    {
+        const TimerId id = m_timers.start(delayNSecs, std::forward<F>(func));
+        this->timerChanged();
+        return id;
+    }
+
+    bool restartTimer(TimerId id, pctk_int64_t delayNSecs);
+    bool cancelTimer(TimerId id) { return m_timers.cancel(id); }
+
+    /**
+     * @brief Returns a future that becomes ready on the loop thread once delayNSecs nanoseconds have passed.
+     */
+    Future<void> after(pctk_int64_t delayNSecs);
+
+    /**
+     * @brief Runs func() on the loop thread during its next iteration, in posting order.
+     * Bursts of posts between two iterations wake the loop only once.
+     */
+    template<typename F>
+    void post(F &&func)
+    {
+        typedef detail::ThreadPoolTaskImpl<typename std::decay<F>::type> Task;
+        this->push(new Task(std::forward<F>(func)));
+    }
+
+    /**
+     * @brief Interrupts a blocking wait of the loop, the current or next processEvents() returns promptly.
+     */
+    void wakeUp() PCTK_NOEXCEPT;
+
+    /**
+     * @brief Processes events until quit(). A quit() that came before run() makes it return right away.
+     */
+    void run();
+
+    /**
+     * @brief Runs one iteration, waiting at most timeoutNSecs nanoseconds for work, -1 waits without limit.
+     * Returns the number of fd callbacks, timers and posted tasks that ran.
+     */
+    std::size_t processEvents(pctk_int64_t timeoutNSecs = -1);
+
+    void quit() PCTK_NOEXCEPT;
+
+    /**
+     * @brief Returns true if called from a callback of this loop or from inside its run() or processEvents().
+     */
+    bool isInLoopThread() const PCTK_NOEXCEPT;
+
+    /**
+     * @brief The loop running on the calling thread, PCTK_NULLPTR outside of run() and processEvents().
+     */
+    static EventLoop *current() PCTK_NOEXCEPT;
+
+private:
+    PCTK_DISABLE_COPY_MOVE(EventLoop)
+
+    WatchId addWatch(int fd, int events, detail::EventLoopWatcher *watcher);
+    pctk_uint32_t lookup(WatchId id) const PCTK_NOEXCEPT;
+    void release(pctk_uint32_t index) PCTK_NOEXCEPT;
+    void push(detail::ThreadPoolTask *task);
+    void timerChanged() PCTK_NOEXCEPT;
+    std::size_t dispatch();
+    std::size_t runPosted() PCTK_NOEXCEPT;
+
+    detail::EventLoopBackend *m_backend;
+    Backend m_backendType;
+
+    Vector<detail::EventLoopWatch> m_watches;
+    Vector<detail::EventLoopReady> m_ready;
+    pctk_uint32_t m_freeList;
+    /* the watcher whose callback is running, cleared by unwatch() so the dispatcher destroys it afterwards */
+    detail::EventLoopWatcher *m_dispatching;
+
+    TimerWheel m_timers;
+
+    /* posted tasks, m_wakePending is set by the first post after the loop last drained the queue */
+    Mutex m_postLock;
+    detail::ThreadPoolTask *m_postHead;
+    detail::ThreadPoolTask *m_postTail;
+    AtomicInt m_wakePending;
+    AtomicInt m_quit;
+};
+
+/**
+ * @brief One EventLoop per thread, by default one per CPU, for servers that shard connections across cores.
+ * Every loop may own a listening socket bound with SO_REUSEPORT to the same address, see listenReusePort(), the
+ * kernel then spreads incoming connections over the loops without a shared accept queue.
+ */
+class PCTK_CORE_API EventLoopGroup
+{
+public:
+    struct Options
+    {
+        Options() : loopCount(0), backend(EventLoop::Auto), pinThreads(false), name("pctkLoop") {}
+
+        /* number of loops, 0 means one per CPU available to the process */
+        int loopCount;
+        EventLoop::Backend backend;
+        /* pin loop i to the i-th CPU available to the process, Linux only */
+        bool pinThreads;
+        /* thread name prefix, threads are named "<name>-<index>" where the system supports it */
+        std::string name;
+    };
+
+    explicit EventLoopGroup(int loopCount = 0);
+    explicit EventLoopGroup(const Options &options);
+
+    /**
+     * @brief Quits every loop, joins the threads and destroys the loops.
+     */
+    ~EventLoopGroup();
+
+    int loopCount() const PCTK_NOEXCEPT { return (int) m_loops.size(); }
+    EventLoop *loop(int index) const { return m_loops[index]; }
+
+    /**
+     * @brief Picks the loops in round robin order, for handing out connections accepted elsewhere.
+     */
+    EventLoop *next() PCTK_NOEXCEPT;
+
+    /**
+     * @brief Creates a non-blocking TCP socket listening on a numeric IPv4 or IPv6 address with SO_REUSEADDR and
+     * SO_REUSEPORT set, one per loop shares the port. Throws std::system_error on failure.
+     */
+    static int listenReusePort(const std::string &address, int port, int backlog = 128);
+
+private:
+    PCTK_DISABLE_COPY_MOVE(EventLoopGroup)
+
+    void start(const Options &options);
+    void stop() PCTK_NOEXCEPT;
+
+    Vector<EventLoop *> m_loops;
+    Vector<std::thread *> m_threads;
+    AtomicInt m_next;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKEVENTLOOP_H
@@ -0,0 +1,288 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include <pctkSteadyClock.h>
+#include <pctkAtomic.h>
+#include <pctkSeqLock.h>
+
+#if defined(PCTK_OS_WIN)
+#   include <windows.h>
+#elif defined(PCTK_OS_UNIX)
+#   include <time.h>
+#endif
+
+#if defined(PCTK_PROCESSOR_X86) || defined(PCTK_PROCESSOR_X86_64)
+#   if defined(PCTK_CC_MSVC)
+#       include <intrin.h>
+#       define PCTK_STEADYCLOCK_TSC
+#   elif defined(PCTK_CC_GNU)
+#       include <cpuid.h>
+#       include <x86intrin.h>
+#       define PCTK_STEADYCLOCK_TSC
+#   endif
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+static pctk_int64_t monotonicNSecs() PCTK_NOEXCEPT
+{
+#if defined(PCTK_OS_WIN)
+    static LARGE_INTEGER frequency = {};
+    if (0 == frequency.QuadPart)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / frequency.QuadPart * PCTK_NSECS_PER_SEC
+           + counter.QuadPart % frequency.QuadPart * PCTK_NSECS_PER_SEC / frequency.QuadPart;
+#elif defined(PCTK_OS_UNIX) && defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (pctk_int64_t) ts.tv_sec * PCTK_NSECS_PER_SEC + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+#if defined(PCTK_STEADYCLOCK_TSC)
+/* Length of the first calibration window, the rate error is about the clock_gettime() jitter divided by it. */
+static const pctk_int64_t SteadyClockCalibrationNSecs = 5 * PCTK_NSECS_PER_MSEC;
+/* Interval at which the conversion is anchored to CLOCK_MONOTONIC again and its rate measured over the whole interval,
+ * which bounds the drift between now() and coarseNow() to the rate error of one interval. */
+static const pctk_int64_t SteadyClockRecalibrationNSecs = PCTK_NSECS_PER_SEC;
+
+/* Conversion from counter ticks to CLOCK_MONOTONIC nanoseconds, scale is nanoseconds per tick in 32.32 fixed point.
+ * A scale of 0 means calibration is still running from the anchor (baseTicks, baseNSecs). */
+struct SteadyClockTsc
+{
+    pctk_uint64_t baseTicks;
+    pctk_int64_t baseNSecs;
+    pctk_uint64_t scale;
+    pctk_int64_t recalibrateNSecs;
+
+    pctk_int64_t toNSecs(pctk_uint64_t ticks) const PCTK_NOEXCEPT
+    {
+        if (PCTK_LIKELY(ticks >= baseTicks))
+        {
+            return baseNSecs + scaled(ticks - baseTicks);
+        }
+        /* counters of different cores may disagree by a few ticks right after calibration */
+        return baseNSecs - scaled(baseTicks - ticks);
+    }
+
+    pctk_int64_t scaled(pctk_uint64_t delta) const PCTK_NOEXCEPT
+    {
+        /* split multiply, scale stays below 2^32 so neither product overflows */
+        return (pctk_int64_t) ((delta >> 32) * scale + (((delta & 0xffffffffULL) * scale) >> 32));
+    }
+};
+} // namespace detail
+
+PCTK_DECL_TYPEINFO(detail::SteadyClockTsc, PCTK_TYPEINFO_PRIMITIVE);
+
+namespace detail
+{
+static inline pctk_uint64_t readTsc() PCTK_NOEXCEPT
+{
+    return __rdtsc();
+}
+
+static bool hasInvariantTsc() PCTK_NOEXCEPT
+{
+#if defined(PCTK_CC_MSVC)
+    int registers[4];
+    __cpuid(registers, 0x80000000);
+    if ((unsigned int) registers[0] < 0x80000007u)
+    {
+        return false;
+    }
+    __cpuid(registers, 0x80000007);
+    return 0 != (registers[3] & (1 << 8));
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+    {
+        return false;
+    }
+    return 0 != (edx & (1u << 8));
+#endif
+}
+
+/* Pairs a counter reading with a system clock reading, keeping the tightest bracket of a few tries. */
+static void sampleTsc(pctk_uint64_t &ticks, pctk_int64_t &nsecs) PCTK_NOEXCEPT
+{
+    pctk_uint64_t best = ~0ULL;
+    for (int i = 0; i < 8; ++i)
+    {
+        const pctk_uint64_t before = readTsc();
+        const pctk_int64_t system = monotonicNSecs();
+        const pctk_uint64_t after = readTsc();
+        if (after - before < best)
+        {
+            best = after - before;
+            ticks = before + (after - before) / 2;
+            nsecs = system;
+        }
+    }
+}
+
+/* Calibration piggybacks on ordinary now() calls: the first one takes an anchor, the first one at least
+ * SteadyClockCalibrationNSecs later computes the rate, and from then on one call per SteadyClockRecalibrationNSecs
+ * measures the rate again over the interval and re-anchors. Nobody ever waits for it. */
+struct SteadyClockState
+{
+    SteadyClockState() : invariant(hasInvariantTsc()), disabled(0), writing(0) {}
+
+    const bool invariant;
+    AtomicInt disabled;
+    AtomicInt writing;
+    SeqLock<SteadyClockTsc> tsc;
+};
+
+static SteadyClockState &steadyClockState() PCTK_NOEXCEPT
+{
+    static SteadyClockState state;
+    return state;
+}
+
+static void recalibrateTsc(SteadyClockState &state) PCTK_NOEXCEPT
+{
+    /* one thread at a time, the others keep converting with the current parameters */
+    if (!state.writing.testAndSetAcquire(0, 1))
+    {
+        return;
+    }
+    const SteadyClockTsc current = state.tsc.load();
+    pctk_uint64_t ticks = 0;
+    pctk_int64_t nsecs = 0;
+    sampleTsc(ticks, nsecs);
+    SteadyClockTsc next = current;
+    if (0 == current.baseTicks)
+    {
+        next.baseTicks = ticks;
+        next.baseNSecs = nsecs;
+        state.tsc.store(next);
+    }
+    else if (0 != current.scale || nsecs - current.baseNSecs >= SteadyClockCalibrationNSecs)
+    {
+        pctk_uint64_t elapsedNSecs = (pctk_uint64_t) (nsecs - current.baseNSecs);
+        pctk_uint64_t elapsedTicks = ticks - current.baseTicks;
+        /* keeps the 32.32 division in range after a long pause between calls */
+        while (elapsedNSecs >= (1ULL << 31))
+        {
+            elapsedNSecs >>= 1;
+            elapsedTicks >>= 1;
+        }
+        const pctk_uint64_t scale = ticks > current.baseTicks && 0 != elapsedTicks
+                                    ? (elapsedNSecs << 32) / elapsedTicks : 0;
+        if (0 == scale || scale >= (1ULL << 32))
+        {
+            /* a counter that went backwards or runs below 1GHz is not worth it and would break the split multiply */
+            state.disabled.storeRelease(1);
+        }
+        else
+        {
+            next.baseTicks = ticks;
+            next.baseNSecs = nsecs;
+            next.scale = scale;
+            if (0 != current.scale)
+            {
+                /* the clock must not step back: when the old conversion ran ahead, continue from where it is and run
+                 * slower for one interval so that it meets CLOCK_MONOTONIC again at the next anchor */
+                const pctk_int64_t ahead = current.toNSecs(ticks) - nsecs;
+                if (ahead > 0)
+                {
+                    const pctk_int64_t catchUp = ahead < SteadyClockRecalibrationNSecs / 2
+                                                 ? ahead : SteadyClockRecalibrationNSecs / 2;
+                    next.baseNSecs = nsecs + ahead;
+                    next.scale = scale - scale * (pctk_uint64_t) catchUp / (pctk_uint64_t) SteadyClockRecalibrationNSecs;
+                }
+            }
+            next.recalibrateNSecs = next.baseNSecs + SteadyClockRecalibrationNSecs;
+            state.tsc.store(next);
+        }
+    }
+    state.writing.storeRelease(0);
+}
+#endif
+} // namespace detail
+
+const bool SteadyClock::is_steady;
+
+SteadyClock::time_point SteadyClock::now() PCTK_NOEXCEPT
+{
+#if defined(PCTK_STEADYCLOCK_TSC)
+    detail::SteadyClockState &state = detail::steadyClockState();
+    if (PCTK_LIKELY(state.invariant && !state.disabled.loadAcquire()))
+    {
+        const detail::SteadyClockTsc tsc = state.tsc.load();
+        if (PCTK_LIKELY(0 != tsc.scale))
+        {
+            const pctk_int64_t nsecs = tsc.toNSecs(detail::readTsc());
+            if (PCTK_UNLIKELY(nsecs >= tsc.recalibrateNSecs))
+            {
+                detail::recalibrateTsc(state);
+            }
+            return time_point(duration(nsecs));
+        }
+        /* still calibrating, the system clock answers meanwhile */
+        const pctk_int64_t nsecs = detail::monotonicNSecs();
+        if (0 == tsc.baseTicks || nsecs - tsc.baseNSecs >= detail::SteadyClockCalibrationNSecs)
+        {
+            detail::recalibrateTsc(state);
+        }
+        return time_point(duration(nsecs));
+    }
+#endif
+    return time_point(duration(detail::monotonicNSecs()));
+}
+
+SteadyClock::time_point SteadyClock::coarseNow() PCTK_NOEXCEPT
+{
+#if defined(PCTK_OS_UNIX) && defined(CLOCK_MONOTONIC_COARSE)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return time_point(duration((pctk_int64_t) ts.tv_sec * PCTK_NSECS_PER_SEC + ts.tv_nsec));
+#else
+    return time_point(duration(detail::monotonicNSecs()));
+#endif
+}
+
+bool SteadyClock::isTscBased() PCTK_NOEXCEPT
+{
+#if defined(PCTK_STEADYCLOCK_TSC)
+    detail::SteadyClockState &state = detail::steadyClockState();
+    return state.invariant && !state.disabled.loadAcquire() && 0 != state.tsc.load().scale;
+#else
+    return false;
+#endif
+}
+
+PCTK_END_NAMESPACE
@@ -0,0 +1,73 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#ifndef _PCTKSTEADYCLOCK_H
+#define _PCTKSTEADYCLOCK_H
+
+#include <pctkGlobal.h>
+
+#include <chrono>
+#include <ratio>
+
+PCTK_BEGIN_NAMESPACE
+
+/**
+ * @brief Monotonic clock in nanoseconds, usable wherever a std::chrono clock is expected.
+ * now() reads the time stamp counter when the CPU has an invariant one and falls back to the system monotonic clock
+ * otherwise. The counter is calibrated against CLOCK_MONOTONIC in the background of ordinary calls, which read the
+ * system clock for the first few milliseconds, and is anchored to it again every second. now() therefore stays within
+ * the rate error of one second, typically microseconds, of CLOCK_MONOTONIC and shares its epoch with coarseNow().
+ */
+class PCTK_CORE_API SteadyClock
+{
+public:
+    typedef pctk_int64_t rep;
+    typedef std::nano period;
+    typedef std::chrono::duration<rep, period> duration;
+    typedef std::chrono::time_point<SteadyClock> time_point;
+
+    static const bool is_steady = true;
+
+    static time_point now() PCTK_NOEXCEPT;
+
+    /**
+     * @brief Cheapest reading at scheduler tick resolution, CLOCK_MONOTONIC_COARSE where the system has it.
+     * Meant for timeout bookkeeping that tolerates a few milliseconds of error.
+     */
+    static time_point coarseNow() PCTK_NOEXCEPT;
+
+    static pctk_int64_t nowNSecs() PCTK_NOEXCEPT { return now().time_since_epoch().count(); }
+
+    /**
+     * @brief Returns true if now() runs from the time stamp counter, which it does a few milliseconds after the first
+     * call on CPUs with an invariant one.
+     */
+    static bool isTscBased() PCTK_NOEXCEPT;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKSTEADYCLOCK_H
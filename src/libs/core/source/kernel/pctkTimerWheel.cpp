@@ -0,0 +1,591 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include <pctkTimerWheel.h>
+#include <pctkHashTable.h>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#if defined(PCTK_OS_UNIX)
+#   include <pthread.h>
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+static const pctk_uint32_t TimerWheelNone = 0xffffffffu;
+
+enum TimerWheelState
+{
+    TimerWheelFree = 0,
+    TimerWheelPending,
+    /* taken off the wheel by expire(), not yet running */
+    TimerWheelFiring,
+    TimerWheelRunning,
+    /* cancelled while firing, the expiring thread releases it */
+    TimerWheelCanceled
+};
+
+/* The expired timer the expiring thread works on, and the one it ran before that still has to be released. */
+struct TimerWheelClaim
+{
+    pctk_uint32_t index;
+    pctk_uint32_t next;
+    pctk_uint32_t done;
+    void (*callback)(void *data);
+    void (*destroy)(void *data);
+    void *data;
+};
+
+static inline pctk_uint64_t rotateRight(pctk_uint64_t value, int count) PCTK_NOEXCEPT
+{
+    return 0 == count ? value : (value >> count) | (value << (64 - count));
+}
+
+static void timerWheelFulfil(void *data)
+{
+    static_cast<Promise<void> *>(data)->setValue();
+}
+
+static void timerWheelDrop(void *data)
+{
+    delete static_cast<Promise<void> *>(data);
+}
+} // namespace detail
+
+TimerWheel::TimerWheel(pctk_int64_t resolutionNSecs)
+    : m_freeList(detail::TimerWheelNone), m_pending(0), m_base(0), m_origin(SteadyClock::nowNSecs()),
+      m_resolution(resolutionNSecs > 0 ? resolutionNSecs : 1), m_wake(0), m_stopping(0), m_sleepUntil(0)
+{
+    for (int i = 0; i < LevelCount; ++i)
+    {
+        m_bitmaps[i] = 0;
+    }
+    for (int i = 0; i < BucketCount; ++i)
+    {
+        m_buckets[i] = detail::TimerWheelNone;
+    }
+}
+
+TimerWheel::~TimerWheel()
+{
+    this->stopThread();
+    for (Vector<detail::TimerWheelNode>::size_type i = 0; i < m_nodes.size(); ++i)
+    {
+        const detail::TimerWheelNode &node = m_nodes[i];
+        if (detail::TimerWheelPending == node.state && node.destroy)
+        {
+            node.destroy(node.data);
+        }
+    }
+}
+
+TimerWheel::TimerId TimerWheel::start(pctk_int64_t delayNSecs, Callback callback, void *data)
+{
+    return this->insert(delayNSecs, callback, PCTK_NULLPTR, data);
+}
+
+Future<void> TimerWheel::after(pctk_int64_t delayNSecs)
+{
+    Promise<void> *promise = new Promise<void>;
+    Future<void> future = promise->future();
+    try
+    {
+        this->insert(delayNSecs, &detail::timerWheelFulfil, &detail::timerWheelDrop, promise);
+    }
+    catch (...)
+    {
+        delete promise;
+        throw;
+    }
+    return future;
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+    Callback destroy = PCTK_NULLPTR;
+    void *data = PCTK_NULLPTR;
+    {
+        LockGuard<Mutex> locker(m_lock);
+        const pctk_uint32_t index = this->lookup(id);
+        if (detail::TimerWheelNone == index)
+        {
+            return false;
+        }
+        detail::TimerWheelNode &node = m_nodes[index];
+        if (detail::TimerWheelFiring == node.state)
+        {
+            node.state = detail::TimerWheelCanceled;
+            return true;
+        }
+        if (detail::TimerWheelPending != node.state)
+        {
+            return false;
+        }
+        this->unlink(index);
+        --m_pending;
+        destroy = node.destroy;
+        data = node.data;
+        this->release(index);
+    }
+    if (destroy)
+    {
+        destroy(data);
+    }
+    return true;
+}
+
+bool TimerWheel::restart(TimerId id, pctk_int64_t delayNSecs)
+{
+    const pctk_uint64_t expires = this->tickAfter(delayNSecs);
+    {
+        LockGuard<Mutex> locker(m_lock);
+        const pctk_uint32_t index = this->lookup(id);
+        if (detail::TimerWheelNone == index || detail::TimerWheelPending != m_nodes[index].state)
+        {
+            return false;
+        }
+        this->unlink(index);
+        m_nodes[index].expires = expires;
+        this->link(index);
+        if (expires >= m_sleepUntil)
+        {
+            return true;
+        }
+        m_sleepUntil = expires;
+    }
+    m_wake.fetchAndAddRelease(1);
+    m_wake.notifyOne();
+    return true;
+}
+
+std::size_t TimerWheel::expire(SteadyClock::time_point now)
+{
+    const pctk_uint64_t target = this->tickAt(now);
+    pctk_uint32_t head = detail::TimerWheelNone;
+    pctk_uint32_t tail = detail::TimerWheelNone;
+    detail::TimerWheelClaim current = {detail::TimerWheelNone, detail::TimerWheelNone, detail::TimerWheelNone,
+                                       PCTK_NULLPTR, PCTK_NULLPTR, PCTK_NULLPTR};
+    {
+        LockGuard<Mutex> locker(m_lock);
+        while (m_base <= target)
+        {
+            if (0 == m_pending)
+            {
+                m_base = target + 1;
+                break;
+            }
+            const int slot = (int) (m_base & (LevelSize - 1));
+            if (0 == slot)
+            {
+                /* a level is cascaded each time the one below wraps around */
+                for (int level = 1; level < LevelCount; ++level)
+                {
+                    const int index = (int) ((m_base >> (LevelBits * level)) & (LevelSize - 1));
+                    this->cascade(level, index);
+                    if (0 != index)
+                    {
+                        break;
+                    }
+                }
+            }
+            const pctk_uint64_t bits = m_bitmaps[0] >> slot;
+            if (0 == bits)
+            {
+                /* nothing left in this turn of the first level, jump to the next cascade */
+                m_base = std::min((m_base | (LevelSize - 1)) + 1, target + 1);
+                continue;
+            }
+            const int skip = detail::countTrailingZeros(bits);
+            if (0 != skip)
+            {
+                m_base = std::min(m_base + skip, target + 1);
+                continue;
+            }
+            pctk_uint32_t index = m_buckets[slot];
+            m_buckets[slot] = detail::TimerWheelNone;
+            m_bitmaps[0] &= ~((pctk_uint64_t) 1 << slot);
+            while (detail::TimerWheelNone != index)
+            {
+                detail::TimerWheelNode &node = m_nodes[index];
+                const pctk_uint32_t next = node.next;
+                node.state = detail::TimerWheelFiring;
+                node.next = detail::TimerWheelNone;
+                if (detail::TimerWheelNone == tail)
+                {
+                    head = index;
+                }
+                else
+                {
+                    m_nodes[tail].next = index;
+                }
+                tail = index;
+                --m_pending;
+                index = next;
+            }
+            ++m_base;
+        }
+        if (detail::TimerWheelNone != head)
+        {
+            this->claim(head, current);
+        }
+    }
+
+    std::size_t fired = 0;
+    while (detail::TimerWheelNone != current.index)
+    {
+        if (current.callback)
+        {
+            current.callback(current.data);
+            ++fired;
+        }
+        if (current.destroy)
+        {
+            current.destroy(current.data);
+        }
+        if (detail::TimerWheelNone == current.next)
+        {
+            break;
+        }
+        /* the lock is taken once per timer to claim it, which also releases the one run before */
+        LockGuard<Mutex> locker(m_lock);
+        this->claim(current.next, current);
+    }
+    if (detail::TimerWheelNone != current.done)
+    {
+        LockGuard<Mutex> locker(m_lock);
+        this->release(current.done);
+    }
+    return fired;
+}
+
+pctk_int64_t TimerWheel::nextTimeout(SteadyClock::time_point now) const
+{
+    pctk_uint64_t tick;
+    {
+        LockGuard<Mutex> locker(m_lock);
+        tick = this->nextTick();
+    }
+    if (~(pctk_uint64_t) 0 == tick)
+    {
+        return -1;
+    }
+    const pctk_int64_t elapsed = now.time_since_epoch().count() - m_origin;
+    if (tick > (pctk_uint64_t) (std::numeric_limits<pctk_int64_t>::max() / m_resolution))
+    {
+        return std::numeric_limits<pctk_int64_t>::max();
+    }
+    const pctk_int64_t remaining = (pctk_int64_t) tick * m_resolution - elapsed;
+    return remaining > 0 ? remaining : 0;
+}
+
+void TimerWheel::startThread(const std::string &name)
+{
+    if (m_thread.joinable())
+    {
+        return;
+    }
+    m_threadName = name;
+    m_stopping.storeRelease(0);
+    m_thread = std::thread(&TimerWheel::threadMain, this);
+}
+
+void TimerWheel::stopThread()
+{
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+    m_stopping.storeRelease(1);
+    m_wake.fetchAndAddRelease(1);
+    m_wake.notifyAll();
+    m_thread.join();
+    LockGuard<Mutex> locker(m_lock);
+    m_sleepUntil = 0;
+}
+
+std::size_t TimerWheel::size() const
+{
+    LockGuard<Mutex> locker(m_lock);
+    return m_pending;
+}
+
+TimerWheel::TimerId TimerWheel::insert(pctk_int64_t delayNSecs, Callback callback, Callback destroy, void *data)
+{
+    const pctk_uint64_t expires = this->tickAfter(delayNSecs);
+    TimerId id;
+    {
+        LockGuard<Mutex> locker(m_lock);
+        const pctk_uint32_t index = this->allocate();
+        detail::TimerWheelNode &node = m_nodes[index];
+        node.expires = expires;
+        node.callback = callback;
+        node.destroy = destroy;
+        node.data = data;
+        node.state = detail::TimerWheelPending;
+        this->link(index);
+        ++m_pending;
+        id = ((TimerId) node.generation << 32) | (TimerId) (index + 1);
+        if (expires >= m_sleepUntil)
+        {
+            return id;
+        }
+        m_sleepUntil = expires;
+    }
+    /* the expiry thread sleeps past the new timer */
+    m_wake.fetchAndAddRelease(1);
+    m_wake.notifyOne();
+    return id;
+}
+
+pctk_uint64_t TimerWheel::tickAfter(pctk_int64_t delayNSecs) const PCTK_NOEXCEPT
+{
+    /* round up so that a timer never fires before its delay has passed */
+    const pctk_int64_t elapsed = SteadyClock::nowNSecs() - m_origin + (delayNSecs > 0 ? delayNSecs : 0);
+    return elapsed > 0 ? ((pctk_uint64_t) elapsed + m_resolution - 1) / m_resolution : 0;
+}
+
+pctk_uint64_t TimerWheel::tickAt(SteadyClock::time_point now) const PCTK_NOEXCEPT
+{
+    const pctk_int64_t elapsed = now.time_since_epoch().count() - m_origin;
+    return elapsed > 0 ? (pctk_uint64_t) elapsed / m_resolution : 0;
+}
+
+pctk_uint64_t TimerWheel::nextTick() const PCTK_NOEXCEPT
+{
+    pctk_uint64_t best = ~(pctk_uint64_t) 0;
+    if (0 == m_pending)
+    {
+        return best;
+    }
+    /* the first level is exact, slot s holds the timers of the tick at distance (s - base) modulo its size */
+    if (m_bitmaps[0])
+    {
+        const int slot = (int) (m_base & (LevelSize - 1));
+        best = m_base + detail::countTrailingZeros(detail::rotateRight(m_bitmaps[0], slot));
+    }
+    /* higher levels only tell when their nearest bucket is cascaded, which is a lower bound of its timers */
+    for (int level = 1; level < LevelCount; ++level)
+    {
+        if (!m_bitmaps[level])
+        {
+            continue;
+        }
+        const int shift = LevelBits * level;
+        const pctk_uint64_t unit = (m_base + ((pctk_uint64_t) 1 << shift) - 1) >> shift;
+        const int position = (int) (unit & (LevelSize - 1));
+        const pctk_uint64_t tick = (unit + detail::countTrailingZeros(detail::rotateRight(m_bitmaps[level], position)))
+                                   << shift;
+        if (tick < best)
+        {
+            best = tick;
+        }
+    }
+    return best;
+}
+
+void TimerWheel::claim(pctk_uint32_t index, detail::TimerWheelClaim &claim) PCTK_NOEXCEPT
+{
+    if (detail::TimerWheelNone != claim.done)
+    {
+        this->release(claim.done);
+    }
+    detail::TimerWheelNode &node = m_nodes[index];
+    claim.index = index;
+    claim.next = node.next;
+    claim.destroy = node.destroy;
+    claim.data = node.data;
+    if (detail::TimerWheelFiring == node.state)
+    {
+        node.state = detail::TimerWheelRunning;
+        claim.callback = node.callback;
+        claim.done = index;
+    }
+    else
+    {
+        /* cancelled after it was taken off the wheel, only its data is destroyed */
+        this->release(index);
+        claim.callback = PCTK_NULLPTR;
+        claim.done = detail::TimerWheelNone;
+    }
+}
+
+pctk_uint32_t TimerWheel::lookup(TimerId id) const PCTK_NOEXCEPT
+{
+    const pctk_uint64_t slot = id & 0xffffffffu;
+    if (0 == slot || slot > m_nodes.size())
+    {
+        return detail::TimerWheelNone;
+    }
+    const pctk_uint32_t index = (pctk_uint32_t) (slot - 1);
+    const detail::TimerWheelNode &node = m_nodes[index];
+    if (node.generation != (pctk_uint32_t) (id >> 32) || detail::TimerWheelFree == node.state)
+    {
+        return detail::TimerWheelNone;
+    }
+    return index;
+}
+
+pctk_uint32_t TimerWheel::allocate()
+{
+    if (detail::TimerWheelNone != m_freeList)
+    {
+        const pctk_uint32_t index = m_freeList;
+        m_freeList = m_nodes[index].next;
+        return index;
+    }
+    if (m_nodes.size() >= (Vector<detail::TimerWheelNode>::size_type) detail::TimerWheelNone)
+    {
+        throw std::length_error("TimerWheel: too many pending timers");
+    }
+    detail::TimerWheelNode node;
+    node.expires = 0;
+    node.callback = PCTK_NULLPTR;
+    node.destroy = PCTK_NULLPTR;
+    node.data = PCTK_NULLPTR;
+    node.prev = detail::TimerWheelNone;
+    node.next = detail::TimerWheelNone;
+    node.generation = 1;
+    node.bucket = 0;
+    node.state = detail::TimerWheelFree;
+    m_nodes.push_back(node);
+    return (pctk_uint32_t) (m_nodes.size() - 1);
+}
+
+void TimerWheel::release(pctk_uint32_t index) PCTK_NOEXCEPT
+{
+    detail::TimerWheelNode &node = m_nodes[index];
+    node.state = detail::TimerWheelFree;
+    ++node.generation;
+    node.next = m_freeList;
+    m_freeList = index;
+}
+
+void TimerWheel::link(pctk_uint32_t index) PCTK_NOEXCEPT
+{
+    detail::TimerWheelNode &node = m_nodes[index];
+    /* overdue timers go to the bucket processed next */
+    pctk_uint64_t expires = node.expires < m_base ? m_base : node.expires;
+    const pctk_uint64_t delta = expires - m_base;
+    int level = 0;
+    while (level < LevelCount - 1 && delta >= ((pctk_uint64_t) 1 << (LevelBits * (level + 1))))
+    {
+        ++level;
+    }
+    if (delta >= ((pctk_uint64_t) 1 << (LevelBits * LevelCount)))
+    {
+        /* beyond the last level, parked at its end and cascaded again from there */
+        expires = m_base + ((pctk_uint64_t) 1 << (LevelBits * LevelCount)) - 1;
+    }
+    const int slot = (int) ((expires >> (LevelBits * level)) & (LevelSize - 1));
+    const int bucket = level * LevelSize + slot;
+    node.bucket = (pctk_uint16_t) bucket;
+    node.prev = detail::TimerWheelNone;
+    node.next = m_buckets[bucket];
+    if (detail::TimerWheelNone != node.next)
+    {
+        m_nodes[node.next].prev = index;
+    }
+    m_buckets[bucket] = index;
+    m_bitmaps[level] |= (pctk_uint64_t) 1 << slot;
+}
+
+void TimerWheel::unlink(pctk_uint32_t index) PCTK_NOEXCEPT
+{
+    detail::TimerWheelNode &node = m_nodes[index];
+    const int bucket = node.bucket;
+    if (detail::TimerWheelNone != node.prev)
+    {
+        m_nodes[node.prev].next = node.next;
+    }
+    else
+    {
+        m_buckets[bucket] = node.next;
+    }
+    if (detail::TimerWheelNone != node.next)
+    {
+        m_nodes[node.next].prev = node.prev;
+    }
+    if (detail::TimerWheelNone == m_buckets[bucket])
+    {
+        m_bitmaps[bucket / LevelSize] &= ~((pctk_uint64_t) 1 << (bucket % LevelSize));
+    }
+}
+
+void TimerWheel::cascade(int level, int slot) PCTK_NOEXCEPT
+{
+    const int bucket = level * LevelSize + slot;
+    pctk_uint32_t index = m_buckets[bucket];
+    m_buckets[bucket] = detail::TimerWheelNone;
+    m_bitmaps[level] &= ~((pctk_uint64_t) 1 << slot);
+    while (detail::TimerWheelNone != index)
+    {
+        const pctk_uint32_t next = m_nodes[index].next;
+        this->link(index);
+        index = next;
+    }
+}
+
+void TimerWheel::threadMain()
+{
+#if defined(PCTK_OS_UNIX) && PCTK_HAS_PTHREAD_SETNAME_NP
+    /* Linux limits thread names to 15 characters */
+    const std::string name = m_threadName.substr(0, 15);
+#   if defined(PCTK_OS_DARWIN)
+    pthread_setname_np(name.c_str());
+#   else
+    pthread_setname_np(pthread_self(), name.c_str());
+#   endif
+#endif
+    while (!m_stopping.loadAcquire())
+    {
+        const int wake = m_wake.loadAcquire();
+        this->expire(SteadyClock::now());
+        pctk_uint64_t tick;
+        {
+            LockGuard<Mutex> locker(m_lock);
+            tick = this->nextTick();
+            m_sleepUntil = tick;
+        }
+        if (~(pctk_uint64_t) 0 == tick)
+        {
+            m_wake.wait(wake);
+            continue;
+        }
+        const pctk_int64_t elapsed = SteadyClock::nowNSecs() - m_origin;
+        const pctk_int64_t remaining = (pctk_int64_t) std::min(
+            tick, (pctk_uint64_t) (std::numeric_limits<pctk_int64_t>::max() / m_resolution)) * m_resolution - elapsed;
+        if (remaining > 0)
+        {
+            m_wake.waitFor(wake, remaining);
+        }
+    }
+}
+
+PCTK_END_NAMESPACE
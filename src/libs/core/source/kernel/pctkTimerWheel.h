@@ -0,0 +1,214 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#ifndef _PCTKTIMERWHEEL_H
+#define _PCTKTIMERWHEEL_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+#include <pctkFuture.h>
+#include <pctkMutex.h>
+#include <pctkSteadyClock.h>
+#include <pctkVector.h>
+
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* One timer slot, linked by index into its wheel bucket so the node array may grow while timers are pending. */
+struct TimerWheelNode
+{
+    pctk_uint64_t expires;
+    void (*callback)(void *data);
+    void (*destroy)(void *data);
+    void *data;
+    pctk_uint32_t prev;
+    pctk_uint32_t next;
+    pctk_uint32_t generation;
+    pctk_uint16_t bucket;
+    pctk_uint8_t state;
+};
+
+struct TimerWheelClaim;
+
+template<typename F>
+struct TimerWheelFunctor
+{
+    template<typename U>
+    explicit TimerWheelFunctor(U &&f) : func(std::forward<U>(f)) {}
+
+    static void invoke(void *data) { static_cast<TimerWheelFunctor *>(data)->func(); }
+    static void destroy(void *data) { delete static_cast<TimerWheelFunctor *>(data); }
+
+    F func;
+};
+} // namespace detail
+
+/**
+ * @brief Hierarchical timing wheel (Varghese and Lauck) for large numbers of timeouts, such as per connection idle
+ * and request deadlines. start(), cancel() and restart() are O(1), expiry costs O(1) amortized per timer plus one
+ * step per 64 empty ticks. Time is quantized to the resolution given at construction, a timer never fires early and
+ * fires at most one tick late plus the delay of whoever drives the wheel.
+ *
+ * The wheel is driven either by its own thread, see startThread(), or by an event loop that sleeps for
+ * nextTimeout() and then calls expire(). Callbacks run on the driving thread without the wheel's lock held, so they
+ * may start, restart and cancel timers, and must not throw. All members are thread-safe.
+ */
+class PCTK_CORE_API TimerWheel
+{
+public:
+    /* 0 never names a timer, identifiers of fired or cancelled timers are not reused for a long time */
+    typedef pctk_uint64_t TimerId;
+    typedef void (*Callback)(void *data);
+
+    /**
+     * @brief Creates an empty wheel with a tick of resolutionNSecs nanoseconds, one millisecond by default.
+     */
+    explicit TimerWheel(pctk_int64_t resolutionNSecs = PCTK_NSECS_PER_MSEC);
+
+    /**
+     * @brief Stops the expiry thread and drops pending timers without running them.
+     */
+    ~TimerWheel();
+
+    /**
+     * @brief Runs callback(data) once delayNSecs nanoseconds have passed.
+     */
+    TimerId start(pctk_int64_t delayNSecs, Callback callback, void *data);
+
+    /**
+     * @brief Runs func() once delayNSecs nanoseconds have passed, func is moved or copied into a heap allocation.
+     */
+    template<typename F>
+    TimerId start(pctk_int64_t delayNSecs, F &&func)
+    {
+        typedef detail::TimerWheelFunctor<typename std::decay<F>::type> Functor;
+        Functor *functor = new Functor(std::forward<F>(func));
+        try
+        {
+            return this->insert(delayNSecs, &Functor::invoke, &Functor::destroy, functor);
+        }
+        catch (...)
+        {
+            delete functor;
+            throw;
+        }
+    }
+
+    /**
+     * @brief Returns a future that becomes ready once delayNSecs nanoseconds have passed, awaitable from a Task.
+     * Destroying the wheel first fails it with std::future_errc::broken_promise.
+     */
+    Future<void> after(pctk_int64_t delayNSecs);
+
+    /**
+     * @brief Cancels a pending timer, returns false if it already ran, is running or is unknown.
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief Moves a pending timer to delayNSecs from now, cheaper than cancel() and start() for idle timeouts that
+     * are pushed back on every activity. Returns false if the timer is no longer pending.
+     */
+    bool restart(TimerId id, pctk_int64_t delayNSecs);
+
+    /**
+     * @brief Runs every timer due at now and returns how many ran.
+     */
+    std::size_t expire(SteadyClock::time_point now = SteadyClock::now());
+
+    /**
+     * @brief Nanoseconds from now until the wheel next needs expire(), 0 if timers are due, -1 without timers.
+     * The value may be early when the nearest timers still sit in a coarse level, expire() then just cascades them.
+     */
+    pctk_int64_t nextTimeout(SteadyClock::time_point now = SteadyClock::now()) const;
+
+    /**
+     * @brief Starts a thread named name that drives the wheel until stopThread() or destruction.
+     */
+    void startThread(const std::string &name = "pctkTimer");
+    void stopThread();
+
+    /**
+     * @brief Number of pending timers.
+     */
+    std::size_t size() const;
+
+    pctk_int64_t resolution() const PCTK_NOEXCEPT { return m_resolution; }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(TimerWheel)
+
+    enum
+    {
+        LevelBits = 6,
+        LevelSize = 1 << LevelBits,
+        LevelCount = 8,
+        BucketCount = LevelSize * LevelCount
+    };
+
+    TimerId insert(pctk_int64_t delayNSecs, Callback callback, Callback destroy, void *data);
+    pctk_uint64_t tickAfter(pctk_int64_t delayNSecs) const PCTK_NOEXCEPT;
+    pctk_uint64_t tickAt(SteadyClock::time_point now) const PCTK_NOEXCEPT;
+    pctk_uint64_t nextTick() const PCTK_NOEXCEPT;
+    pctk_uint32_t lookup(TimerId id) const PCTK_NOEXCEPT;
+    pctk_uint32_t allocate();
+    void release(pctk_uint32_t index) PCTK_NOEXCEPT;
+    void link(pctk_uint32_t index) PCTK_NOEXCEPT;
+    void unlink(pctk_uint32_t index) PCTK_NOEXCEPT;
+    void cascade(int level, int slot) PCTK_NOEXCEPT;
+    void claim(pctk_uint32_t index, detail::TimerWheelClaim &claim) PCTK_NOEXCEPT;
+    void wakeIfEarlier(pctk_uint64_t expires) PCTK_NOEXCEPT;
+    void threadMain();
+
+    mutable Mutex m_lock;
+    Vector<detail::TimerWheelNode> m_nodes;
+    pctk_uint32_t m_freeList;
+    std::size_t m_pending;
+
+    /* next tick to process, ticks count resolution sized steps from m_origin */
+    pctk_uint64_t m_base;
+    pctk_int64_t m_origin;
+    const pctk_int64_t m_resolution;
+    pctk_uint64_t m_bitmaps[LevelCount];
+    pctk_uint32_t m_buckets[BucketCount];
+
+    /* expiry thread state, m_sleepUntil is the tick the thread sleeps until and is guarded by m_lock */
+    std::thread m_thread;
+    AtomicInt m_wake;
+    AtomicInt m_stopping;
+    pctk_uint64_t m_sleepUntil;
+    std::string m_threadName;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKTIMERWHEEL_H
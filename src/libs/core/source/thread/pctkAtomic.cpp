@@ -0,0 +1,234 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkAtomic.h>
+
+#include <atomic>
+
+#if defined(PCTK_OS_LINUX) && !defined(PCTK_ATOMIC_WAIT_PARKING_LOT)
+#   define PCTK_ATOMIC_WAIT_FUTEX
+#   include <linux/futex.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#   include <cerrno>
+#   include <ctime>
+#elif defined(PCTK_OS_WIN) && !defined(PCTK_ATOMIC_WAIT_PARKING_LOT)
+#   define PCTK_ATOMIC_WAIT_WIN32
+#   include <windows.h>
+#else
+#   define PCTK_ATOMIC_WAIT_PTHREAD
+#   include <pthread.h>
+#   include <cerrno>
+#   include <ctime>
+#   include <sys/time.h>
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* Every waited address hashes to one bucket. The waiter count lets notify skip the syscall when nobody sleeps. */
+struct AtomicWaitBucket
+{
+    std::atomic<int> waiters;
+#if defined(PCTK_ATOMIC_WAIT_PTHREAD)
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+#endif
+};
+
+static const int sg_atomicWaitBucketCount = 64;
+
+struct PCTK_ALIGN(PCTK_CACHELINE_SIZE) AtomicWaitPaddedBucket
+{
+    AtomicWaitBucket bucket;
+};
+
+static AtomicWaitBucket &atomicWaitBucket(const void *address) PCTK_NOEXCEPT
+{
+    static AtomicWaitPaddedBucket buckets[sg_atomicWaitBucketCount];
+#if defined(PCTK_ATOMIC_WAIT_PTHREAD)
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    struct Init
+    {
+        static void run()
+        {
+            pthread_condattr_t attr;
+            pthread_condattr_init(&attr);
+#   if PCTK_HAS_PTHREAD_CONDATTR_SETCLOCK
+            pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+#   endif
+            for (int i = 0; i < sg_atomicWaitBucketCount; ++i)
+            {
+                pthread_mutex_init(&buckets[i].bucket.mutex, PCTK_NULLPTR);
+                pthread_cond_init(&buckets[i].bucket.cond, &attr);
+            }
+            pthread_condattr_destroy(&attr);
+        }
+    };
+    pthread_once(&once, &Init::run);
+#endif
+    const pctk_uintptr_t key = (pctk_uintptr_t) address;
+    return buckets[((key >> 2) ^ (key >> 8)) % sg_atomicWaitBucketCount].bucket;
+}
+
+static inline int atomicWaitLoad(const void *address) PCTK_NOEXCEPT
+{
+    return reinterpret_cast<const std::atomic<int> *>(address)->load(std::memory_order_acquire);
+}
+
+#if defined(PCTK_ATOMIC_WAIT_FUTEX) || defined(PCTK_ATOMIC_WAIT_PTHREAD)
+static inline pctk_int64_t atomicWaitNow() PCTK_NOEXCEPT
+{
+    struct timespec ts;
+#   if defined(PCTK_ATOMIC_WAIT_PTHREAD) && !PCTK_HAS_PTHREAD_CONDATTR_SETCLOCK
+    /* condition variables measure against the realtime clock without pthread_condattr_setclock */
+    clock_gettime(CLOCK_REALTIME, &ts);
+#   else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#   endif
+    return (pctk_int64_t) ts.tv_sec * PCTK_NSECS_PER_SEC + ts.tv_nsec;
+}
+
+static inline struct timespec atomicWaitTimespec(pctk_int64_t nsecs) PCTK_NOEXCEPT
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t) (nsecs / PCTK_NSECS_PER_SEC);
+    ts.tv_nsec = (long) (nsecs % PCTK_NSECS_PER_SEC);
+    return ts;
+}
+#endif
+
+#if defined(PCTK_ATOMIC_WAIT_FUTEX)
+static inline long atomicFutex(const void *address, int op, int value, const struct timespec *timeout) PCTK_NOEXCEPT
+{
+    return syscall(SYS_futex, address, op, value, timeout, PCTK_NULLPTR, 0);
+}
+#endif
+
+bool atomicWait(const void *address, int old, pctk_int64_t timeoutNSecs) PCTK_NOEXCEPT
+{
+    AtomicWaitBucket &bucket = atomicWaitBucket(address);
+    /* seq_cst increment pairs with the fence in notify: either the notifier sees us or we see its store */
+    bucket.waiters.fetch_add(1, std::memory_order_seq_cst);
+    bool changed = true;
+#if defined(PCTK_ATOMIC_WAIT_FUTEX)
+    const pctk_int64_t deadline = timeoutNSecs < 0 ? -1 : atomicWaitNow() + timeoutNSecs;
+    while (atomicWaitLoad(address) == old)
+    {
+        if (deadline < 0)
+        {
+            atomicFutex(address, FUTEX_WAIT_PRIVATE, old, PCTK_NULLPTR);
+            continue;
+        }
+        const pctk_int64_t remaining = deadline - atomicWaitNow();
+        if (remaining <= 0)
+        {
+            changed = false;
+            break;
+        }
+        const struct timespec timeout = atomicWaitTimespec(remaining);
+        atomicFutex(address, FUTEX_WAIT_PRIVATE, old, &timeout);
+    }
+#elif defined(PCTK_ATOMIC_WAIT_WIN32)
+    const ULONGLONG deadline = timeoutNSecs < 0 ? 0 : GetTickCount64() + timeoutNSecs / PCTK_NSECS_PER_MSEC;
+    while (atomicWaitLoad(address) == old)
+    {
+        DWORD timeout = INFINITE;
+        if (timeoutNSecs >= 0)
+        {
+            const ULONGLONG now = GetTickCount64();
+            if (now >= deadline)
+            {
+                changed = false;
+                break;
+            }
+            timeout = (DWORD) (deadline - now);
+        }
+        WaitOnAddress(const_cast<void *>(address), &old, sizeof(int), timeout);
+    }
+#else
+    const pctk_int64_t deadline = timeoutNSecs < 0 ? -1 : atomicWaitNow() + timeoutNSecs;
+    pthread_mutex_lock(&bucket.mutex);
+    while (atomicWaitLoad(address) == old)
+    {
+        if (deadline < 0)
+        {
+            pthread_cond_wait(&bucket.cond, &bucket.mutex);
+            continue;
+        }
+        const struct timespec abstime = atomicWaitTimespec(deadline);
+        if (ETIMEDOUT == pthread_cond_timedwait(&bucket.cond, &bucket.mutex, &abstime))
+        {
+            changed = atomicWaitLoad(address) != old;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&bucket.mutex);
+#endif
+    bucket.waiters.fetch_sub(1, std::memory_order_relaxed);
+    return changed;
+}
+
+static inline void atomicNotify(const void *address, bool all) PCTK_NOEXCEPT
+{
+    AtomicWaitBucket &bucket = atomicWaitBucket(address);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (0 == bucket.waiters.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+#if defined(PCTK_ATOMIC_WAIT_FUTEX)
+    atomicFutex(address, FUTEX_WAKE_PRIVATE, all ? PCTK_INT_MAX : 1, PCTK_NULLPTR);
+#elif defined(PCTK_ATOMIC_WAIT_WIN32)
+    if (all)
+    {
+        WakeByAddressAll(const_cast<void *>(address));
+    }
+    else
+    {
+        WakeByAddressSingle(const_cast<void *>(address));
+    }
+#else
+    /* the bucket is shared between addresses, waking a single thread could pick an unrelated waiter */
+    PCTK_UNUSED(all);
+    pthread_mutex_lock(&bucket.mutex);
+    pthread_mutex_unlock(&bucket.mutex);
+    pthread_cond_broadcast(&bucket.cond);
+#endif
+}
+
+void atomicNotifyOne(const void *address) PCTK_NOEXCEPT
+{
+    atomicNotify(address, false);
+}
+
+void atomicNotifyAll(const void *address) PCTK_NOEXCEPT
+{
+    atomicNotify(address, true);
+}
+} // namespace detail
+
+PCTK_END_NAMESPACE
@@ -1,6 +1,6 @@
 /***********************************************************************************************************************
 **
-** Library: UTK
+** Library: PCTK
 **
 ** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
 **
@@ -22,202 +22,482 @@
 **
 ***********************************************************************************************************************/
 
+
 #ifndef _PCTKATOMIC_H
 #define _PCTKATOMIC_H
 
 #include <pctkGlobal.h>
+#include <pctkTypeTraits.h>
+
+#if defined(PCTK_CC_MSVC)
+#   include <intrin.h>
+#endif
+
+/* Atomic backend, may be forced by defining PCTK_ATOMIC_BACKEND to one of the values below before inclusion. */
+#define PCTK_ATOMIC_BACKEND_CXX11 1
+#define PCTK_ATOMIC_BACKEND_C11   2
+#define PCTK_ATOMIC_BACKEND_GCC   3
+#define PCTK_ATOMIC_BACKEND_MSVC  4
+#define PCTK_ATOMIC_BACKEND_POSIX 5
+
+#ifndef PCTK_ATOMIC_BACKEND
+#   if PCTK_FEATURE_STDCXX_ATOMIC
+#       define PCTK_ATOMIC_BACKEND PCTK_ATOMIC_BACKEND_CXX11
+#   elif PCTK_FEATURE_STDC_ATOMIC && PCTK_CC_HAS_BUILTIN(__c11_atomic_load)
+#       define PCTK_ATOMIC_BACKEND PCTK_ATOMIC_BACKEND_C11
+#   elif defined(PCTK_CC_GNU)
+#       define PCTK_ATOMIC_BACKEND PCTK_ATOMIC_BACKEND_GCC
+#   elif defined(PCTK_CC_MSVC)
+#       define PCTK_ATOMIC_BACKEND PCTK_ATOMIC_BACKEND_MSVC
+#   else
+#       define PCTK_ATOMIC_BACKEND PCTK_ATOMIC_BACKEND_POSIX
+#   endif
+#endif
 
 PCTK_BEGIN_NAMESPACE
 
-class AtomicIntPrivate;
-class PCTK_CORE_API AtomicInt
+namespace detail
+{
+enum AtomicOrder
 {
+    AtomicRelaxed,
+    AtomicAcquire,
+    AtomicRelease,
+    AtomicOrdered
+};
+
+/* Address based blocking used by AtomicInt::wait()/notify*(), futex on Linux, parking lot elsewhere. */
+PCTK_CORE_API bool atomicWait(const void *address, int old, pctk_int64_t timeoutNSecs) PCTK_NOEXCEPT;
+PCTK_CORE_API void atomicNotifyOne(const void *address) PCTK_NOEXCEPT;
+PCTK_CORE_API void atomicNotifyAll(const void *address) PCTK_NOEXCEPT;
+
+/* Busy-wait hint for spin loops, lets the sibling hyper-thread run and saves power while spinning. */
+PCTK_FORCE_INLINE void cpuRelax() PCTK_NOEXCEPT
+{
+#if defined(PCTK_CC_MSVC) && (defined(PCTK_PROCESSOR_X86) || defined(PCTK_PROCESSOR_X86_64))
+    _mm_pause();
+#elif defined(PCTK_CC_MSVC) && (defined(PCTK_PROCESSOR_ARM) || defined(PCTK_PROCESSOR_ARM_64))
+    __yield();
+#elif defined(PCTK_CC_GNU) && (defined(__i386__) || defined(__x86_64__))
+    __builtin_ia32_pause();
+#elif defined(PCTK_CC_GNU) && (defined(__arm__) || defined(__aarch64__))
+    __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+} // namespace detail
+
+PCTK_END_NAMESPACE
+
+#if PCTK_ATOMIC_BACKEND == PCTK_ATOMIC_BACKEND_CXX11
+#   include "pctkAtomic_cxx11.h"
+#elif PCTK_ATOMIC_BACKEND == PCTK_ATOMIC_BACKEND_C11
+#   include "pctkAtomic_c11.h"
+#elif PCTK_ATOMIC_BACKEND == PCTK_ATOMIC_BACKEND_GCC
+#   include "pctkAtomic_gcc.h"
+#elif PCTK_ATOMIC_BACKEND == PCTK_ATOMIC_BACKEND_MSVC
+#   include "pctkAtomic_msvc.h"
+#elif PCTK_ATOMIC_BACKEND == PCTK_ATOMIC_BACKEND_POSIX
+#   include "pctkAtomic_posix.h"
+#else
+#   error "Unknown PCTK_ATOMIC_BACKEND"
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+/**
+ * @brief Header only atomic integer for every integral type of pctkTypes.h. The atomic word is the whole object, so
+ * sizeof(AtomicInteger<T>) == sizeof(T) and no operation allocates or leaves the caller's translation unit.
+ */
+template<typename T>
+class AtomicInteger
+{
+    PCTK_STATIC_ASSERT_X(TypeIsIntegral<T>::value && !(TypeIsSame<T, bool>::value),
+                         "AtomicInteger only supports integral types other than bool");
+    typedef detail::AtomicOps<T> Ops;
+
 public:
-    AtomicInt() PCTK_NOEXCEPT;
-    explicit AtomicInt(int val) PCTK_NOEXCEPT;
-    AtomicInt(const AtomicInt &other) PCTK_NOEXCEPT;
-    virtual ~AtomicInt();
+    typedef T Type;
 
-    operator int() const PCTK_NOEXCEPT { return this->load(); }
+    PCTK_CONSTEXPR AtomicInteger() PCTK_NOEXCEPT : m_value(0) {}
+    PCTK_CONSTEXPR explicit AtomicInteger(T val) PCTK_NOEXCEPT : m_value(val) {}
+    AtomicInteger(const AtomicInteger &other) PCTK_NOEXCEPT : m_value(other.loadAcquire()) {}
 
-    AtomicInt &operator=(int val) PCTK_NOEXCEPT
+    /**
+     * @brief Returns true if every operation on this type is lock free with the selected backend, known at compile
+     * time.
+     */
+    static PCTK_CONSTEXPR bool isLockFree() PCTK_NOEXCEPT { return Ops::IsAlwaysLockFree; }
+
+    operator T() const PCTK_NOEXCEPT { return this->load(); }
+
+    AtomicInteger &operator=(T val) PCTK_NOEXCEPT
     {
         this->storeRelease(val);
         return *this;
     }
 
-    inline AtomicInt &operator=(const AtomicInt &other) PCTK_NOEXCEPT
+    inline AtomicInteger &operator=(const AtomicInteger &other) PCTK_NOEXCEPT
     {
         this->storeRelease(other.loadAcquire());
         return *this;
     }
 
-    bool operator==(const AtomicInt &other) const PCTK_NOEXCEPT { return this->loadAcquire() == other.loadAcquire(); }
+    bool operator==(const AtomicInteger &other) const PCTK_NOEXCEPT
+    {
+        return this->loadAcquire() == other.loadAcquire();
+    }
 
-    bool operator!=(const AtomicInt &other) const PCTK_NOEXCEPT { return this->loadAcquire() != other.loadAcquire(); }
+    bool operator!=(const AtomicInteger &other) const PCTK_NOEXCEPT
+    {
+        return this->loadAcquire() != other.loadAcquire();
+    }
 
-    int operator++() PCTK_NOEXCEPT { return this->fetchAndAddOrdered(1) + 1; }
+    T operator++() PCTK_NOEXCEPT { return T(this->fetchAndAddOrdered(1) + 1); }
 
-    int operator++(int) PCTK_NOEXCEPT { return this->fetchAndAddOrdered(1); }
+    T operator++(int) PCTK_NOEXCEPT { return this->fetchAndAddOrdered(1); }
 
-    int operator--() PCTK_NOEXCEPT { return this->fetchAndSubOrdered(1) - 1; }
+    T operator--() PCTK_NOEXCEPT { return T(this->fetchAndSubOrdered(1) - 1); }
 
-    int operator--(int) PCTK_NOEXCEPT { return this->fetchAndSubOrdered(1); }
+    T operator--(int) PCTK_NOEXCEPT { return this->fetchAndSubOrdered(1); }
 
-    int operator+=(int arg) PCTK_NOEXCEPT { return this->fetchAndAddOrdered(arg) + arg; }
+    T operator+=(T arg) PCTK_NOEXCEPT { return T(this->fetchAndAddOrdered(arg) + arg); }
 
-    int operator-=(int arg) PCTK_NOEXCEPT { return this->fetchAndSubOrdered(arg) - arg; }
+    T operator-=(T arg) PCTK_NOEXCEPT { return T(this->fetchAndSubOrdered(arg) - arg); }
 
-    int operator|=(int arg) PCTK_NOEXCEPT { return this->fetchAndOrOrdered(arg) | arg; }
+    T operator|=(T arg) PCTK_NOEXCEPT { return T(this->fetchAndOrOrdered(arg) | arg); }
 
-    int operator&=(int arg) PCTK_NOEXCEPT { return this->fetchAndAndOrdered(arg) & arg; }
+    T operator&=(T arg) PCTK_NOEXCEPT { return T(this->fetchAndAndOrdered(arg) & arg); }
 
-    int operator^=(int arg) PCTK_NOEXCEPT { return this->fetchAndXorOrdered(arg) ^ arg; }
+    T operator^=(T arg) PCTK_NOEXCEPT { return T(this->fetchAndXorOrdered(arg) ^ arg); }
 
-    bool ref() PCTK_NOEXCEPT;
+    bool ref() PCTK_NOEXCEPT { return Ops::template fetchAndAdd<detail::AtomicOrdered>(m_value, 1) != T(-1); }
 
-    bool deref() PCTK_NOEXCEPT;
+    bool deref() PCTK_NOEXCEPT { return Ops::template fetchAndSub<detail::AtomicOrdered>(m_value, 1) != T(1); }
 
-    int load() const PCTK_NOEXCEPT;
+    T load() const PCTK_NOEXCEPT { return Ops::template load<detail::AtomicRelaxed>(m_value); }
 
-    int loadAcquire() const PCTK_NOEXCEPT;
+    T loadAcquire() const PCTK_NOEXCEPT { return Ops::template load<detail::AtomicAcquire>(m_value); }
 
-    void store(int desired) PCTK_NOEXCEPT;
+    void store(T desired) PCTK_NOEXCEPT { Ops::template store<detail::AtomicRelaxed>(m_value, desired); }
 
-    void storeRelease(int desired) PCTK_NOEXCEPT;
+    void storeRelease(T desired) PCTK_NOEXCEPT { Ops::template store<detail::AtomicRelease>(m_value, desired); }
 
-    bool testAndSetRelaxed(int expected, int desired) PCTK_NOEXCEPT;
+    bool testAndSetRelaxed(T expected, T desired) PCTK_NOEXCEPT
+    {
+        return Ops::template testAndSet<detail::AtomicRelaxed>(m_value, expected, desired);
+    }
 
-    bool testAndSetAcquire(int expected, int desired) PCTK_NOEXCEPT;
+    bool testAndSetAcquire(T expected, T desired) PCTK_NOEXCEPT
+    {
+        return Ops::template testAndSet<detail::AtomicAcquire>(m_value, expected, desired);
+    }
 
-    bool testAndSetRelease(int expected, int desired) PCTK_NOEXCEPT;
+    bool testAndSetRelease(T expected, T desired) PCTK_NOEXCEPT
+    {
+        return Ops::template testAndSet<detail::AtomicRelease>(m_value, expected, desired);
+    }
 
-    bool testAndSetOrdered(int expected, int desired) PCTK_NOEXCEPT;
+    bool testAndSetOrdered(T expected, T desired) PCTK_NOEXCEPT
+    {
+        return Ops::template testAndSet<detail::AtomicOrdered>(m_value, expected, desired);
+    }
 
-    int fetchAndStoreRelaxed(int desired) PCTK_NOEXCEPT;
+    T fetchAndStoreRelaxed(T desired) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndStore<detail::AtomicRelaxed>(m_value, desired);
+    }
 
-    int fetchAndStoreAcquire(int desired) PCTK_NOEXCEPT;
+    T fetchAndStoreAcquire(T desired) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndStore<detail::AtomicAcquire>(m_value, desired);
+    }
 
-    int fetchAndStoreRelease(int desired) PCTK_NOEXCEPT;
+    T fetchAndStoreRelease(T desired) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndStore<detail::AtomicRelease>(m_value, desired);
+    }
 
-    int fetchAndStoreOrdered(int desired) PCTK_NOEXCEPT;
+    T fetchAndStoreOrdered(T desired) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndStore<detail::AtomicOrdered>(m_value, desired);
+    }
 
-    int fetchAndAddRelaxed(int arg) PCTK_NOEXCEPT;
+    T fetchAndAddRelaxed(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndAdd<detail::AtomicRelaxed>(m_value, arg);
+    }
 
-    int fetchAndAddAcquire(int arg) PCTK_NOEXCEPT;
+    T fetchAndAddAcquire(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndAdd<detail::AtomicAcquire>(m_value, arg);
+    }
 
-    int fetchAndAddRelease(int arg) PCTK_NOEXCEPT;
+    T fetchAndAddRelease(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndAdd<detail::AtomicRelease>(m_value, arg);
+    }
 
-    int fetchAndAddOrdered(int arg) PCTK_NOEXCEPT;
+    T fetchAndAddOrdered(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndAdd<detail::AtomicOrdered>(m_value, arg);
+    }
 
-    int fetchAndSubRelaxed(int arg) PCTK_NOEXCEPT;
+    T fetchAndSubRelaxed(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndSub<detail::AtomicRelaxed>(m_value, arg);
+    }
 
-    int fetchAndSubAcquire(int arg) PCTK_NOEXCEPT;
+    T fetchAndSubAcquire(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndSub<detail::AtomicAcquire>(m_value, arg);
+    }
 
-    int fetchAndSubRelease(int arg) PCTK_NOEXCEPT;
+    T fetchAndSubRelease(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndSub<detail::AtomicRelease>(m_value, arg);
+    }
 
-    int fetchAndSubOrdered(int arg) PCTK_NOEXCEPT;
+    T fetchAndSubOrdered(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndSub<detail::AtomicOrdered>(m_value, arg);
+    }
 
-    int fetchAndOrRelaxed(int arg) PCTK_NOEXCEPT;
+    T fetchAndOrRelaxed(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndOr<detail::AtomicRelaxed>(m_value, arg);
+    }
 
-    int fetchAndOrAcquire(int arg) PCTK_NOEXCEPT;
+    T fetchAndOrAcquire(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndOr<detail::AtomicAcquire>(m_value, arg);
+    }
 
-    int fetchAndOrRelease(int arg) PCTK_NOEXCEPT;
+    T fetchAndOrRelease(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndOr<detail::AtomicRelease>(m_value, arg);
+    }
 
-    int fetchAndOrOrdered(int arg) PCTK_NOEXCEPT;
+    T fetchAndOrOrdered(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndOr<detail::AtomicOrdered>(m_value, arg);
+    }
 
-    int fetchAndAndRelaxed(int arg) PCTK_NOEXCEPT;
+    T fetchAndAndRelaxed(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndAnd<detail::AtomicRelaxed>(m_value, arg);
+    }
 
-    int fetchAndAndAcquire(int arg) PCTK_NOEXCEPT;
+    T fetchAndAndAcquire(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndAnd<detail::AtomicAcquire>(m_value, arg);
+    }
 
-    int fetchAndAndRelease(int arg) PCTK_NOEXCEPT;
+    T fetchAndAndRelease(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndAnd<detail::AtomicRelease>(m_value, arg);
+    }
 
-    int fetchAndAndOrdered(int arg) PCTK_NOEXCEPT;
+    T fetchAndAndOrdered(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndAnd<detail::AtomicOrdered>(m_value, arg);
+    }
 
-    int fetchAndXorRelaxed(int arg) PCTK_NOEXCEPT;
+    T fetchAndXorRelaxed(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndXor<detail::AtomicRelaxed>(m_value, arg);
+    }
 
-    int fetchAndXorAcquire(int arg) PCTK_NOEXCEPT;
+    T fetchAndXorAcquire(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndXor<detail::AtomicAcquire>(m_value, arg);
+    }
 
-    int fetchAndXorRelease(int arg) PCTK_NOEXCEPT;
+    T fetchAndXorRelease(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndXor<detail::AtomicRelease>(m_value, arg);
+    }
 
-    int fetchAndXorOrdered(int arg) PCTK_NOEXCEPT;
+    T fetchAndXorOrdered(T arg) PCTK_NOEXCEPT
+    {
+        return Ops::template fetchAndXor<detail::AtomicOrdered>(m_value, arg);
+    }
 
 protected:
-    AtomicIntPrivate *dd_ptr;
+    typename Ops::Type m_value;
+};
 
-private:
-    PCTK_DECL_PRIVATE_D(dd_ptr, AtomicInt)
+class AtomicInt : public AtomicInteger<int>
+{
+public:
+    PCTK_CONSTEXPR AtomicInt() PCTK_NOEXCEPT {}
+    PCTK_CONSTEXPR explicit AtomicInt(int val) PCTK_NOEXCEPT : AtomicInteger<int>(val) {}
+    AtomicInt(const AtomicInt &other) PCTK_NOEXCEPT : AtomicInteger<int>(other) {}
+
+    AtomicInt &operator=(int val) PCTK_NOEXCEPT
+    {
+        this->storeRelease(val);
+        return *this;
+    }
+
+    inline AtomicInt &operator=(const AtomicInt &other) PCTK_NOEXCEPT
+    {
+        this->storeRelease(other.loadAcquire());
+        return *this;
+    }
+
+    /**
+     * @brief Blocks while the value equals old, without holding any per object kernel resource.
+     * Spurious returns are filtered out, the value observed on return differs from old.
+     */
+    void wait(int old) const PCTK_NOEXCEPT
+    {
+        while (this->loadAcquire() == old)
+        {
+            detail::atomicWait(&m_value, old, -1);
+        }
+    }
+
+    /**
+     * @brief Timed wait(), returns false if the value still equals old after timeoutNSecs nanoseconds.
+     */
+    bool waitFor(int old, pctk_int64_t timeoutNSecs) const PCTK_NOEXCEPT
+    {
+        if (this->loadAcquire() != old)
+        {
+            return true;
+        }
+        return detail::atomicWait(&m_value, old, timeoutNSecs < 0 ? 0 : timeoutNSecs);
+    }
+
+    /**
+     * @brief Wakes at least one thread blocked in wait() on this object, cheap when nobody waits.
+     */
+    void notifyOne() PCTK_NOEXCEPT { detail::atomicNotifyOne(&m_value); }
+
+    /**
+     * @brief Wakes every thread blocked in wait() on this object, cheap when nobody waits.
+     */
+    void notifyAll() PCTK_NOEXCEPT { detail::atomicNotifyAll(&m_value); }
 };
 
-class AtomicPointerBasePrivate;
-class PCTK_CORE_API AtomicPointerBase
+class AtomicPointerBase
 {
 public:
     typedef pctk_pointer_t Pointer;
     typedef pctk_ptrdiff_t Ptrdiff;
 
 protected:
-    AtomicPointerBase() PCTK_NOEXCEPT;
-    explicit AtomicPointerBase(Pointer val) PCTK_NOEXCEPT;
-    AtomicPointerBase(const AtomicPointerBase &other) PCTK_NOEXCEPT;
-    virtual ~AtomicPointerBase();
+    typedef pctk_intptr_t Value;
+    typedef detail::AtomicOps<Value> Ops;
 
-    Pointer load() const PCTK_NOEXCEPT;
+    PCTK_CONSTEXPR AtomicPointerBase() PCTK_NOEXCEPT : m_value(0) {}
+    explicit AtomicPointerBase(Pointer val) PCTK_NOEXCEPT : m_value((Value) val) {}
+    AtomicPointerBase(const AtomicPointerBase &other) PCTK_NOEXCEPT : m_value((Value) other.loadAcquire()) {}
 
-    Pointer loadAcquire() const PCTK_NOEXCEPT;
+    Pointer load() const PCTK_NOEXCEPT { return (Pointer) Ops::load<detail::AtomicRelaxed>(m_value); }
 
-    void store(Pointer desired) PCTK_NOEXCEPT;
+    Pointer loadAcquire() const PCTK_NOEXCEPT { return (Pointer) Ops::load<detail::AtomicAcquire>(m_value); }
 
-    void storeRelease(Pointer desired) PCTK_NOEXCEPT;
+    void store(Pointer desired) PCTK_NOEXCEPT { Ops::store<detail::AtomicRelaxed>(m_value, (Value) desired); }
 
-    bool testAndSetRelaxed(Pointer expected, Pointer desired) PCTK_NOEXCEPT;
+    void storeRelease(Pointer desired) PCTK_NOEXCEPT { Ops::store<detail::AtomicRelease>(m_value, (Value) desired); }
 
-    bool testAndSetAcquire(Pointer expected, Pointer desired) PCTK_NOEXCEPT;
+    bool testAndSetRelaxed(Pointer expected, Pointer desired) PCTK_NOEXCEPT
+    {
+        return Ops::testAndSet<detail::AtomicRelaxed>(m_value, (Value) expected, (Value) desired);
+    }
 
-    bool testAndSetRelease(Pointer expected, Pointer desired) PCTK_NOEXCEPT;
+    bool testAndSetAcquire(Pointer expected, Pointer desired) PCTK_NOEXCEPT
+    {
+        return Ops::testAndSet<detail::AtomicAcquire>(m_value, (Value) expected, (Value) desired);
+    }
 
-    bool testAndSetOrdered(Pointer expected, Pointer desired) PCTK_NOEXCEPT;
+    bool testAndSetRelease(Pointer expected, Pointer desired) PCTK_NOEXCEPT
+    {
+        return Ops::testAndSet<detail::AtomicRelease>(m_value, (Value) expected, (Value) desired);
+    }
 
-    Pointer fetchAndStoreRelaxed(Pointer desired) PCTK_NOEXCEPT;
+    bool testAndSetOrdered(Pointer expected, Pointer desired) PCTK_NOEXCEPT
+    {
+        return Ops::testAndSet<detail::AtomicOrdered>(m_value, (Value) expected, (Value) desired);
+    }
 
-    Pointer fetchAndStoreAcquire(Pointer desired) PCTK_NOEXCEPT;
+    Pointer fetchAndStoreRelaxed(Pointer desired) PCTK_NOEXCEPT
+    {
+        return (Pointer) Ops::fetchAndStore<detail::AtomicRelaxed>(m_value, (Value) desired);
+    }
 
-    Pointer fetchAndStoreRelease(Pointer desired) PCTK_NOEXCEPT;
+    Pointer fetchAndStoreAcquire(Pointer desired) PCTK_NOEXCEPT
+    {
+        return (Pointer) Ops::fetchAndStore<detail::AtomicAcquire>(m_value, (Value) desired);
+    }
 
-    Pointer fetchAndStoreOrdered(Pointer desired) PCTK_NOEXCEPT;
+    Pointer fetchAndStoreRelease(Pointer desired) PCTK_NOEXCEPT
+    {
+        return (Pointer) Ops::fetchAndStore<detail::AtomicRelease>(m_value, (Value) desired);
+    }
 
-    Pointer fetchAndAddRelaxed(Ptrdiff arg) PCTK_NOEXCEPT;
+    Pointer fetchAndStoreOrdered(Pointer desired) PCTK_NOEXCEPT
+    {
+        return (Pointer) Ops::fetchAndStore<detail::AtomicOrdered>(m_value, (Value) desired);
+    }
 
-    Pointer fetchAndAddAcquire(Ptrdiff arg) PCTK_NOEXCEPT;
+    Pointer fetchAndAddRelaxed(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (Pointer) Ops::fetchAndAdd<detail::AtomicRelaxed>(m_value, arg);
+    }
 
-    Pointer fetchAndAddRelease(Ptrdiff arg) PCTK_NOEXCEPT;
+    Pointer fetchAndAddAcquire(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (Pointer) Ops::fetchAndAdd<detail::AtomicAcquire>(m_value, arg);
+    }
 
-    Pointer fetchAndAddOrdered(Ptrdiff arg) PCTK_NOEXCEPT;
+    Pointer fetchAndAddRelease(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (Pointer) Ops::fetchAndAdd<detail::AtomicRelease>(m_value, arg);
+    }
 
-    Pointer fetchAndSubRelaxed(Ptrdiff arg) PCTK_NOEXCEPT;
+    Pointer fetchAndAddOrdered(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (Pointer) Ops::fetchAndAdd<detail::AtomicOrdered>(m_value, arg);
+    }
 
-    Pointer fetchAndSubAcquire(Ptrdiff arg) PCTK_NOEXCEPT;
+    Pointer fetchAndSubRelaxed(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (Pointer) Ops::fetchAndSub<detail::AtomicRelaxed>(m_value, arg);
+    }
 
-    Pointer fetchAndSubRelease(Ptrdiff arg) PCTK_NOEXCEPT;
+    Pointer fetchAndSubAcquire(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (Pointer) Ops::fetchAndSub<detail::AtomicAcquire>(m_value, arg);
+    }
 
-    Pointer fetchAndSubOrdered(Ptrdiff arg) PCTK_NOEXCEPT;
+    Pointer fetchAndSubRelease(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (Pointer) Ops::fetchAndSub<detail::AtomicRelease>(m_value, arg);
+    }
 
-    AtomicPointerBasePrivate *dd_ptr;
+    Pointer fetchAndSubOrdered(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (Pointer) Ops::fetchAndSub<detail::AtomicOrdered>(m_value, arg);
+    }
 
 private:
-    PCTK_DECL_PRIVATE_D(dd_ptr, AtomicPointerBase)
+    Ops::Type m_value;
 };
 
+/**
+ * @brief Header only atomic pointer, sizeof(AtomicPointer<T>) == sizeof(T *). Add and sub operate on bytes.
+ */
 template<typename T>
-class PCTK_CORE_API AtomicPointer : public AtomicPointerBase
+class AtomicPointer : public AtomicPointerBase
 {
 public:
     typedef AtomicPointerBase::Ptrdiff Ptrdiff;
 
-    AtomicPointer() PCTK_NOEXCEPT {}
+    PCTK_CONSTEXPR AtomicPointer() PCTK_NOEXCEPT {}
     explicit AtomicPointer(T *val) PCTK_NOEXCEPT: AtomicPointerBase(val) {}
     AtomicPointer(const AtomicPointer &other) PCTK_NOEXCEPT: AtomicPointerBase(other.loadAcquire()) {}
-    ~AtomicPointer() PCTK_OVERRIDE {}
 
     AtomicPointer &operator=(T *val) PCTK_NOEXCEPT
     {
@@ -259,31 +539,177 @@ public:
         return AtomicPointerBase::testAndSetOrdered(expected, desired);
     }
 
-    T *fetchAndStoreRelaxed(T *desired) PCTK_NOEXCEPT { return (T *) AtomicPointerBase::fetchAndStoreRelaxed(desired); }
+    T *fetchAndStoreRelaxed(T *desired) PCTK_NOEXCEPT
+    {
+        return (T *) AtomicPointerBase::fetchAndStoreRelaxed(desired);
+    }
+
+    T *fetchAndStoreAcquire(T *desired) PCTK_NOEXCEPT
+    {
+        return (T *) AtomicPointerBase::fetchAndStoreAcquire(desired);
+    }
+
+    T *fetchAndStoreRelease(T *desired) PCTK_NOEXCEPT
+    {
+        return (T *) AtomicPointerBase::fetchAndStoreRelease(desired);
+    }
+
+    T *fetchAndStoreOrdered(T *desired) PCTK_NOEXCEPT
+    {
+        return (T *) AtomicPointerBase::fetchAndStoreOrdered(desired);
+    }
+
+    T *fetchAndAddRelaxed(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (T *) AtomicPointerBase::fetchAndAddRelaxed(arg);
+    }
+
+    T *fetchAndAddAcquire(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (T *) AtomicPointerBase::fetchAndAddAcquire(arg);
+    }
 
-    T *fetchAndStoreAcquire(T *desired) PCTK_NOEXCEPT { return (T *) AtomicPointerBase::fetchAndStoreAcquire(desired); }
+    T *fetchAndAddRelease(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (T *) AtomicPointerBase::fetchAndAddRelease(arg);
+    }
 
-    T *fetchAndStoreRelease(T *desired) PCTK_NOEXCEPT { return (T *) AtomicPointerBase::fetchAndStoreRelease(desired); }
+    T *fetchAndAddOrdered(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (T *) AtomicPointerBase::fetchAndAddOrdered(arg);
+    }
 
-    T *fetchAndStoreOrdered(T *desired) PCTK_NOEXCEPT { return (T *) AtomicPointerBase::fetchAndStoreOrdered(desired); }
+    T *fetchAndSubRelaxed(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (T *) AtomicPointerBase::fetchAndSubRelaxed(arg);
+    }
 
-    T *fetchAndAddRelaxed(Ptrdiff arg) PCTK_NOEXCEPT { return (T *) AtomicPointerBase::fetchAndAddRelaxed(arg); }
+    T *fetchAndSubAcquire(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (T *) AtomicPointerBase::fetchAndSubAcquire(arg);
+    }
 
-    T *fetchAndAddAcquire(Ptrdiff arg) PCTK_NOEXCEPT { return (T *) AtomicPointerBase::fetchAndAddAcquire(arg); }
+    T *fetchAndSubRelease(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (T *) AtomicPointerBase::fetchAndSubRelease(arg);
+    }
+
+    T *fetchAndSubOrdered(Ptrdiff arg) PCTK_NOEXCEPT
+    {
+        return (T *) AtomicPointerBase::fetchAndSubOrdered(arg);
+    }
+};
+
+#if PCTK_HAS_UINT128_T && defined(PCTK_CC_GNU) && (defined(PCTK_PROCESSOR_X86_64) || defined(PCTK_PROCESSOR_ARM_64))
+#   define PCTK_ATOMIC_HAS_DOUBLE_WORD_CAS 1
+#else
+#   define PCTK_ATOMIC_HAS_DOUBLE_WORD_CAS 0
+#endif
+
+#if PCTK_ATOMIC_HAS_DOUBLE_WORD_CAS
+/**
+ * @brief Lock free 128 bit word with a double-word compare-and-swap, used for ABA safe tagged pointers.
+ * The instruction is a full barrier on every supported processor, so all memory orders map to the same code.
+ */
+class AtomicDoubleWord
+{
+public:
+    typedef pctk_uint128_t Value;
 
-    T *fetchAndAddRelease(Ptrdiff arg) PCTK_NOEXCEPT { return (T *) AtomicPointerBase::fetchAndAddRelease(arg); }
+    PCTK_CONSTEXPR AtomicDoubleWord() PCTK_NOEXCEPT : m_value(0) {}
+    PCTK_CONSTEXPR explicit AtomicDoubleWord(Value val) PCTK_NOEXCEPT : m_value(val) {}
 
-    T *fetchAndAddOrdered(Ptrdiff arg) PCTK_NOEXCEPT { return (T *) AtomicPointerBase::fetchAndAddOrdered(arg); }
+    static PCTK_CONSTEXPR bool isLockFree() PCTK_NOEXCEPT { return true; }
 
-    T *fetchAndSubRelaxed(Ptrdiff arg) PCTK_NOEXCEPT { return (T *) AtomicPointerBase::fetchAndSubRelaxed(arg); }
+    static PCTK_CONSTEXPR Value make(pctk_uint64_t low, pctk_uint64_t high) PCTK_NOEXCEPT
+    {
+        return ((Value) high << 64) | low;
+    }
+    static PCTK_CONSTEXPR pctk_uint64_t low(Value val) PCTK_NOEXCEPT { return (pctk_uint64_t) val; }
+    static PCTK_CONSTEXPR pctk_uint64_t high(Value val) PCTK_NOEXCEPT { return (pctk_uint64_t) (val >> 64); }
 
-    T *fetchAndSubAcquire(Ptrdiff arg) PCTK_NOEXCEPT { return (T *) AtomicPointerBase::fetchAndSubAcquire(arg); }
+    Value load() const PCTK_NOEXCEPT { return this->loadAcquire(); }
 
-    T *fetchAndSubRelease(Ptrdiff arg) PCTK_NOEXCEPT { return (T *) AtomicPointerBase::fetchAndSubRelease(arg); }
+    Value loadAcquire() const PCTK_NOEXCEPT
+    {
+        Value current = 0;
+        const_cast<AtomicDoubleWord *>(this)->compareExchange(current, 0);
+        return current;
+    }
 
-    T *fetchAndSubOrdered(Ptrdiff arg) PCTK_NOEXCEPT { return (T *) AtomicPointerBase::fetchAndSubOrdered(arg); }
+    void store(Value desired) PCTK_NOEXCEPT { this->fetchAndStoreOrdered(desired); }
 
+    void storeRelease(Value desired) PCTK_NOEXCEPT { this->fetchAndStoreOrdered(desired); }
+
+    bool testAndSetRelaxed(Value expected, Value desired) PCTK_NOEXCEPT
+    {
+        return this->compareExchange(expected, desired);
+    }
+
+    bool testAndSetAcquire(Value expected, Value desired) PCTK_NOEXCEPT
+    {
+        return this->compareExchange(expected, desired);
+    }
+
+    bool testAndSetRelease(Value expected, Value desired) PCTK_NOEXCEPT
+    {
+        return this->compareExchange(expected, desired);
+    }
+
+    bool testAndSetOrdered(Value expected, Value desired) PCTK_NOEXCEPT
+    {
+        return this->compareExchange(expected, desired);
+    }
+
+    /**
+     * @brief On failure current receives the value found in memory, ready for the next retry of a CAS loop.
+     */
+    bool testAndSetOrdered(Value expected, Value desired, Value &current) PCTK_NOEXCEPT
+    {
+        current = expected;
+        return this->compareExchange(current, desired);
+    }
+
+    Value fetchAndStoreOrdered(Value desired) PCTK_NOEXCEPT
+    {
+        Value current = m_value;
+        while (!this->compareExchange(current, desired))
+        {
+        }
+        return current;
+    }
+
+private:
+    bool compareExchange(Value &expected, Value desired) PCTK_NOEXCEPT
+    {
+#if defined(PCTK_PROCESSOR_X86_64)
+        /* Spelled out so that no -mcx16 or libatomic is required. */
+        pctk_uint64_t expectedLow = low(expected);
+        pctk_uint64_t expectedHigh = high(expected);
+        bool result;
+        __asm__ __volatile__("lock cmpxchg16b %1\n\t"
+                             "sete %0"
+                             : "=q"(result), "+m"(m_value), "+a"(expectedLow), "+d"(expectedHigh)
+                             : "b"(low(desired)), "c"(high(desired))
+                             : "cc", "memory");
+        expected = make(expectedLow, expectedHigh);
+        return result;
+#else
+        const Value previous = __sync_val_compare_and_swap(&m_value, expected, desired);
+        const bool result = previous == expected;
+        expected = previous;
+        return result;
+#endif
+    }
+
+    PCTK_ALIGN(16) Value m_value;
 };
+#endif
+
+PCTK_STATIC_ASSERT_X(sizeof(AtomicInt) == sizeof(int), "AtomicInt must be exactly one int wide");
+PCTK_STATIC_ASSERT_X(sizeof(AtomicInteger<pctk_int64_t>) == sizeof(pctk_int64_t),
+                     "AtomicInteger must be exactly one word wide");
+PCTK_STATIC_ASSERT_X(sizeof(AtomicPointer<void>) == sizeof(void *), "AtomicPointer must be exactly one pointer wide");
 
 PCTK_END_NAMESPACE
 
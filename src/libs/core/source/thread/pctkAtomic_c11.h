@@ -0,0 +1,122 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKATOMIC_C11_H
+#define _PCTKATOMIC_C11_H
+
+/* This header is part of the pctkAtomic.h implementation and must not be included directly. */
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+template<AtomicOrder Order> struct AtomicC11Order;
+template<> struct AtomicC11Order<AtomicRelaxed>
+{
+    enum { success = __ATOMIC_RELAXED, failure = __ATOMIC_RELAXED };
+};
+template<> struct AtomicC11Order<AtomicAcquire>
+{
+    enum { success = __ATOMIC_ACQUIRE, failure = __ATOMIC_ACQUIRE };
+};
+template<> struct AtomicC11Order<AtomicRelease>
+{
+    enum { success = __ATOMIC_RELEASE, failure = __ATOMIC_RELAXED };
+};
+template<> struct AtomicC11Order<AtomicOrdered>
+{
+    enum { success = __ATOMIC_ACQ_REL, failure = __ATOMIC_ACQUIRE };
+};
+
+template<typename T>
+struct AtomicOps
+{
+    typedef _Atomic(T) Type;
+
+    enum { IsAlwaysLockFree = __atomic_always_lock_free(sizeof(T), 0) };
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T load(const Type &value) PCTK_NOEXCEPT
+    {
+        return __c11_atomic_load(&value, AtomicC11Order<Order>::failure);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE void store(Type &value, T desired) PCTK_NOEXCEPT
+    {
+        __c11_atomic_store(&value, desired, AtomicC11Order<Order>::success);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE bool testAndSet(Type &value, T expected, T desired) PCTK_NOEXCEPT
+    {
+        return __c11_atomic_compare_exchange_strong(&value,
+                                                    &expected,
+                                                    desired,
+                                                    AtomicC11Order<Order>::success,
+                                                    AtomicC11Order<Order>::failure);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndStore(Type &value, T desired) PCTK_NOEXCEPT
+    {
+        return __c11_atomic_exchange(&value, desired, AtomicC11Order<Order>::success);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndAdd(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return __c11_atomic_fetch_add(&value, arg, AtomicC11Order<Order>::success);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndSub(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return __c11_atomic_fetch_sub(&value, arg, AtomicC11Order<Order>::success);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndOr(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return __c11_atomic_fetch_or(&value, arg, AtomicC11Order<Order>::success);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndAnd(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return __c11_atomic_fetch_and(&value, arg, AtomicC11Order<Order>::success);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndXor(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return __c11_atomic_fetch_xor(&value, arg, AtomicC11Order<Order>::success);
+    }
+};
+} // namespace detail
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKATOMIC_C11_H
@@ -0,0 +1,133 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKATOMIC_CXX11_H
+#define _PCTKATOMIC_CXX11_H
+
+/* This header is part of the pctkAtomic.h implementation and must not be included directly. */
+
+#include <atomic>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+template<AtomicOrder Order> struct AtomicCxx11Order;
+template<> struct AtomicCxx11Order<AtomicRelaxed>
+{
+    static const std::memory_order success = std::memory_order_relaxed;
+    static const std::memory_order failure = std::memory_order_relaxed;
+};
+template<> struct AtomicCxx11Order<AtomicAcquire>
+{
+    static const std::memory_order success = std::memory_order_acquire;
+    static const std::memory_order failure = std::memory_order_acquire;
+};
+template<> struct AtomicCxx11Order<AtomicRelease>
+{
+    static const std::memory_order success = std::memory_order_release;
+    static const std::memory_order failure = std::memory_order_relaxed;
+};
+template<> struct AtomicCxx11Order<AtomicOrdered>
+{
+    static const std::memory_order success = std::memory_order_acq_rel;
+    static const std::memory_order failure = std::memory_order_acquire;
+};
+
+template<typename T>
+struct AtomicOps
+{
+    typedef std::atomic<T> Type;
+
+#if defined(PCTK_CC_GNU)
+    enum { IsAlwaysLockFree = __atomic_always_lock_free(sizeof(T), 0) };
+#elif PCTK_CC_STDCXX_17
+    enum { IsAlwaysLockFree = std::atomic<T>::is_always_lock_free };
+#else
+    enum { IsAlwaysLockFree = sizeof(T) <= sizeof(void *) };
+#endif
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T load(const Type &value) PCTK_NOEXCEPT
+    {
+        return value.load(AtomicCxx11Order<Order>::failure);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE void store(Type &value, T desired) PCTK_NOEXCEPT
+    {
+        value.store(desired, AtomicCxx11Order<Order>::success);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE bool testAndSet(Type &value, T expected, T desired) PCTK_NOEXCEPT
+    {
+        return value.compare_exchange_strong(expected,
+                                             desired,
+                                             AtomicCxx11Order<Order>::success,
+                                             AtomicCxx11Order<Order>::failure);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndStore(Type &value, T desired) PCTK_NOEXCEPT
+    {
+        return value.exchange(desired, AtomicCxx11Order<Order>::success);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndAdd(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return value.fetch_add(arg, AtomicCxx11Order<Order>::success);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndSub(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return value.fetch_sub(arg, AtomicCxx11Order<Order>::success);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndOr(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return value.fetch_or(arg, AtomicCxx11Order<Order>::success);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndAnd(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return value.fetch_and(arg, AtomicCxx11Order<Order>::success);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndXor(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return value.fetch_xor(arg, AtomicCxx11Order<Order>::success);
+    }
+};
+} // namespace detail
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKATOMIC_CXX11_H
@@ -0,0 +1,206 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKATOMIC_MSVC_H
+#define _PCTKATOMIC_MSVC_H
+
+/* This header is part of the pctkAtomic.h implementation and must not be included directly. */
+
+#include <intrin.h>
+
+#if defined(PCTK_PROCESSOR_ARM_64)
+#   define PCTK_ATOMIC_MSVC_FENCE() __dmb(_ARM64_BARRIER_ISH)
+#elif defined(PCTK_PROCESSOR_ARM)
+#   define PCTK_ATOMIC_MSVC_FENCE() __dmb(_ARM_BARRIER_ISH)
+#else
+#   define PCTK_ATOMIC_MSVC_FENCE() _ReadWriteBarrier()
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* The Interlocked intrinsics are full barriers, the memory order is only honoured by plain loads and stores. */
+template<int Size> struct AtomicMsvcInterlocked;
+template<> struct AtomicMsvcInterlocked<1>
+{
+    typedef char Word;
+    static Word load(volatile Word *p) { Word v = *p; PCTK_ATOMIC_MSVC_FENCE(); return v; }
+    static Word compareExchange(volatile Word *p, Word d, Word e) { return _InterlockedCompareExchange8(p, d, e); }
+    static Word exchange(volatile Word *p, Word d) { return _InterlockedExchange8(p, d); }
+    static Word exchangeAdd(volatile Word *p, Word a) { return _InterlockedExchangeAdd8(p, a); }
+    static Word exchangeOr(volatile Word *p, Word a) { return _InterlockedOr8(p, a); }
+    static Word exchangeAnd(volatile Word *p, Word a) { return _InterlockedAnd8(p, a); }
+    static Word exchangeXor(volatile Word *p, Word a) { return _InterlockedXor8(p, a); }
+};
+template<> struct AtomicMsvcInterlocked<2>
+{
+    typedef short Word;
+    static Word load(volatile Word *p) { Word v = *p; PCTK_ATOMIC_MSVC_FENCE(); return v; }
+    static Word compareExchange(volatile Word *p, Word d, Word e) { return _InterlockedCompareExchange16(p, d, e); }
+    static Word exchange(volatile Word *p, Word d) { return _InterlockedExchange16(p, d); }
+    static Word exchangeAdd(volatile Word *p, Word a) { return _InterlockedExchangeAdd16(p, a); }
+    static Word exchangeOr(volatile Word *p, Word a) { return _InterlockedOr16(p, a); }
+    static Word exchangeAnd(volatile Word *p, Word a) { return _InterlockedAnd16(p, a); }
+    static Word exchangeXor(volatile Word *p, Word a) { return _InterlockedXor16(p, a); }
+};
+template<> struct AtomicMsvcInterlocked<4>
+{
+    typedef long Word;
+    static Word load(volatile Word *p) { Word v = *p; PCTK_ATOMIC_MSVC_FENCE(); return v; }
+    static Word compareExchange(volatile Word *p, Word d, Word e) { return _InterlockedCompareExchange(p, d, e); }
+    static Word exchange(volatile Word *p, Word d) { return _InterlockedExchange(p, d); }
+    static Word exchangeAdd(volatile Word *p, Word a) { return _InterlockedExchangeAdd(p, a); }
+    static Word exchangeOr(volatile Word *p, Word a) { return _InterlockedOr(p, a); }
+    static Word exchangeAnd(volatile Word *p, Word a) { return _InterlockedAnd(p, a); }
+    static Word exchangeXor(volatile Word *p, Word a) { return _InterlockedXor(p, a); }
+};
+template<> struct AtomicMsvcInterlocked<8>
+{
+    typedef __int64 Word;
+    static Word compareExchange(volatile Word *p, Word d, Word e) { return _InterlockedCompareExchange64(p, d, e); }
+#if defined(_WIN64)
+    static Word load(volatile Word *p) { Word v = *p; PCTK_ATOMIC_MSVC_FENCE(); return v; }
+    static Word exchange(volatile Word *p, Word d) { return _InterlockedExchange64(p, d); }
+    static Word exchangeAdd(volatile Word *p, Word a) { return _InterlockedExchangeAdd64(p, a); }
+    static Word exchangeOr(volatile Word *p, Word a) { return _InterlockedOr64(p, a); }
+    static Word exchangeAnd(volatile Word *p, Word a) { return _InterlockedAnd64(p, a); }
+    static Word exchangeXor(volatile Word *p, Word a) { return _InterlockedXor64(p, a); }
+#else
+    /* 32-bit targets only provide a 64-bit compare-exchange, everything else is built on top of it. */
+    static Word load(volatile Word *p) { return _InterlockedCompareExchange64(p, 0, 0); }
+    static Word exchange(volatile Word *p, Word d)
+    {
+        Word e = load(p);
+        for (Word v; (v = compareExchange(p, d, e)) != e; e = v) {}
+        return e;
+    }
+    static Word exchangeAdd(volatile Word *p, Word a)
+    {
+        Word e = load(p);
+        for (Word v; (v = compareExchange(p, e + a, e)) != e; e = v) {}
+        return e;
+    }
+    static Word exchangeOr(volatile Word *p, Word a)
+    {
+        Word e = load(p);
+        for (Word v; (v = compareExchange(p, e | a, e)) != e; e = v) {}
+        return e;
+    }
+    static Word exchangeAnd(volatile Word *p, Word a)
+    {
+        Word e = load(p);
+        for (Word v; (v = compareExchange(p, e & a, e)) != e; e = v) {}
+        return e;
+    }
+    static Word exchangeXor(volatile Word *p, Word a)
+    {
+        Word e = load(p);
+        for (Word v; (v = compareExchange(p, e ^ a, e)) != e; e = v) {}
+        return e;
+    }
+#endif
+};
+
+template<typename T>
+struct AtomicOps
+{
+    typedef T Type;
+    typedef AtomicMsvcInterlocked<sizeof(T)> Interlocked;
+    typedef typename Interlocked::Word Word;
+
+    enum { IsAlwaysLockFree = true };
+
+    static PCTK_FORCE_INLINE volatile Word *word(const Type &value) PCTK_NOEXCEPT
+    {
+        return (volatile Word *) const_cast<Type *>(&value);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T load(const Type &value) PCTK_NOEXCEPT
+    {
+        return (T) Interlocked::load(word(value));
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE void store(Type &value, T desired) PCTK_NOEXCEPT
+    {
+        if (AtomicRelaxed == Order && sizeof(T) <= sizeof(void *))
+        {
+            *(volatile T *) &value = desired;
+        }
+        else
+        {
+            Interlocked::exchange(word(value), (Word) desired);
+        }
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE bool testAndSet(Type &value, T expected, T desired) PCTK_NOEXCEPT
+    {
+        return Interlocked::compareExchange(word(value), (Word) desired, (Word) expected) == (Word) expected;
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndStore(Type &value, T desired) PCTK_NOEXCEPT
+    {
+        return (T) Interlocked::exchange(word(value), (Word) desired);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndAdd(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return (T) Interlocked::exchangeAdd(word(value), (Word) arg);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndSub(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return (T) Interlocked::exchangeAdd(word(value), (Word) (T(0) - arg));
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndOr(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return (T) Interlocked::exchangeOr(word(value), (Word) arg);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndAnd(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return (T) Interlocked::exchangeAnd(word(value), (Word) arg);
+    }
+
+    template<AtomicOrder Order>
+    static PCTK_FORCE_INLINE T fetchAndXor(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        return (T) Interlocked::exchangeXor(word(value), (Word) arg);
+    }
+};
+} // namespace detail
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKATOMIC_MSVC_H
@@ -0,0 +1,150 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKATOMIC_POSIX_H
+#define _PCTKATOMIC_POSIX_H
+
+/* This header is part of the pctkAtomic.h implementation and must not be included directly. */
+
+#include <pthread.h>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* Last resort backend: every operation is serialized by one of a few address striped mutexes. */
+class AtomicPosixLocker
+{
+public:
+    explicit AtomicPosixLocker(const void *address) PCTK_NOEXCEPT
+        : m_mutex(mutexFor(address)) { pthread_mutex_lock(m_mutex); }
+    ~AtomicPosixLocker() { pthread_mutex_unlock(m_mutex); }
+
+private:
+    static pthread_mutex_t *mutexFor(const void *address) PCTK_NOEXCEPT
+    {
+        static pthread_mutex_t mutexes[8] = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+                                             PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+                                             PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+                                             PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER};
+        return &mutexes[((pctk_uintptr_t) address >> 4) & 7];
+    }
+
+    pthread_mutex_t *const m_mutex;
+    PCTK_DISABLE_COPY_MOVE(AtomicPosixLocker)
+};
+
+template<typename T>
+struct AtomicOps
+{
+    typedef T Type;
+
+    enum { IsAlwaysLockFree = false };
+
+    template<AtomicOrder Order>
+    static inline T load(const Type &value) PCTK_NOEXCEPT
+    {
+        AtomicPosixLocker locker(&value);
+        return value;
+    }
+
+    template<AtomicOrder Order>
+    static inline void store(Type &value, T desired) PCTK_NOEXCEPT
+    {
+        AtomicPosixLocker locker(&value);
+        value = desired;
+    }
+
+    template<AtomicOrder Order>
+    static inline bool testAndSet(Type &value, T expected, T desired) PCTK_NOEXCEPT
+    {
+        AtomicPosixLocker locker(&value);
+        if (value == expected)
+        {
+            value = desired;
+            return true;
+        }
+        return false;
+    }
+
+    template<AtomicOrder Order>
+    static inline T fetchAndStore(Type &value, T desired) PCTK_NOEXCEPT
+    {
+        AtomicPosixLocker locker(&value);
+        const T old = value;
+        value = desired;
+        return old;
+    }
+
+    template<AtomicOrder Order>
+    static inline T fetchAndAdd(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        AtomicPosixLocker locker(&value);
+        const T old = value;
+        value = old + arg;
+        return old;
+    }
+
+    template<AtomicOrder Order>
+    static inline T fetchAndSub(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        AtomicPosixLocker locker(&value);
+        const T old = value;
+        value = old - arg;
+        return old;
+    }
+
+    template<AtomicOrder Order>
+    static inline T fetchAndOr(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        AtomicPosixLocker locker(&value);
+        const T old = value;
+        value = old | arg;
+        return old;
+    }
+
+    template<AtomicOrder Order>
+    static inline T fetchAndAnd(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        AtomicPosixLocker locker(&value);
+        const T old = value;
+        value = old & arg;
+        return old;
+    }
+
+    template<AtomicOrder Order>
+    static inline T fetchAndXor(Type &value, T arg) PCTK_NOEXCEPT
+    {
+        AtomicPosixLocker locker(&value);
+        const T old = value;
+        value = old ^ arg;
+        return old;
+    }
+};
+} // namespace detail
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKATOMIC_POSIX_H
@@ -0,0 +1,131 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkCacheLine.h>
+
+#if defined(PCTK_OS_WIN)
+#   include <windows.h>
+#   include <vector>
+#elif defined(PCTK_OS_APPLE)
+#   include <sys/sysctl.h>
+#   include <sys/types.h>
+#else
+#   include <unistd.h>
+#   include <cstdio>
+#endif
+
+#if defined(PCTK_PROCESSOR_X86)
+#   if defined(PCTK_CC_MSVC)
+#       include <intrin.h>
+#   elif defined(PCTK_CC_GNU)
+#       include <cpuid.h>
+#   endif
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+static int cacheLineSizeFromCpuid()
+{
+#if defined(PCTK_PROCESSOR_X86) && defined(PCTK_CC_MSVC)
+    int regs[4];
+    __cpuid(regs, 1);
+    return ((regs[1] >> 8) & 0xff) * 8;
+#elif defined(PCTK_PROCESSOR_X86) && defined(PCTK_CC_GNU)
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        /* CLFLUSH line size, in 8 byte units */
+        return (int) ((ebx >> 8) & 0xff) * 8;
+    }
+    return 0;
+#else
+    return 0;
+#endif
+}
+
+static int cacheLineSizeFromSystem()
+{
+#if defined(PCTK_OS_WIN)
+    DWORD bytes = 0;
+    GetLogicalProcessorInformation(PCTK_NULLPTR, &bytes);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infos(bytes / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (infos.empty() || !GetLogicalProcessorInformation(&infos[0], &bytes))
+    {
+        return 0;
+    }
+    for (std::size_t i = 0; i < infos.size(); ++i)
+    {
+        if (RelationCache == infos[i].Relationship && 1 == infos[i].Cache.Level)
+        {
+            return (int) infos[i].Cache.LineSize;
+        }
+    }
+    return 0;
+#elif defined(PCTK_OS_APPLE)
+    pctk_int64_t size = 0;
+    std::size_t length = sizeof(size);
+    return 0 == sysctlbyname("hw.cachelinesize", &size, &length, PCTK_NULLPTR, 0) ? (int) size : 0;
+#else
+    long size = 0;
+#   if defined(_SC_LEVEL1_DCACHE_LINESIZE)
+    size = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+#   endif
+    if (size <= 0)
+    {
+        /* sysconf reports 0 on several ARM kernels, sysfs usually knows */
+        FILE *file = std::fopen("/sys/devices/system/cpu/cpu0/cache/index0/coherency_line_size", "r");
+        if (file)
+        {
+            if (1 != std::fscanf(file, "%ld", &size))
+            {
+                size = 0;
+            }
+            std::fclose(file);
+        }
+    }
+    return size > 0 ? (int) size : 0;
+#endif
+}
+} // namespace detail
+
+int CacheLine::runtimeSize() PCTK_NOEXCEPT
+{
+    static AtomicInt cached(-1);
+    int size = cached.loadAcquire();
+    if (size < 0)
+    {
+        size = detail::cacheLineSizeFromSystem();
+        if (size <= 0)
+        {
+            size = detail::cacheLineSizeFromCpuid();
+        }
+        cached.storeRelease(size);
+    }
+    return size;
+}
+
+PCTK_END_NAMESPACE
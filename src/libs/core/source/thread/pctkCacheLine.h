@@ -0,0 +1,118 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKCACHELINE_H
+#define _PCTKCACHELINE_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+
+PCTK_BEGIN_NAMESPACE
+
+class PCTK_CORE_API CacheLine
+{
+public:
+    /**
+     * @brief Compile time line size, PCTK_CACHELINE_SIZE, used for every padded type.
+     */
+    static PCTK_CONSTEXPR int size() PCTK_NOEXCEPT { return PCTK_CACHELINE_SIZE; }
+
+    /**
+     * @brief Line size reported by the running CPU (sysconf, sysctl, cpuid or the Win32 processor information),
+     * 0 if it cannot be determined. Queried once and cached.
+     */
+    static int runtimeSize() PCTK_NOEXCEPT;
+
+    /**
+     * @brief Returns false if the running CPU uses larger lines than PCTK_CACHELINE_SIZE, in which case padded types
+     * can still false-share and the library should be rebuilt with a larger PCTK_CACHELINE_SIZE.
+     */
+    static bool checkRuntimeSize() PCTK_NOEXCEPT
+    {
+        return runtimeSize() <= PCTK_CACHELINE_SIZE;
+    }
+
+    /**
+     * @brief False-sharing diagnostic, returns true if both addresses fall into the same cache line.
+     */
+    static bool isSameLine(const void *first, const void *second) PCTK_NOEXCEPT
+    {
+        return ((pctk_uintptr_t) first / PCTK_CACHELINE_SIZE) == ((pctk_uintptr_t) second / PCTK_CACHELINE_SIZE);
+    }
+};
+
+/**
+ * @brief Holds a T on a cache line of its own, so that neighbouring array elements never false-share.
+ */
+template<typename T>
+class PCTK_ALIGN(PCTK_CACHELINE_SIZE) CacheAligned
+{
+public:
+    CacheAligned() : m_value() {}
+    explicit CacheAligned(const T &value) : m_value(value) {}
+
+    T &get() PCTK_NOEXCEPT { return m_value; }
+    const T &get() const PCTK_NOEXCEPT { return m_value; }
+
+    T &operator*() PCTK_NOEXCEPT { return m_value; }
+    const T &operator*() const PCTK_NOEXCEPT { return m_value; }
+
+    T *operator->() PCTK_NOEXCEPT { return &m_value; }
+    const T *operator->() const PCTK_NOEXCEPT { return &m_value; }
+
+private:
+    T m_value;
+};
+
+/**
+ * @brief AtomicInteger<T> padded to a full cache line, a drop-in replacement for packed arrays of atomics.
+ */
+template<typename T>
+class PCTK_ALIGN(PCTK_CACHELINE_SIZE) PaddedAtomic : public AtomicInteger<T>
+{
+public:
+    PCTK_CONSTEXPR PaddedAtomic() PCTK_NOEXCEPT {}
+    PCTK_CONSTEXPR explicit PaddedAtomic(T val) PCTK_NOEXCEPT : AtomicInteger<T>(val) {}
+    PaddedAtomic(const PaddedAtomic &other) PCTK_NOEXCEPT : AtomicInteger<T>(other) {}
+
+    PaddedAtomic &operator=(T val) PCTK_NOEXCEPT
+    {
+        this->storeRelease(val);
+        return *this;
+    }
+
+    inline PaddedAtomic &operator=(const PaddedAtomic &other) PCTK_NOEXCEPT
+    {
+        this->storeRelease(other.loadAcquire());
+        return *this;
+    }
+};
+
+PCTK_STATIC_ASSERT_X(sizeof(PaddedAtomic<int>) == PCTK_CACHELINE_SIZE, "PaddedAtomic must fill one cache line");
+PCTK_STATIC_ASSERT_X(sizeof(CacheAligned<char>) == PCTK_CACHELINE_SIZE, "CacheAligned must fill one cache line");
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKCACHELINE_H
@@ -0,0 +1,742 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKCONCURRENTQUEUE_H
+#define _PCTKCONCURRENTQUEUE_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+#include <pctkCacheLine.h>
+#include <pctkTypeInfo.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <utility>
+#include <type_traits>
+
+PCTK_BEGIN_NAMESPACE
+
+/**
+ * @brief How the blocking push()/pop() calls of the concurrent queues wait.
+ * QueueWaitSpin spins and then yields, the non-blocking calls never signal anybody and stay as cheap as possible.
+ * QueueWaitBlock parks waiters on a futex after a short spin, every successful operation then pays a fence to find
+ * out whether somebody sleeps on the other side.
+ */
+enum QueueWaitMode
+{
+    QueueWaitSpin,
+    QueueWaitBlock
+};
+
+namespace detail
+{
+static const int QueueSpinRounds = 64;
+
+inline std::size_t queueCapacity(std::size_t wanted) PCTK_NOEXCEPT
+{
+    std::size_t capacity = 2;
+    while (capacity < wanted)
+    {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+/* Moving payloads in and out of slots, relocatable types are moved as raw bytes. */
+template<typename T>
+struct QueueSlotOps
+{
+    enum
+    {
+        isPrimitive = !TypeInfoQuery<T>::isComplex,
+        isRelocatable = TypeInfoQuery<T>::isRelocatable
+    };
+
+    /* moves the slot value into the live object dst and ends the slot value's lifetime */
+    static void relocateOut(T *dst, T *slot)
+    {
+        if (isRelocatable)
+        {
+            if (!isPrimitive)
+            {
+                dst->~T();
+            }
+            memcpy(static_cast<void *>(dst), static_cast<const void *>(slot), sizeof(T));
+        }
+        else
+        {
+            *dst = std::move(*slot);
+            slot->~T();
+        }
+    }
+
+    static void relocateOut(T *dst, T *slots, std::size_t count)
+    {
+        if (isRelocatable)
+        {
+            if (!isPrimitive)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    dst[i].~T();
+                }
+            }
+            memcpy(static_cast<void *>(dst), static_cast<const void *>(slots), count * sizeof(T));
+        }
+        else
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                relocateOut(dst + i, slots + i);
+            }
+        }
+    }
+
+    static void copyIn(T *slots, const T *src, std::size_t count)
+    {
+        if (isPrimitive)
+        {
+            memcpy(static_cast<void *>(slots), static_cast<const void *>(src), count * sizeof(T));
+        }
+        else
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                new(slots + i) T(src[i]);
+            }
+        }
+    }
+};
+
+/* Sleep/wake handshake of one queue side, see QueueWaitBlock. */
+class PCTK_ALIGN(PCTK_CACHELINE_SIZE) QueueWaiter
+{
+public:
+    QueueWaiter() PCTK_NOEXCEPT : m_epoch(0), m_waiters(0) {}
+
+    /* Retries attempt() until it returns true, spinning, yielding or sleeping in between. */
+    template<typename Attempt>
+    void waitUntil(Attempt attempt, QueueWaitMode mode)
+    {
+        for (int round = 0;; ++round)
+        {
+            if (attempt())
+            {
+                return;
+            }
+            if (round < QueueSpinRounds)
+            {
+                cpuRelax();
+                continue;
+            }
+            if (QueueWaitSpin == mode)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            /* announce the sleeper before the last attempt, notify() checks in the opposite order */
+            const int epoch = m_epoch.loadAcquire();
+            m_waiters.fetchAndAddOrdered(1);
+            const bool done = attempt();
+            if (!done)
+            {
+                m_epoch.wait(epoch);
+            }
+            m_waiters.fetchAndSubRelaxed(1);
+            if (done)
+            {
+                return;
+            }
+        }
+    }
+
+    void notify(bool all) PCTK_NOEXCEPT
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load() > 0)
+        {
+            m_epoch.fetchAndAddRelease(1);
+            if (all)
+            {
+                m_epoch.notifyAll();
+            }
+            else
+            {
+                m_epoch.notifyOne();
+            }
+        }
+    }
+
+private:
+    AtomicInt m_epoch;
+    AtomicInt m_waiters;
+};
+} // namespace detail
+
+/**
+ * @brief Bounded lock-free multi-producer multi-consumer queue after Dmitry Vyukov's array queue.
+ * Every slot carries a sequence number telling producers and consumers whose turn it is, so an operation costs one
+ * CAS on the shared position plus one release store on the slot. The capacity is rounded up to a power of two.
+ * The try*() calls never block, push()/pop() wait as chosen by QueueWaitMode.
+ */
+template<typename T>
+class MpmcQueue
+{
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+
+    explicit MpmcQueue(size_type capacity, QueueWaitMode mode = QueueWaitSpin)
+        : m_slots(PCTK_NULLPTR), m_mask(detail::queueCapacity(capacity) - 1), m_mode(mode)
+    {
+        PCTK_STATIC_ASSERT_X(PCTK_ALIGNOF(T) <= PCTK_ALIGNOF(std::max_align_t), "MpmcQueue: over-aligned T");
+        m_slots = new Slot[m_mask + 1];
+        for (size_type i = 0; i <= m_mask; ++i)
+        {
+            m_slots[i].sequence.store(i);
+        }
+        m_enqueuePos.store(0);
+        m_dequeuePos.store(0);
+    }
+
+    ~MpmcQueue()
+    {
+        if (!Ops::isPrimitive)
+        {
+            for (size_type pos = m_dequeuePos.load(); pos != m_enqueuePos.load(); ++pos)
+            {
+                m_slots[pos & m_mask].value()->~T();
+            }
+        }
+        delete[] m_slots;
+    }
+
+    size_type capacity() const PCTK_NOEXCEPT { return m_mask + 1; }
+
+    /**
+     * @brief Number of queued elements, only a snapshot while other threads operate on the queue.
+     */
+    size_type size() const PCTK_NOEXCEPT
+    {
+        const size_type dequeuePos = m_dequeuePos.loadAcquire();
+        const size_type enqueuePos = m_enqueuePos.loadAcquire();
+        const pctk_ptrdiff_t size = (pctk_ptrdiff_t) (enqueuePos - dequeuePos);
+        return size < 0 ? 0 : ((size_type) size > m_mask + 1 ? m_mask + 1 : (size_type) size);
+    }
+
+    bool isEmpty() const PCTK_NOEXCEPT { return 0 == this->size(); }
+
+    QueueWaitMode waitMode() const PCTK_NOEXCEPT { return m_mode; }
+
+    template<typename... Args>
+    bool tryEmplace(Args &&...args)
+    {
+        Slot *slot = this->claimPush();
+        if (!slot)
+        {
+            return false;
+        }
+        const size_type pos = slot->sequence.load();
+        new(slot->value()) T(std::forward<Args>(args)...);
+        slot->sequence.storeRelease(pos + 1);
+        this->notifyConsumers(false);
+        return true;
+    }
+
+    bool tryPush(const T &value) { return this->tryEmplace(value); }
+    bool tryPush(T &&value) { return this->tryEmplace(std::move(value)); }
+
+    bool tryPop(T &value)
+    {
+        Slot *slot = this->claimPop();
+        if (!slot)
+        {
+            return false;
+        }
+        const size_type pos = slot->sequence.load() - 1;
+        Ops::relocateOut(&value, slot->value());
+        slot->sequence.storeRelease(pos + m_mask + 1);
+        this->notifyProducers(false);
+        return true;
+    }
+
+    void push(const T &value)
+    {
+        m_notFull.waitUntil([&]() { return this->tryEmplace(value); }, m_mode);
+    }
+
+    void push(T &&value)
+    {
+        m_notFull.waitUntil([&]() { return this->tryEmplace(std::move(value)); }, m_mode);
+    }
+
+    void pop(T &value)
+    {
+        m_notEmpty.waitUntil([&]() { return this->tryPop(value); }, m_mode);
+    }
+
+    /**
+     * @brief Copies up to count items in one claim of consecutive slots, returns how many were pushed.
+     */
+    size_type tryPushN(const T *items, size_type count)
+    {
+        size_type pos = m_enqueuePos.load();
+        for (;;)
+        {
+            size_type ready = 0;
+            while (ready < count && m_slots[(pos + ready) & m_mask].sequence.loadAcquire() == pos + ready)
+            {
+                ++ready;
+            }
+            if (0 == ready)
+            {
+                const pctk_ptrdiff_t diff = (pctk_ptrdiff_t) (m_slots[pos & m_mask].sequence.loadAcquire() - pos);
+                if (diff < 0 || 0 == count)
+                {
+                    return 0;
+                }
+                pos = m_enqueuePos.load();
+                continue;
+            }
+            if (m_enqueuePos.testAndSetRelaxed(pos, pos + ready))
+            {
+                for (size_type i = 0; i < ready; ++i)
+                {
+                    Slot &slot = m_slots[(pos + i) & m_mask];
+                    Ops::copyIn(slot.value(), items + i, 1);
+                    slot.sequence.storeRelease(pos + i + 1);
+                }
+                this->notifyConsumers(ready > 1);
+                return ready;
+            }
+            pos = m_enqueuePos.load();
+        }
+    }
+
+    /**
+     * @brief Moves up to maxCount items into out in one claim of consecutive slots, returns how many were popped.
+     */
+    size_type tryPopN(T *out, size_type maxCount)
+    {
+        size_type pos = m_dequeuePos.load();
+        for (;;)
+        {
+            size_type ready = 0;
+            while (ready < maxCount && m_slots[(pos + ready) & m_mask].sequence.loadAcquire() == pos + ready + 1)
+            {
+                ++ready;
+            }
+            if (0 == ready)
+            {
+                const pctk_ptrdiff_t diff = (pctk_ptrdiff_t) (m_slots[pos & m_mask].sequence.loadAcquire()
+                                                              - (pos + 1));
+                if (diff < 0 || 0 == maxCount)
+                {
+                    return 0;
+                }
+                pos = m_dequeuePos.load();
+                continue;
+            }
+            if (m_dequeuePos.testAndSetRelaxed(pos, pos + ready))
+            {
+                for (size_type i = 0; i < ready; ++i)
+                {
+                    Slot &slot = m_slots[(pos + i) & m_mask];
+                    Ops::relocateOut(out + i, slot.value());
+                    slot.sequence.storeRelease(pos + i + m_mask + 1);
+                }
+                this->notifyProducers(ready > 1);
+                return ready;
+            }
+            pos = m_dequeuePos.load();
+        }
+    }
+
+    /**
+     * @brief Pushes all count items, waiting for room as often as needed.
+     */
+    void pushN(const T *items, size_type count)
+    {
+        size_type done = 0;
+        while (done < count)
+        {
+            m_notFull.waitUntil([&]() {
+                const size_type pushed = this->tryPushN(items + done, count - done);
+                done += pushed;
+                return pushed > 0;
+            }, m_mode);
+        }
+    }
+
+    /**
+     * @brief Waits until at least one item is available, then pops up to maxCount, returns how many were popped.
+     */
+    size_type popN(T *out, size_type maxCount)
+    {
+        size_type popped = 0;
+        if (maxCount > 0)
+        {
+            m_notEmpty.waitUntil([&]() { return 0 != (popped = this->tryPopN(out, maxCount)); }, m_mode);
+        }
+        return popped;
+    }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(MpmcQueue)
+
+    typedef detail::QueueSlotOps<T> Ops;
+
+    struct Slot
+    {
+        AtomicInteger<size_type> sequence;
+        typename std::aligned_storage<sizeof(T), PCTK_ALIGNOF(T)>::type storage;
+
+        T *value() PCTK_NOEXCEPT { return reinterpret_cast<T *>(&storage); }
+    };
+
+    Slot *claimPush() PCTK_NOEXCEPT
+    {
+        size_type pos = m_enqueuePos.load();
+        for (;;)
+        {
+            Slot *slot = &m_slots[pos & m_mask];
+            const pctk_ptrdiff_t diff = (pctk_ptrdiff_t) (slot->sequence.loadAcquire() - pos);
+            if (0 == diff)
+            {
+                if (m_enqueuePos.testAndSetRelaxed(pos, pos + 1))
+                {
+                    return slot;
+                }
+            }
+            else if (diff < 0)
+            {
+                return PCTK_NULLPTR;
+            }
+            pos = m_enqueuePos.load();
+        }
+    }
+
+    Slot *claimPop() PCTK_NOEXCEPT
+    {
+        size_type pos = m_dequeuePos.load();
+        for (;;)
+        {
+            Slot *slot = &m_slots[pos & m_mask];
+            const pctk_ptrdiff_t diff = (pctk_ptrdiff_t) (slot->sequence.loadAcquire() - (pos + 1));
+            if (0 == diff)
+            {
+                if (m_dequeuePos.testAndSetRelaxed(pos, pos + 1))
+                {
+                    return slot;
+                }
+            }
+            else if (diff < 0)
+            {
+                return PCTK_NULLPTR;
+            }
+            pos = m_dequeuePos.load();
+        }
+    }
+
+    void notifyConsumers(bool all) PCTK_NOEXCEPT
+    {
+        if (QueueWaitBlock == m_mode)
+        {
+            m_notEmpty.notify(all);
+        }
+    }
+
+    void notifyProducers(bool all) PCTK_NOEXCEPT
+    {
+        if (QueueWaitBlock == m_mode)
+        {
+            m_notFull.notify(all);
+        }
+    }
+
+    PaddedAtomic<size_type> m_enqueuePos;
+    PaddedAtomic<size_type> m_dequeuePos;
+    detail::QueueWaiter m_notEmpty;
+    detail::QueueWaiter m_notFull;
+    Slot *m_slots;
+    const size_type m_mask;
+    const QueueWaitMode m_mode;
+};
+
+/**
+ * @brief Bounded wait-free single-producer single-consumer ring buffer.
+ * Each side owns its index on a cache line of its own, next to a cached copy of the other side's index, so the
+ * shared line only moves when the cached view says the ring looks full or empty. Batches are copied as at most two
+ * contiguous runs, with memcpy for primitive and relocatable payloads. The capacity is rounded up to a power of two.
+ */
+template<typename T>
+class SpscRing
+{
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+
+    explicit SpscRing(size_type capacity, QueueWaitMode mode = QueueWaitSpin)
+        : m_buffer(PCTK_NULLPTR), m_mask(detail::queueCapacity(capacity) - 1), m_mode(mode)
+    {
+        PCTK_STATIC_ASSERT_X(PCTK_ALIGNOF(T) <= PCTK_ALIGNOF(std::max_align_t), "SpscRing: over-aligned T");
+        m_buffer = static_cast<T *>(::operator new((m_mask + 1) * sizeof(T)));
+        m_consumer.head.store(0);
+        m_consumer.cachedTail = 0;
+        m_producer.tail.store(0);
+        m_producer.cachedHead = 0;
+    }
+
+    ~SpscRing()
+    {
+        if (!Ops::isPrimitive)
+        {
+            for (size_type pos = m_consumer.head.load(); pos != m_producer.tail.load(); ++pos)
+            {
+                m_buffer[pos & m_mask].~T();
+            }
+        }
+        ::operator delete(m_buffer);
+    }
+
+    size_type capacity() const PCTK_NOEXCEPT { return m_mask + 1; }
+
+    /**
+     * @brief Number of queued elements, exact from either side, a snapshot from any other thread.
+     */
+    size_type size() const PCTK_NOEXCEPT
+    {
+        return m_producer.tail.loadAcquire() - m_consumer.head.loadAcquire();
+    }
+
+    bool isEmpty() const PCTK_NOEXCEPT { return 0 == this->size(); }
+
+    QueueWaitMode waitMode() const PCTK_NOEXCEPT { return m_mode; }
+
+    template<typename... Args>
+    bool tryEmplace(Args &&...args)
+    {
+        const size_type tail = m_producer.tail.load();
+        if (0 == this->freeSlots(tail, 1))
+        {
+            return false;
+        }
+        new(m_buffer + (tail & m_mask)) T(std::forward<Args>(args)...);
+        m_producer.tail.storeRelease(tail + 1);
+        this->notifyConsumer();
+        return true;
+    }
+
+    bool tryPush(const T &value) { return this->tryEmplace(value); }
+    bool tryPush(T &&value) { return this->tryEmplace(std::move(value)); }
+
+    bool tryPop(T &value)
+    {
+        const size_type head = m_consumer.head.load();
+        if (0 == this->usedSlots(head, 1))
+        {
+            return false;
+        }
+        Ops::relocateOut(&value, m_buffer + (head & m_mask));
+        m_consumer.head.storeRelease(head + 1);
+        this->notifyProducer();
+        return true;
+    }
+
+    /**
+     * @brief Consumer side access to the oldest element without popping it, PCTK_NULLPTR if the ring is empty.
+     */
+    T *front()
+    {
+        const size_type head = m_consumer.head.load();
+        return this->usedSlots(head, 1) ? m_buffer + (head & m_mask) : PCTK_NULLPTR;
+    }
+
+    /**
+     * @brief Consumer side, destroys the element returned by front().
+     */
+    void popFront()
+    {
+        const size_type head = m_consumer.head.load();
+        m_buffer[head & m_mask].~T();
+        m_consumer.head.storeRelease(head + 1);
+        this->notifyProducer();
+    }
+
+    void push(const T &value)
+    {
+        m_notFull.waitUntil([&]() { return this->tryEmplace(value); }, m_mode);
+    }
+
+    void push(T &&value)
+    {
+        m_notFull.waitUntil([&]() { return this->tryEmplace(std::move(value)); }, m_mode);
+    }
+
+    void pop(T &value)
+    {
+        m_notEmpty.waitUntil([&]() { return this->tryPop(value); }, m_mode);
+    }
+
+    /**
+     * @brief Copies up to count items, returns how many were pushed.
+     */
+    size_type tryPushN(const T *items, size_type count)
+    {
+        const size_type tail = m_producer.tail.load();
+        const size_type n = this->freeSlots(tail, count);
+        if (0 == n)
+        {
+            return 0;
+        }
+        const size_type index = tail & m_mask;
+        const size_type first = n < m_mask + 1 - index ? n : m_mask + 1 - index;
+        Ops::copyIn(m_buffer + index, items, first);
+        Ops::copyIn(m_buffer, items + first, n - first);
+        m_producer.tail.storeRelease(tail + n);
+        this->notifyConsumer();
+        return n;
+    }
+
+    /**
+     * @brief Moves up to maxCount items into out, returns how many were popped.
+     */
+    size_type tryPopN(T *out, size_type maxCount)
+    {
+        const size_type head = m_consumer.head.load();
+        const size_type n = this->usedSlots(head, maxCount);
+        if (0 == n)
+        {
+            return 0;
+        }
+        const size_type index = head & m_mask;
+        const size_type first = n < m_mask + 1 - index ? n : m_mask + 1 - index;
+        Ops::relocateOut(out, m_buffer + index, first);
+        Ops::relocateOut(out + first, m_buffer, n - first);
+        m_consumer.head.storeRelease(head + n);
+        this->notifyProducer();
+        return n;
+    }
+
+    /**
+     * @brief Pushes all count items, waiting for room as often as needed.
+     */
+    void pushN(const T *items, size_type count)
+    {
+        size_type done = 0;
+        while (done < count)
+        {
+            m_notFull.waitUntil([&]() {
+                const size_type pushed = this->tryPushN(items + done, count - done);
+                done += pushed;
+                return pushed > 0;
+            }, m_mode);
+        }
+    }
+
+    /**
+     * @brief Waits until at least one item is available, then pops up to maxCount, returns how many were popped.
+     */
+    size_type popN(T *out, size_type maxCount)
+    {
+        size_type popped = 0;
+        if (maxCount > 0)
+        {
+            m_notEmpty.waitUntil([&]() { return 0 != (popped = this->tryPopN(out, maxCount)); }, m_mode);
+        }
+        return popped;
+    }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(SpscRing)
+
+    typedef detail::QueueSlotOps<T> Ops;
+
+    /* room for up to wanted items, the consumer's head is only re-read when the cached one is not enough */
+    size_type freeSlots(size_type tail, size_type wanted) PCTK_NOEXCEPT
+    {
+        size_type available = m_mask + 1 - (tail - m_producer.cachedHead);
+        if (available < wanted)
+        {
+            m_producer.cachedHead = m_consumer.head.loadAcquire();
+            available = m_mask + 1 - (tail - m_producer.cachedHead);
+        }
+        return available < wanted ? available : wanted;
+    }
+
+    size_type usedSlots(size_type head, size_type wanted) PCTK_NOEXCEPT
+    {
+        size_type available = m_consumer.cachedTail - head;
+        if (available < wanted)
+        {
+            m_consumer.cachedTail = m_producer.tail.loadAcquire();
+            available = m_consumer.cachedTail - head;
+        }
+        return available < wanted ? available : wanted;
+    }
+
+    void notifyConsumer() PCTK_NOEXCEPT
+    {
+        if (QueueWaitBlock == m_mode)
+        {
+            m_notEmpty.notify(false);
+        }
+    }
+
+    void notifyProducer() PCTK_NOEXCEPT
+    {
+        if (QueueWaitBlock == m_mode)
+        {
+            m_notFull.notify(false);
+        }
+    }
+
+    struct PCTK_ALIGN(PCTK_CACHELINE_SIZE) ConsumerSide
+    {
+        AtomicInteger<size_type> head;
+        size_type cachedTail;
+    };
+
+    struct PCTK_ALIGN(PCTK_CACHELINE_SIZE) ProducerSide
+    {
+        AtomicInteger<size_type> tail;
+        size_type cachedHead;
+    };
+
+    ConsumerSide m_consumer;
+    ProducerSide m_producer;
+    detail::QueueWaiter m_notEmpty;
+    detail::QueueWaiter m_notFull;
+    T *m_buffer;
+    const size_type m_mask;
+    const QueueWaitMode m_mode;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKCONCURRENTQUEUE_H
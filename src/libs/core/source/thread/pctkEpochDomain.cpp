@@ -0,0 +1,482 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkEpochDomain.h>
+#include <pctkVector.h>
+
+#include <atomic>
+#include <new>
+#include <thread>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+static const std::size_t EpochCollectThreshold = 64;
+static const std::size_t EpochThreadEntryPruneSize = 16;
+
+struct EpochRetired
+{
+    void *pointer;
+    void (*deleter)(void *);
+    pctk_uint64_t epoch;
+};
+
+/* One thread's view of one domain. Only epoch is read by other threads, the rest is owner private. */
+struct PCTK_ALIGN(PCTK_CACHELINE_SIZE) EpochParticipant
+{
+    /* (global epoch << 1) | 1 while pinned, 0 while quiescent */
+    AtomicInteger<pctk_uint64_t> epoch;
+    AtomicInt inUse;
+    EpochParticipant *next;
+    void *memory;
+    int nesting;
+    bool transient;
+    std::size_t collectAt;
+    Vector<EpochRetired> retired;
+};
+
+struct EpochOrphans
+{
+    EpochOrphans() : lock(0), count(0) {}
+
+    void add(const EpochRetired *first, const EpochRetired *last)
+    {
+        if (first == last)
+        {
+            return;
+        }
+        while (!lock.testAndSetAcquire(0, 1))
+        {
+            cpuRelax();
+        }
+        retired.append(first, last);
+        count.storeRelease((int) retired.size());
+        lock.storeRelease(0);
+    }
+
+    /* moves the orphans retired at or before epoch into out, skipped when another thread is at it */
+    void take(Vector<EpochRetired> &out, pctk_uint64_t epoch)
+    {
+        if (0 == count.loadAcquire() || !lock.testAndSetAcquire(0, 1))
+        {
+            return;
+        }
+        Vector<EpochRetired> keep;
+        for (Vector<EpochRetired>::size_type i = 0; i < retired.size(); ++i)
+        {
+            if (retired[i].epoch <= epoch)
+            {
+                out.push_back(retired[i]);
+            }
+            else
+            {
+                keep.push_back(retired[i]);
+            }
+        }
+        retired.swap(keep);
+        count.storeRelease((int) retired.size());
+        lock.storeRelease(0);
+    }
+
+    AtomicInt lock;
+    AtomicInt count;
+    Vector<EpochRetired> retired;
+};
+
+/* Ids of the live domains, lets exiting threads skip the domains that were destroyed before them. */
+class EpochRegistry
+{
+public:
+    EpochRegistry() : m_lock(0), m_nextId(1) {}
+
+    void lock() PCTK_NOEXCEPT
+    {
+        while (!m_lock.testAndSetAcquire(0, 1))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void unlock() PCTK_NOEXCEPT { m_lock.storeRelease(0); }
+
+    pctk_uint64_t add()
+    {
+        this->lock();
+        const pctk_uint64_t id = m_nextId++;
+        m_live.push_back(id);
+        this->unlock();
+        return id;
+    }
+
+    void remove(pctk_uint64_t id)
+    {
+        this->lock();
+        for (Vector<pctk_uint64_t>::size_type i = 0; i < m_live.size(); ++i)
+        {
+            if (m_live[i] == id)
+            {
+                m_live.erase(m_live.begin() + i);
+                break;
+            }
+        }
+        this->unlock();
+    }
+
+    /* caller holds the lock */
+    bool isLive(pctk_uint64_t id) const PCTK_NOEXCEPT
+    {
+        for (Vector<pctk_uint64_t>::size_type i = 0; i < m_live.size(); ++i)
+        {
+            if (m_live[i] == id)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    AtomicInt m_lock;
+    pctk_uint64_t m_nextId;
+    Vector<pctk_uint64_t> m_live;
+};
+
+static EpochRegistry &epochRegistry()
+{
+    static EpochRegistry *registry = new EpochRegistry;
+    return *registry;
+}
+
+struct EpochThreadEntry
+{
+    EpochDomain *domain;
+    pctk_uint64_t id;
+    EpochParticipant *participant;
+};
+
+/* The participants of the calling thread, one per domain it used, detached when the thread exits. */
+class EpochThreadState
+{
+public:
+    EpochThreadState() : lastDomain(PCTK_NULLPTR), lastId(0), lastParticipant(PCTK_NULLPTR) {}
+
+    ~EpochThreadState()
+    {
+        exited = true;
+        EpochRegistry &registry = epochRegistry();
+        registry.lock();
+        for (Vector<EpochThreadEntry>::size_type i = 0; i < entries.size(); ++i)
+        {
+            if (registry.isLive(entries[i].id))
+            {
+                entries[i].domain->detach(entries[i].participant);
+            }
+        }
+        registry.unlock();
+    }
+
+    void prune()
+    {
+        EpochRegistry &registry = epochRegistry();
+        Vector<EpochThreadEntry> live;
+        registry.lock();
+        for (Vector<EpochThreadEntry>::size_type i = 0; i < entries.size(); ++i)
+        {
+            if (registry.isLive(entries[i].id))
+            {
+                live.push_back(entries[i]);
+            }
+        }
+        registry.unlock();
+        entries.swap(live);
+    }
+
+    Vector<EpochThreadEntry> entries;
+    EpochDomain *lastDomain;
+    pctk_uint64_t lastId;
+    EpochParticipant *lastParticipant;
+
+    static thread_local bool exited;
+};
+
+thread_local bool EpochThreadState::exited = false;
+static thread_local EpochThreadState epochThreadState;
+
+static EpochParticipant *newEpochParticipant()
+{
+    /* over-aligned new is C++17 only, align by hand so participants never share a line */
+    void *memory = ::operator new(sizeof(EpochParticipant) + PCTK_CACHELINE_SIZE);
+    const pctk_uintptr_t base = ((pctk_uintptr_t) memory + PCTK_CACHELINE_SIZE - 1)
+                                & ~(pctk_uintptr_t) (PCTK_CACHELINE_SIZE - 1);
+    EpochParticipant *participant = new(reinterpret_cast<void *>(base)) EpochParticipant;
+    participant->epoch.store(0);
+    participant->inUse.store(1);
+    participant->next = PCTK_NULLPTR;
+    participant->memory = memory;
+    participant->nesting = 0;
+    participant->transient = false;
+    participant->collectAt = EpochCollectThreshold;
+    return participant;
+}
+} // namespace detail
+
+EpochDomain::EpochDomain()
+    : m_epoch(0), m_participants(PCTK_NULLPTR), m_orphans(new detail::EpochOrphans), m_id(0)
+{
+    m_id = detail::epochRegistry().add();
+}
+
+EpochDomain::~EpochDomain()
+{
+    detail::epochRegistry().remove(m_id);
+    detail::EpochParticipant *participant = m_participants.load();
+    while (participant)
+    {
+        detail::EpochParticipant *next = participant->next;
+        for (Vector<detail::EpochRetired>::size_type i = 0; i < participant->retired.size(); ++i)
+        {
+            participant->retired[i].deleter(participant->retired[i].pointer);
+        }
+        void *memory = participant->memory;
+        participant->~EpochParticipant();
+        ::operator delete(memory);
+        participant = next;
+    }
+    for (Vector<detail::EpochRetired>::size_type i = 0; i < m_orphans->retired.size(); ++i)
+    {
+        m_orphans->retired[i].deleter(m_orphans->retired[i].pointer);
+    }
+    delete m_orphans;
+}
+
+detail::EpochParticipant *EpochDomain::participant()
+{
+    const bool exited = detail::EpochThreadState::exited;
+    detail::EpochThreadState *state = exited ? PCTK_NULLPTR : &detail::epochThreadState;
+    if (PCTK_LIKELY(state && state->lastDomain == this && state->lastId == m_id))
+    {
+        return state->lastParticipant;
+    }
+
+    detail::EpochParticipant *participant = PCTK_NULLPTR;
+    for (Vector<detail::EpochThreadEntry>::size_type i = 0; state && i < state->entries.size(); ++i)
+    {
+        if (state->entries[i].domain == this && state->entries[i].id == m_id)
+        {
+            participant = state->entries[i].participant;
+            break;
+        }
+    }
+
+    if (!participant)
+    {
+        participant = this->acquireParticipant();
+        if (!state)
+        {
+            /* the thread is exiting, hand the participant back as soon as it is unpinned */
+            participant->transient = true;
+            return participant;
+        }
+        if (state->entries.size() >= detail::EpochThreadEntryPruneSize)
+        {
+            state->prune();
+        }
+        const detail::EpochThreadEntry entry = {this, m_id, participant};
+        state->entries.push_back(entry);
+    }
+
+    state->lastDomain = this;
+    state->lastId = m_id;
+    state->lastParticipant = participant;
+    return participant;
+}
+
+detail::EpochParticipant *EpochDomain::acquireParticipant()
+{
+    for (detail::EpochParticipant *participant = m_participants.loadAcquire(); participant;
+         participant = participant->next)
+    {
+        if (0 == participant->inUse.load() && participant->inUse.testAndSetAcquire(0, 1))
+        {
+            return participant;
+        }
+    }
+    detail::EpochParticipant *participant = detail::newEpochParticipant();
+    detail::EpochParticipant *head;
+    do
+    {
+        head = m_participants.load();
+        participant->next = head;
+    } while (!m_participants.testAndSetRelease(head, participant));
+    return participant;
+}
+
+detail::EpochParticipant *EpochDomain::pin()
+{
+    detail::EpochParticipant *participant = this->participant();
+    if (0 == participant->nesting++)
+    {
+        participant->epoch.store((m_epoch.load() << 1) | 1);
+        /* the pin must be visible before any shared node is loaded, tryAdvance() checks in the opposite order */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    return participant;
+}
+
+void EpochDomain::unpin(detail::EpochParticipant *participant) PCTK_NOEXCEPT
+{
+    if (0 == --participant->nesting)
+    {
+        participant->epoch.storeRelease(0);
+        if (PCTK_UNLIKELY(participant->transient))
+        {
+            this->detach(participant);
+        }
+    }
+}
+
+void EpochDomain::detach(detail::EpochParticipant *participant)
+{
+    /* deleters are not run here, the registry lock may be held, other threads pick the nodes up */
+    participant->nesting = 0;
+    participant->epoch.storeRelease(0);
+    m_orphans->add(participant->retired.begin(), participant->retired.end());
+    participant->retired.clear();
+    participant->transient = false;
+    participant->collectAt = detail::EpochCollectThreshold;
+    participant->inUse.storeRelease(0);
+}
+
+bool EpochDomain::tryAdvance() PCTK_NOEXCEPT
+{
+    const pctk_uint64_t epoch = m_epoch.loadAcquire();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (detail::EpochParticipant *participant = m_participants.loadAcquire(); participant;
+         participant = participant->next)
+    {
+        const pctk_uint64_t local = participant->epoch.loadAcquire();
+        if ((local & 1) && (local >> 1) != epoch)
+        {
+            return false;
+        }
+    }
+    m_epoch.testAndSetOrdered(epoch, epoch + 1);
+    return true;
+}
+
+void EpochDomain::collect(detail::EpochParticipant *participant)
+{
+    const pctk_uint64_t epoch = m_epoch.loadAcquire();
+    if (epoch < 2)
+    {
+        return;
+    }
+    const pctk_uint64_t reclaimable = epoch - 2;
+
+    Vector<detail::EpochRetired> pending;
+    m_orphans->take(pending, reclaimable);
+    if (participant)
+    {
+        /* a thread retires in epoch order, the reclaimable nodes form a prefix */
+        Vector<detail::EpochRetired> &retired = participant->retired;
+        Vector<detail::EpochRetired>::size_type count = 0;
+        while (count < retired.size() && retired[count].epoch <= reclaimable)
+        {
+            ++count;
+        }
+        pending.append(retired.begin(), retired.begin() + count);
+        retired.erase(retired.begin(), retired.begin() + count);
+    }
+    /* deleters may retire further nodes, those go to the list we are no longer iterating */
+    for (Vector<detail::EpochRetired>::size_type i = 0; i < pending.size(); ++i)
+    {
+        pending[i].deleter(pending[i].pointer);
+    }
+}
+
+void EpochDomain::retire(void *pointer, void (*deleter)(void *))
+{
+    /* the node was unlinked before, read the epoch after the unlink is globally visible */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const detail::EpochRetired retired = {pointer, deleter, m_epoch.load()};
+    if (detail::EpochThreadState::exited)
+    {
+        m_orphans->add(&retired, &retired + 1);
+        return;
+    }
+
+    detail::EpochParticipant *participant = this->participant();
+    participant->retired.push_back(retired);
+    if (participant->retired.size() >= participant->collectAt)
+    {
+        this->tryAdvance();
+        this->collect(participant);
+        /* readers holding the epoch back must not turn every retire into a scan */
+        const std::size_t twice = 2 * participant->retired.size();
+        participant->collectAt = twice > detail::EpochCollectThreshold ? twice : detail::EpochCollectThreshold;
+    }
+}
+
+void EpochDomain::synchronize()
+{
+    const pctk_uint64_t target = m_epoch.loadAcquire() + 2;
+    while (m_epoch.loadAcquire() < target)
+    {
+        if (!this->tryAdvance())
+        {
+            std::this_thread::yield();
+        }
+    }
+    this->collect(detail::EpochThreadState::exited ? PCTK_NULLPTR : this->participant());
+}
+
+void EpochDomain::reclaim()
+{
+    this->tryAdvance();
+    this->collect(detail::EpochThreadState::exited ? PCTK_NULLPTR : this->participant());
+}
+
+std::size_t EpochDomain::retiredCount()
+{
+    return detail::EpochThreadState::exited ? 0 : this->participant()->retired.size();
+}
+
+bool EpochDomain::isPinned()
+{
+    if (detail::EpochThreadState::exited)
+    {
+        return false;
+    }
+    return this->participant()->nesting > 0;
+}
+
+EpochDomain *EpochDomain::globalInstance()
+{
+    static EpochDomain *domain = new EpochDomain;
+    return domain;
+}
+
+PCTK_END_NAMESPACE
@@ -0,0 +1,148 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKEPOCHDOMAIN_H
+#define _PCTKEPOCHDOMAIN_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+struct EpochParticipant;
+struct EpochOrphans;
+class EpochThreadState;
+
+template<typename T>
+void epochDeleteObject(void *pointer)
+{
+    delete static_cast<T *>(pointer);
+}
+} // namespace detail
+
+/**
+ * @brief Epoch based memory reclamation, the cheap alternative to HazardPointer when readers may hold a whole
+ * traversal instead of single nodes.
+ * Readers hold a Guard while they touch shared nodes, entering and leaving writes only the calling thread's own
+ * participant record. A node handed to retire() is tagged with the global epoch and freed once the epoch advanced
+ * twice, which it only does when every thread inside a Guard has observed the current one. Retire lists are local
+ * to the thread and collected every few dozen retires. A reader that stays inside a Guard holds back every node
+ * retired in the meantime, so guards must be short.
+ * A domain must outlive the structures using it, threads may exit before or after it is destroyed.
+ */
+class PCTK_CORE_API EpochDomain
+{
+public:
+    /**
+     * @brief Critical section of one thread, nodes loaded under the guard stay valid until it is destroyed. Nests.
+     */
+    class Guard
+    {
+    public:
+        explicit Guard(EpochDomain *domain = EpochDomain::globalInstance())
+            : m_domain(domain), m_participant(domain->pin()) {}
+
+        ~Guard() { m_domain->unpin(m_participant); }
+
+        template<typename T>
+        T *protect(const AtomicPointer<T> &src) const PCTK_NOEXCEPT { return src.loadAcquire(); }
+
+        EpochDomain *domain() const PCTK_NOEXCEPT { return m_domain; }
+
+    private:
+        PCTK_DISABLE_COPY_MOVE(Guard)
+
+        EpochDomain *m_domain;
+        detail::EpochParticipant *m_participant;
+    };
+
+    EpochDomain();
+
+    /**
+     * @brief Frees everything still retired, no thread may be inside a Guard of this domain any more.
+     */
+    ~EpochDomain();
+
+    /**
+     * @brief Hands an unlinked node over for deletion once no Guard that might have seen it is left.
+     */
+    template<typename T>
+    void retire(T *pointer)
+    {
+        this->retire(pointer, &detail::epochDeleteObject<T>);
+    }
+
+    void retire(void *pointer, void (*deleter)(void *));
+
+    /**
+     * @brief Waits for a grace period, every Guard that existed on entry has been destroyed on return, then frees
+     * what became reclaimable. Must not be called from inside a Guard of this domain.
+     */
+    void synchronize();
+
+    /**
+     * @brief Tries to advance the epoch once and frees what the calling thread, or exited threads, retired long
+     * enough ago.
+     */
+    void reclaim();
+
+    /**
+     * @brief Number of nodes retired by the calling thread and not freed yet.
+     */
+    std::size_t retiredCount();
+
+    pctk_uint64_t epoch() const PCTK_NOEXCEPT { return m_epoch.loadAcquire(); }
+
+    /**
+     * @brief Returns true if the calling thread holds a Guard of this domain.
+     */
+    bool isPinned();
+
+    static EpochDomain *globalInstance();
+
+private:
+    PCTK_DISABLE_COPY_MOVE(EpochDomain)
+
+    friend class detail::EpochThreadState;
+
+    detail::EpochParticipant *participant();
+    detail::EpochParticipant *acquireParticipant();
+    detail::EpochParticipant *pin();
+    void unpin(detail::EpochParticipant *participant) PCTK_NOEXCEPT;
+    void detach(detail::EpochParticipant *participant);
+    bool tryAdvance() PCTK_NOEXCEPT;
+    void collect(detail::EpochParticipant *participant);
+
+    AtomicInteger<pctk_uint64_t> m_epoch;
+    AtomicPointer<detail::EpochParticipant> m_participants;
+    detail::EpochOrphans *m_orphans;
+    pctk_uint64_t m_id;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKEPOCHDOMAIN_H
@@ -0,0 +1,150 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkFuture.h>
+
+#include <chrono>
+#include <system_error>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* Marks a callback stack that was already run, later callbacks are invoked right away. */
+static FutureCallback *futureClosedCallbacks() PCTK_NOEXCEPT
+{
+    static FutureCallback closed = {PCTK_NULLPTR, PCTK_NULLPTR};
+    return &closed;
+}
+
+std::exception_ptr futureCanceledError()
+{
+    return std::make_exception_ptr(std::system_error(std::make_error_code(std::errc::operation_canceled),
+                                                     "pctk::Future"));
+}
+
+FutureStateBase::FutureStateBase() PCTK_NOEXCEPT : m_refs(1), m_status(Pending), m_callbacks(PCTK_NULLPTR)
+{
+}
+
+FutureStateBase::~FutureStateBase()
+{
+}
+
+void FutureStateBase::wait() const PCTK_NOEXCEPT
+{
+    int status;
+    while (Ready != (status = m_status.loadAcquire()))
+    {
+        m_status.wait(status);
+    }
+}
+
+bool FutureStateBase::waitFor(pctk_int64_t timeoutNSecs) const PCTK_NOEXCEPT
+{
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point deadline = Clock::now() + std::chrono::nanoseconds(timeoutNSecs);
+    for (;;)
+    {
+        const int status = m_status.loadAcquire();
+        if (Ready == status)
+        {
+            return true;
+        }
+        const pctk_int64_t remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            deadline - Clock::now()).count();
+        if (remaining <= 0)
+        {
+            return false;
+        }
+        m_status.waitFor(status, remaining);
+    }
+}
+
+bool FutureStateBase::trySetError(const std::exception_ptr &error)
+{
+    if (!this->tryClaim())
+    {
+        return false;
+    }
+    m_error = error;
+    this->publish();
+    return true;
+}
+
+void FutureStateBase::breakPromise()
+{
+    if (!this->tryClaim())
+    {
+        return;
+    }
+    m_error = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+    this->publish();
+}
+
+void FutureStateBase::publish()
+{
+    m_status.storeRelease(Ready);
+    m_status.notifyAll();
+
+    /* the stack holds the newest callback first, run them in the order they were added */
+    FutureCallback *callback = m_callbacks.fetchAndStoreAcquire(futureClosedCallbacks());
+    FutureCallback *ordered = PCTK_NULLPTR;
+    while (callback)
+    {
+        FutureCallback *next = callback->next;
+        callback->next = ordered;
+        ordered = callback;
+        callback = next;
+    }
+    while (ordered)
+    {
+        FutureCallback *next = ordered->next;
+        ordered->invoke(ordered);
+        ordered = next;
+    }
+}
+
+void FutureStateBase::addCallback(FutureCallback *callback)
+{
+    FutureCallback *head = m_callbacks.loadAcquire();
+    for (;;)
+    {
+        if (futureClosedCallbacks() == head)
+        {
+            callback->invoke(callback);
+            return;
+        }
+        callback->next = head;
+        if (m_callbacks.testAndSetRelease(head, callback))
+        {
+            return;
+        }
+        head = m_callbacks.loadAcquire();
+    }
+}
+} // namespace detail
+
+PCTK_END_NAMESPACE
@@ -0,0 +1,801 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKFUTURE_H
+#define _PCTKFUTURE_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+#include <pctkException.h>
+#include <pctkThreadPool.h>
+#include <pctkVector.h>
+
+#include <exception>
+#include <future>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+PCTK_BEGIN_NAMESPACE
+
+template<typename T>
+class Future;
+template<typename T>
+class Promise;
+
+namespace detail
+{
+struct CancellationState
+{
+    AtomicInt refs;
+    AtomicInt requested;
+};
+} // namespace detail
+
+/**
+ * @brief Read side of a cancellation request, cheap to copy. A default constructed token is never cancelled.
+ * Cancellation is cooperative: tasks and continuations started with a token fail with std::errc::operation_canceled
+ * instead of running once it is requested, running ones may poll isCancellationRequested().
+ */
+class CancellationToken
+{
+public:
+    CancellationToken() PCTK_NOEXCEPT : m_state(PCTK_NULLPTR) {}
+
+    CancellationToken(const CancellationToken &other) PCTK_NOEXCEPT : m_state(other.m_state)
+    {
+        if (m_state)
+        {
+            m_state->refs.fetchAndAddRelaxed(1);
+        }
+    }
+
+    ~CancellationToken() { release(m_state); }
+
+    CancellationToken &operator=(CancellationToken other) PCTK_NOEXCEPT
+    {
+        std::swap(m_state, other.m_state);
+        return *this;
+    }
+
+    bool isCancellationRequested() const PCTK_NOEXCEPT { return m_state && 0 != m_state->requested.loadAcquire(); }
+
+    bool canBeCancelled() const PCTK_NOEXCEPT { return PCTK_NULLPTR != m_state; }
+
+private:
+    friend class CancellationSource;
+
+    explicit CancellationToken(detail::CancellationState *state) PCTK_NOEXCEPT : m_state(state)
+    {
+        m_state->refs.fetchAndAddRelaxed(1);
+    }
+
+    static void release(detail::CancellationState *state) PCTK_NOEXCEPT
+    {
+        if (state && 1 == state->refs.fetchAndSubOrdered(1))
+        {
+            delete state;
+        }
+    }
+
+    detail::CancellationState *m_state;
+};
+
+/**
+ * @brief Write side of a cancellation request, copies share the same request.
+ */
+class CancellationSource
+{
+public:
+    CancellationSource() : m_state(new detail::CancellationState)
+    {
+        m_state->refs.store(1);
+        m_state->requested.store(0);
+    }
+
+    CancellationSource(const CancellationSource &other) PCTK_NOEXCEPT : m_state(other.m_state)
+    {
+        m_state->refs.fetchAndAddRelaxed(1);
+    }
+
+    ~CancellationSource() { CancellationToken::release(m_state); }
+
+    CancellationSource &operator=(CancellationSource other) PCTK_NOEXCEPT
+    {
+        std::swap(m_state, other.m_state);
+        return *this;
+    }
+
+    void cancel() PCTK_NOEXCEPT { m_state->requested.storeRelease(1); }
+
+    bool isCancellationRequested() const PCTK_NOEXCEPT { return 0 != m_state->requested.loadAcquire(); }
+
+    CancellationToken token() const PCTK_NOEXCEPT { return CancellationToken(m_state); }
+
+private:
+    detail::CancellationState *m_state;
+};
+
+namespace detail
+{
+/* Heap node of one completion callback, invoke() runs and destroys it. next links the state's callback stack. */
+struct FutureCallback
+{
+    void (*invoke)(FutureCallback *callback);
+    FutureCallback *next;
+};
+
+template<typename F>
+struct FutureCallbackImpl : public FutureCallback
+{
+    template<typename U>
+    explicit FutureCallbackImpl(U &&f) : func(std::forward<U>(f))
+    {
+        this->invoke = &FutureCallbackImpl::run;
+        this->next = PCTK_NULLPTR;
+    }
+
+    static void run(FutureCallback *callback)
+    {
+        FutureCallbackImpl *self = static_cast<FutureCallbackImpl *>(callback);
+        self->func();
+        delete self;
+    }
+
+    F func;
+};
+
+PCTK_CORE_API std::exception_ptr futureCanceledError();
+
+/* Type independent part of the shared state: reference count, status, error and the callback stack. */
+class PCTK_CORE_API FutureStateBase
+{
+public:
+    void ref() PCTK_NOEXCEPT { m_refs.fetchAndAddRelaxed(1); }
+
+    void deref() PCTK_NOEXCEPT
+    {
+        if (1 == m_refs.fetchAndSubOrdered(1))
+        {
+            delete this;
+        }
+    }
+
+    bool isReady() const PCTK_NOEXCEPT { return Ready == m_status.loadAcquire(); }
+
+    /* valid once isReady() returned true */
+    const std::exception_ptr &error() const PCTK_NOEXCEPT { return m_error; }
+
+    void wait() const PCTK_NOEXCEPT;
+    bool waitFor(pctk_int64_t timeoutNSecs) const PCTK_NOEXCEPT;
+
+    bool trySetError(const std::exception_ptr &error);
+
+    /* fails the state with std::future_errc::broken_promise unless it was set */
+    void breakPromise();
+
+    /* runs callback right away when ready, otherwise on the thread that makes the state ready */
+    void addCallback(FutureCallback *callback);
+
+protected:
+    enum Status
+    {
+        Pending = 0,
+        /* a setter won the race and is storing the result */
+        Setting = 1,
+        Ready = 2
+    };
+
+    FutureStateBase() PCTK_NOEXCEPT;
+    virtual ~FutureStateBase();
+
+    bool tryClaim() PCTK_NOEXCEPT { return m_status.testAndSetAcquire(Pending, Setting); }
+    void publish();
+
+    std::exception_ptr m_error;
+
+private:
+    PCTK_DISABLE_COPY_MOVE(FutureStateBase)
+
+    AtomicInt m_refs;
+    AtomicInt m_status;
+    AtomicPointer<FutureCallback> m_callbacks;
+};
+
+/* The whole shared state of a Future<T>, the value lives inside it so a future costs one allocation. */
+template<typename T>
+class FutureState : public FutureStateBase
+{
+public:
+    FutureState() PCTK_NOEXCEPT : m_hasValue(false) {}
+
+    ~FutureState()
+    {
+        if (m_hasValue)
+        {
+            this->value().~T();
+        }
+    }
+
+    template<typename... Args>
+    bool trySetValue(Args &&...args)
+    {
+        if (!this->tryClaim())
+        {
+            return false;
+        }
+        try
+        {
+            new(&m_storage) T(std::forward<Args>(args)...);
+            m_hasValue = true;
+        }
+        catch (...)
+        {
+            m_error = std::current_exception();
+        }
+        this->publish();
+        return true;
+    }
+
+    const T &value() const PCTK_NOEXCEPT { return *reinterpret_cast<const T *>(&m_storage); }
+    T &value() PCTK_NOEXCEPT { return *reinterpret_cast<T *>(&m_storage); }
+
+private:
+    typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type m_storage;
+    bool m_hasValue;
+};
+
+template<>
+class FutureState<void> : public FutureStateBase
+{
+public:
+    bool trySetValue()
+    {
+        if (!this->tryClaim())
+        {
+            return false;
+        }
+        this->publish();
+        return true;
+    }
+};
+
+template<typename T>
+struct FutureValue
+{
+    typedef const T &Result;
+
+    static const T &get(FutureState<T> *state) PCTK_NOEXCEPT { return state->value(); }
+};
+
+template<>
+struct FutureValue<void>
+{
+    typedef void Result;
+
+    static void get(FutureState<void> *) PCTK_NOEXCEPT {}
+};
+
+/* Type of func(value), or of func() for void antecedents. */
+template<typename T, typename F>
+struct FutureThenResult
+{
+    typedef typename std::decay<decltype(std::declval<F &>()(std::declval<const T &>()))>::type Type;
+};
+
+template<typename F>
+struct FutureThenResult<void, F>
+{
+    typedef typename std::decay<decltype(std::declval<F &>()())>::type Type;
+};
+
+/* Calls func(args...) and stores what it returned in out. */
+template<typename R>
+struct FutureApply
+{
+    template<typename F, typename... Args>
+    static void run(FutureState<R> *out, F &func, Args &&...args)
+    {
+        out->trySetValue(func(std::forward<Args>(args)...));
+    }
+};
+
+template<>
+struct FutureApply<void>
+{
+    template<typename F, typename... Args>
+    static void run(FutureState<void> *out, F &func, Args &&...args)
+    {
+        func(std::forward<Args>(args)...);
+        out->trySetValue();
+    }
+};
+
+/* Calls func with the value of in, in may be null for void. */
+template<typename T>
+struct FutureInvoke
+{
+    template<typename R, typename F>
+    static void run(FutureState<R> *out, F &func, FutureState<T> *in)
+    {
+        FutureApply<R>::run(out, func, static_cast<const T &>(in->value()));
+    }
+};
+
+template<>
+struct FutureInvoke<void>
+{
+    template<typename R, typename F>
+    static void run(FutureState<R> *out, F &func, FutureState<void> *)
+    {
+        FutureApply<R>::run(out, func);
+    }
+};
+
+/**
+ * Runs func once in is ready and completes out with its result, func is skipped and the error forwarded when in
+ * failed or the token was cancelled. Also the body of async() tasks, with a null in.
+ */
+template<typename T, typename R, typename F>
+class FutureContinuation
+{
+public:
+    template<typename U>
+    FutureContinuation(FutureState<T> *in, FutureState<R> *out, U &&func, ThreadPool *pool,
+                       const CancellationToken &token)
+        : m_in(in), m_out(out), m_func(std::forward<U>(func)), m_pool(pool), m_token(token)
+    {
+        if (m_in)
+        {
+            m_in->ref();
+        }
+        m_out->ref();
+    }
+
+    FutureContinuation(FutureContinuation &&other)
+        : m_in(other.m_in), m_out(other.m_out), m_func(std::move(other.m_func)), m_pool(other.m_pool),
+          m_token(other.m_token)
+    {
+        other.m_in = PCTK_NULLPTR;
+        other.m_out = PCTK_NULLPTR;
+    }
+
+    ~FutureContinuation()
+    {
+        if (m_in)
+        {
+            m_in->deref();
+        }
+        if (m_out)
+        {
+            m_out->deref();
+        }
+    }
+
+    void operator()()
+    {
+        if (m_pool)
+        {
+            ThreadPool *pool = m_pool;
+            m_pool = PCTK_NULLPTR;
+            pool->submit(std::move(*this));
+            return;
+        }
+        if (m_token.isCancellationRequested())
+        {
+            m_out->trySetError(futureCanceledError());
+        }
+        else if (m_in && m_in->error())
+        {
+            m_out->trySetError(m_in->error());
+        }
+        else
+        {
+            try
+            {
+                FutureInvoke<T>::template run<R>(m_out, m_func, m_in);
+            }
+            catch (...)
+            {
+                m_out->trySetError(std::current_exception());
+            }
+        }
+    }
+
+private:
+    PCTK_DISABLE_COPY(FutureContinuation)
+
+    FutureState<T> *m_in;
+    FutureState<R> *m_out;
+    F m_func;
+    ThreadPool *m_pool;
+    CancellationToken m_token;
+};
+
+struct FutureAccess
+{
+    /* takes over one reference */
+    template<typename T>
+    static Future<T> adopt(FutureState<T> *state) PCTK_NOEXCEPT { return Future<T>(state); }
+
+    template<typename T>
+    static FutureState<T> *state(const Future<T> &future) PCTK_NOEXCEPT { return future.m_state; }
+};
+} // namespace detail
+
+/**
+ * @brief Result of an asynchronous operation, a cheap to copy handle on a reference counted shared state.
+ * Composition never blocks: then() attaches a continuation that receives the value, runs inline right away when the
+ * result is already there and otherwise on the thread that completes it, or on the given ThreadPool. Errors are
+ * carried as std::exception_ptr and skip continuations until get() rethrows them.
+ */
+template<typename T>
+class Future
+{
+public:
+    typedef T ValueType;
+
+    Future() PCTK_NOEXCEPT : m_state(PCTK_NULLPTR) {}
+
+    Future(const Future &other) PCTK_NOEXCEPT : m_state(other.m_state)
+    {
+        if (m_state)
+        {
+            m_state->ref();
+        }
+    }
+
+    Future(Future &&other) PCTK_NOEXCEPT : m_state(other.m_state) { other.m_state = PCTK_NULLPTR; }
+
+    ~Future()
+    {
+        if (m_state)
+        {
+            m_state->deref();
+        }
+    }
+
+    Future &operator=(Future other) PCTK_NOEXCEPT
+    {
+        std::swap(m_state, other.m_state);
+        return *this;
+    }
+
+    bool isValid() const PCTK_NOEXCEPT { return PCTK_NULLPTR != m_state; }
+
+    bool isReady() const PCTK_NOEXCEPT { return m_state && m_state->isReady(); }
+
+    bool hasError() const PCTK_NOEXCEPT { return this->isReady() && m_state->error(); }
+
+    void wait() const PCTK_NOEXCEPT { m_state->wait(); }
+
+    /**
+     * @brief Waits at most timeoutNSecs nanoseconds, returns true if the result is ready.
+     */
+    bool waitFor(pctk_int64_t timeoutNSecs) const PCTK_NOEXCEPT { return m_state->waitFor(timeoutNSecs); }
+
+    /**
+     * @brief Waits for the result and returns it, or rethrows the error it failed with.
+     */
+    typename detail::FutureValue<T>::Result get() const
+    {
+        if (!m_state)
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        m_state->wait();
+        if (m_state->error())
+        {
+            std::rethrow_exception(m_state->error());
+        }
+        return detail::FutureValue<T>::get(m_state);
+    }
+
+    /**
+     * @brief The error the future failed with, null while not ready or when it holds a value.
+     */
+    std::exception_ptr error() const
+    {
+        return this->isReady() ? m_state->error() : std::exception_ptr();
+    }
+
+    /**
+     * @brief Message of error() for diagnostics, empty without error.
+     */
+    std::string errorString() const { return util::getExceptionStr(this->error()); }
+
+    /**
+     * @brief Calls func(value), or func() for Future<void>, once ready and returns the future of its result.
+     */
+    template<typename F>
+    Future<typename detail::FutureThenResult<T, F>::Type> then(F &&func) const
+    {
+        return this->thenImpl(PCTK_NULLPTR, CancellationToken(), std::forward<F>(func));
+    }
+
+    /**
+     * @brief Same as then(func), but a continuation that has to wait runs on pool instead of the completing thread.
+     */
+    template<typename F>
+    Future<typename detail::FutureThenResult<T, F>::Type> then(ThreadPool &pool, F &&func) const
+    {
+        return this->thenImpl(&pool, CancellationToken(), std::forward<F>(func));
+    }
+
+    template<typename F>
+    Future<typename detail::FutureThenResult<T, F>::Type> then(const CancellationToken &token, F &&func) const
+    {
+        return this->thenImpl(PCTK_NULLPTR, token, std::forward<F>(func));
+    }
+
+    template<typename F>
+    Future<typename detail::FutureThenResult<T, F>::Type> then(ThreadPool &pool, const CancellationToken &token,
+                                                               F &&func) const
+    {
+        return this->thenImpl(&pool, token, std::forward<F>(func));
+    }
+
+    /**
+     * @brief Calls func() once ready, inline if it already is. func must not throw.
+     */
+    template<typename F>
+    void onReady(F &&func) const
+    {
+        m_state->addCallback(new detail::FutureCallbackImpl<typename std::decay<F>::type>(std::forward<F>(func)));
+    }
+
+private:
+    friend struct detail::FutureAccess;
+
+    explicit Future(detail::FutureState<T> *state) PCTK_NOEXCEPT : m_state(state) {}
+
+    template<typename F>
+    Future<typename detail::FutureThenResult<T, F>::Type> thenImpl(ThreadPool *pool, const CancellationToken &token,
+                                                                   F &&func) const
+    {
+        typedef typename detail::FutureThenResult<T, F>::Type R;
+        typedef detail::FutureContinuation<T, R, typename std::decay<F>::type> Continuation;
+        detail::FutureState<R> *out = new detail::FutureState<R>;
+        const bool ready = m_state->isReady();
+        Continuation continuation(m_state, out, std::forward<F>(func), ready ? PCTK_NULLPTR : pool, token);
+        if (ready)
+        {
+            /* no scheduler hop for a result that is already there */
+            continuation();
+        }
+        else
+        {
+            m_state->addCallback(new detail::FutureCallbackImpl<Continuation>(std::move(continuation)));
+        }
+        return detail::FutureAccess::adopt(out);
+    }
+
+    detail::FutureState<T> *m_state;
+};
+
+/**
+ * @brief Write side of a Future, the first setValue() or setException() wins. A promise destroyed without a result
+ * fails its future with std::future_errc::broken_promise.
+ */
+template<typename T>
+class Promise
+{
+public:
+    Promise() : m_state(new detail::FutureState<T>) {}
+
+    Promise(Promise &&other) PCTK_NOEXCEPT : m_state(other.m_state) { other.m_state = PCTK_NULLPTR; }
+
+    ~Promise()
+    {
+        if (m_state)
+        {
+            m_state->breakPromise();
+            m_state->deref();
+        }
+    }
+
+    Promise &operator=(Promise &&other) PCTK_NOEXCEPT
+    {
+        std::swap(m_state, other.m_state);
+        return *this;
+    }
+
+    Future<T> future() const
+    {
+        m_state->ref();
+        return detail::FutureAccess::adopt(m_state);
+    }
+
+    /**
+     * @brief Constructs the value from args, returns false if the future already had a result.
+     */
+    template<typename... Args>
+    bool setValue(Args &&...args)
+    {
+        return m_state->trySetValue(std::forward<Args>(args)...);
+    }
+
+    bool setException(const std::exception_ptr &error) { return m_state->trySetError(error); }
+
+private:
+    PCTK_DISABLE_COPY(Promise)
+
+    detail::FutureState<T> *m_state;
+};
+
+template<typename T>
+Future<typename std::decay<T>::type> makeReadyFuture(T &&value)
+{
+    Promise<typename std::decay<T>::type> promise;
+    promise.setValue(std::forward<T>(value));
+    return promise.future();
+}
+
+inline Future<void> makeReadyFuture()
+{
+    Promise<void> promise;
+    promise.setValue();
+    return promise.future();
+}
+
+template<typename T>
+Future<T> makeExceptionalFuture(const std::exception_ptr &error)
+{
+    Promise<T> promise;
+    promise.setException(error);
+    return promise.future();
+}
+
+/**
+ * @brief Runs func() on pool and returns the future of its result, exceptions thrown by func end up in the future.
+ */
+template<typename F>
+Future<typename detail::FutureThenResult<void, F>::Type> async(ThreadPool &pool, const CancellationToken &token,
+                                                               F &&func)
+{
+    typedef typename detail::FutureThenResult<void, F>::Type R;
+    typedef detail::FutureContinuation<void, R, typename std::decay<F>::type> Task;
+    detail::FutureState<R> *state = new detail::FutureState<R>;
+    pool.submit(Task(PCTK_NULLPTR, state, std::forward<F>(func), PCTK_NULLPTR, token));
+    return detail::FutureAccess::adopt(state);
+}
+
+template<typename F>
+Future<typename detail::FutureThenResult<void, F>::Type> async(ThreadPool &pool, F &&func)
+{
+    return pctk::async(pool, CancellationToken(), std::forward<F>(func));
+}
+
+namespace detail
+{
+/* Shared by the callbacks of whenAll() and whenAny(), freed by the last of them. */
+template<typename T, typename R>
+struct FutureJoin
+{
+    explicit FutureJoin(const Vector<Future<T> > &inputs)
+        : futures(inputs), refs((int) inputs.size()), remaining((int) inputs.size()) {}
+
+    void deref()
+    {
+        if (1 == refs.fetchAndSubOrdered(1))
+        {
+            delete this;
+        }
+    }
+
+    Vector<Future<T> > futures;
+    AtomicInt refs;
+    AtomicInt remaining;
+    Promise<R> promise;
+};
+
+template<typename T>
+struct FutureCollect
+{
+    typedef Vector<T> Type;
+
+    static void finish(FutureJoin<T, Type> *join)
+    {
+        Vector<T> values;
+        values.reserve(join->futures.size());
+        for (typename Vector<Future<T> >::size_type i = 0; i < join->futures.size(); ++i)
+        {
+            values.push_back(join->futures[i].get());
+        }
+        join->promise.setValue(std::move(values));
+    }
+
+    static Future<Type> empty() { return makeReadyFuture(Vector<T>()); }
+};
+
+template<>
+struct FutureCollect<void>
+{
+    typedef void Type;
+
+    static void finish(FutureJoin<void, void> *join) { join->promise.setValue(); }
+
+    static Future<void> empty() { return makeReadyFuture(); }
+};
+} // namespace detail
+
+/**
+ * @brief Future of all values in input order, fails with the first error as soon as any input fails.
+ */
+template<typename T>
+Future<typename detail::FutureCollect<T>::Type> whenAll(const Vector<Future<T> > &futures)
+{
+    typedef typename detail::FutureCollect<T>::Type R;
+    if (futures.empty())
+    {
+        return detail::FutureCollect<T>::empty();
+    }
+    detail::FutureJoin<T, R> *join = new detail::FutureJoin<T, R>(futures);
+    Future<R> result = join->promise.future();
+    for (typename Vector<Future<T> >::size_type i = 0; i < futures.size(); ++i)
+    {
+        join->futures[i].onReady([join, i]() {
+            const std::exception_ptr error = join->futures[i].error();
+            if (error)
+            {
+                join->promise.setException(error);
+            }
+            else if (1 == join->remaining.fetchAndSubOrdered(1))
+            {
+                detail::FutureCollect<T>::finish(join);
+            }
+            join->deref();
+        });
+    }
+    return result;
+}
+
+/**
+ * @brief Future of the index of the first input to become ready, with a value or an error.
+ */
+template<typename T>
+Future<std::size_t> whenAny(const Vector<Future<T> > &futures)
+{
+    if (futures.empty())
+    {
+        return makeExceptionalFuture<std::size_t>(
+            std::make_exception_ptr(std::future_error(std::future_errc::no_state)));
+    }
+    detail::FutureJoin<T, std::size_t> *join = new detail::FutureJoin<T, std::size_t>(futures);
+    Future<std::size_t> result = join->promise.future();
+    for (typename Vector<Future<T> >::size_type i = 0; i < futures.size(); ++i)
+    {
+        join->futures[i].onReady([join, i]() {
+            join->promise.setValue((std::size_t) i);
+            join->deref();
+        });
+    }
+    return result;
+}
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKFUTURE_H
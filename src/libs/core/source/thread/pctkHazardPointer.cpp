@@ -0,0 +1,279 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkHazardPointer.h>
+#include <pctkVector.h>
+
+#include <algorithm>
+#include <new>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+static const std::size_t HazardScanMinimum = 64;
+static const int HazardThreadCacheSize = 8;
+
+struct HazardRetired
+{
+    void *pointer;
+    void (*deleter)(void *);
+};
+
+/* Process wide record list and orphan list. Never destroyed, threads may exit after main() returned. */
+class HazardDomain
+{
+public:
+    HazardDomain() : m_head(PCTK_NULLPTR), m_recordCount(0), m_orphanLock(0), m_orphanCount(0) {}
+
+    HazardRecord *acquire()
+    {
+        for (HazardRecord *record = m_head.loadAcquire(); record; record = record->next)
+        {
+            if (0 == record->inUse.load() && record->inUse.testAndSetAcquire(0, 1))
+            {
+                return record;
+            }
+        }
+
+        /* over-aligned new is C++17 only, align by hand, records live as long as the process */
+        void *memory = ::operator new(sizeof(HazardRecord) + PCTK_CACHELINE_SIZE);
+        const pctk_uintptr_t base = ((pctk_uintptr_t) memory + PCTK_CACHELINE_SIZE - 1)
+                                    & ~(pctk_uintptr_t) (PCTK_CACHELINE_SIZE - 1);
+        HazardRecord *record = new(reinterpret_cast<void *>(base)) HazardRecord;
+        record->pointer.store(PCTK_NULLPTR);
+        record->inUse.store(1);
+        HazardRecord *head;
+        do
+        {
+            head = m_head.load();
+            record->next = head;
+        } while (!m_head.testAndSetRelease(head, record));
+        m_recordCount.fetchAndAddRelaxed(1);
+        return record;
+    }
+
+    void release(HazardRecord *record) PCTK_NOEXCEPT
+    {
+        record->pointer.storeRelease(PCTK_NULLPTR);
+        record->inUse.storeRelease(0);
+    }
+
+    int recordCount() const PCTK_NOEXCEPT { return m_recordCount.load(); }
+
+    /* Frees every node of retired that no record protects, survivors go back into retired. */
+    void scan(Vector<HazardRetired> &retired)
+    {
+        this->adoptOrphans(retired);
+
+        Vector<HazardRetired> pending;
+        pending.swap(retired);
+
+        /* pairs with the fence in HazardPointer::tryProtect(), nodes were unlinked before they were retired */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        Vector<const void *> hazards;
+        hazards.reserve((Vector<const void *>::size_type) this->recordCount());
+        for (HazardRecord *record = m_head.loadAcquire(); record; record = record->next)
+        {
+            const void *pointer = record->pointer.loadAcquire();
+            if (pointer)
+            {
+                hazards.push_back(pointer);
+            }
+        }
+        std::sort(hazards.begin(), hazards.end());
+
+        /* deleters may retire further nodes, those land in retired and wait for the next scan */
+        for (Vector<HazardRetired>::size_type i = 0; i < pending.size(); ++i)
+        {
+            if (std::binary_search(hazards.begin(), hazards.end(), (const void *) pending[i].pointer))
+            {
+                retired.push_back(pending[i]);
+            }
+            else
+            {
+                pending[i].deleter(pending[i].pointer);
+            }
+        }
+    }
+
+    void addOrphans(const Vector<HazardRetired> &retired)
+    {
+        if (retired.empty())
+        {
+            return;
+        }
+        this->lockOrphans();
+        m_orphans.append(retired.begin(), retired.end());
+        m_orphanCount.storeRelease((int) m_orphans.size());
+        this->unlockOrphans();
+    }
+
+private:
+    void adoptOrphans(Vector<HazardRetired> &retired)
+    {
+        if (0 == m_orphanCount.loadAcquire() || !m_orphanLock.testAndSetAcquire(0, 1))
+        {
+            return;
+        }
+        retired.append(m_orphans.begin(), m_orphans.end());
+        m_orphans.clear();
+        m_orphanCount.storeRelease(0);
+        this->unlockOrphans();
+    }
+
+    void lockOrphans() PCTK_NOEXCEPT
+    {
+        while (!m_orphanLock.testAndSetAcquire(0, 1))
+        {
+            cpuRelax();
+        }
+    }
+
+    void unlockOrphans() PCTK_NOEXCEPT { m_orphanLock.storeRelease(0); }
+
+    AtomicPointer<HazardRecord> m_head;
+    AtomicInt m_recordCount;
+    AtomicInt m_orphanLock;
+    AtomicInt m_orphanCount;
+    Vector<HazardRetired> m_orphans;
+};
+
+static HazardDomain &hazardDomain()
+{
+    static HazardDomain *domain = new HazardDomain;
+    return *domain;
+}
+
+/* Per thread retire list and a few cached records, handed back to the domain when the thread exits. */
+class HazardThreadState
+{
+public:
+    HazardThreadState() : cachedCount(0) {}
+
+    ~HazardThreadState()
+    {
+        exited = true;
+        HazardDomain &domain = hazardDomain();
+        for (int i = 0; i < cachedCount; ++i)
+        {
+            domain.release(cached[i]);
+        }
+        cachedCount = 0;
+        domain.scan(retired);
+        domain.addOrphans(retired);
+        retired.clear();
+    }
+
+    Vector<HazardRetired> retired;
+    HazardRecord *cached[HazardThreadCacheSize];
+    int cachedCount;
+
+    /* set once the state is gone, hazard pointers destroyed later in thread exit go straight to the domain */
+    static thread_local bool exited;
+};
+
+thread_local bool HazardThreadState::exited = false;
+static thread_local HazardThreadState hazardThreadState;
+} // namespace detail
+
+HazardPointer::HazardPointer()
+    : m_record(PCTK_NULLPTR)
+{
+    detail::HazardThreadState &state = detail::hazardThreadState;
+    if (!detail::HazardThreadState::exited && state.cachedCount > 0)
+    {
+        m_record = state.cached[--state.cachedCount];
+    }
+    else
+    {
+        m_record = detail::hazardDomain().acquire();
+    }
+}
+
+HazardPointer::~HazardPointer()
+{
+    this->release();
+}
+
+void HazardPointer::release() PCTK_NOEXCEPT
+{
+    if (!m_record)
+    {
+        return;
+    }
+    if (!detail::HazardThreadState::exited && detail::hazardThreadState.cachedCount < detail::HazardThreadCacheSize)
+    {
+        m_record->pointer.storeRelease(PCTK_NULLPTR);
+        detail::hazardThreadState.cached[detail::hazardThreadState.cachedCount++] = m_record;
+    }
+    else
+    {
+        detail::hazardDomain().release(m_record);
+    }
+    m_record = PCTK_NULLPTR;
+}
+
+void HazardPointer::retire(void *pointer, void (*deleter)(void *))
+{
+    detail::HazardDomain &domain = detail::hazardDomain();
+    const detail::HazardRetired retired = {pointer, deleter};
+    if (detail::HazardThreadState::exited)
+    {
+        Vector<detail::HazardRetired> orphan;
+        orphan.push_back(retired);
+        domain.addOrphans(orphan);
+        return;
+    }
+
+    Vector<detail::HazardRetired> &list = detail::hazardThreadState.retired;
+    list.push_back(retired);
+    /* at most recordCount nodes survive a scan, so scanning at twice that frees at least half of the list */
+    const std::size_t threshold = 2 * (std::size_t) domain.recordCount();
+    if (list.size() >= (threshold > detail::HazardScanMinimum ? threshold : detail::HazardScanMinimum))
+    {
+        domain.scan(list);
+    }
+}
+
+void HazardPointer::reclaim()
+{
+    if (!detail::HazardThreadState::exited)
+    {
+        detail::hazardDomain().scan(detail::hazardThreadState.retired);
+    }
+}
+
+std::size_t HazardPointer::retiredCount() PCTK_NOEXCEPT
+{
+    return detail::HazardThreadState::exited ? 0 : detail::hazardThreadState.retired.size();
+}
+
+int HazardPointer::recordCount() PCTK_NOEXCEPT
+{
+    return detail::hazardDomain().recordCount();
+}
+
+PCTK_END_NAMESPACE
@@ -0,0 +1,171 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKHAZARDPOINTER_H
+#define _PCTKHAZARDPOINTER_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+
+#include <atomic>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* One published hazard, owned by at most one HazardPointer at a time. Records are never freed. */
+struct PCTK_ALIGN(PCTK_CACHELINE_SIZE) HazardRecord
+{
+    AtomicPointer<void> pointer;
+    AtomicInt inUse;
+    HazardRecord *next;
+};
+
+template<typename T>
+void hazardDeleteObject(void *pointer)
+{
+    delete static_cast<T *>(pointer);
+}
+} // namespace detail
+
+/**
+ * @brief Hazard pointer, protects one node of a lock-free structure against being freed while it is read.
+ * A reader publishes the pointer it is about to dereference with protect(), writers unlink nodes and hand them to
+ * retire(). Retired nodes go to a list local to the retiring thread, which is scanned against all published hazards
+ * once it grows past twice the number of hazard records, so reclamation costs amortized O(1) per retire() and at
+ * most O(threads * hazards) nodes are waiting at any time. Nodes left over by exiting threads are adopted by the next
+ * scan of any thread.
+ *
+ * @code
+ *  pctk::HazardPointer hazard;
+ *  Node *node = hazard.protect(m_head);    // safe to dereference until reset() or hazard goes out of scope
+ *  ...
+ *  if (m_head.testAndSetOrdered(node, node->next)) pctk::HazardPointer::retire(node);
+ * @endcode
+ */
+class PCTK_CORE_API HazardPointer
+{
+public:
+    HazardPointer();
+    ~HazardPointer();
+
+    HazardPointer(HazardPointer &&other) PCTK_NOEXCEPT : m_record(other.m_record) { other.m_record = PCTK_NULLPTR; }
+
+    HazardPointer &operator=(HazardPointer &&other) PCTK_NOEXCEPT
+    {
+        if (this != &other)
+        {
+            this->release();
+            m_record = other.m_record;
+            other.m_record = PCTK_NULLPTR;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Loads src and protects the result, retrying until the published hazard matches src.
+     */
+    template<typename T>
+    T *protect(const AtomicPointer<T> &src) PCTK_NOEXCEPT
+    {
+        T *pointer = src.loadAcquire();
+        while (!this->tryProtect(pointer, src))
+        {
+        }
+        return pointer;
+    }
+
+    /**
+     * @brief Protects pointer, a value previously loaded from src, returns false and stores the current value of src
+     * into pointer if src changed in the meantime, in which case pointer is not protected.
+     */
+    template<typename T>
+    bool tryProtect(T *&pointer, const AtomicPointer<T> &src) PCTK_NOEXCEPT
+    {
+        T *const expected = pointer;
+        this->resetProtection(expected);
+        /* the hazard must be visible before src is validated, a reclaimer scans in the opposite order */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        pointer = src.loadAcquire();
+        if (PCTK_UNLIKELY(pointer != expected))
+        {
+            this->resetProtection();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Publishes pointer without validation, for nodes the caller knows to be alive, e.g. while a neighbour
+     * protecting a link to them is still held. Does nothing on a moved-from hazard, which protects nothing.
+     */
+    void resetProtection(const void *pointer = PCTK_NULLPTR) PCTK_NOEXCEPT
+    {
+        if (m_record)
+        {
+            m_record->pointer.storeRelease(const_cast<void *>(pointer));
+        }
+    }
+
+    bool isEmpty() const PCTK_NOEXCEPT { return PCTK_NULLPTR == m_record; }
+
+    /**
+     * @brief Hands an unlinked node over for deletion once no hazard pointer protects it any more.
+     */
+    template<typename T>
+    static void retire(T *pointer)
+    {
+        HazardPointer::retire(pointer, &detail::hazardDeleteObject<T>);
+    }
+
+    static void retire(void *pointer, void (*deleter)(void *));
+
+    /**
+     * @brief Scans now, frees every node retired by the calling thread or orphaned by exited threads that is not
+     * protected any more.
+     */
+    static void reclaim();
+
+    /**
+     * @brief Number of nodes retired by the calling thread and not freed yet.
+     */
+    static std::size_t retiredCount() PCTK_NOEXCEPT;
+
+    /**
+     * @brief Number of hazard records ever created, which bounds the number of protected nodes.
+     */
+    static int recordCount() PCTK_NOEXCEPT;
+
+private:
+    PCTK_DISABLE_COPY(HazardPointer)
+
+    void release() PCTK_NOEXCEPT;
+
+    detail::HazardRecord *m_record;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKHAZARDPOINTER_H
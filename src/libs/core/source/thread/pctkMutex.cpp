@@ -0,0 +1,106 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkMutex.h>
+
+#include <chrono>
+#include <thread>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+static const int LockSpinLimit = 128;
+
+int lockSpinCount() PCTK_NOEXCEPT
+{
+    static const int count = std::thread::hardware_concurrency() > 1 ? LockSpinLimit : 0;
+    return count;
+}
+} // namespace detail
+
+bool Mutex::spin() PCTK_NOEXCEPT
+{
+    /* exponential backoff between reads, the owner of a short section is usually gone within a few hundred cycles */
+    const int limit = detail::lockSpinCount();
+    int backoff = 1;
+    for (int spins = 0; spins < limit; spins += backoff, backoff = backoff < 16 ? backoff << 1 : backoff)
+    {
+        const int state = m_state.load();
+        if (Unlocked == state)
+        {
+            if (m_state.testAndSetAcquire(Unlocked, Locked))
+            {
+                return true;
+            }
+        }
+        else if (Contended == state)
+        {
+            /* others already parked, the section is a long one */
+            return false;
+        }
+        for (int i = 0; i < backoff; ++i)
+        {
+            detail::cpuRelax();
+        }
+    }
+    return false;
+}
+
+void Mutex::lockSlow() PCTK_NOEXCEPT
+{
+    if (this->spin())
+    {
+        return;
+    }
+    /* from here on the state stays Contended while we hold the lock, we cannot know whether others parked meanwhile */
+    while (Unlocked != m_state.fetchAndStoreAcquire(Contended))
+    {
+        m_state.wait(Contended);
+    }
+}
+
+bool Mutex::tryLockFor(pctk_int64_t timeoutNSecs) PCTK_NOEXCEPT
+{
+    if (m_state.testAndSetAcquire(Unlocked, Locked) || this->spin())
+    {
+        return true;
+    }
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point deadline = Clock::now() + std::chrono::nanoseconds(timeoutNSecs);
+    while (Unlocked != m_state.fetchAndStoreAcquire(Contended))
+    {
+        const pctk_int64_t remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            deadline - Clock::now()).count();
+        if (remaining <= 0 || !m_state.waitFor(Contended, remaining))
+        {
+            /* our Contended store may hide parked threads, leaving it in place costs the owner one extra wake */
+            return false;
+        }
+    }
+    return true;
+}
+
+PCTK_END_NAMESPACE
@@ -0,0 +1,114 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKMUTEX_H
+#define _PCTKMUTEX_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* Spin budget before parking, 0 on a single CPU where the owner cannot run while we spin. */
+PCTK_CORE_API int lockSpinCount() PCTK_NOEXCEPT;
+} // namespace detail
+
+/**
+ * @brief One word mutex, uncontended lock() and unlock() are a single atomic each.
+ * A contended lock() spins while the owner is likely to release soon and parks on the word with AtomicInt::wait()
+ * otherwise, spinning stops as soon as other threads are already parked. unlock() only enters the kernel when
+ * someone is parked. Not recursive.
+ */
+class PCTK_CORE_API Mutex
+{
+public:
+    PCTK_CONSTEXPR Mutex() PCTK_NOEXCEPT : m_state(Unlocked) {}
+
+    void lock() PCTK_NOEXCEPT
+    {
+        if (PCTK_LIKELY(m_state.testAndSetAcquire(Unlocked, Locked)))
+        {
+            return;
+        }
+        this->lockSlow();
+    }
+
+    bool tryLock() PCTK_NOEXCEPT { return m_state.testAndSetAcquire(Unlocked, Locked); }
+
+    /**
+     * @brief Tries for at most timeoutNSecs nanoseconds, returns true if the mutex was acquired.
+     */
+    bool tryLockFor(pctk_int64_t timeoutNSecs) PCTK_NOEXCEPT;
+
+    void unlock() PCTK_NOEXCEPT
+    {
+        if (PCTK_UNLIKELY(Contended == m_state.fetchAndStoreRelease(Unlocked)))
+        {
+            m_state.notifyOne();
+        }
+    }
+
+    bool isLocked() const PCTK_NOEXCEPT { return Unlocked != m_state.load(); }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(Mutex)
+
+    enum State
+    {
+        Unlocked = 0,
+        Locked = 1,
+        /* locked and threads may be parked, the unlock must wake one */
+        Contended = 2
+    };
+
+    void lockSlow() PCTK_NOEXCEPT;
+    bool spin() PCTK_NOEXCEPT;
+
+    AtomicInt m_state;
+};
+
+PCTK_STATIC_ASSERT_X(sizeof(Mutex) == 4, "Mutex must fit in 4 bytes");
+
+/**
+ * @brief Locks on construction and unlocks on destruction, for Mutex, SpinLock and ReadWriteLock write access.
+ */
+template<typename Lock>
+class LockGuard
+{
+public:
+    explicit LockGuard(Lock &lock) PCTK_NOEXCEPT : m_lock(lock) { m_lock.lock(); }
+    ~LockGuard() { m_lock.unlock(); }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(LockGuard)
+
+    Lock &m_lock;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKMUTEX_H
@@ -0,0 +1,172 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKRCU_H
+#define _PCTKRCU_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+#include <pctkEpochDomain.h>
+
+#include <thread>
+
+PCTK_BEGIN_NAMESPACE
+
+/**
+ * @brief Read-copy-update cell for read mostly values such as configuration or routing tables.
+ * Readers take a ReadLock and dereference the current snapshot, the snapshot pointer is a plain loadAcquire and
+ * the only store goes to the calling thread's own EpochDomain participant, so readers share no written cache line.
+ * Writers copy the current value, change the copy and publish it, the replaced snapshot is retired to the domain
+ * and freed once every reader that might still see it has left. Writers are serialized against each other only.
+ * The domain must outlive the cell.
+ */
+template<typename T>
+class Rcu
+{
+public:
+    /**
+     * @brief Snapshot held by one reader, stays valid and unchanged until the lock is destroyed.
+     */
+    class ReadLock
+    {
+    public:
+        explicit ReadLock(const Rcu &rcu) : m_guard(rcu.m_domain), m_value(m_guard.protect(rcu.m_value)) {}
+
+        const T *get() const PCTK_NOEXCEPT { return m_value; }
+        const T &operator*() const PCTK_NOEXCEPT { return *m_value; }
+        const T *operator->() const PCTK_NOEXCEPT { return m_value; }
+
+    private:
+        PCTK_DISABLE_COPY_MOVE(ReadLock)
+
+        EpochDomain::Guard m_guard;
+        const T *m_value;
+    };
+
+    explicit Rcu(const T &value = T(), EpochDomain *domain = EpochDomain::globalInstance())
+        : m_domain(domain), m_value(new T(value)), m_writer(0) {}
+
+    /**
+     * @brief Frees the current snapshot, no ReadLock of this cell may be left.
+     */
+    ~Rcu() { delete m_value.load(); }
+
+    /**
+     * @brief Returns a copy of the current value.
+     */
+    T load() const
+    {
+        ReadLock lock(*this);
+        return *lock;
+    }
+
+    /**
+     * @brief Publishes a copy of value, readers that already hold a ReadLock keep their snapshot.
+     */
+    void store(const T &value)
+    {
+        this->exchange(new T(value));
+    }
+
+    /**
+     * @brief Copies the current value, calls func(T &) on the copy and publishes it. Concurrent updates are applied
+     * one after the other, none of them is lost. Nothing is published if func throws.
+     */
+    template<typename Func>
+    void update(Func func)
+    {
+        WriterLocker locker(this);
+        T *next = new T(*m_value.load());
+        try
+        {
+            func(*next);
+        }
+        catch (...)
+        {
+            delete next;
+            throw;
+        }
+        T *previous = m_value.load();
+        m_value.storeRelease(next);
+        locker.unlock();
+        m_domain->retire(previous);
+    }
+
+    /**
+     * @brief Waits until no reader holds a snapshot replaced before the call and frees them.
+     */
+    void synchronize() { m_domain->synchronize(); }
+
+    EpochDomain *domain() const PCTK_NOEXCEPT { return m_domain; }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(Rcu)
+
+    class WriterLocker
+    {
+    public:
+        explicit WriterLocker(Rcu *rcu) : m_rcu(rcu)
+        {
+            /* writes come a few times a minute, a plain spin with yield is enough */
+            while (!m_rcu->m_writer.testAndSetAcquire(0, 1))
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        ~WriterLocker() { this->unlock(); }
+
+        void unlock() PCTK_NOEXCEPT
+        {
+            if (m_rcu)
+            {
+                m_rcu->m_writer.storeRelease(0);
+                m_rcu = PCTK_NULLPTR;
+            }
+        }
+
+    private:
+        PCTK_DISABLE_COPY_MOVE(WriterLocker)
+
+        Rcu *m_rcu;
+    };
+
+    void exchange(T *next)
+    {
+        WriterLocker locker(this);
+        T *previous = m_value.load();
+        m_value.storeRelease(next);
+        locker.unlock();
+        m_domain->retire(previous);
+    }
+
+    EpochDomain *m_domain;
+    AtomicPointer<T> m_value;
+    AtomicInt m_writer;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKRCU_H
@@ -0,0 +1,147 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkReadWriteLock.h>
+#include <pctkMutex.h>
+
+PCTK_BEGIN_NAMESPACE
+
+bool ReadWriteLock::tryLockForRead() PCTK_NOEXCEPT
+{
+    int state = m_state.load();
+    while (!(state & (Writer | WriterWaiting)))
+    {
+        if (m_state.testAndSetAcquire(state, state + Reader))
+        {
+            return true;
+        }
+        state = m_state.load();
+    }
+    return false;
+}
+
+bool ReadWriteLock::tryLockForWrite() PCTK_NOEXCEPT
+{
+    int state = m_state.load();
+    while (!(state & Writer) && state < Reader)
+    {
+        /* keeps the waiting bits, their owners are woken by our unlock */
+        if (m_state.testAndSetAcquire(state, state | Writer))
+        {
+            return true;
+        }
+        state = m_state.load();
+    }
+    return false;
+}
+
+void ReadWriteLock::lockForReadSlow() PCTK_NOEXCEPT
+{
+    int spins = detail::lockSpinCount();
+    for (;;)
+    {
+        int state = m_state.load();
+        if (!(state & (Writer | WriterWaiting)))
+        {
+            if (m_state.testAndSetAcquire(state, state + Reader))
+            {
+                return;
+            }
+            continue;
+        }
+        if (spins > 0)
+        {
+            --spins;
+            detail::cpuRelax();
+            continue;
+        }
+        if (!(state & ReadersWaiting))
+        {
+            if (!m_state.testAndSetRelaxed(state, state | ReadersWaiting))
+            {
+                continue;
+            }
+            state |= ReadersWaiting;
+        }
+        m_state.wait(state);
+    }
+}
+
+void ReadWriteLock::lockForWriteSlow() PCTK_NOEXCEPT
+{
+    int spins = detail::lockSpinCount();
+    for (;;)
+    {
+        int state = m_state.load();
+        if (!(state & Writer) && state < Reader)
+        {
+            /* WriterWaiting stays set, another writer may have set it, unlock() clears it and wakes everybody */
+            if (m_state.testAndSetAcquire(state, state | Writer))
+            {
+                return;
+            }
+            continue;
+        }
+        if (spins > 0)
+        {
+            --spins;
+            detail::cpuRelax();
+            continue;
+        }
+        if (!(state & WriterWaiting))
+        {
+            /* from now on new readers queue up behind us */
+            if (!m_state.testAndSetRelaxed(state, state | WriterWaiting))
+            {
+                continue;
+            }
+            state |= WriterWaiting;
+        }
+        m_state.wait(state);
+    }
+}
+
+void ReadWriteLock::unlock() PCTK_NOEXCEPT
+{
+    int state = m_state.load();
+    if (state & Writer)
+    {
+        /* the waiters that are still interested set their bit again after waking up */
+        state = m_state.fetchAndStoreRelease(0);
+        if (state & (WriterWaiting | ReadersWaiting))
+        {
+            m_state.notifyAll();
+        }
+        return;
+    }
+    state = m_state.fetchAndSubRelease(Reader);
+    if (Reader == (state & ~(WriterWaiting | ReadersWaiting)) && (state & WriterWaiting))
+    {
+        /* last reader out, the parked writers get their turn */
+        m_state.notifyAll();
+    }
+}
+
+PCTK_END_NAMESPACE
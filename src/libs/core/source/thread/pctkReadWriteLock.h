@@ -0,0 +1,129 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKREADWRITELOCK_H
+#define _PCTKREADWRITELOCK_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+
+PCTK_BEGIN_NAMESPACE
+
+/**
+ * @brief One word reader-writer lock that prefers writers.
+ * Readers and the writer share a single 32 bit state: a writer bit, a writer-waiting bit, a readers-waiting bit and
+ * the reader count. Once a writer waits, new readers queue behind it, so a steady stream of readers cannot starve
+ * writes. Contended paths spin briefly and park on the word with AtomicInt::wait(). Neither side is recursive, a
+ * thread holding read access must not take it again while a writer may be waiting.
+ */
+class PCTK_CORE_API ReadWriteLock
+{
+public:
+    PCTK_CONSTEXPR ReadWriteLock() PCTK_NOEXCEPT : m_state(0) {}
+
+    void lockForRead() PCTK_NOEXCEPT
+    {
+        const int state = m_state.load();
+        if (PCTK_LIKELY(!(state & (Writer | WriterWaiting)) && m_state.testAndSetAcquire(state, state + Reader)))
+        {
+            return;
+        }
+        this->lockForReadSlow();
+    }
+
+    bool tryLockForRead() PCTK_NOEXCEPT;
+
+    void lockForWrite() PCTK_NOEXCEPT
+    {
+        if (PCTK_LIKELY(m_state.testAndSetAcquire(0, Writer)))
+        {
+            return;
+        }
+        this->lockForWriteSlow();
+    }
+
+    bool tryLockForWrite() PCTK_NOEXCEPT;
+
+    /**
+     * @brief Releases read or write access, whichever the calling thread holds.
+     */
+    void unlock() PCTK_NOEXCEPT;
+
+    int readerCount() const PCTK_NOEXCEPT { return m_state.load() >> ReaderShift; }
+    bool isLockedForWrite() const PCTK_NOEXCEPT { return 0 != (m_state.load() & Writer); }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(ReadWriteLock)
+
+    enum State
+    {
+        Writer = 0x1,
+        WriterWaiting = 0x2,
+        ReadersWaiting = 0x4,
+        ReaderShift = 3,
+        Reader = 1 << ReaderShift
+    };
+
+    void lockForReadSlow() PCTK_NOEXCEPT;
+    void lockForWriteSlow() PCTK_NOEXCEPT;
+
+    AtomicInt m_state;
+};
+
+PCTK_STATIC_ASSERT_X(sizeof(ReadWriteLock) == 4, "ReadWriteLock must fit in 4 bytes");
+
+/**
+ * @brief Holds read access to a ReadWriteLock for its lifetime.
+ */
+class ReadLocker
+{
+public:
+    explicit ReadLocker(ReadWriteLock &lock) PCTK_NOEXCEPT : m_lock(lock) { m_lock.lockForRead(); }
+    ~ReadLocker() { m_lock.unlock(); }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(ReadLocker)
+
+    ReadWriteLock &m_lock;
+};
+
+/**
+ * @brief Holds write access to a ReadWriteLock for its lifetime.
+ */
+class WriteLocker
+{
+public:
+    explicit WriteLocker(ReadWriteLock &lock) PCTK_NOEXCEPT : m_lock(lock) { m_lock.lockForWrite(); }
+    ~WriteLocker() { m_lock.unlock(); }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(WriteLocker)
+
+    ReadWriteLock &m_lock;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKREADWRITELOCK_H
@@ -0,0 +1,163 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKSEQLOCK_H
+#define _PCTKSEQLOCK_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+#include <pctkTypeInfo.h>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+PCTK_BEGIN_NAMESPACE
+
+/**
+ * @brief Sequence lock publishing a small value from one writer to many readers.
+ * The writer makes the sequence odd, stores the value and makes it even again, it never waits. Readers copy the value
+ * between two reads of the sequence and retry while a store overlapped, they write nothing shared and never see a torn
+ * value. The payload is kept in word sized atomics so the racing copy is well defined, T is limited to primitive
+ * types, see PCTK_DECL_TYPEINFO. Stores must come from one thread at a time.
+ */
+template<typename T>
+class SeqLock
+{
+    PCTK_STATIC_ASSERT_X(!TypeInfoQuery<T>::isComplex, "SeqLock<T> requires a primitive T, see PCTK_DECL_TYPEINFO");
+
+public:
+    explicit SeqLock(const T &value = T()) : m_sequence(0) { this->storeWords(value); }
+
+    /**
+     * @brief Returns a consistent copy, retrying while the writer is inside store().
+     */
+    T load() const PCTK_NOEXCEPT
+    {
+        T value;
+        for (int attempts = 1; !this->tryLoad(value); ++attempts)
+        {
+            if (attempts < 64)
+            {
+                detail::cpuRelax();
+            }
+            else
+            {
+                /* the writer was preempted inside store(), spinning will not bring it back */
+                std::this_thread::yield();
+            }
+        }
+        return value;
+    }
+
+    /**
+     * @brief Makes one attempt, returns false without touching value if a store overlapped it.
+     */
+    bool tryLoad(T &value) const PCTK_NOEXCEPT
+    {
+        const int before = m_sequence.loadAcquire();
+        if (before & 1)
+        {
+            return false;
+        }
+        pctk_uintptr_t words[WordCount];
+        for (int i = 0; i < WordCount; ++i)
+        {
+            words[i] = m_words[i].load();
+        }
+        /* keeps the payload loads above the second sequence read */
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (before != m_sequence.load())
+        {
+            return false;
+        }
+        std::memcpy(&value, words, sizeof(T));
+        return true;
+    }
+
+    void store(const T &value) PCTK_NOEXCEPT
+    {
+        const int sequence = m_sequence.load();
+        m_sequence.store((int) ((unsigned int) sequence + 1));
+        /* keeps the payload stores below the odd sequence */
+        std::atomic_thread_fence(std::memory_order_release);
+        this->storeWords(value);
+        m_sequence.storeRelease((int) ((unsigned int) sequence + 2));
+    }
+
+    /**
+     * @brief Calls func(T &) on a copy of the current value and stores the result, writer thread only.
+     */
+    template<typename Func>
+    void update(Func func)
+    {
+        T value = this->current();
+        func(value);
+        this->store(value);
+    }
+
+    /**
+     * @brief Number of completed stores times two, odd while a store is running.
+     */
+    int sequence() const PCTK_NOEXCEPT { return m_sequence.loadAcquire(); }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(SeqLock)
+
+    enum
+    {
+        WordCount = (sizeof(T) + sizeof(pctk_uintptr_t) - 1) / sizeof(pctk_uintptr_t)
+    };
+
+    /* the writer's own view, no retry needed since nobody else stores */
+    T current() const PCTK_NOEXCEPT
+    {
+        pctk_uintptr_t words[WordCount];
+        for (int i = 0; i < WordCount; ++i)
+        {
+            words[i] = m_words[i].load();
+        }
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    void storeWords(const T &value) PCTK_NOEXCEPT
+    {
+        pctk_uintptr_t words[WordCount] = {};
+        std::memcpy(words, &value, sizeof(T));
+        for (int i = 0; i < WordCount; ++i)
+        {
+            m_words[i].store(words[i]);
+        }
+    }
+
+    AtomicInt m_sequence;
+    AtomicInteger<pctk_uintptr_t> m_words[WordCount];
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKSEQLOCK_H
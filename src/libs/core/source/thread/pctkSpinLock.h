@@ -0,0 +1,95 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKSPINLOCK_H
+#define _PCTKSPINLOCK_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+
+#include <thread>
+
+PCTK_BEGIN_NAMESPACE
+
+/**
+ * @brief Test-and-test-and-set lock for critical sections of a few dozen instructions.
+ * Waiters spin on a plain load so the line stays shared until the owner releases it, with a pause between reads
+ * and a yield once the owner seems descheduled. Never parks, use Mutex when the section may block. Not recursive.
+ */
+class SpinLock
+{
+public:
+    PCTK_CONSTEXPR SpinLock() PCTK_NOEXCEPT : m_state(0) {}
+
+    void lock() PCTK_NOEXCEPT
+    {
+        if (PCTK_LIKELY(m_state.testAndSetAcquire(0, 1)))
+        {
+            return;
+        }
+        this->lockSlow();
+    }
+
+    bool tryLock() PCTK_NOEXCEPT { return 0 == m_state.load() && m_state.testAndSetAcquire(0, 1); }
+
+    void unlock() PCTK_NOEXCEPT { m_state.storeRelease(0); }
+
+    bool isLocked() const PCTK_NOEXCEPT { return 0 != m_state.load(); }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(SpinLock)
+
+    void lockSlow() PCTK_NOEXCEPT
+    {
+        int spins = 0;
+        for (;;)
+        {
+            while (0 != m_state.load())
+            {
+                if (++spins < 64)
+                {
+                    detail::cpuRelax();
+                }
+                else
+                {
+                    /* the owner is probably not running, let it */
+                    std::this_thread::yield();
+                }
+            }
+            if (m_state.testAndSetAcquire(0, 1))
+            {
+                return;
+            }
+        }
+    }
+
+    AtomicInt m_state;
+};
+
+PCTK_STATIC_ASSERT_X(sizeof(SpinLock) == 4, "SpinLock must fit in 4 bytes");
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKSPINLOCK_H
@@ -0,0 +1,97 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkStripedCounter.h>
+
+#include <new>
+#include <thread>
+
+#if defined(PCTK_OS_LINUX)
+#   include <sched.h>
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+StripedCounter::StripedCounter(int stripeCount)
+    : m_stripes(PCTK_NULLPTR), m_memory(PCTK_NULLPTR), m_mask(0)
+{
+    unsigned int wanted = stripeCount > 0 ? (unsigned int) stripeCount : std::thread::hardware_concurrency();
+    unsigned int count = 1;
+    while (count < wanted && count < 1024)
+    {
+        count <<= 1;
+    }
+    m_mask = count - 1;
+
+    /* over-aligned new is C++17 only, align the block by hand */
+    m_memory = ::operator new(count * sizeof(PaddedAtomic<pctk_int64_t>) + PCTK_CACHELINE_SIZE);
+    const pctk_uintptr_t base = ((pctk_uintptr_t) m_memory + PCTK_CACHELINE_SIZE - 1)
+                                & ~(pctk_uintptr_t) (PCTK_CACHELINE_SIZE - 1);
+    m_stripes = reinterpret_cast<PaddedAtomic<pctk_int64_t> *>(base);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        new(m_stripes + i) PaddedAtomic<pctk_int64_t>(0);
+    }
+}
+
+StripedCounter::~StripedCounter()
+{
+    ::operator delete(m_memory);
+}
+
+pctk_int64_t StripedCounter::sum() const PCTK_NOEXCEPT
+{
+    pctk_int64_t total = 0;
+    for (unsigned int i = 0; i <= m_mask; ++i)
+    {
+        total += m_stripes[i].load();
+    }
+    return total;
+}
+
+void StripedCounter::reset() PCTK_NOEXCEPT
+{
+    for (unsigned int i = 0; i <= m_mask; ++i)
+    {
+        m_stripes[i].store(0);
+    }
+}
+
+unsigned int StripedCounter::currentStripe() PCTK_NOEXCEPT
+{
+#if defined(PCTK_OS_LINUX)
+    const int cpu = sched_getcpu();
+    if (PCTK_LIKELY(cpu >= 0))
+    {
+        return (unsigned int) cpu;
+    }
+#endif
+    /* no cheap cpu number, give each thread its own stripe round robin */
+    static AtomicInt nextStripe(0);
+    static thread_local unsigned int stripe = (unsigned int) nextStripe.fetchAndAddRelaxed(1);
+    return stripe;
+}
+
+PCTK_END_NAMESPACE
@@ -0,0 +1,103 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKSTRIPEDCOUNTER_H
+#define _PCTKSTRIPEDCOUNTER_H
+
+#include <pctkGlobal.h>
+#include <pctkCacheLine.h>
+
+PCTK_BEGIN_NAMESPACE
+
+/**
+ * @brief Counter for values updated by many threads and read rarely, e.g. metrics.
+ * Increments go to a per CPU stripe on its own cache line, sum() adds all stripes up. The sum is exact once writers
+ * are quiescent and a relaxed snapshot while they are running.
+ */
+class PCTK_CORE_API StripedCounter
+{
+public:
+    /**
+     * @brief Creates the counter with stripeCount stripes rounded up to a power of two, 0 means one per CPU.
+     */
+    explicit StripedCounter(int stripeCount = 0);
+    ~StripedCounter();
+
+    void add(pctk_int64_t value) PCTK_NOEXCEPT
+    {
+        m_stripes[currentStripe() & m_mask].fetchAndAddRelaxed(value);
+    }
+
+    void sub(pctk_int64_t value) PCTK_NOEXCEPT { this->add(-value); }
+
+    StripedCounter &operator++() PCTK_NOEXCEPT
+    {
+        this->add(1);
+        return *this;
+    }
+
+    StripedCounter &operator--() PCTK_NOEXCEPT
+    {
+        this->add(-1);
+        return *this;
+    }
+
+    StripedCounter &operator+=(pctk_int64_t value) PCTK_NOEXCEPT
+    {
+        this->add(value);
+        return *this;
+    }
+
+    StripedCounter &operator-=(pctk_int64_t value) PCTK_NOEXCEPT
+    {
+        this->add(-value);
+        return *this;
+    }
+
+    pctk_int64_t sum() const PCTK_NOEXCEPT;
+
+    /**
+     * @brief Zeroes every stripe, increments racing with reset() may survive it.
+     */
+    void reset() PCTK_NOEXCEPT;
+
+    int stripeCount() const PCTK_NOEXCEPT { return (int) m_mask + 1; }
+
+    /**
+     * @brief Stripe hint of the calling thread, the current CPU where the system exposes it cheaply.
+     */
+    static unsigned int currentStripe() PCTK_NOEXCEPT;
+
+private:
+    PCTK_DISABLE_COPY_MOVE(StripedCounter)
+
+    PaddedAtomic<pctk_int64_t> *m_stripes;
+    void *m_memory;
+    unsigned int m_mask;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKSTRIPEDCOUNTER_H
@@ -0,0 +1,129 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include <pctkTask.h>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* Frames are rounded up to TaskFrameGranule bytes, each size class keeps at most TaskFrameCacheLimit free frames. */
+enum
+{
+    TaskFrameGranule = 64,
+    TaskFrameClassCount = 16,
+    TaskFrameCacheLimit = 32
+};
+
+struct TaskFrameBlock
+{
+    TaskFrameBlock *next;
+};
+
+/* Trivially constructible so the hot path is a single TLS access without an initialization guard. */
+struct TaskFrameCache
+{
+    TaskFrameBlock *heads[TaskFrameClassCount];
+    int counts[TaskFrameClassCount];
+    bool registered;
+    /* set once the thread's frames were released, later frames go straight to the heap */
+    bool exited;
+};
+
+static thread_local TaskFrameCache taskFrameCache;
+
+/* Returns the cached frames to the heap at thread exit, only constructed once the thread caches a frame. */
+struct TaskFrameCacheReaper
+{
+    ~TaskFrameCacheReaper()
+    {
+        TaskFrameCache &cache = taskFrameCache;
+        cache.exited = true;
+        for (int i = 0; i < TaskFrameClassCount; ++i)
+        {
+            while (cache.heads[i])
+            {
+                TaskFrameBlock *next = cache.heads[i]->next;
+                ::operator delete(cache.heads[i]);
+                cache.heads[i] = next;
+            }
+            cache.counts[i] = 0;
+        }
+    }
+};
+
+static void registerTaskFrameCache(TaskFrameCache &cache)
+{
+    static thread_local TaskFrameCacheReaper reaper;
+    (void) reaper;
+    cache.registered = true;
+}
+
+static inline std::size_t taskFrameClass(std::size_t size) PCTK_NOEXCEPT
+{
+    return (size + TaskFrameGranule - 1) / TaskFrameGranule - 1;
+}
+
+void *taskFrameAllocate(std::size_t size)
+{
+    const std::size_t index = taskFrameClass(size);
+    if (index >= TaskFrameClassCount)
+    {
+        return ::operator new(size);
+    }
+    TaskFrameCache &cache = taskFrameCache;
+    TaskFrameBlock *block = cache.heads[index];
+    if (PCTK_LIKELY(block))
+    {
+        cache.heads[index] = block->next;
+        --cache.counts[index];
+        return block;
+    }
+    /* allocate the whole class size so that any frame of the class can reuse the block */
+    return ::operator new((index + 1) * TaskFrameGranule);
+}
+
+void taskFrameDeallocate(void *frame, std::size_t size) PCTK_NOEXCEPT
+{
+    const std::size_t index = taskFrameClass(size);
+    TaskFrameCache &cache = taskFrameCache;
+    if (index >= TaskFrameClassCount || cache.exited || cache.counts[index] >= TaskFrameCacheLimit)
+    {
+        ::operator delete(frame);
+        return;
+    }
+    if (PCTK_UNLIKELY(!cache.registered))
+    {
+        registerTaskFrameCache(cache);
+    }
+    TaskFrameBlock *block = static_cast<TaskFrameBlock *>(frame);
+    block->next = cache.heads[index];
+    cache.heads[index] = block;
+    ++cache.counts[index];
+}
+} // namespace detail
+
+PCTK_END_NAMESPACE
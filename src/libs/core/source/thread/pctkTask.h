@@ -0,0 +1,363 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#ifndef _PCTKTASK_H
+#define _PCTKTASK_H
+
+#include <pctkGlobal.h>
+#include <pctkFuture.h>
+#include <pctkThreadPool.h>
+
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if PCTK_CC_FEATURE_COROUTINES
+#   include <coroutine>
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/**
+ * @brief Coroutine frame allocator, frames up to 1KiB come from size classed free lists owned by the calling thread
+ * and fall back to global new above that. A frame may be released on another thread than the one that allocated it,
+ * it then feeds that thread's lists. Available on every compiler so that frame heavy callback code can share it.
+ */
+PCTK_CORE_API void *taskFrameAllocate(std::size_t size);
+PCTK_CORE_API void taskFrameDeallocate(void *frame, std::size_t size) PCTK_NOEXCEPT;
+} // namespace detail
+
+#if PCTK_CC_FEATURE_COROUTINES
+
+template<typename T>
+class Task;
+
+namespace detail
+{
+/* Lazily started coroutine state: frame allocation, continuation and the error the body ended with. */
+class TaskPromiseBase
+{
+public:
+    struct FinalAwaiter
+    {
+        bool await_ready() const PCTK_NOEXCEPT { return false; }
+
+        /* symmetric transfer back to the awaiting coroutine keeps long await chains off the stack */
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) PCTK_NOEXCEPT
+        {
+            std::coroutine_handle<> continuation = handle.promise().m_continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const PCTK_NOEXCEPT {}
+    };
+
+    static void *operator new(std::size_t size) { return taskFrameAllocate(size); }
+    static void operator delete(void *frame, std::size_t size) PCTK_NOEXCEPT { taskFrameDeallocate(frame, size); }
+
+    std::suspend_always initial_suspend() const PCTK_NOEXCEPT { return std::suspend_always(); }
+    FinalAwaiter final_suspend() const PCTK_NOEXCEPT { return FinalAwaiter(); }
+    void unhandled_exception() PCTK_NOEXCEPT { m_error = std::current_exception(); }
+
+    void setContinuation(std::coroutine_handle<> continuation) PCTK_NOEXCEPT { m_continuation = continuation; }
+
+protected:
+    void rethrowError() const
+    {
+        if (m_error)
+        {
+            std::rethrow_exception(m_error);
+        }
+    }
+
+    std::coroutine_handle<> m_continuation;
+    std::exception_ptr m_error;
+};
+
+template<typename T>
+class TaskPromise : public TaskPromiseBase
+{
+public:
+    TaskPromise() PCTK_NOEXCEPT : m_hasValue(false) {}
+
+    ~TaskPromise()
+    {
+        if (m_hasValue)
+        {
+            reinterpret_cast<T *>(&m_storage)->~T();
+        }
+    }
+
+    Task<T> get_return_object() PCTK_NOEXCEPT;
+
+    template<typename U>
+    void return_value(U &&value)
+    {
+        new(&m_storage) T(std::forward<U>(value));
+        m_hasValue = true;
+    }
+
+    T result()
+    {
+        this->rethrowError();
+        return std::move(*reinterpret_cast<T *>(&m_storage));
+    }
+
+private:
+    typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type m_storage;
+    bool m_hasValue;
+};
+
+template<>
+class TaskPromise<void> : public TaskPromiseBase
+{
+public:
+    Task<void> get_return_object() PCTK_NOEXCEPT;
+
+    void return_void() PCTK_NOEXCEPT {}
+
+    void result() { this->rethrowError(); }
+};
+} // namespace detail
+
+/**
+ * @brief Lazily started coroutine returning T. The body runs when the task is first awaited, on the awaiting thread,
+ * and hands control straight back to the awaiting coroutine when it finishes. Exceptions escaping the body are
+ * rethrown by co_await, awaiting an empty task throws std::logic_error. A task is move-only, awaited at most once and
+ * destroys its frame when destroyed.
+ * Frames come from the per-thread frame pool instead of global new.
+ */
+template<typename T>
+class Task
+{
+public:
+    typedef T ValueType;
+    typedef detail::TaskPromise<T> promise_type;
+
+    class Awaiter
+    {
+    public:
+        explicit Awaiter(std::coroutine_handle<promise_type> handle) PCTK_NOEXCEPT : m_handle(handle) {}
+
+        bool await_ready() const PCTK_NOEXCEPT { return !m_handle || m_handle.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) PCTK_NOEXCEPT
+        {
+            m_handle.promise().setContinuation(awaiting);
+            return m_handle;
+        }
+
+        T await_resume()
+        {
+            if (PCTK_UNLIKELY(!m_handle))
+            {
+                throw std::logic_error("Task: co_await on an empty task");
+            }
+            return m_handle.promise().result();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    Task() PCTK_NOEXCEPT : m_handle(PCTK_NULLPTR) {}
+
+    explicit Task(std::coroutine_handle<promise_type> handle) PCTK_NOEXCEPT : m_handle(handle) {}
+
+    Task(Task &&other) PCTK_NOEXCEPT : m_handle(other.m_handle) { other.m_handle = PCTK_NULLPTR; }
+
+    ~Task()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    Task &operator=(Task &&other) PCTK_NOEXCEPT
+    {
+        std::swap(m_handle, other.m_handle);
+        return *this;
+    }
+
+    bool isValid() const PCTK_NOEXCEPT { return static_cast<bool>(m_handle); }
+
+    /**
+     * @brief Returns true once the body has run to completion.
+     */
+    bool isReady() const PCTK_NOEXCEPT { return m_handle && m_handle.done(); }
+
+    Awaiter operator co_await() const PCTK_NOEXCEPT { return Awaiter(m_handle); }
+
+private:
+    PCTK_DISABLE_COPY(Task)
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+namespace detail
+{
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() PCTK_NOEXCEPT
+{
+    return Task<T>(std::coroutine_handle<TaskPromise<T> >::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() PCTK_NOEXCEPT
+{
+    return Task<void>(std::coroutine_handle<TaskPromise<void> >::from_promise(*this));
+}
+
+/* Eagerly started coroutine nobody awaits, it frees its own frame when the body ends. */
+struct TaskDetached
+{
+    struct promise_type
+    {
+        static void *operator new(std::size_t size) { return taskFrameAllocate(size); }
+        static void operator delete(void *frame, std::size_t size) PCTK_NOEXCEPT { taskFrameDeallocate(frame, size); }
+
+        TaskDetached get_return_object() const PCTK_NOEXCEPT { return TaskDetached(); }
+        std::suspend_never initial_suspend() const PCTK_NOEXCEPT { return std::suspend_never(); }
+        std::suspend_never final_suspend() const PCTK_NOEXCEPT { return std::suspend_never(); }
+        void return_void() const PCTK_NOEXCEPT {}
+        void unhandled_exception() const PCTK_NOEXCEPT { std::terminate(); }
+    };
+};
+
+template<typename T>
+TaskDetached taskFulfil(Task<T> task, Promise<T> promise)
+{
+    try
+    {
+        if constexpr (std::is_void<T>::value)
+        {
+            co_await task;
+            promise.setValue();
+        }
+        else
+        {
+            promise.setValue(co_await task);
+        }
+    }
+    catch (...)
+    {
+        promise.setException(std::current_exception());
+    }
+}
+} // namespace detail
+
+/**
+ * @brief Awaitable that resumes the awaiting coroutine on one of pool's workers.
+ */
+class ThreadPoolAwaiter
+{
+public:
+    explicit ThreadPoolAwaiter(ThreadPool &pool) PCTK_NOEXCEPT : m_pool(&pool) {}
+
+    bool await_ready() const PCTK_NOEXCEPT { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        m_pool->submit([handle]() { handle.resume(); });
+    }
+
+    void await_resume() const PCTK_NOEXCEPT {}
+
+private:
+    ThreadPool *m_pool;
+};
+
+/**
+ * @brief co_await schedule(pool) moves the rest of the coroutine onto pool.
+ */
+inline ThreadPoolAwaiter schedule(ThreadPool &pool) PCTK_NOEXCEPT
+{
+    return ThreadPoolAwaiter(pool);
+}
+
+/**
+ * @brief Awaitable over a Future, resumes the awaiting coroutine on the thread that completes it, or right away when
+ * it already is. This is how timers, I/O readiness and any other Future based executor are awaited.
+ */
+template<typename T>
+class FutureAwaiter
+{
+public:
+    explicit FutureAwaiter(const Future<T> &future) : m_future(future) {}
+
+    bool await_ready() const PCTK_NOEXCEPT { return m_future.isReady(); }
+
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        /* the coroutine may already run on another thread once onReady() returns, touch nothing after it */
+        m_future.onReady([handle]() { handle.resume(); });
+    }
+
+    T await_resume() const { return m_future.get(); }
+
+private:
+    Future<T> m_future;
+};
+
+template<typename T>
+FutureAwaiter<T> operator co_await(const Future<T> &future)
+{
+    return FutureAwaiter<T>(future);
+}
+
+/**
+ * @brief Starts task on the calling thread and returns the future of its result, the bridge to callback code.
+ */
+template<typename T>
+Future<T> toFuture(Task<T> task)
+{
+    Promise<T> promise;
+    Future<T> future = promise.future();
+    detail::taskFulfil(std::move(task), std::move(promise));
+    return future;
+}
+
+/**
+ * @brief Runs task and blocks the calling thread until it finished, returns its result or rethrows its error.
+ * Must not be called from a pool worker the task needs to make progress.
+ */
+template<typename T>
+T syncWait(Task<T> task)
+{
+    return pctk::toFuture(std::move(task)).get();
+}
+
+#endif // PCTK_CC_FEATURE_COROUTINES
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKTASK_H
@@ -0,0 +1,543 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkThreadPool.h>
+#include <pctkCacheLine.h>
+
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <system_error>
+
+#if defined(PCTK_OS_UNIX)
+#   include <pthread.h>
+#   include <unistd.h>
+#   include <limits.h>
+#endif
+#if defined(PCTK_OS_LINUX)
+#   include <sched.h>
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+static const pctk_int64_t ThreadPoolDequeInitialCapacity = 256;
+static const int ThreadPoolSpinRounds = 32;
+static const int ThreadPoolThreadNameSize = 16;
+
+/* Chase-Lev work-stealing deque in the formulation of Le, Pop, Cohen and Zappa Nardelli (PPoPP 2013).
+ * The owner pushes and takes at the bottom, thieves steal at the top. Arrays replaced on growth are kept until the
+ * deque dies, a thief may still be reading from them. */
+class ThreadPoolDeque
+{
+public:
+    ThreadPoolDeque() : m_top(0), m_bottom(0), m_array(newArray(ThreadPoolDequeInitialCapacity, PCTK_NULLPTR)) {}
+
+    ~ThreadPoolDeque()
+    {
+        Array *array = m_array.load();
+        while (array)
+        {
+            Array *previous = array->previous;
+            delete[] array->slots;
+            delete array;
+            array = previous;
+        }
+    }
+
+    void push(ThreadPoolTask *task)
+    {
+        const pctk_int64_t bottom = m_bottom.load();
+        const pctk_int64_t top = m_top.loadAcquire();
+        Array *array = m_array.load();
+        if (bottom - top > array->mask)
+        {
+            array = this->grow(array, top, bottom);
+        }
+        array->slots[bottom & array->mask].store(task);
+        m_bottom.storeRelease(bottom + 1);
+    }
+
+    ThreadPoolTask *take() PCTK_NOEXCEPT
+    {
+        const pctk_int64_t bottom = m_bottom.load() - 1;
+        Array *array = m_array.load();
+        m_bottom.store(bottom);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const pctk_int64_t top = m_top.load();
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1);
+            return PCTK_NULLPTR;
+        }
+        ThreadPoolTask *task = array->slots[bottom & array->mask].load();
+        if (top == bottom)
+        {
+            /* last element, race the thieves for it */
+            if (!m_top.testAndSetOrdered(top, top + 1))
+            {
+                task = PCTK_NULLPTR;
+            }
+            m_bottom.store(bottom + 1);
+        }
+        return task;
+    }
+
+    ThreadPoolTask *steal(bool *contended) PCTK_NOEXCEPT
+    {
+        const pctk_int64_t top = m_top.loadAcquire();
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const pctk_int64_t bottom = m_bottom.loadAcquire();
+        if (top >= bottom)
+        {
+            return PCTK_NULLPTR;
+        }
+        Array *array = m_array.loadAcquire();
+        ThreadPoolTask *task = array->slots[top & array->mask].load();
+        if (!m_top.testAndSetOrdered(top, top + 1))
+        {
+            *contended = true;
+            return PCTK_NULLPTR;
+        }
+        return task;
+    }
+
+private:
+    PCTK_DISABLE_COPY_MOVE(ThreadPoolDeque)
+
+    struct Array
+    {
+        pctk_int64_t mask;
+        AtomicPointer<ThreadPoolTask> *slots;
+        Array *previous;
+    };
+
+    static Array *newArray(pctk_int64_t capacity, Array *previous)
+    {
+        Array *array = new Array;
+        array->mask = capacity - 1;
+        array->slots = new AtomicPointer<ThreadPoolTask>[capacity];
+        array->previous = previous;
+        return array;
+    }
+
+    Array *grow(Array *array, pctk_int64_t top, pctk_int64_t bottom)
+    {
+        Array *bigger = newArray((array->mask + 1) * 2, array);
+        for (pctk_int64_t i = top; i < bottom; ++i)
+        {
+            bigger->slots[i & bigger->mask].store(array->slots[i & array->mask].load());
+        }
+        m_array.storeRelease(bigger);
+        return bigger;
+    }
+
+    PaddedAtomic<pctk_int64_t> m_top;
+    PaddedAtomic<pctk_int64_t> m_bottom;
+    AtomicPointer<Array> m_array;
+};
+
+struct ThreadPoolWorker
+{
+    ThreadPoolDeque deque;
+    ThreadPool *pool;
+    int index;
+    unsigned int seed;
+    char name[ThreadPoolThreadNameSize];
+#if defined(PCTK_OS_UNIX)
+    pthread_t thread;
+#else
+    std::thread thread;
+#endif
+
+    unsigned int nextRandom() PCTK_NOEXCEPT
+    {
+        /* xorshift32, victim selection only needs to be cheap and spread out */
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+
+    static void *entry(void *arg)
+    {
+        ThreadPoolWorker *self = static_cast<ThreadPoolWorker *>(arg);
+#if PCTK_HAS_PTHREAD_SETNAME_NP
+#   if defined(PCTK_OS_DARWIN)
+        pthread_setname_np(self->name);
+#   else
+        pthread_setname_np(pthread_self(), self->name);
+#   endif
+#endif
+        self->pool->workerMain(self);
+        return PCTK_NULLPTR;
+    }
+};
+
+static thread_local ThreadPoolWorker *currentWorker = PCTK_NULLPTR;
+
+static int availableCpuCount()
+{
+#if defined(PCTK_OS_LINUX)
+    /* honour affinity masks and cpusets, containers often see more cores than they may use */
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (0 == sched_getaffinity(0, sizeof(set), &set))
+    {
+        const int count = CPU_COUNT(&set);
+        if (count > 0)
+        {
+            return count;
+        }
+    }
+#endif
+    const unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? (int) count : 1;
+}
+
+static void lockSpin(AtomicInt &lock) PCTK_NOEXCEPT
+{
+    int spins = 0;
+    while (!lock.testAndSetAcquire(0, 1))
+    {
+        if (++spins > ThreadPoolSpinRounds)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+static void unlockSpin(AtomicInt &lock) PCTK_NOEXCEPT
+{
+    lock.storeRelease(0);
+}
+} // namespace detail
+
+ThreadPool::ThreadPool(int threadCount)
+    : m_workers(PCTK_NULLPTR), m_workerMemory(PCTK_NULLPTR), m_workerCount(0), m_joined(false)
+    , m_pending(0), m_sleepers(0), m_wakeEpoch(0), m_stopping(0)
+    , m_injectLock(0), m_injectSize(0), m_injectHead(PCTK_NULLPTR), m_injectTail(PCTK_NULLPTR)
+{
+    Options options;
+    options.threadCount = threadCount;
+    this->start(options);
+}
+
+ThreadPool::ThreadPool(const Options &options)
+    : m_workers(PCTK_NULLPTR), m_workerMemory(PCTK_NULLPTR), m_workerCount(0), m_joined(false)
+    , m_pending(0), m_sleepers(0), m_wakeEpoch(0), m_stopping(0)
+    , m_injectLock(0), m_injectSize(0), m_injectHead(PCTK_NULLPTR), m_injectTail(PCTK_NULLPTR)
+{
+    this->start(options);
+}
+
+ThreadPool::~ThreadPool()
+{
+    this->shutdown();
+    this->destroyWorkers();
+}
+
+void ThreadPool::start(const Options &options)
+{
+    const int count = options.threadCount > 0 ? options.threadCount : detail::availableCpuCount();
+
+    /* over-aligned new is C++17 only, align the block by hand so the deques never share a line */
+    m_workerMemory = ::operator new(count * sizeof(detail::ThreadPoolWorker) + PCTK_CACHELINE_SIZE);
+    const pctk_uintptr_t base = ((pctk_uintptr_t) m_workerMemory + PCTK_CACHELINE_SIZE - 1)
+                                & ~(pctk_uintptr_t) (PCTK_CACHELINE_SIZE - 1);
+    m_workers = reinterpret_cast<detail::ThreadPoolWorker *>(base);
+
+    std::string prefix = options.name;
+    for (int i = 0; i < count; ++i)
+    {
+        detail::ThreadPoolWorker *worker = new(m_workers + i) detail::ThreadPoolWorker;
+        worker->pool = this;
+        worker->index = i;
+        worker->seed = 0x9e3779b9u * (unsigned int) (i + 1);
+        /* Linux limits names to 15 characters, shorten the prefix and keep the index */
+        const std::string suffix = "-" + std::to_string(i);
+        const std::size_t room = detail::ThreadPoolThreadNameSize - 1 - suffix.size();
+        const std::string name = prefix.substr(0, room) + suffix;
+        memcpy(worker->name, name.c_str(), name.size() + 1);
+    }
+
+    m_workerCount = count;
+    for (int i = 0; i < count; ++i)
+    {
+        detail::ThreadPoolWorker *worker = m_workers + i;
+#if defined(PCTK_OS_UNIX)
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+#   if PCTK_HAS_PTHREAD_ATTR_SETSTACKSIZE
+        if (options.stackSize > 0)
+        {
+            std::size_t stackSize = options.stackSize;
+#       ifdef PTHREAD_STACK_MIN
+            if (stackSize < (std::size_t) PTHREAD_STACK_MIN)
+            {
+                stackSize = PTHREAD_STACK_MIN;
+            }
+#       endif
+            /* some systems reject sizes that are not a multiple of the page size */
+            const std::size_t page = (std::size_t) sysconf(_SC_PAGESIZE);
+            stackSize = (stackSize + page - 1) / page * page;
+            pthread_attr_setstacksize(&attr, stackSize);
+        }
+#   endif
+        const int error = pthread_create(&worker->thread, &attr, &detail::ThreadPoolWorker::entry, worker);
+        pthread_attr_destroy(&attr);
+#else
+        int error = 0;
+        try
+        {
+            worker->thread = std::thread(&detail::ThreadPoolWorker::entry, worker);
+        }
+        catch (const std::system_error &e)
+        {
+            error = e.code().value();
+        }
+#endif
+        if (0 != error)
+        {
+            /* join what did start so the pool is fully torn down before the constructor throws */
+            m_joined = true;
+            this->stopWorkers(i);
+            this->destroyWorkers();
+            throw std::system_error(error, std::generic_category(), "ThreadPool: cannot start worker thread");
+        }
+    }
+}
+
+void ThreadPool::destroyWorkers() PCTK_NOEXCEPT
+{
+    for (int i = 0; i < m_workerCount; ++i)
+    {
+        m_workers[i].~ThreadPoolWorker();
+    }
+    ::operator delete(m_workerMemory);
+    m_workerMemory = PCTK_NULLPTR;
+    m_workers = PCTK_NULLPTR;
+}
+
+void ThreadPool::push(detail::ThreadPoolTask *task)
+{
+    m_pending.fetchAndAddRelaxed(1);
+    detail::ThreadPoolWorker *worker = detail::currentWorker;
+    if (worker && worker->pool == this)
+    {
+        worker->deque.push(task);
+    }
+    else
+    {
+        detail::lockSpin(m_injectLock);
+        if (m_injectTail)
+        {
+            m_injectTail->next = task;
+        }
+        else
+        {
+            m_injectHead = task;
+        }
+        m_injectTail = task;
+        m_injectSize.fetchAndAddRelease(1);
+        detail::unlockSpin(m_injectLock);
+    }
+    this->wakeOne();
+}
+
+void ThreadPool::wakeOne() PCTK_NOEXCEPT
+{
+    /* pairs with the sleeper announcing itself in m_sleepers before its last look for work, either the sleeper
+     * sees the new task or this sees the sleeper and moves the epoch it is about to wait on */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load() > 0)
+    {
+        m_wakeEpoch.fetchAndAddRelease(1);
+        m_wakeEpoch.notifyOne();
+    }
+}
+
+detail::ThreadPoolTask *ThreadPool::popInjected() PCTK_NOEXCEPT
+{
+    if (m_injectSize.loadAcquire() == 0)
+    {
+        return PCTK_NULLPTR;
+    }
+    detail::lockSpin(m_injectLock);
+    detail::ThreadPoolTask *task = m_injectHead;
+    if (task)
+    {
+        m_injectHead = task->next;
+        if (!m_injectHead)
+        {
+            m_injectTail = PCTK_NULLPTR;
+        }
+        task->next = PCTK_NULLPTR;
+        m_injectSize.fetchAndSubRelaxed(1);
+    }
+    detail::unlockSpin(m_injectLock);
+    return task;
+}
+
+detail::ThreadPoolTask *ThreadPool::findWork(detail::ThreadPoolWorker *self) PCTK_NOEXCEPT
+{
+    detail::ThreadPoolTask *task = this->popInjected();
+    if (task || m_workerCount < 2)
+    {
+        return task;
+    }
+    const int start = (int) (self->nextRandom() % (unsigned int) m_workerCount);
+    bool contended = true;
+    while (contended)
+    {
+        /* a lost race means the victim had work, sweep again before giving up */
+        contended = false;
+        for (int i = 0; i < m_workerCount; ++i)
+        {
+            const int victim = (start + i) % m_workerCount;
+            if (victim != self->index)
+            {
+                task = m_workers[victim].deque.steal(&contended);
+                if (task)
+                {
+                    return task;
+                }
+            }
+        }
+    }
+    return PCTK_NULLPTR;
+}
+
+void ThreadPool::execute(detail::ThreadPoolTask *task) PCTK_NOEXCEPT
+{
+    task->invoke(task);
+    if (1 == m_pending.fetchAndSubOrdered(1))
+    {
+        m_pending.notifyAll();
+    }
+}
+
+void ThreadPool::workerMain(detail::ThreadPoolWorker *self) PCTK_NOEXCEPT
+{
+    detail::currentWorker = self;
+    int idleRounds = 0;
+    for (;;)
+    {
+        detail::ThreadPoolTask *task = self->deque.take();
+        if (!task)
+        {
+            task = this->findWork(self);
+        }
+        if (task)
+        {
+            idleRounds = 0;
+            this->execute(task);
+            continue;
+        }
+        if (++idleRounds < detail::ThreadPoolSpinRounds)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        idleRounds = 0;
+
+        /* announce the sleep, then look once more, see wakeOne() for the other half of the handshake */
+        const int epoch = m_wakeEpoch.loadAcquire();
+        m_sleepers.fetchAndAddOrdered(1);
+        task = this->findWork(self);
+        if (task)
+        {
+            m_sleepers.fetchAndSubOrdered(1);
+            this->execute(task);
+            continue;
+        }
+        if (m_stopping.loadAcquire())
+        {
+            m_sleepers.fetchAndSubOrdered(1);
+            break;
+        }
+        m_wakeEpoch.wait(epoch);
+        m_sleepers.fetchAndSubOrdered(1);
+    }
+    detail::currentWorker = PCTK_NULLPTR;
+}
+
+void ThreadPool::waitForDone() PCTK_NOEXCEPT
+{
+    for (;;)
+    {
+        const int pending = m_pending.loadAcquire();
+        if (0 == pending)
+        {
+            return;
+        }
+        m_pending.wait(pending);
+    }
+}
+
+void ThreadPool::shutdown() PCTK_NOEXCEPT
+{
+    if (m_joined)
+    {
+        return;
+    }
+    m_joined = true;
+    this->stopWorkers(m_workerCount);
+}
+
+void ThreadPool::stopWorkers(int started) PCTK_NOEXCEPT
+{
+    m_stopping.fetchAndStoreOrdered(1);
+    m_wakeEpoch.fetchAndAddOrdered(1);
+    m_wakeEpoch.notifyAll();
+    for (int i = 0; i < started; ++i)
+    {
+#if defined(PCTK_OS_UNIX)
+        pthread_join(m_workers[i].thread, PCTK_NULLPTR);
+#else
+        m_workers[i].thread.join();
+#endif
+    }
+}
+
+int ThreadPool::currentThreadIndex() PCTK_NOEXCEPT
+{
+    return detail::currentWorker ? detail::currentWorker->index : -1;
+}
+
+bool ThreadPool::isWorkerThread() const PCTK_NOEXCEPT
+{
+    return detail::currentWorker && detail::currentWorker->pool == this;
+}
+
+ThreadPool *ThreadPool::globalInstance()
+{
+    static ThreadPool instance;
+    return &instance;
+}
+
+PCTK_END_NAMESPACE
@@ -0,0 +1,178 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKTHREADPOOL_H
+#define _PCTKTHREADPOOL_H
+
+#include <pctkGlobal.h>
+#include <pctkAtomic.h>
+
+#include <string>
+#include <utility>
+#include <type_traits>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* Heap node of one submitted callable, invoke() runs and destroys it. next links the pool's injection queue. */
+struct ThreadPoolTask
+{
+    void (*invoke)(ThreadPoolTask *task);
+    ThreadPoolTask *next;
+};
+
+template<typename F>
+struct ThreadPoolTaskImpl : public ThreadPoolTask
+{
+    template<typename U>
+    explicit ThreadPoolTaskImpl(U &&f) : func(std::forward<U>(f))
+    {
+        this->invoke = &ThreadPoolTaskImpl::run;
+        this->next = PCTK_NULLPTR;
+    }
+
+    static void run(ThreadPoolTask *task)
+    {
+        ThreadPoolTaskImpl *self = static_cast<ThreadPoolTaskImpl *>(task);
+        self->func();
+        delete self;
+    }
+
+    F func;
+};
+
+struct ThreadPoolWorker;
+} // namespace detail
+
+/**
+ * @brief Work-stealing thread pool, meant to be shared by components instead of one ad-hoc pool each.
+ * Every worker owns a Chase-Lev deque, tasks submitted from a worker go to the bottom of its own deque and are
+ * popped LIFO for locality, tasks submitted from any other thread go to a shared injection queue. Idle workers
+ * steal the oldest task of a randomly chosen victim and sleep on a futex once there is nothing left anywhere.
+ * Tasks must not throw, an escaping exception terminates the process as it would for a plain std::thread.
+ */
+class PCTK_CORE_API ThreadPool
+{
+public:
+    struct Options
+    {
+        Options() : threadCount(0), stackSize(0), name("pctkPool") {}
+
+        /* number of workers, 0 means one per CPU available to the process */
+        int threadCount;
+        /* worker stack size in bytes, 0 keeps the system default */
+        std::size_t stackSize;
+        /* worker thread name prefix, workers are named "<name>-<index>" where the system supports it */
+        std::string name;
+    };
+
+    explicit ThreadPool(int threadCount = 0);
+    explicit ThreadPool(const Options &options);
+
+    /**
+     * @brief Runs every task still queued, then joins the workers.
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Queues func() for execution, func is moved or copied into a heap allocated task.
+     */
+    template<typename F>
+    void submit(F &&func)
+    {
+        typedef detail::ThreadPoolTaskImpl<typename std::decay<F>::type> Task;
+        this->push(new Task(std::forward<F>(func)));
+    }
+
+    /**
+     * @brief Blocks until every submitted task, including tasks submitted by tasks, has finished.
+     * Must not be called from inside one of this pool's tasks.
+     */
+    void waitForDone() PCTK_NOEXCEPT;
+
+    /**
+     * @brief Stops accepting work, runs every task still queued and joins the workers, idempotent.
+     * Submitting after shutdown() has started is undefined.
+     */
+    void shutdown() PCTK_NOEXCEPT;
+
+    int threadCount() const PCTK_NOEXCEPT { return m_workerCount; }
+
+    /**
+     * @brief Number of submitted tasks that have not finished yet.
+     */
+    int pendingCount() const PCTK_NOEXCEPT { return m_pending.loadAcquire(); }
+
+    /**
+     * @brief Index of the calling worker thread in [0, threadCount()) of its pool, -1 outside any pool.
+     */
+    static int currentThreadIndex() PCTK_NOEXCEPT;
+
+    /**
+     * @brief Returns true if the calling thread is one of this pool's workers.
+     */
+    bool isWorkerThread() const PCTK_NOEXCEPT;
+
+    /**
+     * @brief Process wide pool with one worker per CPU, created on first use and shut down at exit.
+     */
+    static ThreadPool *globalInstance();
+
+private:
+    PCTK_DISABLE_COPY_MOVE(ThreadPool)
+
+    friend struct detail::ThreadPoolWorker;
+
+    void start(const Options &options);
+    void stopWorkers(int started) PCTK_NOEXCEPT;
+    void destroyWorkers() PCTK_NOEXCEPT;
+    void push(detail::ThreadPoolTask *task);
+    void wakeOne() PCTK_NOEXCEPT;
+    void workerMain(detail::ThreadPoolWorker *self) PCTK_NOEXCEPT;
+    detail::ThreadPoolTask *findWork(detail::ThreadPoolWorker *self) PCTK_NOEXCEPT;
+    detail::ThreadPoolTask *popInjected() PCTK_NOEXCEPT;
+    void execute(detail::ThreadPoolTask *task) PCTK_NOEXCEPT;
+
+    detail::ThreadPoolWorker *m_workers;
+    void *m_workerMemory;
+    int m_workerCount;
+    bool m_joined;
+
+    AtomicInt m_pending;
+    AtomicInt m_sleepers;
+    AtomicInt m_wakeEpoch;
+    AtomicInt m_stopping;
+
+    /* injection queue for submissions from non worker threads, a spin lock guarded intrusive list */
+    AtomicInt m_injectLock;
+    AtomicInt m_injectSize;
+    detail::ThreadPoolTask *m_injectHead;
+    detail::ThreadPoolTask *m_injectTail;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKTHREADPOOL_H
@@ -26,10 +26,15 @@
 #define _PCTKANY_H
 
 #include <pctkGlobal.h>
+#include <pctkTypeInfo.h>
 #include <pctkTypeTraits.h>
 
+#include <new>
+#include <cstring>
 #include <utility>
 #include <typeinfo>
+#include <type_traits>
+#include <initializer_list>
 
 PCTK_BEGIN_NAMESPACE
 
@@ -42,16 +47,83 @@ public:
     }
 };
 
+namespace detail
+{
+template<typename T>
+struct InPlaceTypeTag {};
+
+/* True when T == T compiles; values without an equality operator compare unequal. */
+template<typename T>
+class AnyHasEqual
+{
+    template<typename U>
+    static char check(decltype(std::declval<const U &>() == std::declval<const U &>()) *);
+    template<typename U>
+    static long check(...);
+
+public:
+    enum { value = sizeof(check<T>(PCTK_NULLPTR)) == sizeof(char) };
+};
+} // namespace detail
+
+/* Tag type of in_place_type<T>, which selects the in-place constructors of Any:
+ *     pctk::Any any(pctk::in_place_type<std::pair<char, int> >, 'a', 7); */
+struct InPlaceT {};
+
+template<typename T>
+inline InPlaceT in_place_type(detail::InPlaceTypeTag<T> = detail::InPlaceTypeTag<T>())
+{
+    return InPlaceT();
+}
+
+#define PCTK_IN_PLACE_TYPE(T) PCTK_PREPEND_NAMESPACE(in_place_type)<T>
+#define PCTK_IN_PLACE_TYPE_T(T) PCTK_PREPEND_NAMESPACE(InPlaceT) (&)(PCTK_PREPEND_NAMESPACE(detail)::InPlaceTypeTag<T>)
+
+/* Any keeps values of up to InlineSize bytes that move without throwing in an inline buffer, everything else on the
+ * heap. Each stored type gets one static table of functions, so copying, moving and casting never go through virtual
+ * calls or RTTI: any_cast compares table addresses. Relocatable and heap values move with a memcpy of the buffer.
+ * Any builds without RTTI as well, type() is only there with it. */
 class Any
 {
 public:
-    PCTK_CONSTEXPR Any() PCTK_NOEXCEPT: m_content(PCTK_NULLPTR) {}
-    Any(const Any &other) : m_content(other.m_content ? other.m_content->clone() : PCTK_NULLPTR) {}
+    enum { InlineSize = 3 * sizeof(void *) };
 
-    template<typename T>
-    Any(const T &value) : m_content(new Holder<T>(value)) {}
+    PCTK_CONSTEXPR Any() PCTK_NOEXCEPT : m_storage(), m_vtable(PCTK_NULLPTR) {}
+    Any(const Any &other) : m_vtable(other.m_vtable)
+    {
+        if (m_vtable)
+        {
+            this->copyFrom(other);
+        }
+    }
+    Any(Any &&other) PCTK_NOEXCEPT : m_vtable(other.m_vtable)
+    {
+        if (m_vtable)
+        {
+            this->moveFrom(other);
+        }
+    }
 
-    virtual ~Any() { this->reset(); }
+    template<typename T, typename = typename std::enable_if<!std::is_same<typename std::decay<T>::type, Any>::value>::type>
+    Any(T &&value) : m_vtable(PCTK_NULLPTR)
+    {
+        this->create<typename std::decay<T>::type>(std::forward<T>(value));
+    }
+
+    template<typename T, typename... Args>
+    explicit Any(InPlaceT (&)(detail::InPlaceTypeTag<T>), Args &&...args) : m_vtable(PCTK_NULLPTR)
+    {
+        this->create<T>(std::forward<Args>(args)...);
+    }
+
+    template<typename T, typename U, typename... Args>
+    explicit Any(InPlaceT (&)(detail::InPlaceTypeTag<T>), std::initializer_list<U> list, Args &&...args)
+        : m_vtable(PCTK_NULLPTR)
+    {
+        this->create<T>(list, std::forward<Args>(args)...);
+    }
+
+    ~Any() { this->reset(); }
 
     Any &operator=(const Any &other)
     {
@@ -59,27 +131,51 @@ public:
         return *this;
     }
 
-    template<typename T>
-    Any &operator=(const T &value)
+    Any &operator=(Any &&other) PCTK_NOEXCEPT
     {
-        Any(value).swap(*this);
+        if (this != &other)
+        {
+            this->reset();
+            m_vtable = other.m_vtable;
+            if (m_vtable)
+            {
+                this->moveFrom(other);
+            }
+        }
         return *this;
     }
 
+    template<typename T, typename = typename std::enable_if<!std::is_same<typename std::decay<T>::type, Any>::value>::type>
+    Any &operator=(T &&value)
+    {
+        Any(std::forward<T>(value)).swap(*this);
+        return *this;
+    }
+
+    /* Destroys the current value and constructs a T from args in its place. */
+    template<typename T, typename... Args>
+    T &emplace(Args &&...args)
+    {
+        this->reset();
+        this->create<T>(std::forward<Args>(args)...);
+        return *this->toPtr<T>();
+    }
+
+    template<typename T, typename U, typename... Args>
+    T &emplace(std::initializer_list<U> list, Args &&...args)
+    {
+        this->reset();
+        this->create<T>(list, std::forward<Args>(args)...);
+        return *this->toPtr<T>();
+    }
+
     bool operator==(const Any &other) const
     {
-        if (this->type() == other.type())
+        if (!m_vtable || !other.m_vtable)
         {
-            if (m_content && other.m_content)
-            {
-                return m_content->compare(other.m_content);
-            }
-            else
-            {
-                return m_content == other.m_content;
-            }
+            return m_vtable == other.m_vtable;
         }
-        return false;
+        return this->sameType(other.m_vtable) && m_vtable->equal(m_storage, other.m_storage);
     }
 
     bool operator!=(const Any &other) const
@@ -89,74 +185,214 @@ public:
 
     void reset() PCTK_NOEXCEPT
     {
-        if (PCTK_NULLPTR != m_content)
+        if (m_vtable)
         {
-            delete m_content;
-            m_content = PCTK_NULLPTR;
+            if (m_vtable->destroy)
+            {
+                m_vtable->destroy(m_storage);
+            }
+            m_vtable = PCTK_NULLPTR;
         }
     }
 
-    void swap(Any &other) PCTK_NOEXCEPT { std::swap(m_content, other.m_content); }
+    void swap(Any &other) PCTK_NOEXCEPT
+    {
+        if (this != &other)
+        {
+            Any tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+    }
 
-    bool hasValue() const PCTK_NOEXCEPT { return m_content != PCTK_NULLPTR; }
+    bool hasValue() const PCTK_NOEXCEPT { return m_vtable != PCTK_NULLPTR; }
 
-    const std::type_info &type() const PCTK_NOEXCEPT { return this->hasValue() ? m_content->type() : typeid(void); }
+#if PCTK_CC_FEATURE_RTTI
+    const std::type_info &type() const PCTK_NOEXCEPT { return m_vtable ? m_vtable->type() : typeid(void); }
+#endif
 
     template<typename T>
     const T *toPtr() const
     {
-        return &(static_cast<Holder<T> *>(m_content)->m_hold);
+        return StoresInline<T>::value ? reinterpret_cast<const T *>(&m_storage.buffer)
+                                      : static_cast<const T *>(m_storage.heap);
     }
 
     template<typename T>
     T *toPtr()
     {
-        return &(static_cast<Holder<T> *>(m_content)->m_hold);
+        return StoresInline<T>::value ? reinterpret_cast<T *>(&m_storage.buffer) : static_cast<T *>(m_storage.heap);
     }
 
     template<typename T>
     bool canConvert() const
     {
-        return this->hasValue() ? typeid(T) == m_content->type() : false;
+        return m_vtable && this->sameType(&VTableFor<typename TypeRemoveConstVolatile<T>::Type>::table);
     }
 
+    /* True when a T would be kept in the inline buffer rather than on the heap. */
+    template<typename T>
+    static PCTK_CONSTEXPR bool isStoredInline() { return StoresInline<T>::value; }
+
 private:
-    class PlaceHolder
+    union Storage
     {
-    public:
-        virtual ~PlaceHolder() {}
+        void *heap;
+        long long alignLongLong;
+        double alignDouble;
+        unsigned char buffer[InlineSize];
+    };
 
-        virtual std::type_info const &type() const = 0;
-        virtual PlaceHolder *clone() const = 0;
-        virtual bool compare(PlaceHolder *other) const = 0;
+    /* A null copy or move means the value is copied or moved with a memcpy of the storage, a null destroy that there
+     * is nothing to destroy. */
+    struct VTable
+    {
+#if PCTK_CC_FEATURE_RTTI
+        const std::type_info &(*type)();
+#endif
+        void (*destroy)(Storage &storage);
+        void (*copy)(Storage &dest, const Storage &source);
+        void (*move)(Storage &dest, Storage &source);
+        bool (*equal)(const Storage &lhs, const Storage &rhs);
     };
 
     template<typename T>
-    class Holder : public PlaceHolder
+    struct StoresInline
     {
-    public:
-        typedef T Type;
+        enum
+        {
+            value = sizeof(T) <= InlineSize && PCTK_ALIGNOF(Storage) % PCTK_ALIGNOF(T) == 0 &&
+                    (TypeInfoQuery<T>::isRelocatable || std::is_nothrow_move_constructible<T>::value)
+        };
+    };
 
-        Holder(T const &value) : m_hold(value) {}
+    template<typename T, bool IsInline = StoresInline<T>::value>
+    struct Manager
+    {
+        static T *get(Storage &storage) { return reinterpret_cast<T *>(&storage.buffer); }
+        static const T *get(const Storage &storage) { return reinterpret_cast<const T *>(&storage.buffer); }
+        template<typename... Args>
+        static void create(Storage &storage, Args &&...args) { new(&storage.buffer) T(std::forward<Args>(args)...); }
+        static void destroy(Storage &storage) { get(storage)->~T(); }
+        static void copy(Storage &dest, const Storage &source) { new(&dest.buffer) T(*get(source)); }
+        static void move(Storage &dest, Storage &source)
+        {
+            new(&dest.buffer) T(std::move(*get(source)));
+            get(source)->~T();
+        }
 
-        virtual std::type_info const &type() const { return typeid(T); }
+        enum
+        {
+            TrivialCopy = !TypeInfoQuery<T>::isComplex,
+            TrivialDestroy = !TypeInfoQuery<T>::isComplex,
+            TrivialMove = TypeInfoQuery<T>::isRelocatable
+        };
+    };
 
-        virtual PlaceHolder *clone() const { return new Holder(m_hold); }
+    template<typename T>
+    struct Manager<T, false>
+    {
+        static T *get(Storage &storage) { return static_cast<T *>(storage.heap); }
+        static const T *get(const Storage &storage) { return static_cast<const T *>(storage.heap); }
+        template<typename... Args>
+        static void create(Storage &storage, Args &&...args) { storage.heap = new T(std::forward<Args>(args)...); }
+        static void destroy(Storage &storage) { delete get(storage); }
+        static void copy(Storage &dest, const Storage &source) { dest.heap = new T(*get(source)); }
+        static void move(Storage &dest, Storage &source) { dest.heap = source.heap; }
+
+        enum { TrivialCopy = false, TrivialDestroy = false, TrivialMove = true };
+    };
 
-        bool compare(PlaceHolder *other) const
+    template<typename T, bool HasEqual = detail::AnyHasEqual<T>::value>
+    struct Equal
+    {
+        static bool equal(const Storage &lhs, const Storage &rhs)
+        {
+            return *Manager<T>::get(lhs) == *Manager<T>::get(rhs);
+        }
+    };
+
+    template<typename T>
+    struct Equal<T, false>
+    {
+        static bool equal(const Storage &, const Storage &)
         {
-            Holder *holder = dynamic_cast<Holder *>(other);
-            if (holder)
-            {
-                return this->m_hold == holder->m_hold;
-            }
             return false;
         }
+    };
 
-        T m_hold;
+    template<typename T>
+    struct VTableFor
+    {
+#if PCTK_CC_FEATURE_RTTI
+        static const std::type_info &type() { return typeid(T); }
+#endif
+        static const VTable table;
     };
 
-    PlaceHolder *m_content;
+    /* Constructs the T straight in the buffer or on the heap, without a temporary to move from. */
+    template<typename T, typename... Args>
+    void create(Args &&...args)
+    {
+        Manager<T>::create(m_storage, std::forward<Args>(args)...);
+        m_vtable = &VTableFor<T>::table;
+    }
+
+    void copyFrom(const Any &other)
+    {
+        if (m_vtable->copy)
+        {
+            m_vtable->copy(m_storage, other.m_storage);
+        }
+        else
+        {
+            std::memcpy(&m_storage, &other.m_storage, sizeof(Storage));
+        }
+    }
+
+    void moveFrom(Any &other) PCTK_NOEXCEPT
+    {
+        if (m_vtable->move)
+        {
+            m_vtable->move(m_storage, other.m_storage);
+        }
+        else
+        {
+            std::memcpy(&m_storage, &other.m_storage, sizeof(Storage));
+        }
+        other.m_vtable = PCTK_NULLPTR;
+    }
+
+    /* Tables are normally unique per type, but a type used from several shared objects built with hidden visibility
+     * can end up with one table per object, so with RTTI a mismatch falls back to comparing type_info before failing.
+     * Without it such a value only casts in the object that stored it. */
+    bool sameType(const VTable *vtable) const
+    {
+#if PCTK_CC_FEATURE_RTTI
+        return PCTK_LIKELY(m_vtable == vtable) || m_vtable->type() == vtable->type();
+#else
+        return m_vtable == vtable;
+#endif
+    }
+
+    template<typename T>
+    friend const T *any_cast(const Any *operand) PCTK_NOEXCEPT;
+    template<typename T>
+    friend T *any_cast(Any *operand) PCTK_NOEXCEPT;
+
+    Storage m_storage;
+    const VTable *m_vtable;
+};
+
+template<typename T>
+const Any::VTable Any::VTableFor<T>::table = {
+#if PCTK_CC_FEATURE_RTTI
+    &Any::VTableFor<T>::type,
+#endif
+    Any::Manager<T>::TrivialDestroy ? PCTK_NULLPTR : &Any::Manager<T>::destroy,
+    Any::Manager<T>::TrivialCopy ? PCTK_NULLPTR : &Any::Manager<T>::copy,
+    Any::Manager<T>::TrivialMove ? PCTK_NULLPTR : &Any::Manager<T>::move,
+    &Any::Equal<T>::equal
 };
 
 inline void swap(Any &x, Any &y) PCTK_NOEXCEPT
@@ -164,10 +400,37 @@ inline void swap(Any &x, Any &y) PCTK_NOEXCEPT
     x.swap(y);
 }
 
+template<typename T, typename... Args>
+inline Any make_any(Args &&...args)
+{
+    return Any(in_place_type<T>, std::forward<Args>(args)...);
+}
+
+template<typename T, typename U, typename... Args>
+inline Any make_any(std::initializer_list<U> list, Args &&...args)
+{
+    return Any(in_place_type<T>, list, std::forward<Args>(args)...);
+}
+
 template<typename T>
-inline T any_cast(Any const &operand)
+inline const T *any_cast(const Any *operand) PCTK_NOEXCEPT
 {
-    const T *result = any_cast<typename TypeAddConst<typename TypeRemoveReference<T>::Type>::Type>(&operand);
+    typedef typename TypeRemoveConstVolatile<T>::Type Type;
+    return operand != PCTK_NULLPTR && operand->canConvert<Type>() ? operand->toPtr<Type>() : PCTK_NULLPTR;
+}
+
+template<typename T>
+inline T *any_cast(Any *operand) PCTK_NOEXCEPT
+{
+    typedef typename TypeRemoveConstVolatile<T>::Type Type;
+    return operand != PCTK_NULLPTR && operand->canConvert<Type>() ? operand->toPtr<Type>() : PCTK_NULLPTR;
+}
+
+template<typename T>
+inline T any_cast(const Any &operand)
+{
+    const typename std::remove_reference<T>::type *result =
+        any_cast<typename std::remove_reference<T>::type>(&operand);
     if (!result)
     {
         throw BadAnyCast();
@@ -178,8 +441,7 @@ inline T any_cast(Any const &operand)
 template<typename T>
 inline T any_cast(Any &operand)
 {
-    const T *result = any_cast<typename TypeRemoveReference<T>::Type>(&operand);
-
+    typename std::remove_reference<T>::type *result = any_cast<typename std::remove_reference<T>::type>(&operand);
     if (!result)
     {
         throw BadAnyCast();
@@ -187,16 +449,16 @@ inline T any_cast(Any &operand)
     return *result;
 }
 
+/* Moves the value out of an expiring Any instead of copying it. */
 template<typename T>
-inline T const *any_cast(Any const *operand) PCTK_NOEXCEPT
-{
-    return operand != PCTK_NULLPTR && operand->type() == typeid(T) ? operand->toPtr<T>() : PCTK_NULLPTR;
-}
-
-template<typename T>
-inline T *any_cast(Any *operand) PCTK_NOEXCEPT
+inline T any_cast(Any &&operand)
 {
-    return operand != PCTK_NULLPTR && operand->type() == typeid(T) ? operand->toPtr<T>() : PCTK_NULLPTR;
+    typename std::remove_reference<T>::type *result = any_cast<typename std::remove_reference<T>::type>(&operand);
+    if (!result)
+    {
+        throw BadAnyCast();
+    }
+    return static_cast<T>(std::move(*result));
 }
 
 PCTK_END_NAMESPACE
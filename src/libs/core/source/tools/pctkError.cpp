@@ -25,6 +25,9 @@
 #include <pctkError.h>
 #include <pctkString.h>
 
+#include <cerrno>
+#include <cstring>
+
 PCTK_BEGIN_NAMESPACE
 
 std::string Error::getLastCErrorStr()
@@ -34,9 +34,9 @@ PCTK_BEGIN_NAMESPACE
 
 namespace util
 {
-std::string getExceptionStr(const std::exception_ptr &exc);
+PCTK_CORE_API std::string getExceptionStr(const std::exception_ptr &exc);
 
-std::string getLastExceptionStr();
+PCTK_CORE_API std::string getLastExceptionStr();
 }
 
 PCTK_END_NAMESPACE
@@ -0,0 +1,168 @@
+/***********************************************************************************************************************
+**
+** Library: UTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKHASHMAP_H
+#define _PCTKHASHMAP_H
+
+#include <pctkHashTable.h>
+
+#include <tuple>
+#include <stdexcept>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+template<typename K, typename V>
+struct HashMapPolicy
+{
+    typedef K KeyType;
+    typedef std::pair<const K, V> SlotType;
+    typedef SlotType ElementType;
+
+    enum
+    {
+        isRelocatable = TypeInfoQuery<K>::isRelocatable && TypeInfoQuery<V>::isRelocatable,
+        isTrivial = !TypeInfoQuery<K>::isComplex && !TypeInfoQuery<V>::isComplex
+    };
+
+    static const K &key(const SlotType &slot) { return slot.first; }
+    static void relocate(SlotType *dest, SlotType *source)
+    {
+        HashSlotRelocator<SlotType, isRelocatable>::relocate(dest, source);
+    }
+};
+} // namespace detail
+
+/* Unordered map with open addressing and group probing, see detail::HashTable. Iterators and references are
+ * invalidated by any insertion that grows the table. */
+template<typename K, typename V, typename Hasher = Hash<K>, typename KeyEqual = EqualTo>
+class HashMap : public detail::HashTable<detail::HashMapPolicy<K, V>, Hasher, KeyEqual>
+{
+    typedef detail::HashTable<detail::HashMapPolicy<K, V>, Hasher, KeyEqual> Base;
+
+public:
+    typedef V mapped_type;
+    typedef typename Base::key_type key_type;
+    typedef typename Base::value_type value_type;
+    typedef typename Base::size_type size_type;
+    typedef typename Base::iterator iterator;
+    typedef typename Base::const_iterator const_iterator;
+
+    explicit HashMap(size_type bucketCount = 0, const Hasher &hash = Hasher(), const KeyEqual &equal = KeyEqual())
+        : Base(bucketCount, hash, equal) {}
+    HashMap(std::initializer_list<value_type> list) : Base(list.size())
+    {
+        this->insert(list.begin(), list.end());
+    }
+
+    /* Inserts (key, V(args...)) unless key is present; args are left untouched when it is. */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const key_type &key, Args &&...args)
+    {
+        return this->findOrEmplace(key, std::piecewise_construct, std::forward_as_tuple(key),
+                                   std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(key_type &&key, Args &&...args)
+    {
+        return this->findOrEmplace(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                   std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(const key_type &key, M &&value)
+    {
+        std::pair<iterator, bool> result = this->try_emplace(key, std::forward<M>(value));
+        if (!result.second)
+        {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(const key_type &key, Args &&...args)
+    {
+        return this->try_emplace(key, std::forward<Args>(args)...);
+    }
+
+    V &operator[](const key_type &key) { return this->try_emplace(key).first->second; }
+    V &operator[](key_type &&key) { return this->try_emplace(std::move(key)).first->second; }
+
+    V &at(const key_type &key)
+    {
+        iterator it = this->find(key);
+        if (it == this->end())
+        {
+            throw std::out_of_range("HashMap: key not found");
+        }
+        return it->second;
+    }
+    const V &at(const key_type &key) const
+    {
+        const_iterator it = this->find(key);
+        if (it == this->end())
+        {
+            throw std::out_of_range("HashMap: key not found");
+        }
+        return it->second;
+    }
+
+    /* Returns the value for key, or defaultValue when key is missing. */
+    V value(const key_type &key, const V &defaultValue = V()) const
+    {
+        const_iterator it = this->find(key);
+        return it == this->end() ? defaultValue : it->second;
+    }
+
+    bool operator==(const HashMap &other) const
+    {
+        if (this->size() != other.size())
+        {
+            return false;
+        }
+        for (const_iterator it = this->begin(); it != this->end(); ++it)
+        {
+            const_iterator found = other.find(it->first);
+            if (found == other.end() || !(found->second == it->second))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool operator!=(const HashMap &other) const { return !(*this == other); }
+};
+
+template<typename K, typename V, typename Hasher, typename KeyEqual>
+inline void swap(HashMap<K, V, Hasher, KeyEqual> &x, HashMap<K, V, Hasher, KeyEqual> &y) PCTK_NOEXCEPT
+{
+    x.swap(y);
+}
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKHASHMAP_H
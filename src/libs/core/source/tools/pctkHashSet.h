@@ -0,0 +1,108 @@
+/***********************************************************************************************************************
+**
+** Library: UTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKHASHSET_H
+#define _PCTKHASHSET_H
+
+#include <pctkHashTable.h>
+
+#include <initializer_list>
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+template<typename K>
+struct HashSetPolicy
+{
+    typedef K KeyType;
+    typedef K SlotType;
+    /* iterators hand out const keys, a key changed in place would sit in the wrong group */
+    typedef const K ElementType;
+
+    enum
+    {
+        isRelocatable = TypeInfoQuery<K>::isRelocatable,
+        isTrivial = !TypeInfoQuery<K>::isComplex
+    };
+
+    static const K &key(const K &slot) { return slot; }
+    static void relocate(K *dest, K *source) { HashSlotRelocator<K, isRelocatable>::relocate(dest, source); }
+};
+} // namespace detail
+
+/* Unordered set with open addressing and group probing, see detail::HashTable. Iterators and references are
+ * invalidated by any insertion that grows the table. */
+template<typename K, typename Hasher = Hash<K>, typename KeyEqual = EqualTo>
+class HashSet : public detail::HashTable<detail::HashSetPolicy<K>, Hasher, KeyEqual>
+{
+    typedef detail::HashTable<detail::HashSetPolicy<K>, Hasher, KeyEqual> Base;
+
+public:
+    typedef typename Base::value_type value_type;
+    typedef typename Base::size_type size_type;
+    typedef typename Base::iterator iterator;
+    typedef typename Base::const_iterator const_iterator;
+
+    explicit HashSet(size_type bucketCount = 0, const Hasher &hash = Hasher(), const KeyEqual &equal = KeyEqual())
+        : Base(bucketCount, hash, equal) {}
+    HashSet(std::initializer_list<K> list) : Base(list.size())
+    {
+        this->insert(list.begin(), list.end());
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(Args &&...args)
+    {
+        return this->insert(K(std::forward<Args>(args)...));
+    }
+
+    bool operator==(const HashSet &other) const
+    {
+        if (this->size() != other.size())
+        {
+            return false;
+        }
+        for (const_iterator it = this->begin(); it != this->end(); ++it)
+        {
+            if (!other.contains(*it))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool operator!=(const HashSet &other) const { return !(*this == other); }
+};
+
+template<typename K, typename Hasher, typename KeyEqual>
+inline void swap(HashSet<K, Hasher, KeyEqual> &x, HashSet<K, Hasher, KeyEqual> &y) PCTK_NOEXCEPT
+{
+    x.swap(y);
+}
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKHASHSET_H
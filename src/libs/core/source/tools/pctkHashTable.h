@@ -0,0 +1,711 @@
+/***********************************************************************************************************************
+**
+** Library: UTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKHASHTABLE_H
+#define _PCTKHASHTABLE_H
+
+#include <pctkGlobal.h>
+#include <pctkTypeInfo.h>
+
+#include <new>
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <functional>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define PCTK_HASH_GROUP_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   include <arm_neon.h>
+#   define PCTK_HASH_GROUP_NEON 1
+#endif
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+PCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/* Byte hash shared by Hash<std::string> and its const char * lookups (MurmurHash64A). */
+inline std::size_t hashBytes(const void *data, std::size_t length)
+{
+    const pctk_uint64_t m = 0xc6a4a7935bd1e995ull;
+    const int r = 47;
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    pctk_uint64_t h = 0x8445d61a4e774912ull ^ (length * m);
+    for (; length >= 8; bytes += 8, length -= 8)
+    {
+        pctk_uint64_t k;
+        std::memcpy(&k, bytes, 8);
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+    if (length)
+    {
+        pctk_uint64_t k = 0;
+        for (std::size_t i = length; i-- > 0;)
+        {
+            k = (k << 8) | bytes[i];
+        }
+        h ^= k;
+        h *= m;
+    }
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return std::size_t(h);
+}
+
+inline int countTrailingZeros(pctk_uint64_t value)
+{
+#if defined(PCTK_CC_GNU) || defined(__clang__)
+    return __builtin_ctzll(value);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return int(index);
+#else
+    int count = 0;
+    for (; !(value & 1); value >>= 1)
+    {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+template<typename T>
+struct VoidType
+{
+    typedef void Type;
+};
+
+template<typename T, typename = void>
+struct IsTransparent : std::false_type {};
+
+template<typename T>
+struct IsTransparent<T, typename VoidType<typename T::is_transparent>::Type> : std::true_type {};
+
+/* Control byte of each slot: empty, deleted, or the low 7 bits of the slot hash when full. */
+enum HashControl
+{
+    HashControlEmpty = -128,
+    HashControlDeleted = -2
+};
+
+/* Set bits of a group match, lowest slot first. Each slot owns (1 << Shift) bits of which only the top one is set. */
+template<int Shift>
+class HashBitMask
+{
+public:
+    explicit HashBitMask(pctk_uint64_t mask) : m_mask(mask) {}
+
+    bool hasAny() const { return 0 != m_mask; }
+    int lowest() const { return countTrailingZeros(m_mask) >> Shift; }
+    void next() { m_mask &= m_mask - 1; }
+
+private:
+    pctk_uint64_t m_mask;
+};
+
+#if PCTK_HASH_GROUP_SSE2
+/* Sixteen control bytes compared at once with SSE2. */
+struct HashGroup
+{
+    enum { Width = 16 };
+    typedef HashBitMask<0> Mask;
+
+    explicit HashGroup(const signed char *ctrl)
+        : m_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl))) {}
+
+    Mask match(signed char h2) const
+    {
+        return Mask(pctk_uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl))));
+    }
+    Mask matchEmpty() const
+    {
+        return Mask(pctk_uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(char(HashControlEmpty)), m_ctrl))));
+    }
+    Mask matchEmptyOrDeleted() const { return Mask(pctk_uint64_t(_mm_movemask_epi8(m_ctrl))); }
+
+    __m128i m_ctrl;
+};
+#elif PCTK_HASH_GROUP_NEON
+/* Sixteen control bytes compared at once with NEON, narrowed to four mask bits per byte. */
+struct HashGroup
+{
+    enum { Width = 16 };
+    typedef HashBitMask<2> Mask;
+
+    explicit HashGroup(const signed char *ctrl) : m_ctrl(vld1q_s8(ctrl)) {}
+
+    static Mask toMask(uint8x16_t lanes)
+    {
+        const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(lanes), 4);
+        return Mask(vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ull);
+    }
+    Mask match(signed char h2) const { return toMask(vceqq_s8(vdupq_n_s8(h2), m_ctrl)); }
+    Mask matchEmpty() const { return toMask(vceqq_s8(vdupq_n_s8(HashControlEmpty), m_ctrl)); }
+    Mask matchEmptyOrDeleted() const { return toMask(vcltq_s8(m_ctrl, vdupq_n_s8(0))); }
+
+    int8x16_t m_ctrl;
+};
+#else
+/* Eight control bytes compared at once in a 64-bit word. match() may report a false positive next to a true one,
+ * which costs one extra key comparison. */
+struct HashGroup
+{
+    enum { Width = 8 };
+    typedef HashBitMask<3> Mask;
+
+    explicit HashGroup(const signed char *ctrl) { std::memcpy(&m_ctrl, ctrl, 8); }
+
+    Mask match(signed char h2) const
+    {
+        const pctk_uint64_t lsbs = 0x0101010101010101ull;
+        const pctk_uint64_t x = m_ctrl ^ (lsbs * (unsigned char) h2);
+        return Mask((x - lsbs) & ~x & 0x8080808080808080ull);
+    }
+    Mask matchEmpty() const { return Mask(m_ctrl & ~(m_ctrl << 6) & 0x8080808080808080ull); }
+    Mask matchEmptyOrDeleted() const { return Mask(m_ctrl & 0x8080808080808080ull); }
+
+    pctk_uint64_t m_ctrl;
+};
+#endif
+
+/* Open addressing table in the Swiss table layout: one control byte per slot followed by a copy of the first
+ * Width control bytes, so a group can be loaded at any slot, then the slots themselves, all in one allocation.
+ * Probing visits whole groups in triangular steps and stops at the first group with an empty slot. Erasing leaves
+ * a tombstone; tombstones are dropped the next time the table is rebuilt. Policy gives the slot type and its key. */
+template<typename Policy, typename Hasher, typename KeyEqual>
+class HashTable
+{
+public:
+    typedef typename Policy::KeyType key_type;
+    typedef typename Policy::SlotType value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Hasher hasher;
+    typedef KeyEqual key_equal;
+    typedef value_type &reference;
+    typedef const value_type &const_reference;
+
+    enum
+    {
+        isRelocatable = Policy::isRelocatable,
+        GroupWidth = HashGroup::Width
+    };
+
+    template<typename Value>
+    class Iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename std::remove_const<Value>::type value_type;
+        typedef Value &reference;
+        typedef Value *pointer;
+        typedef std::ptrdiff_t difference_type;
+
+        Iterator() : m_ctrl(PCTK_NULLPTR), m_slot(PCTK_NULLPTR), m_end(PCTK_NULLPTR) {}
+        template<typename Other, typename = typename std::enable_if<std::is_convertible<Other *, Value *>::value>::type>
+        Iterator(const Iterator<Other> &other) : m_ctrl(other.m_ctrl), m_slot(other.m_slot), m_end(other.m_end) {}
+
+        reference operator*() const { return *m_slot; }
+        pointer operator->() const { return m_slot; }
+        Iterator &operator++()
+        {
+            ++m_ctrl;
+            ++m_slot;
+            this->skipEmpty();
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator copy(*this);
+            ++*this;
+            return copy;
+        }
+        bool operator==(const Iterator &other) const { return m_slot == other.m_slot; }
+        bool operator!=(const Iterator &other) const { return m_slot != other.m_slot; }
+
+    private:
+        friend class HashTable;
+        template<typename>
+        friend class Iterator;
+
+        Iterator(const signed char *ctrl, Value *slot, const signed char *end)
+            : m_ctrl(ctrl), m_slot(slot), m_end(end) {}
+
+        void skipEmpty()
+        {
+            while (m_ctrl != m_end && *m_ctrl < 0)
+            {
+                ++m_ctrl;
+                ++m_slot;
+            }
+        }
+
+        const signed char *m_ctrl;
+        Value *m_slot;
+        const signed char *m_end;
+    };
+
+    typedef Iterator<typename Policy::ElementType> iterator;
+    typedef Iterator<const value_type> const_iterator;
+
+    explicit HashTable(size_type bucketCount = 0, const Hasher &hash = Hasher(), const KeyEqual &equal = KeyEqual())
+        : m_ctrl(PCTK_NULLPTR), m_slots(PCTK_NULLPTR), m_capacity(0), m_size(0), m_growthLeft(0),
+          m_hash(hash), m_equal(equal)
+    {
+        this->reserve(bucketCount);
+    }
+    HashTable(const HashTable &other)
+        : m_ctrl(PCTK_NULLPTR), m_slots(PCTK_NULLPTR), m_capacity(0), m_size(0), m_growthLeft(0),
+          m_hash(other.m_hash), m_equal(other.m_equal)
+    {
+        this->reserve(other.m_size);
+        for (const_iterator it = other.begin(); it != other.end(); ++it)
+        {
+            this->insertUnique(*it);
+        }
+    }
+    HashTable(HashTable &&other) PCTK_NOEXCEPT
+        : m_ctrl(other.m_ctrl), m_slots(other.m_slots), m_capacity(other.m_capacity), m_size(other.m_size),
+          m_growthLeft(other.m_growthLeft), m_hash(other.m_hash), m_equal(other.m_equal)
+    {
+        other.m_ctrl = PCTK_NULLPTR;
+        other.m_slots = PCTK_NULLPTR;
+        other.m_capacity = other.m_size = other.m_growthLeft = 0;
+    }
+
+    ~HashTable() { this->destroyAll(); }
+
+    HashTable &operator=(const HashTable &other)
+    {
+        if (this != &other)
+        {
+            HashTable(other).swap(*this);
+        }
+        return *this;
+    }
+    HashTable &operator=(HashTable &&other) PCTK_NOEXCEPT
+    {
+        if (this != &other)
+        {
+            HashTable(std::move(other)).swap(*this);
+        }
+        return *this;
+    }
+
+    iterator begin()
+    {
+        iterator it(m_ctrl, m_slots, m_ctrl + m_capacity);
+        it.skipEmpty();
+        return it;
+    }
+    const_iterator begin() const
+    {
+        const_iterator it(m_ctrl, m_slots, m_ctrl + m_capacity);
+        it.skipEmpty();
+        return it;
+    }
+    const_iterator cbegin() const { return this->begin(); }
+    iterator end() { return iterator(m_ctrl + m_capacity, m_slots + m_capacity, m_ctrl + m_capacity); }
+    const_iterator end() const
+    {
+        return const_iterator(m_ctrl + m_capacity, m_slots + m_capacity, m_ctrl + m_capacity);
+    }
+    const_iterator cend() const { return this->end(); }
+
+    size_type size() const PCTK_NOEXCEPT { return m_size; }
+    bool empty() const PCTK_NOEXCEPT { return 0 == m_size; }
+    size_type capacity() const PCTK_NOEXCEPT { return m_capacity; }
+    float load_factor() const { return m_capacity ? float(m_size) / float(m_capacity) : 0.0f; }
+    hasher hash_function() const { return m_hash; }
+    key_equal key_eq() const { return m_equal; }
+
+    iterator find(const key_type &key) { return this->findImpl(key); }
+    const_iterator find(const key_type &key) const { return const_cast<HashTable *>(this)->findImpl(key); }
+
+    /* Heterogeneous lookup, for example a const char * in a table of std::string, when Hasher and KeyEqual both
+     * declare is_transparent. */
+    template<typename Key, typename H = Hasher, typename = typename std::enable_if<IsTransparent<H>::value &&
+                                                                             IsTransparent<KeyEqual>::value>::type>
+    iterator find(const Key &key) { return this->findImpl(key); }
+    template<typename Key, typename H = Hasher, typename = typename std::enable_if<IsTransparent<H>::value &&
+                                                                             IsTransparent<KeyEqual>::value>::type>
+    const_iterator find(const Key &key) const { return const_cast<HashTable *>(this)->findImpl(key); }
+
+    bool contains(const key_type &key) const { return this->find(key) != this->end(); }
+    template<typename Key, typename H = Hasher, typename = typename std::enable_if<IsTransparent<H>::value &&
+                                                                             IsTransparent<KeyEqual>::value>::type>
+    bool contains(const Key &key) const { return this->find(key) != this->end(); }
+    size_type count(const key_type &key) const { return this->contains(key) ? 1 : 0; }
+
+    std::pair<iterator, bool> insert(const value_type &value) { return this->insertUnique(value); }
+    std::pair<iterator, bool> insert(value_type &&value) { return this->insertUnique(std::move(value)); }
+    template<typename InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            this->insertUnique(*first);
+        }
+    }
+
+    size_type erase(const key_type &key)
+    {
+        iterator it = this->find(key);
+        if (it == this->end())
+        {
+            return 0;
+        }
+        this->erase(it);
+        return 1;
+    }
+    iterator erase(const_iterator position)
+    {
+        const size_type index = size_type(position.m_ctrl - m_ctrl);
+        m_slots[index].~value_type();
+        this->setCtrl(index, HashControlDeleted);
+        --m_size;
+        iterator next(m_ctrl + index, m_slots + index, m_ctrl + m_capacity);
+        return ++next;
+    }
+
+    void clear() PCTK_NOEXCEPT
+    {
+        this->destroySlots();
+        if (m_capacity)
+        {
+            std::memset(m_ctrl, HashControlEmpty, m_capacity + GroupWidth);
+        }
+        m_size = 0;
+        m_growthLeft = growthFor(m_capacity);
+    }
+
+    /* Makes room for count elements without rebuilding the table. */
+    void reserve(size_type count)
+    {
+        if (count > m_size + m_growthLeft)
+        {
+            this->rehash(capacityFor(count));
+        }
+    }
+
+    /* Rebuilds the table with at least capacity slots, rounded up to the power of two probing masks with. */
+    void rehash(size_type capacity)
+    {
+        if (capacity < capacityFor(m_size))
+        {
+            capacity = capacityFor(m_size);
+        }
+        if (0 != capacity)
+        {
+            size_type rounded = GroupWidth;
+            while (rounded < capacity)
+            {
+                rounded *= 2;
+            }
+            capacity = rounded;
+        }
+        if (0 == m_size && 0 == capacity)
+        {
+            this->destroyAll();
+            m_ctrl = PCTK_NULLPTR;
+            m_slots = PCTK_NULLPTR;
+            m_capacity = m_growthLeft = 0;
+            return;
+        }
+        this->resize(capacity);
+    }
+
+    void swap(HashTable &other) PCTK_NOEXCEPT
+    {
+        std::swap(m_ctrl, other.m_ctrl);
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_size, other.m_size);
+        std::swap(m_growthLeft, other.m_growthLeft);
+        std::swap(m_hash, other.m_hash);
+        std::swap(m_equal, other.m_equal);
+    }
+
+protected:
+    struct HashSplit
+    {
+        size_type h1;
+        signed char h2;
+    };
+
+    template<typename Key>
+    HashSplit split(const Key &key) const
+    {
+        // spread weak hashes such as the identity hash of integers over all bits
+        pctk_uint64_t h = pctk_uint64_t(m_hash(key)) * 0x9e3779b97f4a7c15ull;
+        h ^= h >> 32;
+        HashSplit result;
+        result.h1 = size_type(h >> 7);
+        result.h2 = (signed char) (h & 0x7f);
+        return result;
+    }
+
+    template<typename Key>
+    iterator findImpl(const Key &key)
+    {
+        if (PCTK_UNLIKELY(0 == m_capacity))
+        {
+            return this->end();
+        }
+        const HashSplit hash = this->split(key);
+        const size_type mask = m_capacity - 1;
+        size_type position = hash.h1 & mask;
+        for (size_type step = GroupWidth;; step += GroupWidth)
+        {
+            const HashGroup group(m_ctrl + position);
+            for (typename HashGroup::Mask match = group.match(hash.h2); match.hasAny(); match.next())
+            {
+                const size_type index = (position + size_type(match.lowest())) & mask;
+                if (PCTK_LIKELY(m_equal(Policy::key(m_slots[index]), key)))
+                {
+                    return iterator(m_ctrl + index, m_slots + index, m_ctrl + m_capacity);
+                }
+            }
+            if (PCTK_LIKELY(group.matchEmpty().hasAny()))
+            {
+                return this->end();
+            }
+            position = (position + step) & mask;
+        }
+    }
+
+    /* Looks key up and, when it is missing, constructs a slot for it from args. */
+    template<typename Key, typename... Args>
+    std::pair<iterator, bool> findOrEmplace(const Key &key, Args &&...args)
+    {
+        iterator found = this->findImpl(key);
+        if (found != this->end())
+        {
+            return std::make_pair(found, false);
+        }
+        const HashSplit hash = this->split(key);
+        const size_type index = this->prepareInsert(hash);
+        new(m_slots + index) value_type(std::forward<Args>(args)...);
+        /* published only once constructed, a throwing constructor leaves the slot free */
+        if (m_ctrl[index] == HashControlEmpty)
+        {
+            --m_growthLeft;
+        }
+        this->setCtrl(index, hash.h2);
+        ++m_size;
+        return std::make_pair(iterator(m_ctrl + index, m_slots + index, m_ctrl + m_capacity), true);
+    }
+
+    template<typename Value>
+    std::pair<iterator, bool> insertUnique(Value &&value)
+    {
+        return this->findOrEmplace(Policy::key(value), std::forward<Value>(value));
+    }
+
+private:
+    static_assert(PCTK_ALIGNOF(value_type) <= PCTK_ALIGNOF(std::max_align_t), "HashTable slots come from operator new");
+
+    static size_type growthFor(size_type capacity) { return capacity - capacity / 8; }
+
+    static size_type capacityFor(size_type count)
+    {
+        if (0 == count)
+        {
+            return 0;
+        }
+        size_type capacity = GroupWidth;
+        while (growthFor(capacity) < count)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    void setCtrl(size_type index, signed char value)
+    {
+        m_ctrl[index] = value;
+        if (index < size_type(GroupWidth))
+        {
+            m_ctrl[m_capacity + index] = value;
+        }
+    }
+
+    size_type findNonFull(const HashSplit &hash) const
+    {
+        const size_type mask = m_capacity - 1;
+        size_type position = hash.h1 & mask;
+        for (size_type step = GroupWidth;; step += GroupWidth)
+        {
+            const typename HashGroup::Mask free = HashGroup(m_ctrl + position).matchEmptyOrDeleted();
+            if (free.hasAny())
+            {
+                return (position + size_type(free.lowest())) & mask;
+            }
+            position = (position + step) & mask;
+        }
+    }
+
+    /* Returns the index of a free slot for hash, growing or cleaning the table first when it is out of room. The
+     * slot stays marked free, the caller publishes it. */
+    size_type prepareInsert(const HashSplit &hash)
+    {
+        size_type index = m_capacity ? this->findNonFull(hash) : 0;
+        if (0 == m_capacity || (0 == m_growthLeft && m_ctrl[index] != HashControlDeleted))
+        {
+            // many tombstones: rebuild at the same size, otherwise double
+            const bool isMostlyTombstones = m_capacity && m_size < growthFor(m_capacity) / 2;
+            this->resize(isMostlyTombstones ? m_capacity : (m_capacity ? m_capacity * 2 : size_type(GroupWidth)));
+            index = this->findNonFull(hash);
+        }
+        return index;
+    }
+
+    void resize(size_type capacity)
+    {
+        const size_type slotOffset = (capacity + GroupWidth + PCTK_ALIGNOF(value_type) - 1) /
+                                     PCTK_ALIGNOF(value_type) * PCTK_ALIGNOF(value_type);
+        char *memory = static_cast<char *>(::operator new(slotOffset + capacity * sizeof(value_type)));
+        signed char *oldCtrl = m_ctrl;
+        value_type *oldSlots = m_slots;
+        const size_type oldCapacity = m_capacity;
+
+        m_ctrl = reinterpret_cast<signed char *>(memory);
+        m_slots = reinterpret_cast<value_type *>(memory + slotOffset);
+        m_capacity = capacity;
+        std::memset(m_ctrl, HashControlEmpty, capacity + GroupWidth);
+        m_growthLeft = growthFor(capacity) - m_size;
+        for (size_type i = 0; i < oldCapacity; ++i)
+        {
+            if (oldCtrl[i] >= 0)
+            {
+                const HashSplit hash = this->split(Policy::key(oldSlots[i]));
+                const size_type index = this->findNonFull(hash);
+                this->setCtrl(index, hash.h2);
+                Policy::relocate(m_slots + index, oldSlots + i);
+            }
+        }
+        ::operator delete(oldCtrl);
+    }
+
+    void destroySlots() PCTK_NOEXCEPT
+    {
+        if (!Policy::isTrivial)
+        {
+            for (size_type i = 0; i < m_capacity; ++i)
+            {
+                if (m_ctrl[i] >= 0)
+                {
+                    m_slots[i].~value_type();
+                }
+            }
+        }
+    }
+
+    void destroyAll() PCTK_NOEXCEPT
+    {
+        this->destroySlots();
+        ::operator delete(m_ctrl);
+    }
+
+    signed char *m_ctrl;
+    value_type *m_slots;
+    size_type m_capacity;
+    size_type m_size;
+    size_type m_growthLeft;
+    Hasher m_hash;
+    KeyEqual m_equal;
+};
+
+/* Moves a slot to raw memory and ends the old one: a memcpy when TypeInfo calls the slot relocatable. */
+template<typename Slot, bool Relocatable>
+struct HashSlotRelocator
+{
+    static void relocate(Slot *dest, Slot *source)
+    {
+        std::memcpy(static_cast<void *>(dest), static_cast<const void *>(source), sizeof(Slot));
+    }
+};
+
+template<typename Slot>
+struct HashSlotRelocator<Slot, false>
+{
+    static void relocate(Slot *dest, Slot *source)
+    {
+        new(dest) Slot(std::move(*source));
+        source->~Slot();
+    }
+};
+
+template<typename K, typename V>
+struct HashSlotRelocator<std::pair<const K, V>, false>
+{
+    static void relocate(std::pair<const K, V> *dest, std::pair<const K, V> *source)
+    {
+        // the old key dies right after this, so it may be moved from despite being const
+        new(dest) std::pair<const K, V>(std::move(const_cast<K &>(source->first)), std::move(source->second));
+        source->~pair();
+    }
+};
+} // namespace detail
+
+/* Default hash of HashMap and HashSet: std::hash, except for strings, which hash their bytes so that a const char *
+ * or a character range can look up a std::string key without building one. */
+template<typename T>
+struct Hash : public std::hash<T> {};
+
+template<>
+struct Hash<std::string>
+{
+    typedef void is_transparent;
+
+    std::size_t operator()(const std::string &value) const { return detail::hashBytes(value.data(), value.size()); }
+    std::size_t operator()(const char *value) const { return detail::hashBytes(value, std::strlen(value)); }
+};
+
+/* Default key comparison: operator== between any two types, which lets heterogeneous lookups through. */
+struct EqualTo
+{
+    typedef void is_transparent;
+
+    template<typename A, typename B>
+    bool operator()(const A &lhs, const B &rhs) const { return lhs == rhs; }
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKHASHTABLE_H
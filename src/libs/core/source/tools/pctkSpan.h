@@ -0,0 +1,100 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#ifndef _PCTKSPAN_H
+#define _PCTKSPAN_H
+
+#include <pctkGlobal.h>
+
+#include <cstddef>
+#include <type_traits>
+
+PCTK_BEGIN_NAMESPACE
+
+/* A non owning view of contiguous elements, the part of C++20 std::span the I/O classes hand out. Unlike
+ * std::span, first(), last() and subspan() clamp their arguments to the view instead of being undefined past it. */
+template<typename T>
+class Span
+{
+public:
+    typedef T element_type;
+    typedef typename std::remove_cv<T>::type value_type;
+    typedef std::size_t size_type;
+    typedef T *pointer;
+    typedef T &reference;
+    typedef T *iterator;
+
+    static const size_type npos = ~size_type(0);
+
+    PCTK_CONSTEXPR Span() PCTK_NOEXCEPT : m_data(PCTK_NULLPTR), m_size(0) {}
+    PCTK_CONSTEXPR Span(T *data, size_type size) PCTK_NOEXCEPT : m_data(data), m_size(size) {}
+    PCTK_CONSTEXPR Span(T *first, T *last) PCTK_NOEXCEPT : m_data(first), m_size(size_type(last - first)) {}
+
+    template<std::size_t N>
+    PCTK_CONSTEXPR Span(T (&array)[N]) PCTK_NOEXCEPT : m_data(array), m_size(N) {}
+
+    /* Span<char> converts to Span<const char>, not the other way around */
+    template<typename U, typename = typename std::enable_if<std::is_convertible<U (*)[], T (*)[]>::value>::type>
+    PCTK_CONSTEXPR Span(const Span<U> &other) PCTK_NOEXCEPT : m_data(other.data()), m_size(other.size()) {}
+
+    PCTK_CONSTEXPR pointer data() const PCTK_NOEXCEPT { return m_data; }
+    PCTK_CONSTEXPR size_type size() const PCTK_NOEXCEPT { return m_size; }
+    PCTK_CONSTEXPR size_type size_bytes() const PCTK_NOEXCEPT { return m_size * sizeof(T); }
+    PCTK_CONSTEXPR bool empty() const PCTK_NOEXCEPT { return 0 == m_size; }
+
+    PCTK_CONSTEXPR iterator begin() const PCTK_NOEXCEPT { return m_data; }
+    PCTK_CONSTEXPR iterator end() const PCTK_NOEXCEPT { return m_data + m_size; }
+
+    PCTK_CONSTEXPR reference operator[](size_type index) const { return m_data[index]; }
+    PCTK_CONSTEXPR reference front() const { return m_data[0]; }
+    PCTK_CONSTEXPR reference back() const { return m_data[m_size - 1]; }
+
+    PCTK_CONSTEXPR Span first(size_type count) const PCTK_NOEXCEPT
+    {
+        return Span(m_data, count < m_size ? count : m_size);
+    }
+
+    PCTK_CONSTEXPR Span last(size_type count) const PCTK_NOEXCEPT
+    {
+        return count < m_size ? Span(m_data + (m_size - count), count) : *this;
+    }
+
+    PCTK_CONSTEXPR Span subspan(size_type offset, size_type count = npos) const PCTK_NOEXCEPT
+    {
+        return offset < m_size ? Span(m_data + offset, m_size - offset).first(count) : Span(m_data + m_size, size_type(0));
+    }
+
+private:
+    T *m_data;
+    size_type m_size;
+};
+
+template<typename T>
+const typename Span<T>::size_type Span<T>::npos;
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKSPAN_H
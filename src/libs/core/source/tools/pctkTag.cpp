@@ -22,90 +22,359 @@
 **
 ***********************************************************************************************************************/
 
+
 #include <pctkTag.h>
+#include <pctkAtomic.h>
 
 #include <string>
 #include <cstring>
+#include <cstdlib>
 #include <sstream>
-#include <memory>
-#include <map>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
 
 PCTK_BEGIN_NAMESPACE
 
-class TagStringHolder
+namespace detail
+{
+/* Immutable once published: readers reach an entry only through a release store made after it was filled in. */
+struct TagEntry
+{
+    unsigned int hash;
+    int length;
+    int id;
+    const char *name;
+};
+
+/* Open addressing table of one shard. Readers probe it without any lock, writers hold the shard mutex and replace the
+ * whole table when it gets half full. A replaced table is kept alive because a reader may still be probing it. */
+struct TagTable
+{
+    explicit TagTable(int capacity)
+        : mask(capacity - 1), slots(new AtomicPointer<TagEntry>[capacity]), retired(PCTK_NULLPTR) {}
+
+    const int mask;
+    AtomicPointer<TagEntry> *const slots;
+    TagTable *retired;
+};
+
+static const int sg_tagShardBits = 6;
+static const int sg_tagShardCount = 1 << sg_tagShardBits;
+static const int sg_tagTableInitialCapacity = 16;
+static const int sg_tagPageBits = 10;
+static const int sg_tagPageSize = 1 << sg_tagPageBits;
+static const int sg_tagPageCount = Tag::MaxIdCount / sg_tagPageSize;
+static const size_t sg_tagArenaChunkSize = 16 * 1024;
+
+struct PCTK_ALIGN(PCTK_CACHELINE_SIZE) TagShard
+{
+    TagShard() : count(0), arena(PCTK_NULLPTR), arenaLeft(0) {}
+
+    AtomicPointer<TagTable> table;
+    std::mutex mutex;
+    int count;
+    char *arena;
+    size_t arenaLeft;
+};
+
+/* Entries and names are never freed, so Tag::name() pointers stay valid until the process exits. */
+struct TagRegistry
 {
-public:
-    TagStringHolder() : n(0), str(NULL) {}
+    TagRegistry() : nextId(Tag::ReservedIdCount) {}
+
+    TagShard shards[sg_tagShardCount];
+    AtomicPointer<AtomicPointer<TagEntry> > pages[sg_tagPageCount];
+    AtomicInt nextId;
+};
 
-    TagStringHolder(const char *s, int length) : n(length), str(s)
+static TagRegistry &tagRegistry()
+{
+    static TagRegistry registry;
+    return registry;
+}
+
+/* Loop form of the constexpr detail::tagHash() for strings only known at runtime, both must agree. */
+static unsigned int tagHashString(const char *s, int length)
+{
+    unsigned int h = 0;
+    while (length--)
     {
-        if (!n)
+        h = (h << 4) + *s++;
+        h ^= (h & 0xf0000000) >> 23;
+        h &= 0x0fffffff;
+    }
+    return h;
+}
+
+static TagShard &tagShard(TagRegistry &registry, unsigned int hash)
+{
+    /* the multiplicative mix spreads the 28 bit hash over the top bits that pick the shard */
+    return registry.shards[(hash * 0x9e3779b1u) >> (32 - sg_tagShardBits)];
+}
+
+static TagEntry *tagFind(const TagTable *table, unsigned int hash, const char *str, int length)
+{
+    for (unsigned int i = hash;; ++i)
+    {
+        TagEntry *entry = table->slots[i & table->mask].loadAcquire();
+        if (!entry)
         {
-            length = n = static_cast<int>(strlen(s));
+            return PCTK_NULLPTR;
         }
-        h = 0;
-        while (length--)
+        if (entry->hash == hash && entry->length == length && 0 == memcmp(entry->name, str, length))
         {
-            h = (h << 4) + *s++;
-            h ^= (h & 0xf0000000) >> 23;
-            h &= 0x0fffffff;
+            return entry;
         }
     }
+}
 
-    int n;
-    const char *str;
-    unsigned int h;
-};
+static void tagPlace(TagTable *table, TagEntry *entry)
+{
+    unsigned int i = entry->hash;
+    while (table->slots[i & table->mask].load())
+    {
+        ++i;
+    }
+    table->slots[i & table->mask].storeRelease(entry);
+}
 
-struct TagStringHolderCompare
+/* Called with the shard mutex held. Entry and name share one arena block so a lookup touches adjacent memory. */
+static TagEntry *tagNewEntry(TagShard &shard, unsigned int hash, const char *str, int length, int id)
 {
-    bool operator()(const TagStringHolder &lhs, const TagStringHolder &rhs) const
+    const size_t align = sizeof(void *);
+    const size_t size = (sizeof(TagEntry) + length + 1 + align - 1) & ~(align - 1);
+    char *block;
+    if (size > sg_tagArenaChunkSize / 4)
     {
-        return std::string(lhs.str) > std::string(rhs.str);
+        block = static_cast<char *>(std::malloc(size));
     }
-};
+    else
+    {
+        if (size > shard.arenaLeft)
+        {
+            shard.arena = static_cast<char *>(std::malloc(sg_tagArenaChunkSize));
+            shard.arenaLeft = shard.arena ? sg_tagArenaChunkSize : 0;
+        }
+        block = shard.arena;
+        if (block)
+        {
+            shard.arena += size;
+            shard.arenaLeft -= size;
+        }
+    }
+    if (!block)
+    {
+        throw std::bad_alloc();
+    }
+    char *name = block + sizeof(TagEntry);
+    memcpy(name, str, length);
+    name[length] = '\0';
+    TagEntry *entry = new(block) TagEntry;
+    entry->hash = hash;
+    entry->length = length;
+    entry->id = id;
+    entry->name = name;
+    return entry;
+}
 
-static bool operator==(const TagStringHolder &sh1, const TagStringHolder &sh2)
+static TagEntry *tagEntryForId(int id)
 {
-    return sh1.h == sh2.h && sh1.str && sh2.str && strcmp(sh1.str, sh2.str) == 0;
+    if (id <= 0 || id >= Tag::MaxIdCount)
+    {
+        return PCTK_NULLPTR;
+    }
+    AtomicPointer<TagEntry> *page = tagRegistry().pages[id >> sg_tagPageBits].loadAcquire();
+    return page ? page[id & (sg_tagPageSize - 1)].loadAcquire() : PCTK_NULLPTR;
 }
 
-struct TagCache : public std::map<TagStringHolder, int, TagStringHolderCompare>
+/* Shards insert concurrently, so both the page and the id slot are claimed with a compare-and-swap. */
+static bool tagClaimId(TagRegistry &registry, TagEntry *entry)
 {
-    // dont allow static leaks
-    ~TagCache()
+    AtomicPointer<AtomicPointer<TagEntry> > &pageSlot = registry.pages[entry->id >> sg_tagPageBits];
+    AtomicPointer<TagEntry> *page = pageSlot.loadAcquire();
+    if (!page)
     {
-        for (TagCache::iterator iter = this->begin(); iter != this->end(); ++iter)
+        AtomicPointer<TagEntry> *fresh = new AtomicPointer<TagEntry>[sg_tagPageSize];
+        if (pageSlot.testAndSetOrdered(PCTK_NULLPTR, fresh))
+        {
+            page = fresh;
+        }
+        else
         {
-            delete[](const_cast<char *>(iter->first.str));
+            delete[] fresh;
+            page = pageSlot.loadAcquire();
         }
     }
-};
+    return page[entry->id & (sg_tagPageSize - 1)].testAndSetOrdered(PCTK_NULLPTR, entry);
+}
+
+static int tagCheckedId(const TagEntry *entry, int requestedId)
+{
+    if (requestedId && entry->id != requestedId)
+    {
+        throw std::invalid_argument(std::string("Tag name already registered with another id: ") + entry->name);
+    }
+    return entry->id;
+}
+
+/* Called with the shard mutex held. */
+static int tagInternLocked(TagRegistry &registry, TagShard &shard, unsigned int hash, const char *str, int length,
+                           int requestedId)
+{
+    TagTable *table = shard.table.load();
+    TagEntry *entry = table ? tagFind(table, hash, str, length) : PCTK_NULLPTR;
+    if (entry)
+    {
+        return tagCheckedId(entry, requestedId);
+    }
+    int id = requestedId;
+    if (!id)
+    {
+        id = registry.nextId.fetchAndAddRelaxed(1);
+        if (id >= Tag::MaxIdCount)
+        {
+            throw std::overflow_error("Tag id space exhausted");
+        }
+    }
+    entry = tagNewEntry(shard, hash, str, length, id);
+    if (!tagClaimId(registry, entry))
+    {
+        throw std::invalid_argument(std::string("Tag id already registered with another name: ") + entry->name);
+    }
+    if (!table || 2 * (shard.count + 1) > table->mask + 1)
+    {
+        TagTable *grown = new TagTable(table ? 2 * (table->mask + 1) : sg_tagTableInitialCapacity);
+        if (table)
+        {
+            for (int i = 0; i <= table->mask; ++i)
+            {
+                if (TagEntry *old = table->slots[i].load())
+                {
+                    tagPlace(grown, old);
+                }
+            }
+        }
+        grown->retired = table;
+        shard.table.storeRelease(grown);
+        table = grown;
+    }
+    tagPlace(table, entry);
+    ++shard.count;
+    return id;
+}
 
-typedef std::map<int, TagStringHolder> TagMap;;
+/* Interns str and returns its id. A requestedId of 0 hands out the next dynamic id. */
+static int tagIntern(unsigned int hash, const char *str, int length, int requestedId)
+{
+    TagRegistry &registry = tagRegistry();
+    TagShard &shard = tagShard(registry, hash);
+    const TagTable *table = shard.table.loadAcquire();
+    const TagEntry *entry = table ? tagFind(table, hash, str, length) : PCTK_NULLPTR;
+    if (entry)
+    {
+        return tagCheckedId(entry, requestedId);
+    }
+    std::lock_guard<std::mutex> locker(shard.mutex);
+    return tagInternLocked(registry, shard, hash, str, length, requestedId);
+}
 
-static int sg_firstUnusedId = 0;
-static TagMap sg_stringFromId;
-static TagCache sg_idFromString;
+/* Registers a whole table taking every shard lock once: entries are bucketed by shard first. An id or name that is
+ * already bound to something else, in the runtime table or elsewhere in the same array, throws before anything is
+ * inserted. Distinct names that merely share a hash are fine, probing compares the names. */
+static void tagRegisterMany(const TagRegistration *tags, int count)
+{
+    if (count < 0)
+    {
+        throw std::invalid_argument("Tag::registerId() negative count");
+    }
+    TagRegistry &registry = tagRegistry();
+    std::vector<int> starts(sg_tagShardCount + 1, 0);
+    std::vector<int> order(count);
+    for (int i = 0; i < count; ++i)
+    {
+        if (tags[i].id <= 0 || tags[i].id >= Tag::ReservedIdCount)
+        {
+            throw std::out_of_range("Tag::registerId() id outside the reserved range");
+        }
+        if (PCTK_NULLPTR == tags[i].name || tags[i].length <= 0)
+        {
+            throw std::invalid_argument("Tag::registerId() empty name");
+        }
+        ++starts[&tagShard(registry, tags[i].hash) - registry.shards + 1];
+    }
+    for (int s = 0; s < sg_tagShardCount; ++s)
+    {
+        starts[s + 1] += starts[s];
+    }
+    std::vector<int> next(starts.begin(), starts.end() - 1);
+    for (int i = 0; i < count; ++i)
+    {
+        order[next[&tagShard(registry, tags[i].hash) - registry.shards]++] = i;
+    }
+
+    /* the affected shards stay locked from the checks to the last insert, taken in index order so that concurrent
+     * registrations cannot deadlock */
+    std::vector<std::unique_lock<std::mutex> > locks;
+    for (int s = 0; s < sg_tagShardCount; ++s)
+    {
+        if (starts[s] != starts[s + 1])
+        {
+            locks.push_back(std::unique_lock<std::mutex>(registry.shards[s].mutex));
+        }
+    }
+    std::unordered_map<int, int> batchIds;
+    std::unordered_map<std::string, int> batchNames;
+    for (int i = 0; i < count; ++i)
+    {
+        const TagRegistration &tag = tags[i];
+        const std::string name(tag.name, tag.length);
+        const TagTable *table = tagShard(registry, tag.hash).table.load();
+        const TagEntry *entry = table ? tagFind(table, tag.hash, tag.name, tag.length) : PCTK_NULLPTR;
+        if (entry)
+        {
+            tagCheckedId(entry, tag.id);
+        }
+        else if (tagEntryForId(tag.id))
+        {
+            throw std::invalid_argument("Tag id already registered with another name: " + name);
+        }
+        const std::pair<std::unordered_map<std::string, int>::iterator, bool> named = batchNames.insert(
+            std::make_pair(name, tag.id));
+        if (!named.second && named.first->second != tag.id)
+        {
+            throw std::invalid_argument("Tag name already registered with another id: " + name);
+        }
+        const std::pair<std::unordered_map<int, int>::iterator, bool> identified = batchIds.insert(
+            std::make_pair(tag.id, i));
+        const TagRegistration &first = tags[identified.first->second];
+        if (!identified.second && (first.length != tag.length || 0 != memcmp(first.name, tag.name, tag.length)))
+        {
+            throw std::invalid_argument("Tag id already registered with another name: " + name);
+        }
+    }
+    for (int s = 0; s < sg_tagShardCount; ++s)
+    {
+        TagShard &shard = registry.shards[s];
+        for (int k = starts[s]; k < starts[s + 1]; ++k)
+        {
+            const TagRegistration &tag = tags[order[k]];
+            tagInternLocked(registry, shard, tag.hash, tag.name, tag.length, tag.id);
+        }
+    }
+}
+} // namespace detail
 
 static int theId(const char *str, int n = 0)
 {
     if (PCTK_NULLPTR == str || !*str)
     {
-        //        qCritical() << "theId():parameter str error!";
         return 0;
     }
-    TagStringHolder sh(str, n);
-    TagCache::iterator iter = sg_idFromString.find(sh);
-    int id = 0;
-    if (sg_idFromString.end() == iter)
-    {
-        id = sg_firstUnusedId++;
-        sh.str = strdup(sh.str);
-        sg_idFromString[sh] = id;
-        sg_stringFromId[id] = sh;
-    }
-    return id;
+    const int length = n ? n : static_cast<int>(strlen(str));
+    return detail::tagIntern(detail::tagHashString(str, length), str, length, 0);
 }
 
 Tag::Tag()
@@ -125,22 +394,24 @@ Tag::Tag(const char *name)
 
 Tag::Tag(const std::string &name)
 {
-    m_id = theId(name.data(), name.length());
+    m_id = theId(name.data(), static_cast<int>(name.length()));
 }
 
 const char *Tag::name() const
 {
-    return sg_stringFromId.find(m_id)->second.str;
+    const detail::TagEntry *entry = detail::tagEntryForId(m_id);
+    return entry ? entry->name : "";
 }
 
 std::string Tag::toString() const
 {
-    return std::string(sg_stringFromId.find(m_id)->second.str);
+    const detail::TagEntry *entry = detail::tagEntryForId(m_id);
+    return entry ? std::string(entry->name, entry->length) : std::string();
 }
 
 Tag Tag::fromString(const std::string &string)
 {
-    return Tag(theId(string.data(), string.length()));
+    return Tag(theId(string.data(), static_cast<int>(string.length())));
 }
 
 Tag Tag::withSuffix(int suffix) const
@@ -173,17 +444,34 @@ Tag Tag::withPrefix(const char *prefix) const
 
 void Tag::registerId(int id, const char *name)
 {
-    TagStringHolder sh(name, 0);
-    sg_idFromString[sh] = id;
-    sg_stringFromId[id] = sh;
+    if (id <= 0 || id >= ReservedIdCount)
+    {
+        throw std::out_of_range("Tag::registerId() id outside the reserved range");
+    }
+    if (PCTK_NULLPTR == name || !*name)
+    {
+        throw std::invalid_argument("Tag::registerId() empty name");
+    }
+    const int length = static_cast<int>(strlen(name));
+    detail::tagIntern(detail::tagHashString(name, length), name, length, id);
+}
+
+void Tag::registerId(const TagRegistration *tags, int count)
+{
+    detail::tagRegisterMany(tags, count);
+}
+
+Tag Tag::fromHashedName(const char *name, int length, unsigned int hash)
+{
+    return Tag(length > 0 ? detail::tagIntern(hash, name, length, 0) : 0);
 }
 
 bool Tag::operator==(const char *name) const
 {
-    const char *string = sg_stringFromId.find(m_id)->second.str;
-    if (string && name)
+    const detail::TagEntry *entry = detail::tagEntryForId(m_id);
+    if (entry && name)
     {
-        return strcmp(string, name) == 0;
+        return strcmp(entry->name, name) == 0;
     }
     else
     {
@@ -193,8 +481,8 @@ bool Tag::operator==(const char *name) const
 
 const char *nameForId(int id)
 {
-    TagMap::iterator iter = sg_stringFromId.find(id);
-    return sg_stringFromId.end() == iter ? PCTK_NULLPTR : iter->second.str;
+    const detail::TagEntry *entry = detail::tagEntryForId(id);
+    return entry ? entry->name : PCTK_NULLPTR;
 }
 
 std::string Tag::suffixAfter(Tag baseId) const
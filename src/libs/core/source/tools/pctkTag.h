@@ -28,12 +28,50 @@
 #include <pctkGlobal.h>
 
 #include <string>
+#include <cstddef>
+#include <type_traits>
 
 PCTK_BEGIN_NAMESPACE
 
+namespace detail
+{
+/* The interning hash, usable in constant expressions. Tag literals and TagRegistration compute it at compile time. */
+PCTK_CONSTEXPR inline unsigned int tagHashStep(unsigned int h)
+{
+    return (h ^ ((h & 0xf0000000) >> 23)) & 0x0fffffff;
+}
+
+PCTK_CONSTEXPR inline unsigned int tagHash(const char *s, int length, unsigned int h = 0)
+{
+    return length ? tagHash(s + 1, length - 1, tagHashStep((h << 4) + (unsigned int) *s)) : h;
+}
+} // namespace detail
+
+/* One entry of a bulk Tag::registerId() table, for example
+ *     static PCTK_CONSTEXPR TagRegistration tags[] = {{1, "core.ready"}, {2, "core.done"}}; */
+struct TagRegistration
+{
+    template<std::size_t N>
+    PCTK_CONSTEXPR TagRegistration(int tagId, const char (&tagName)[N])
+        : id(tagId), name(tagName), length(int(N) - 1), hash(detail::tagHash(tagName, int(N) - 1)) {}
+
+    int id;
+    const char *name;
+    int length;
+    unsigned int hash;
+};
+
+/* Tags intern their names in a process wide table: constructing a tag from a name costs one hash and a short probe,
+ * name() is an array index. Names live until the process exits, so the returned pointers never dangle. */
 class PCTK_CORE_API Tag
 {
 public:
+    enum
+    {
+        ReservedIdCount = 0x10000, // ids [1, ReservedIdCount) belong to registerId(), interned names get the rest
+        MaxIdCount = 0x1000000
+    };
+
     Tag();
     Tag(int id);
     Tag(const char *name);
@@ -83,6 +121,15 @@ public:
     }
     static Tag fromString(const std::string &string);
     static void registerId(int id, const char *name);
+    static void registerId(const TagRegistration *tags, int count);
+    template<std::size_t N>
+    static void registerId(const TagRegistration (&tags)[N])
+    {
+        registerId(tags, int(N));
+    }
+
+    /* Interns a name whose hash is already known, hash must equal detail::tagHash(name, length). Used by PCTK_TAG. */
+    static Tag fromHashedName(const char *name, int length, unsigned int hash);
 
 private:
     int m_id;
@@ -90,4 +137,14 @@ private:
 
 PCTK_END_NAMESPACE
 
+/* Tag literal: the name is hashed at compile time and interned once, on first use, into a function-local static.
+ * Every later evaluation of the same PCTK_TAG expression only reads that static. */
+#define PCTK_TAG(name) \
+    ([]() -> const PCTK_PREPEND_NAMESPACE(Tag) & { \
+        static const PCTK_PREPEND_NAMESPACE(Tag) tag = PCTK_PREPEND_NAMESPACE(Tag)::fromHashedName( \
+            name, int(sizeof(name)) - 1, \
+            std::integral_constant<unsigned int, PCTK_PREPEND_NAMESPACE(detail)::tagHash(name, int(sizeof(name)) - 1)>::value); \
+        return tag; \
+    }())
+
 #endif //_PCTKTAG_H
@@ -160,12 +160,7 @@ public: \
     }; \
 }
 
-PCTK_DECL_MOVABLE_CONTAINER(QList);
-PCTK_DECL_MOVABLE_CONTAINER(QVector);
-PCTK_DECL_MOVABLE_CONTAINER(QQueue);
-PCTK_DECL_MOVABLE_CONTAINER(QStack);
-PCTK_DECL_MOVABLE_CONTAINER(QLinkedList);
-PCTK_DECL_MOVABLE_CONTAINER(QSet);
+PCTK_DECL_MOVABLE_CONTAINER(Vector);
 
 #undef PCTK_DECL_MOVABLE_CONTAINER
 
@@ -251,8 +246,8 @@ PCTK_DECL_TYPEINFO(int, PCTK_TYPEINFO_PRIMITIVE);
 PCTK_DECL_TYPEINFO(uint, PCTK_TYPEINFO_PRIMITIVE);
 PCTK_DECL_TYPEINFO(long, PCTK_TYPEINFO_PRIMITIVE);
 PCTK_DECL_TYPEINFO(unsigned long, PCTK_TYPEINFO_PRIMITIVE);
-PCTK_DECL_TYPEINFO(pctk_int64_t, PCTK_TYPEINFO_PRIMITIVE);
-PCTK_DECL_TYPEINFO(pctk_uint64_t, PCTK_TYPEINFO_PRIMITIVE);
+PCTK_DECL_TYPEINFO(long long, PCTK_TYPEINFO_PRIMITIVE);
+PCTK_DECL_TYPEINFO(unsigned long long, PCTK_TYPEINFO_PRIMITIVE);
 PCTK_DECL_TYPEINFO(float, PCTK_TYPEINFO_PRIMITIVE);
 PCTK_DECL_TYPEINFO(double, PCTK_TYPEINFO_PRIMITIVE);
 #ifndef PCTK_OS_DARWIN
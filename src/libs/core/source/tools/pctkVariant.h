@@ -0,0 +1,429 @@
+/***********************************************************************************************************************
+**
+** Library: UTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKVARIANT_H
+#define _PCTKVARIANT_H
+
+#include <pctkGlobal.h>
+#include <pctkTypeInfo.h>
+#include <pctkAny.h>
+
+#include <new>
+#include <cstring>
+#include <cstddef>
+#include <utility>
+#include <exception>
+#include <type_traits>
+
+PCTK_BEGIN_NAMESPACE
+
+class BadVariantAccess : public std::exception
+{
+public:
+    virtual const char *what() const throw()
+    {
+        return "Variant: bad variant access";
+    }
+};
+
+namespace detail
+{
+/* Index of T in Ts, or -1 when T is not one of them. */
+template<typename T, typename... Ts>
+struct VariantIndexOf
+{
+    enum { value = -1 };
+};
+
+template<typename T, typename Head, typename... Tail>
+struct VariantIndexOf<T, Head, Tail...>
+{
+    enum
+    {
+        value = std::is_same<T, Head>::value ? 0
+                                             : (VariantIndexOf<T, Tail...>::value < 0
+                                                ? -1 : 1 + VariantIndexOf<T, Tail...>::value)
+    };
+};
+
+template<typename... Ts>
+struct VariantTraits
+{
+    enum
+    {
+        size = 0,
+        align = 1,
+        isComplex = false,
+        isRelocatable = true,
+        isNothrowMovable = true
+    };
+};
+
+template<typename Head, typename... Tail>
+struct VariantTraits<Head, Tail...>
+{
+    enum
+    {
+        size = sizeof(Head) > std::size_t(VariantTraits<Tail...>::size)
+               ? sizeof(Head) : std::size_t(VariantTraits<Tail...>::size),
+        align = PCTK_ALIGNOF(Head) > std::size_t(VariantTraits<Tail...>::align)
+                ? PCTK_ALIGNOF(Head) : std::size_t(VariantTraits<Tail...>::align),
+        isComplex = TypeInfoQuery<Head>::isComplex || VariantTraits<Tail...>::isComplex,
+        isRelocatable = TypeInfoQuery<Head>::isRelocatable && VariantTraits<Tail...>::isRelocatable,
+        isNothrowMovable = std::is_nothrow_move_constructible<Head>::value && VariantTraits<Tail...>::isNothrowMovable
+    };
+};
+
+template<typename Head, typename... Tail>
+struct VariantFront
+{
+    typedef Head Type;
+};
+
+struct VariantAnyMaker
+{
+    template<typename T>
+    Any operator()(const T &value) const { return Any(value); }
+};
+} // namespace detail
+
+/* A tagged union over a closed list of types. The value lives in place, copies and moves of variants whose types are
+ * all primitive are a memcpy, and visit() dispatches through a static table of one function per alternative.
+ * A variant only becomes valueless when constructing a new value throws. */
+template<typename... Ts>
+class Variant
+{
+    typedef detail::VariantTraits<Ts...> Traits;
+    typedef typename detail::VariantFront<Ts...>::Type First;
+
+    template<typename T>
+    struct IndexOf : detail::VariantIndexOf<typename std::decay<T>::type, Ts...> {};
+
+public:
+    enum
+    {
+        TypeCount = sizeof...(Ts),
+        ValuelessIndex = 0xff
+    };
+    static_assert(sizeof...(Ts) > 0 && sizeof...(Ts) < ValuelessIndex, "Variant needs 1 to 254 types");
+
+    Variant() : m_index(0) { new(&m_storage) First(); }
+    Variant(const Variant &other) : m_index(ValuelessIndex) { this->copyFrom(other); }
+    Variant(Variant &&other) PCTK_NOEXCEPT_EXPR(bool(Traits::isNothrowMovable)) : m_index(ValuelessIndex) { this->moveFrom(other); }
+
+    /* Holds a copy of value, whose type must be exactly one of Ts after decay. */
+    template<typename T, typename = typename std::enable_if<IndexOf<T>::value >= 0>::type>
+    Variant(T &&value) : m_index(ValuelessIndex)
+    {
+        new(&m_storage) typename std::decay<T>::type(std::forward<T>(value));
+        m_index = (unsigned char) IndexOf<T>::value;
+    }
+
+    template<typename T, typename... Args>
+    explicit Variant(InPlaceT (&)(detail::InPlaceTypeTag<T>), Args &&...args) : m_index(ValuelessIndex)
+    {
+        this->construct<T>(std::forward<Args>(args)...);
+    }
+
+    ~Variant() { this->destroy(); }
+
+    Variant &operator=(const Variant &other)
+    {
+        if (this != &other)
+        {
+            this->destroy();
+            this->copyFrom(other);
+        }
+        return *this;
+    }
+
+    Variant &operator=(Variant &&other) PCTK_NOEXCEPT_EXPR(bool(Traits::isNothrowMovable))
+    {
+        if (this != &other)
+        {
+            this->destroy();
+            this->moveFrom(other);
+        }
+        return *this;
+    }
+
+    template<typename T, typename = typename std::enable_if<IndexOf<T>::value >= 0>::type>
+    Variant &operator=(T &&value)
+    {
+        typedef typename std::decay<T>::type Type;
+        if (m_index == IndexOf<T>::value)
+        {
+            *reinterpret_cast<Type *>(&m_storage) = std::forward<T>(value);
+        }
+        else
+        {
+            this->emplace<Type>(std::forward<T>(value));
+        }
+        return *this;
+    }
+
+    /* Destroys the current value and constructs a T from args in its place. */
+    template<typename T, typename... Args>
+    T &emplace(Args &&...args)
+    {
+        this->destroy();
+        this->construct<T>(std::forward<Args>(args)...);
+        return *reinterpret_cast<T *>(&m_storage);
+    }
+
+    std::size_t index() const PCTK_NOEXCEPT { return m_index; }
+    bool isValueless() const PCTK_NOEXCEPT { return m_index == ValuelessIndex; }
+
+    template<typename T>
+    bool holds() const PCTK_NOEXCEPT
+    {
+        static_assert(IndexOf<T>::value >= 0, "T is not one of the Variant types");
+        return m_index == IndexOf<T>::value;
+    }
+
+    template<typename T>
+    T *getIf() PCTK_NOEXCEPT
+    {
+        return this->holds<T>() ? reinterpret_cast<T *>(&m_storage) : PCTK_NULLPTR;
+    }
+
+    template<typename T>
+    const T *getIf() const PCTK_NOEXCEPT
+    {
+        return this->holds<T>() ? reinterpret_cast<const T *>(&m_storage) : PCTK_NULLPTR;
+    }
+
+    template<typename T>
+    T &get()
+    {
+        if (!this->holds<T>())
+        {
+            throw BadVariantAccess();
+        }
+        return *reinterpret_cast<T *>(&m_storage);
+    }
+
+    template<typename T>
+    const T &get() const
+    {
+        if (!this->holds<T>())
+        {
+            throw BadVariantAccess();
+        }
+        return *reinterpret_cast<const T *>(&m_storage);
+    }
+
+    /* Calls visitor with the current value. Every overload must return the same type as the one for the first
+     * alternative. Throws BadVariantAccess when the variant is valueless. */
+    template<typename Visitor>
+    auto visit(Visitor &&visitor) -> decltype(visitor(std::declval<First &>()))
+    {
+        typedef decltype(visitor(std::declval<First &>())) Result;
+        typedef Result (*Function)(Visitor &, void *);
+        static PCTK_CONSTEXPR const Function table[] = {&Variant::visitAt<Result, Visitor, Ts>...};
+        if (PCTK_UNLIKELY(this->isValueless()))
+        {
+            throw BadVariantAccess();
+        }
+        return table[m_index](visitor, &m_storage);
+    }
+
+    template<typename Visitor>
+    auto visit(Visitor &&visitor) const -> decltype(visitor(std::declval<const First &>()))
+    {
+        typedef decltype(visitor(std::declval<const First &>())) Result;
+        typedef Result (*Function)(Visitor &, const void *);
+        static PCTK_CONSTEXPR const Function table[] = {&Variant::visitConstAt<Result, Visitor, Ts>...};
+        if (PCTK_UNLIKELY(this->isValueless()))
+        {
+            throw BadVariantAccess();
+        }
+        return table[m_index](visitor, &m_storage);
+    }
+
+    /* Variants whose types are all relocatable swap their bytes, anything else swaps through a temporary. */
+    void swap(Variant &other) PCTK_NOEXCEPT_EXPR(bool(Traits::isNothrowMovable))
+    {
+        if (this == &other)
+        {
+            return;
+        }
+        if (Traits::isRelocatable)
+        {
+            unsigned char bytes[sizeof(Variant)];
+            std::memcpy(bytes, static_cast<void *>(this), sizeof(Variant));
+            std::memcpy(static_cast<void *>(this), static_cast<void *>(&other), sizeof(Variant));
+            std::memcpy(static_cast<void *>(&other), bytes, sizeof(Variant));
+            return;
+        }
+        Variant tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    bool operator==(const Variant &other) const
+    {
+        typedef bool (*Function)(const void *, const void *);
+        static PCTK_CONSTEXPR const Function table[] = {&Variant::equalAt<Ts>...};
+        if (m_index != other.m_index)
+        {
+            return false;
+        }
+        return this->isValueless() || table[m_index](&m_storage, &other.m_storage);
+    }
+
+    bool operator!=(const Variant &other) const
+    {
+        return !(*this == other);
+    }
+
+    /* Returns the current value in an Any, or an empty Any when the variant is valueless. */
+    Any toAny() const
+    {
+        return this->isValueless() ? Any() : this->visit(detail::VariantAnyMaker());
+    }
+
+    /* Takes a copy of the value in any when its type is one of Ts. Otherwise returns false and changes nothing. */
+    bool fromAny(const Any &any)
+    {
+        typedef bool (*Function)(Variant &, const Any &);
+        static PCTK_CONSTEXPR const Function table[] = {&Variant::fromAnyAt<Ts>...};
+        for (std::size_t i = 0; i < TypeCount; ++i)
+        {
+            if (table[i](*this, any))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    template<typename T, typename... Args>
+    void construct(Args &&...args)
+    {
+        static_assert(IndexOf<T>::value >= 0, "T is not one of the Variant types");
+        new(&m_storage) T(std::forward<Args>(args)...);
+        m_index = (unsigned char) IndexOf<T>::value;
+    }
+
+    void destroy() PCTK_NOEXCEPT
+    {
+        typedef void (*Function)(void *);
+        static PCTK_CONSTEXPR const Function table[] = {&Variant::destroyAt<Ts>...};
+        if (Traits::isComplex && !this->isValueless())
+        {
+            table[m_index](&m_storage);
+        }
+        m_index = ValuelessIndex;
+    }
+
+    void copyFrom(const Variant &other)
+    {
+        typedef void (*Function)(void *, const void *);
+        static PCTK_CONSTEXPR const Function table[] = {&Variant::copyAt<Ts>...};
+        if (!Traits::isComplex)
+        {
+            std::memcpy(&m_storage, &other.m_storage, sizeof(m_storage));
+        }
+        else if (!other.isValueless())
+        {
+            table[other.m_index](&m_storage, &other.m_storage);
+        }
+        m_index = other.m_index;
+    }
+
+    void moveFrom(Variant &other)
+    {
+        typedef void (*Function)(void *, void *);
+        static PCTK_CONSTEXPR const Function table[] = {&Variant::moveAt<Ts>...};
+        if (!Traits::isComplex)
+        {
+            std::memcpy(&m_storage, &other.m_storage, sizeof(m_storage));
+        }
+        else if (!other.isValueless())
+        {
+            table[other.m_index](&m_storage, &other.m_storage);
+        }
+        m_index = other.m_index;
+    }
+
+    template<typename T>
+    static void destroyAt(void *storage) { static_cast<T *>(storage)->~T(); }
+    template<typename T>
+    static void copyAt(void *dest, const void *source) { new(dest) T(*static_cast<const T *>(source)); }
+    template<typename T>
+    static void moveAt(void *dest, void *source) { new(dest) T(std::move(*static_cast<T *>(source))); }
+    template<typename T>
+    static bool equalAt(const void *lhs, const void *rhs)
+    {
+        return *static_cast<const T *>(lhs) == *static_cast<const T *>(rhs);
+    }
+    template<typename Result, typename Visitor, typename T>
+    static Result visitAt(Visitor &visitor, void *storage) { return visitor(*static_cast<T *>(storage)); }
+    template<typename Result, typename Visitor, typename T>
+    static Result visitConstAt(Visitor &visitor, const void *storage)
+    {
+        return visitor(*static_cast<const T *>(storage));
+    }
+    template<typename T>
+    static bool fromAnyAt(Variant &variant, const Any &any)
+    {
+        const T *value = any_cast<T>(&any);
+        if (!value)
+        {
+            return false;
+        }
+        variant.template emplace<T>(*value);
+        return true;
+    }
+
+    typename std::aligned_storage<Traits::size, Traits::align>::type m_storage;
+    unsigned char m_index;
+};
+
+template<typename... Ts>
+inline void swap(Variant<Ts...> &x, Variant<Ts...> &y) PCTK_NOEXCEPT_EXPR(noexcept(x.swap(y)))
+{
+    x.swap(y);
+}
+
+template<typename Visitor, typename... Ts>
+inline auto visit(Visitor &&visitor, Variant<Ts...> &variant)
+    -> decltype(variant.visit(std::forward<Visitor>(visitor)))
+{
+    return variant.visit(std::forward<Visitor>(visitor));
+}
+
+template<typename Visitor, typename... Ts>
+inline auto visit(Visitor &&visitor, const Variant<Ts...> &variant)
+    -> decltype(variant.visit(std::forward<Visitor>(visitor)))
+{
+    return variant.visit(std::forward<Visitor>(visitor));
+}
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKVARIANT_H
@@ -0,0 +1,650 @@
+/***********************************************************************************************************************
+**
+** Library: UTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKVECTOR_H
+#define _PCTKVECTOR_H
+
+#include <pctkGlobal.h>
+#include <pctkTypeInfo.h>
+
+#include <new>
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+
+PCTK_BEGIN_NAMESPACE
+
+/* A contiguous array that asks TypeInfo how its elements may be moved around:
+ *  - primitive elements are never constructed or destroyed one by one, they are copied with memcpy and zeroed with
+ *    memset;
+ *  - relocatable elements grow with realloc and shift with memmove;
+ *  - everything else is move or copy constructed like in std::vector.
+ * Capacity grows by half of the current capacity. Storage comes from malloc, so T may not be over-aligned. */
+template<typename T>
+class Vector
+{
+public:
+    typedef T value_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    enum
+    {
+        isPrimitive = !TypeInfoQuery<T>::isComplex,
+        isRelocatable = TypeInfoQuery<T>::isRelocatable,
+        /* moves never throw unless elements must leave a SmallVector's inline storage one by one */
+        isNothrowMovable = isRelocatable || std::is_nothrow_move_constructible<T>::value
+    };
+
+    Vector() PCTK_NOEXCEPT : m_begin(PCTK_NULLPTR), m_size(0), m_capacity(0) {}
+    explicit Vector(size_type count) : m_begin(PCTK_NULLPTR), m_size(0), m_capacity(0) { this->resize(count); }
+    Vector(size_type count, const T &value) : m_begin(PCTK_NULLPTR), m_size(0), m_capacity(0)
+    {
+        this->resize(count, value);
+    }
+    template<typename InputIt, typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    Vector(InputIt first, InputIt last) : m_begin(PCTK_NULLPTR), m_size(0), m_capacity(0)
+    {
+        this->append(first, last);
+    }
+    Vector(std::initializer_list<T> list) : m_begin(PCTK_NULLPTR), m_size(0), m_capacity(0)
+    {
+        this->append(list.begin(), list.end());
+    }
+    Vector(const Vector &other) : m_begin(PCTK_NULLPTR), m_size(0), m_capacity(0)
+    {
+        this->append(other.begin(), other.end());
+    }
+    Vector(Vector &&other) PCTK_NOEXCEPT_EXPR(isNothrowMovable) : m_begin(PCTK_NULLPTR), m_size(0), m_capacity(0)
+    {
+        this->takeFrom(other);
+    }
+
+    ~Vector()
+    {
+        this->destroyRange(m_begin, m_begin + m_size);
+        this->freeStorage();
+    }
+
+    Vector &operator=(const Vector &other)
+    {
+        if (this != &other)
+        {
+            this->assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    Vector &operator=(Vector &&other) PCTK_NOEXCEPT_EXPR(isNothrowMovable)
+    {
+        if (this != &other)
+        {
+            this->clear();
+            this->takeFrom(other);
+        }
+        return *this;
+    }
+
+    Vector &operator=(std::initializer_list<T> list)
+    {
+        this->assign(list.begin(), list.end());
+        return *this;
+    }
+
+    template<typename InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        this->clear();
+        this->append(first, last);
+    }
+
+    iterator begin() PCTK_NOEXCEPT { return m_begin; }
+    const_iterator begin() const PCTK_NOEXCEPT { return m_begin; }
+    const_iterator cbegin() const PCTK_NOEXCEPT { return m_begin; }
+    iterator end() PCTK_NOEXCEPT { return m_begin + m_size; }
+    const_iterator end() const PCTK_NOEXCEPT { return m_begin + m_size; }
+    const_iterator cend() const PCTK_NOEXCEPT { return m_begin + m_size; }
+    reverse_iterator rbegin() PCTK_NOEXCEPT { return reverse_iterator(this->end()); }
+    const_reverse_iterator rbegin() const PCTK_NOEXCEPT { return const_reverse_iterator(this->end()); }
+    reverse_iterator rend() PCTK_NOEXCEPT { return reverse_iterator(this->begin()); }
+    const_reverse_iterator rend() const PCTK_NOEXCEPT { return const_reverse_iterator(this->begin()); }
+
+    size_type size() const PCTK_NOEXCEPT { return m_size; }
+    size_type capacity() const PCTK_NOEXCEPT { return m_capacity & ~InlineFlag; }
+    bool empty() const PCTK_NOEXCEPT { return 0 == m_size; }
+    size_type max_size() const PCTK_NOEXCEPT { return (~InlineFlag) / sizeof(T); }
+
+    T *data() PCTK_NOEXCEPT { return m_begin; }
+    const T *data() const PCTK_NOEXCEPT { return m_begin; }
+
+    T &operator[](size_type index) { return m_begin[index]; }
+    const T &operator[](size_type index) const { return m_begin[index]; }
+    T &at(size_type index)
+    {
+        if (index >= m_size)
+        {
+            throw std::out_of_range("Vector: index out of range");
+        }
+        return m_begin[index];
+    }
+    const T &at(size_type index) const
+    {
+        if (index >= m_size)
+        {
+            throw std::out_of_range("Vector: index out of range");
+        }
+        return m_begin[index];
+    }
+    T &front() { return m_begin[0]; }
+    const T &front() const { return m_begin[0]; }
+    T &back() { return m_begin[m_size - 1]; }
+    const T &back() const { return m_begin[m_size - 1]; }
+
+    void reserve(size_type count)
+    {
+        if (count > this->capacity())
+        {
+            this->reallocate(count);
+        }
+    }
+
+    /* Gives back unused heap capacity. Inline storage of a SmallVector is never released. */
+    void shrink_to_fit()
+    {
+        if (!this->isInline() && m_size < this->capacity())
+        {
+            this->reallocate(m_size);
+        }
+    }
+
+    void clear() PCTK_NOEXCEPT
+    {
+        this->destroyRange(m_begin, m_begin + m_size);
+        m_size = 0;
+    }
+
+    void resize(size_type count)
+    {
+        if (count > m_size)
+        {
+            this->growFor(count);
+            if (isPrimitive)
+            {
+                std::memset(static_cast<void *>(m_begin + m_size), 0, (count - m_size) * sizeof(T));
+            }
+            else
+            {
+                for (T *it = m_begin + m_size; it != m_begin + count; ++it)
+                {
+                    new(it) T();
+                    ++m_size;
+                }
+            }
+        }
+        else
+        {
+            this->destroyRange(m_begin + count, m_begin + m_size);
+        }
+        m_size = count;
+    }
+
+    void resize(size_type count, const T &value)
+    {
+        if (count > m_size)
+        {
+            const T copy(value);
+            this->growFor(count);
+            for (T *it = m_begin + m_size; it != m_begin + count; ++it)
+            {
+                new(it) T(copy);
+                ++m_size;
+            }
+        }
+        else
+        {
+            this->destroyRange(m_begin + count, m_begin + m_size);
+            m_size = count;
+        }
+    }
+
+    void push_back(const T &value) { this->emplace_back(value); }
+    void push_back(T &&value) { this->emplace_back(std::move(value)); }
+
+    template<typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        if (PCTK_LIKELY(m_size < this->capacity()))
+        {
+            new(m_begin + m_size) T(std::forward<Args>(args)...);
+        }
+        else
+        {
+            // the arguments may refer to elements that growing moves away
+            T value(std::forward<Args>(args)...);
+            this->reallocate(this->grownCapacity(m_size + 1));
+            new(m_begin + m_size) T(std::move(value));
+        }
+        return m_begin[m_size++];
+    }
+
+    void pop_back()
+    {
+        --m_size;
+        this->destroyRange(m_begin + m_size, m_begin + m_size + 1);
+    }
+
+    iterator insert(const_iterator position, const T &value) { return this->emplace(position, value); }
+    iterator insert(const_iterator position, T &&value) { return this->emplace(position, std::move(value)); }
+
+    template<typename... Args>
+    iterator emplace(const_iterator position, Args &&...args)
+    {
+        const size_type index = size_type(position - m_begin);
+        if (index == m_size)
+        {
+            this->emplace_back(std::forward<Args>(args)...);
+            return m_begin + index;
+        }
+        T value(std::forward<Args>(args)...);
+        if (m_size == this->capacity())
+        {
+            this->reallocate(this->grownCapacity(m_size + 1));
+        }
+        T *slot = m_begin + index;
+        if (isRelocatable)
+        {
+            std::memmove(static_cast<void *>(slot + 1), static_cast<const void *>(slot), (m_size - index) * sizeof(T));
+            new(slot) T(std::move(value));
+        }
+        else
+        {
+            T *last = m_begin + m_size;
+            new(last) T(std::move(*(last - 1)));
+            for (T *it = last - 1; it != slot; --it)
+            {
+                *it = std::move(*(it - 1));
+            }
+            *slot = std::move(value);
+        }
+        ++m_size;
+        return slot;
+    }
+
+    iterator erase(const_iterator position) { return this->erase(position, position + 1); }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        T *from = m_begin + (first - m_begin);
+        T *to = m_begin + (last - m_begin);
+        if (from == to)
+        {
+            return from;
+        }
+        T *end = m_begin + m_size;
+        if (isRelocatable)
+        {
+            this->destroyRange(from, to);
+            std::memmove(static_cast<void *>(from), static_cast<const void *>(to), (end - to) * sizeof(T));
+        }
+        else
+        {
+            T *out = from;
+            for (T *it = to; it != end; ++it, ++out)
+            {
+                *out = std::move(*it);
+            }
+            this->destroyRange(out, end);
+        }
+        m_size -= size_type(to - from);
+        return from;
+    }
+
+    template<typename InputIt>
+    void append(InputIt first, InputIt last)
+    {
+        this->appendRange(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    }
+
+    void swap(Vector &other)
+    {
+        if (this->isInline() || other.isInline())
+        {
+            Vector tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+            return;
+        }
+        std::swap(m_begin, other.m_begin);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+    }
+
+    bool operator==(const Vector &other) const
+    {
+        if (m_size != other.m_size)
+        {
+            return false;
+        }
+        for (size_type i = 0; i < m_size; ++i)
+        {
+            if (!(m_begin[i] == other.m_begin[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const Vector &other) const { return !(*this == other); }
+
+protected:
+    static const size_type InlineFlag = size_type(1) << (sizeof(size_type) * 8 - 1);
+
+    /* Used by SmallVector: starts out on a buffer the vector does not own. */
+    Vector(T *inlineBuffer, size_type inlineCapacity) PCTK_NOEXCEPT
+        : m_begin(inlineBuffer), m_size(0), m_capacity(inlineCapacity | InlineFlag) {}
+
+    bool isInline() const PCTK_NOEXCEPT { return 0 != (m_capacity & InlineFlag); }
+
+    /* Steals the heap buffer of other, or moves its elements when they sit in inline storage. */
+    void takeFrom(Vector &other)
+    {
+        if (other.isInline())
+        {
+            this->reserve(other.m_size);
+            this->relocateRange(other.m_begin, other.m_begin + other.m_size, m_begin);
+            m_size = other.m_size;
+            other.m_size = 0;
+            return;
+        }
+        this->freeStorage();
+        m_begin = other.m_begin;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        other.m_begin = PCTK_NULLPTR;
+        other.m_size = 0;
+        other.m_capacity = 0;
+    }
+
+private:
+    static_assert(PCTK_ALIGNOF(T) <= PCTK_ALIGNOF(std::max_align_t), "Vector storage comes from malloc");
+
+    size_type grownCapacity(size_type required) const
+    {
+        const size_type capacity = this->capacity();
+        const size_type grown = capacity + capacity / 2;
+        return grown > required ? grown : (required < 4 ? 4 : required);
+    }
+
+    /* Growth by single elements through resize() stays amortized O(1), like push_back(). */
+    void growFor(size_type required)
+    {
+        if (required > this->capacity())
+        {
+            this->reallocate(this->grownCapacity(required));
+        }
+    }
+
+    /* Moves [first, last) into raw memory at dest and ends the lifetime of the source elements. */
+    static void relocateRange(T *first, T *last, T *dest)
+    {
+        if (isRelocatable)
+        {
+            if (first != last)
+            {
+                std::memcpy(static_cast<void *>(dest), static_cast<const void *>(first), (last - first) * sizeof(T));
+            }
+            return;
+        }
+        T *out = dest;
+        try
+        {
+            for (T *it = first; it != last; ++it, ++out)
+            {
+                new(out) T(std::move_if_noexcept(*it));
+            }
+        }
+        catch (...)
+        {
+            destroyRange(dest, out);
+            throw;
+        }
+        destroyRange(first, last);
+    }
+
+    static void destroyRange(T *first, T *last) PCTK_NOEXCEPT
+    {
+        if (!isPrimitive)
+        {
+            for (T *it = first; it != last; ++it)
+            {
+                it->~T();
+            }
+        }
+    }
+
+    void reallocate(size_type capacity)
+    {
+        if (capacity > this->max_size())
+        {
+            throw std::length_error("Vector: capacity exceeds max_size()");
+        }
+        if (0 == capacity)
+        {
+            this->freeStorage();
+            m_begin = PCTK_NULLPTR;
+            m_capacity = 0;
+            return;
+        }
+        T *storage;
+        if (isRelocatable && !this->isInline())
+        {
+            storage = static_cast<T *>(std::realloc(static_cast<void *>(m_begin), capacity * sizeof(T)));
+            if (!storage)
+            {
+                throw std::bad_alloc();
+            }
+        }
+        else
+        {
+            storage = static_cast<T *>(std::malloc(capacity * sizeof(T)));
+            if (!storage)
+            {
+                throw std::bad_alloc();
+            }
+            try
+            {
+                relocateRange(m_begin, m_begin + m_size, storage);
+            }
+            catch (...)
+            {
+                std::free(storage);
+                throw;
+            }
+            this->freeStorage();
+        }
+        m_begin = storage;
+        m_capacity = capacity;
+    }
+
+    void freeStorage() PCTK_NOEXCEPT
+    {
+        if (!this->isInline())
+        {
+            std::free(static_cast<void *>(m_begin));
+        }
+    }
+
+    template<typename InputIt>
+    void appendRange(InputIt first, InputIt last, std::input_iterator_tag)
+    {
+        for (; first != last; ++first)
+        {
+            this->emplace_back(*first);
+        }
+    }
+
+    template<typename ForwardIt>
+    void appendRange(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+    {
+        const size_type count = size_type(std::distance(first, last));
+        if (m_size + count > this->capacity())
+        {
+            this->reallocate(m_size + count > this->grownCapacity(m_size) ? m_size + count
+                                                                          : this->grownCapacity(m_size));
+        }
+        for (T *out = m_begin + m_size; first != last; ++first, ++out)
+        {
+            new(out) T(*first);
+            ++m_size;
+        }
+    }
+
+    void appendRange(const T *first, const T *last, std::random_access_iterator_tag)
+    {
+        const size_type count = size_type(last - first);
+        if (m_size + count > this->capacity())
+        {
+            const size_type capacity = m_size + count > this->grownCapacity(m_size) ? m_size + count
+                                                                                    : this->grownCapacity(m_size);
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(first);
+            const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(m_begin);
+            if (address >= begin && address < begin + m_size * sizeof(T))
+            {
+                // appending a range of this vector to itself: find the range again after growing, from an offset
+                // taken on addresses so no pointer into the storage realloc() frees is used past it
+                const size_type offset = size_type((address - begin) / sizeof(T));
+                this->reallocate(capacity);
+                first = m_begin + offset;
+                last = first + count;
+            }
+            else
+            {
+                this->reallocate(capacity);
+            }
+        }
+        if (isPrimitive)
+        {
+            if (count)
+            {
+                std::memcpy(static_cast<void *>(m_begin + m_size), static_cast<const void *>(first), count * sizeof(T));
+            }
+            m_size += count;
+            return;
+        }
+        for (T *out = m_begin + m_size; first != last; ++first, ++out)
+        {
+            new(out) T(*first);
+            ++m_size;
+        }
+    }
+
+    void appendRange(T *first, T *last, std::random_access_iterator_tag)
+    {
+        this->appendRange(static_cast<const T *>(first), static_cast<const T *>(last),
+                          std::random_access_iterator_tag());
+    }
+
+    T *m_begin;
+    size_type m_size;
+    size_type m_capacity; // the top bit marks storage that belongs to a SmallVector
+};
+
+template<typename T>
+const typename Vector<T>::size_type Vector<T>::InlineFlag;
+
+template<typename T>
+inline void swap(Vector<T> &x, Vector<T> &y)
+{
+    x.swap(y);
+}
+
+/* A Vector that keeps up to N elements in the object itself and only allocates beyond that. */
+template<typename T, std::size_t N>
+class SmallVector : public Vector<T>
+{
+public:
+    typedef typename Vector<T>::size_type size_type;
+
+    SmallVector() PCTK_NOEXCEPT : Vector<T>(this->inlineBuffer(), N) {}
+    explicit SmallVector(size_type count) : Vector<T>(this->inlineBuffer(), N) { this->resize(count); }
+    SmallVector(size_type count, const T &value) : Vector<T>(this->inlineBuffer(), N) { this->resize(count, value); }
+    template<typename InputIt, typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    SmallVector(InputIt first, InputIt last) : Vector<T>(this->inlineBuffer(), N) { this->append(first, last); }
+    SmallVector(std::initializer_list<T> list) : Vector<T>(this->inlineBuffer(), N)
+    {
+        this->append(list.begin(), list.end());
+    }
+    SmallVector(const SmallVector &other) : Vector<T>(this->inlineBuffer(), N)
+    {
+        this->append(other.begin(), other.end());
+    }
+    SmallVector(const Vector<T> &other) : Vector<T>(this->inlineBuffer(), N)
+    {
+        this->append(other.begin(), other.end());
+    }
+    SmallVector(SmallVector &&other) PCTK_NOEXCEPT_EXPR(Vector<T>::isNothrowMovable) : Vector<T>(this->inlineBuffer(), N) { this->takeFrom(other); }
+    SmallVector(Vector<T> &&other) : Vector<T>(this->inlineBuffer(), N) { this->takeFrom(other); }
+
+    SmallVector &operator=(const SmallVector &other)
+    {
+        Vector<T>::operator=(other);
+        return *this;
+    }
+    SmallVector &operator=(SmallVector &&other) PCTK_NOEXCEPT_EXPR(Vector<T>::isNothrowMovable)
+    {
+        Vector<T>::operator=(std::move(other));
+        return *this;
+    }
+    SmallVector &operator=(std::initializer_list<T> list)
+    {
+        Vector<T>::operator=(list);
+        return *this;
+    }
+
+private:
+    T *inlineBuffer() PCTK_NOEXCEPT { return reinterpret_cast<T *>(&m_inline); }
+
+    typename std::aligned_storage<sizeof(T) * N, PCTK_ALIGNOF(T)>::type m_inline;
+};
+
+PCTK_END_NAMESPACE
+
+#endif //_PCTKVECTOR_H
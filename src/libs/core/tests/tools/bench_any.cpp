@@ -0,0 +1,74 @@
+/***********************************************************************************************************************
+**
+** Library: UTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include "bench_common.h"
+
+#include <pctkAny.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/* Copy, move and cast cost of Any holding an inline int, an inline pointer and a heap allocated vector. */
+int main(int argc, char **argv)
+{
+    const std::size_t iterations = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 4000000;
+    int target = 7;
+    const pctk::Any intAny = 7;
+    const pctk::Any pointerAny = &target;
+    const pctk::Any vectorAny = std::vector<int>(8, 1);
+
+    bench::report("copy", "int", bench::nsPerOp(iterations, [&](std::size_t) {
+        pctk::Any copy(intAny);
+        bench::doNotOptimize(copy);
+    }));
+    bench::report("copy", "int *", bench::nsPerOp(iterations, [&](std::size_t) {
+        pctk::Any copy(pointerAny);
+        bench::doNotOptimize(copy);
+    }));
+    bench::report("copy", "std::vector<int>", bench::nsPerOp(iterations, [&](std::size_t) {
+        pctk::Any copy(vectorAny);
+        bench::doNotOptimize(copy);
+    }));
+    bench::report("move", "int *", bench::nsPerOp(iterations, [&](std::size_t) {
+        pctk::Any from(pointerAny);
+        pctk::Any to(std::move(from));
+        bench::doNotOptimize(to);
+    }));
+    bench::report("construct", "int", bench::nsPerOp(iterations, [&](std::size_t i) {
+        pctk::Any value = int(i);
+        bench::doNotOptimize(value);
+    }));
+    bench::report("cast", "any_cast<int>", bench::nsPerOp(iterations, [&](std::size_t) {
+        bench::doNotOptimize(pctk::any_cast<int>(&intAny));
+    }));
+    bench::report("cast", "any_cast<double> (miss)", bench::nsPerOp(iterations, [&](std::size_t) {
+        bench::doNotOptimize(pctk::any_cast<double>(&intAny));
+    }));
+    bench::report("cast", "any_cast<std::vector<int> >", bench::nsPerOp(iterations, [&](std::size_t) {
+        bench::doNotOptimize(pctk::any_cast<std::vector<int> >(&vectorAny));
+    }));
+    return 0;
+}
@@ -0,0 +1,120 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include "bench_common.h"
+
+#include <pctkAtomic.h>
+
+#include <atomic>
+#include <cstdlib>
+
+namespace
+{
+/* Replica of the former pimpl AtomicInt: heap allocated word, virtual destructor and out of line operations. */
+class LegacyAtomicIntPrivate
+{
+public:
+    std::atomic_int m_value;
+};
+
+class LegacyAtomicInt
+{
+public:
+    PCTK_NO_INLINE explicit LegacyAtomicInt(int val) : dd_ptr(new LegacyAtomicIntPrivate)
+    {
+        dd_ptr->m_value.store(val, std::memory_order_release);
+    }
+    PCTK_NO_INLINE virtual ~LegacyAtomicInt() { delete dd_ptr; }
+
+    PCTK_NO_INLINE int loadAcquire() const { return dd_ptr->m_value.load(std::memory_order_acquire); }
+    PCTK_NO_INLINE int fetchAndAddOrdered(int arg)
+    {
+        return dd_ptr->m_value.fetch_add(arg, std::memory_order_acq_rel);
+    }
+    PCTK_NO_INLINE bool testAndSetOrdered(int expected, int desired)
+    {
+        return dd_ptr->m_value.compare_exchange_strong(expected, desired, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire);
+    }
+
+private:
+    LegacyAtomicIntPrivate *dd_ptr;
+};
+
+template<typename Atomic>
+void benchAtomic(const char *group, std::size_t iterations, std::size_t threads)
+{
+    bench::report(group, "construct+destroy", bench::nsPerOp(iterations, [](std::size_t i) {
+        Atomic atomic((int) i);
+        bench::doNotOptimize(atomic);
+    }));
+
+    Atomic atomic(0);
+    bench::report(group, "loadAcquire", bench::nsPerOp(iterations, [&](std::size_t) {
+        bench::doNotOptimize(atomic.loadAcquire());
+    }));
+    bench::report(group, "fetchAndAddOrdered", bench::nsPerOp(iterations, [&](std::size_t) {
+        atomic.fetchAndAddOrdered(1);
+    }));
+    bench::report(group, "testAndSetOrdered", bench::nsPerOp(iterations, [&](std::size_t i) {
+        atomic.testAndSetOrdered((int) i, (int) i + 1);
+    }));
+
+    Atomic shared(0);
+    bench::report(group, "fetchAndAddOrdered contended",
+                  bench::nsPerOpThreaded(threads, iterations / threads, [&](std::size_t, std::size_t count) {
+                      for (std::size_t i = 0; i < count; ++i)
+                      {
+                          shared.fetchAndAddOrdered(1);
+                      }
+                  }));
+}
+
+struct StdAtomicInt
+{
+    explicit StdAtomicInt(int val) : m_value(val) {}
+    int loadAcquire() const { return m_value.load(std::memory_order_acquire); }
+    int fetchAndAddOrdered(int arg) { return m_value.fetch_add(arg, std::memory_order_acq_rel); }
+    bool testAndSetOrdered(int expected, int desired)
+    {
+        return m_value.compare_exchange_strong(expected, desired, std::memory_order_acq_rel);
+    }
+    std::atomic_int m_value;
+};
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t iterations = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 2000000;
+    const std::size_t threads = std::thread::hardware_concurrency() > 1 ? 4 : 1;
+
+    std::printf("sizeof(LegacyAtomicInt) = %u (+%u heap), sizeof(pctk::AtomicInt) = %u\n",
+                (unsigned) sizeof(LegacyAtomicInt), (unsigned) sizeof(LegacyAtomicIntPrivate),
+                (unsigned) sizeof(pctk::AtomicInt));
+    benchAtomic<LegacyAtomicInt>("legacy pimpl AtomicInt", iterations, threads);
+    benchAtomic<pctk::AtomicInt>("pctk::AtomicInt", iterations, threads);
+    benchAtomic<StdAtomicInt>("std::atomic<int>", iterations, threads);
+    return 0;
+}
@@ -0,0 +1,86 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include "bench_common.h"
+
+#include <pctkAtomic.h>
+#include <pctkCacheLine.h>
+#include <pctkStripedCounter.h>
+
+#include <cstdlib>
+
+/* Every thread bumps its own counter (packed or padded) or one shared counter (atomic or striped). */
+int main(int argc, char **argv)
+{
+    const std::size_t iterations = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 4000000;
+    std::printf("PCTK_CACHELINE_SIZE = %d, runtime line size = %d\n", PCTK_CACHELINE_SIZE,
+                pctk::CacheLine::runtimeSize());
+
+    const std::size_t threadCounts[] = {1, 4, 16, 64};
+    for (std::size_t t = 0; t < PCTK_ELEMENTS_NUM(threadCounts); ++t)
+    {
+        const std::size_t threads = threadCounts[t];
+        const std::size_t perThread = iterations / threads;
+        char group[64];
+        std::snprintf(group, sizeof(group), "%u threads", (unsigned) threads);
+
+        std::vector<pctk::AtomicInt> packed(threads);
+        bench::report(group, "packed AtomicInt per thread",
+                      bench::nsPerOpThreaded(threads, perThread, [&](std::size_t index, std::size_t count) {
+                          for (std::size_t i = 0; i < count; ++i)
+                          {
+                              packed[index].fetchAndAddRelaxed(1);
+                          }
+                      }));
+
+        pctk::PaddedAtomic<int> padded[64];
+        bench::report(group, "PaddedAtomic per thread",
+                      bench::nsPerOpThreaded(threads, perThread, [&](std::size_t index, std::size_t count) {
+                          for (std::size_t i = 0; i < count; ++i)
+                          {
+                              padded[index].fetchAndAddRelaxed(1);
+                          }
+                      }));
+
+        pctk::AtomicInteger<pctk_int64_t> shared;
+        bench::report(group, "shared AtomicInteger<int64>",
+                      bench::nsPerOpThreaded(threads, perThread, [&](std::size_t, std::size_t count) {
+                          for (std::size_t i = 0; i < count; ++i)
+                          {
+                              shared.fetchAndAddRelaxed(1);
+                          }
+                      }));
+
+        pctk::StripedCounter striped;
+        bench::report(group, "shared StripedCounter",
+                      bench::nsPerOpThreaded(threads, perThread, [&](std::size_t, std::size_t count) {
+                          for (std::size_t i = 0; i < count; ++i)
+                          {
+                              striped.add(1);
+                          }
+                      }));
+    }
+    return 0;
+}
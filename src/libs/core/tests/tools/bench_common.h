@@ -0,0 +1,88 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKBENCHCOMMON_H
+#define _PCTKBENCHCOMMON_H
+
+#include <pctkGlobal.h>
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+/* Minimal helpers shared by the bench_*.cpp programs, which only build with PCTK_BUILD_BENCHMARKS. */
+namespace bench
+{
+typedef std::chrono::steady_clock Clock;
+
+template<typename T>
+PCTK_FORCE_INLINE void doNotOptimize(const T &value)
+{
+#if defined(PCTK_CC_GNU)
+    __asm__ __volatile__("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+template<typename Func>
+double nsPerOp(std::size_t iterations, Func func)
+{
+    const Clock::time_point start = Clock::now();
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        func(i);
+    }
+    const Clock::duration elapsed = Clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / double(iterations);
+}
+
+/* Runs func(threadIndex, iterations) on threads workers at once and returns the wall time per operation. */
+template<typename Func>
+double nsPerOpThreaded(std::size_t threads, std::size_t iterations, Func func)
+{
+    std::vector<std::thread> workers;
+    const Clock::time_point start = Clock::now();
+    for (std::size_t t = 0; t < threads; ++t)
+    {
+        workers.push_back(std::thread([=]() { func(t, iterations); }));
+    }
+    for (std::size_t t = 0; t < threads; ++t)
+    {
+        workers[t].join();
+    }
+    const Clock::duration elapsed = Clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / double(threads * iterations);
+}
+
+inline void report(const char *group, const char *name, double nsPerOp)
+{
+    std::printf("%-28s %-36s %12.3f ns/op\n", group, name, nsPerOp);
+}
+} // namespace bench
+
+#endif //_PCTKBENCHCOMMON_H
@@ -0,0 +1,197 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include "bench_common.h"
+
+#include <pctkConcurrentQueue.h>
+
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+
+namespace
+{
+/* The mutex protected deque pipeline stages used before. */
+class LockedQueue
+{
+public:
+    bool tryPush(int value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.size() >= 1024)
+        {
+            return false;
+        }
+        m_queue.push_back(value);
+        return true;
+    }
+
+    bool tryPop(int &value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.empty())
+        {
+            return false;
+        }
+        value = m_queue.front();
+        m_queue.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<int> m_queue;
+};
+
+/* Items per second through the queue, reported as wall time per item. */
+template<typename Queue>
+double throughput(Queue &queue, std::size_t producers, std::size_t consumers, std::size_t items)
+{
+    const std::size_t perProducer = items / producers;
+    const std::size_t total = perProducer * producers;
+    pctk::AtomicInteger<std::size_t> received(0);
+    const bench::Clock::time_point start = bench::Clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p)
+    {
+        threads.push_back(std::thread([&]() {
+            for (std::size_t i = 0; i < perProducer; ++i)
+            {
+                while (!queue.tryPush((int) i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+    for (std::size_t c = 0; c < consumers; ++c)
+    {
+        threads.push_back(std::thread([&]() {
+            int value;
+            while (received.load() < total)
+            {
+                if (queue.tryPop(value))
+                {
+                    received.fetchAndAddRelaxed(1);
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+    for (std::size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i].join();
+    }
+    const bench::Clock::duration elapsed = bench::Clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / double(total);
+}
+
+template<typename Queue>
+double batchedThroughput(Queue &queue, std::size_t items)
+{
+    const bench::Clock::time_point start = bench::Clock::now();
+    std::thread producer([&]() {
+        int batch[32];
+        for (int i = 0; i < 32; ++i)
+        {
+            batch[i] = i;
+        }
+        for (std::size_t sent = 0; sent < items; sent += 32)
+        {
+            queue.pushN(batch, 32);
+        }
+    });
+    std::size_t received = 0;
+    int out[32];
+    while (received < items)
+    {
+        received += queue.popN(out, 32);
+    }
+    producer.join();
+    const bench::Clock::duration elapsed = bench::Clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / double(items);
+}
+
+/* Round trip of one item between two threads over a pair of queues. */
+template<typename Queue>
+double pingPong(Queue &ping, Queue &pong, std::size_t rounds)
+{
+    std::thread echo([&]() {
+        int value;
+        for (std::size_t i = 0; i < rounds; ++i)
+        {
+            ping.pop(value);
+            pong.push(value);
+        }
+    });
+    int value = 0;
+    const double ns = bench::nsPerOp(rounds, [&](std::size_t i) {
+        ping.push((int) i);
+        pong.pop(value);
+    });
+    echo.join();
+    return ns;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t items = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 400000;
+
+    const std::size_t counts[] = {1, 2, 4, 8};
+    for (std::size_t t = 0; t < PCTK_ELEMENTS_NUM(counts); ++t)
+    {
+        char group[64];
+        std::snprintf(group, sizeof(group), "%u producers/%u consumers", (unsigned) counts[t], (unsigned) counts[t]);
+        LockedQueue locked;
+        bench::report(group, "mutex + std::deque", throughput(locked, counts[t], counts[t], items));
+        pctk::MpmcQueue<int> mpmc(1024);
+        bench::report(group, "MpmcQueue", throughput(mpmc, counts[t], counts[t], items));
+        if (1 == counts[t])
+        {
+            pctk::SpscRing<int> spsc(1024);
+            bench::report(group, "SpscRing", throughput(spsc, 1, 1, items));
+        }
+    }
+
+    pctk::MpmcQueue<int> mpmcBatched(1024);
+    bench::report("batches of 32", "MpmcQueue pushN/popN", batchedThroughput(mpmcBatched, items));
+    pctk::SpscRing<int> spscBatched(1024);
+    bench::report("batches of 32", "SpscRing pushN/popN", batchedThroughput(spscBatched, items));
+
+    const std::size_t rounds = items / 20;
+    pctk::MpmcQueue<int> mpmcPing(16), mpmcPong(16);
+    bench::report("round trip latency", "MpmcQueue spin", pingPong(mpmcPing, mpmcPong, rounds));
+    pctk::MpmcQueue<int> mpmcBlockPing(16, pctk::QueueWaitBlock), mpmcBlockPong(16, pctk::QueueWaitBlock);
+    bench::report("round trip latency", "MpmcQueue block", pingPong(mpmcBlockPing, mpmcBlockPong, rounds));
+    pctk::SpscRing<int> spscPing(16), spscPong(16);
+    bench::report("round trip latency", "SpscRing spin", pingPong(spscPing, spscPong, rounds));
+    pctk::SpscRing<int> spscBlockPing(16, pctk::QueueWaitBlock), spscBlockPong(16, pctk::QueueWaitBlock);
+    bench::report("round trip latency", "SpscRing block", pingPong(spscBlockPing, spscBlockPong, rounds));
+    return 0;
+}
@@ -0,0 +1,137 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include "bench_common.h"
+
+#include <pctkDirectoryIterator.h>
+#include <pctkFileSystem.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+/* The scan as removeDirectoryRecursive() does it, a std::string and a stat() per entry and native recursion. */
+std::size_t scanWithPaths(const std::string &path)
+{
+    std::size_t files = 0;
+    DIR *dir = ::opendir(path.c_str());
+    if (!dir)
+    {
+        return 0;
+    }
+    struct dirent *entry;
+    while ((entry = ::readdir(dir)) != PCTK_NULLPTR)
+    {
+        if (0 == std::strcmp(entry->d_name, ".") || 0 == std::strcmp(entry->d_name, ".."))
+        {
+            continue;
+        }
+        const std::string child = path + "/" + entry->d_name;
+        struct stat buffer;
+        if (0 != ::lstat(child.c_str(), &buffer))
+        {
+            continue;
+        }
+        if (S_ISDIR(buffer.st_mode))
+        {
+            files += scanWithPaths(child);
+        }
+        else if (S_ISREG(buffer.st_mode))
+        {
+            ++files;
+        }
+    }
+    ::closedir(dir);
+    return files;
+}
+
+std::size_t scanWithIterator(const std::string &path)
+{
+    std::size_t files = 0;
+    pctk::RecursiveDirectoryIterator iterator(path);
+    while (iterator.next())
+    {
+        files += iterator.entry().isFile() ? 1 : 0;
+    }
+    return files;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t total = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 100000;
+    const std::size_t perDirectory = 500;
+
+    char pattern[] = "/tmp/pctk_bench_dir_XXXXXX";
+    if (!::mkdtemp(pattern))
+    {
+        return 1;
+    }
+    const std::string root(pattern);
+    for (std::size_t i = 0; i < total; ++i)
+    {
+        char name[128];
+        if (0 == i % perDirectory)
+        {
+            std::snprintf(name, sizeof(name), "%s/plugins-%04u", root.c_str(), (unsigned) (i / perDirectory));
+            ::mkdir(name, 0755);
+        }
+        std::snprintf(name, sizeof(name), "%s/plugins-%04u/libplugin_%06u.so", root.c_str(),
+                      (unsigned) (i / perDirectory), (unsigned) i);
+        const int fd = ::open(name, O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+
+    char group[64];
+    std::snprintf(group, sizeof(group), "scan %u files", (unsigned) total);
+    for (int round = 0; round < 3; ++round)
+    {
+        std::size_t found = 0;
+        bench::report(group, "readdir + path + lstat", bench::nsPerOp(1, [&](std::size_t) {
+            found = scanWithPaths(root);
+        }) / double(total));
+        bench::doNotOptimize(found);
+        bench::report(group, "RecursiveDirectoryIterator", bench::nsPerOp(1, [&](std::size_t) {
+            found = scanWithIterator(root);
+        }) / double(total));
+        bench::doNotOptimize(found);
+    }
+
+    pctk::FileSystem fileSystem;
+    fileSystem.removeDirectoryRecursive(root);
+    return 0;
+}
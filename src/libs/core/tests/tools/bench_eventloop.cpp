@@ -0,0 +1,123 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include "bench_common.h"
+
+#include <pctkEventLoop.h>
+
+#include <cstdlib>
+#include <system_error>
+
+#include <unistd.h>
+
+namespace
+{
+/* One readiness event per iteration out of fds pipes, write one byte, dispatch, read it back in the callback. */
+double pipeEvents(pctk::EventLoop::Backend backend, std::size_t fds, std::size_t iterations)
+{
+    pctk::EventLoop loop(backend);
+    std::vector<int> pipes(fds * 2);
+    std::vector<pctk::EventLoop::WatchId> ids(fds);
+    for (std::size_t i = 0; i < fds; ++i)
+    {
+        if (0 != ::pipe(&pipes[i * 2]))
+        {
+            std::abort();
+        }
+        ids[i] = loop.watch(pipes[i * 2], pctk::EventLoop::Readable, [](int fd, int) {
+            char byte;
+            bench::doNotOptimize(::read(fd, &byte, 1));
+        });
+    }
+    const double ns = bench::nsPerOp(iterations, [&](std::size_t i) {
+        bench::doNotOptimize(::write(pipes[(i % fds) * 2 + 1], "x", 1));
+        loop.processEvents(-1);
+    });
+    for (std::size_t i = 0; i < fds; ++i)
+    {
+        loop.unwatch(ids[i]);
+        ::close(pipes[i * 2]);
+        ::close(pipes[i * 2 + 1]);
+    }
+    return ns;
+}
+
+/* Tasks posted from producers threads to one running loop, reported as wall time per task. */
+double postThroughput(std::size_t producers, std::size_t perProducer)
+{
+    pctk::EventLoop loop;
+    pctk::AtomicInt received(0);
+    const int total = (int) (producers * perProducer);
+    std::thread runner([&]() { loop.run(); });
+    const double ns = bench::nsPerOpThreaded(producers, perProducer, [&](std::size_t, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            loop.post([&]() {
+                if (received.fetchAndAddRelaxed(1) + 1 == total)
+                {
+                    loop.quit();
+                }
+            });
+        }
+    });
+    runner.join();
+    return ns;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t iterations = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 200000;
+
+    const pctk::EventLoop::Backend backends[] = {pctk::EventLoop::Epoll, pctk::EventLoop::IoUring,
+                                                 pctk::EventLoop::Libuv};
+    const std::size_t fdCounts[] = {1, 64, 1024};
+    for (std::size_t f = 0; f < PCTK_ELEMENTS_NUM(fdCounts); ++f)
+    {
+        char group[64];
+        std::snprintf(group, sizeof(group), "pipe event, %u watched fds", (unsigned) fdCounts[f]);
+        for (std::size_t b = 0; b < PCTK_ELEMENTS_NUM(backends); ++b)
+        {
+            try
+            {
+                bench::report(group, pctk::EventLoop::backendName(backends[b]),
+                              pipeEvents(backends[b], fdCounts[f], iterations));
+            }
+            catch (const std::system_error &)
+            {
+            }
+        }
+    }
+
+    const std::size_t producers[] = {1, 4};
+    for (std::size_t p = 0; p < PCTK_ELEMENTS_NUM(producers); ++p)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "%u producers", (unsigned) producers[p]);
+        bench::report("posted tasks", name, postThroughput(producers[p], iterations * 5 / producers[p]));
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include "bench_common.h"
+
+#include <pctkFile.h>
+#include <pctkFileTree.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+const char Record[] = "2023-06-01 12:00:00.000 INFO worker: task done\n";
+const std::size_t RecordSize = sizeof(Record) - 1;
+
+/* The log and snapshot writers' way, one write() per record. */
+double writeEach(const std::string &path, std::size_t records)
+{
+    const int fd = ::open(path.c_str(), O_CREAT | O_WRONLY | O_TRUNC | O_CLOEXEC, 0644);
+    const double ns = bench::nsPerOp(records, [&](std::size_t) {
+        bench::doNotOptimize(::write(fd, Record, RecordSize));
+    });
+    ::close(fd);
+    return ns;
+}
+
+double writeStdio(const std::string &path, std::size_t records)
+{
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    const double ns = bench::nsPerOp(records, [&](std::size_t) { std::fwrite(Record, 1, RecordSize, file); });
+    std::fclose(file);
+    return ns;
+}
+
+double writeFile(const std::string &path, std::size_t records, int options)
+{
+    pctk::File file(path, pctk::File::WriteOnly, pctk::File::Create | pctk::File::Truncate | options);
+    const bench::Clock::time_point start = bench::Clock::now();
+    for (std::size_t i = 0; i < records; ++i)
+    {
+        file.write(Record, RecordSize);
+    }
+    file.close();
+    const bench::Clock::duration elapsed = bench::Clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / double(records);
+}
+
+/* Line by line replay, fgets() into a caller buffer against views into File's buffer. */
+double linesStdio(const std::string &path, std::size_t records)
+{
+    char line[256];
+    return bench::nsPerOp(1, [&](std::size_t) {
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        std::size_t total = 0;
+        while (std::fgets(line, sizeof(line), file))
+        {
+            total += std::strlen(line);
+        }
+        bench::doNotOptimize(total);
+        std::fclose(file);
+    }) / double(records);
+}
+
+double linesFile(const std::string &path, std::size_t records)
+{
+    return bench::nsPerOp(1, [&](std::size_t) {
+        pctk::File file(path);
+        file.advise(pctk::File::Sequential);
+        std::size_t total = 0;
+        pctk::Span<const char> line;
+        while (!(line = file.readLine()).empty())
+        {
+            total += line.size();
+        }
+        bench::doNotOptimize(total);
+    }) / double(records);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t records = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 1000000;
+
+    char pattern[] = "/tmp/pctk_bench_file_XXXXXX";
+    const std::string root = ::mkdtemp(pattern);
+    const std::string path = root + "/log";
+
+    bench::report("48 byte log records", "write() per record", writeEach(path, records));
+    bench::report("48 byte log records", "fwrite()", writeStdio(path, records));
+    bench::report("48 byte log records", "File", writeFile(path, records, pctk::File::NoOption));
+    bench::report("48 byte log records", "File Direct", writeFile(path, records, pctk::File::Direct));
+
+    writeFile(path, records, pctk::File::NoOption);
+    bench::report("line replay", "fgets()", linesStdio(path, records));
+    bench::report("line replay", "File::readLine", linesFile(path, records));
+
+    pctk::FileTree::removeAll(root);
+    return 0;
+}
@@ -0,0 +1,134 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include "bench_common.h"
+
+#include <pctkFileSystem.h>
+#include <pctkFileTree.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+/* directories of 250 small files two levels deep, the shape of a build or package cache */
+std::string makeTree(std::size_t total)
+{
+    char pattern[] = "/tmp/pctk_bench_tree_XXXXXX";
+    if (!::mkdtemp(pattern))
+    {
+        std::abort();
+    }
+    const std::string root(pattern);
+    const std::size_t perDirectory = 250;
+    char name[160];
+    for (std::size_t i = 0; i < total; ++i)
+    {
+        const unsigned directory = (unsigned) (i / perDirectory);
+        if (0 == i % perDirectory)
+        {
+            if (0 == directory % 16)
+            {
+                std::snprintf(name, sizeof(name), "%s/%02x", root.c_str(), directory / 16);
+                ::mkdir(name, 0755);
+            }
+            std::snprintf(name, sizeof(name), "%s/%02x/%04x", root.c_str(), directory / 16, directory);
+            ::mkdir(name, 0755);
+        }
+        std::snprintf(name, sizeof(name), "%s/%02x/%04x/object_%06u.o", root.c_str(), directory / 16, directory,
+                      (unsigned) i);
+        const int fd = ::open(name, O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+        if (fd >= 0)
+        {
+            ::write(fd, name, 64);
+            ::close(fd);
+        }
+    }
+    return root;
+}
+
+double timeRemove(std::size_t total, int mode)
+{
+    const std::string root = makeTree(total);
+    const bench::Clock::time_point start = bench::Clock::now();
+    if (0 == mode)
+    {
+        pctk::FileSystem fileSystem;
+        fileSystem.removeDirectoryRecursive(root);
+    }
+    else
+    {
+        pctk::FileTree::Options options;
+        options.flags = 1 == mode ? pctk::FileTree::SingleThreaded : pctk::FileTree::NoOption;
+        pctk::FileTree::removeAll(root, options);
+    }
+    const bench::Clock::duration elapsed = bench::Clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / double(total);
+}
+
+double timeCopy(const std::string &source, std::size_t total, int flags)
+{
+    const std::string destination = source + ".copy";
+    pctk::FileTree::Options options;
+    options.flags = flags;
+    const bench::Clock::time_point start = bench::Clock::now();
+    pctk::FileTree::copyTree(source, destination, options);
+    const bench::Clock::duration elapsed = bench::Clock::now() - start;
+    pctk::FileTree::removeAll(destination);
+    return std::chrono::duration<double, std::nano>(elapsed).count() / double(total);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t total = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 100000;
+
+    char group[64];
+    std::snprintf(group, sizeof(group), "remove %u files", (unsigned) total);
+    for (int round = 0; round < 2; ++round)
+    {
+        bench::report(group, "removeDirectoryRecursive", timeRemove(total, 0));
+        bench::report(group, "FileTree::removeAll single thread", timeRemove(total, 1));
+        bench::report(group, "FileTree::removeAll pool", timeRemove(total, 2));
+    }
+
+    const std::string source = makeTree(total);
+    std::snprintf(group, sizeof(group), "copy %u files", (unsigned) total);
+    for (int round = 0; round < 2; ++round)
+    {
+        bench::report(group, "copyTree read/write, single thread",
+                      timeCopy(source, total, pctk::FileTree::SingleThreaded | pctk::FileTree::NoReflink));
+        bench::report(group, "copyTree single thread", timeCopy(source, total, pctk::FileTree::SingleThreaded));
+        bench::report(group, "copyTree pool", timeCopy(source, total, pctk::FileTree::NoOption));
+    }
+    pctk::FileTree::removeAll(source);
+    return 0;
+}
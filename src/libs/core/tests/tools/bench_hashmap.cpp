@@ -0,0 +1,107 @@
+/***********************************************************************************************************************
+**
+** Library: UTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include "bench_common.h"
+
+#include <pctkHashMap.h>
+
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+std::size_t allocatedBytes = 0;
+}
+
+/* Counts live heap bytes so the benchmark can report memory per element. */
+void *operator new(std::size_t size)
+{
+    void *memory = std::malloc(size + sizeof(std::max_align_t));
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    *static_cast<std::size_t *>(memory) = size;
+    allocatedBytes += size;
+    return static_cast<char *>(memory) + sizeof(std::max_align_t);
+}
+
+void operator delete(void *memory) PCTK_NOEXCEPT
+{
+    if (memory)
+    {
+        char *block = static_cast<char *>(memory) - sizeof(std::max_align_t);
+        allocatedBytes -= *reinterpret_cast<std::size_t *>(block);
+        std::free(block);
+    }
+}
+
+namespace
+{
+template<typename Map>
+void run(const char *group, const char *name, const std::vector<std::string> &keys, std::size_t rounds)
+{
+    const std::size_t before = allocatedBytes;
+    Map map;
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+        map[keys[i]] = int(i);
+    }
+    const double bytes = double(allocatedBytes - before) / double(keys.size());
+
+    const std::string lookup = std::string(group) + " find";
+    bench::report(lookup.c_str(), name, bench::nsPerOp(rounds * keys.size(), [&](std::size_t i) {
+        bench::doNotOptimize(map.find(keys[(i * 7919) % keys.size()]));
+    }));
+    const std::string memory = std::string(group) + " bytes/elem";
+    std::printf("%-28s %-36s %12.1f\n", memory.c_str(), name, bytes);
+}
+} // namespace
+
+/* Lookup time and heap bytes per element for std::map, std::unordered_map and pctk::HashMap with string keys. */
+int main(int argc, char **argv)
+{
+    const std::size_t rounds = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 20;
+    const std::size_t sizes[] = {64, 4096, 262144};
+    for (std::size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        std::vector<std::string> keys;
+        for (std::size_t i = 0; i < sizes[s]; ++i)
+        {
+            keys.push_back("pctk.service." + std::to_string(i * 2654435761u % 1000003));
+        }
+        const std::string group = std::to_string(sizes[s]);
+        const std::size_t scaled = rounds * 4096 / sizes[s] + 1;
+        run<std::map<std::string, int> >(group.c_str(), "std::map", keys, scaled);
+        run<std::unordered_map<std::string, int> >(group.c_str(), "std::unordered_map", keys, scaled);
+        run<pctk::HashMap<std::string, int> >(group.c_str(), "pctk::HashMap", keys, scaled);
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include "bench_common.h"
+
+#include <pctkSpinLock.h>
+#include <pctkMutex.h>
+#include <pctkReadWriteLock.h>
+
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
+
+#if __cplusplus >= 201703L
+typedef std::shared_mutex SharedMutex;
+#else
+typedef std::shared_timed_mutex SharedMutex;
+#endif
+
+namespace
+{
+/* A short critical section, the usual case for a lock guarding a small structure. */
+template<typename Lock>
+double exclusive(Lock &lock, std::size_t threads, std::size_t iterations)
+{
+    std::size_t counter = 0;
+    const double ns = bench::nsPerOpThreaded(threads, iterations, [&](std::size_t, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            lock.lock();
+            ++counter;
+            lock.unlock();
+        }
+    });
+    bench::doNotOptimize(counter);
+    return ns;
+}
+
+/* Nine reads for every write. */
+double shared(pctk::ReadWriteLock &lock, std::size_t threads, std::size_t iterations)
+{
+    int value = 0;
+    return bench::nsPerOpThreaded(threads, iterations, [&](std::size_t, std::size_t count) {
+        int sum = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (0 == i % 10)
+            {
+                pctk::WriteLocker locker(lock);
+                ++value;
+            }
+            else
+            {
+                pctk::ReadLocker locker(lock);
+                sum += value;
+            }
+        }
+        bench::doNotOptimize(sum);
+    });
+}
+
+double shared(SharedMutex &lock, std::size_t threads, std::size_t iterations)
+{
+    int value = 0;
+    return bench::nsPerOpThreaded(threads, iterations, [&](std::size_t, std::size_t count) {
+        int sum = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (0 == i % 10)
+            {
+                std::unique_lock<SharedMutex> locker(lock);
+                ++value;
+            }
+            else
+            {
+                std::shared_lock<SharedMutex> locker(lock);
+                sum += value;
+            }
+        }
+        bench::doNotOptimize(sum);
+    });
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t iterations = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 1000000;
+
+    const std::size_t counts[] = {1, 2, 4, 8};
+    for (std::size_t c = 0; c < PCTK_ELEMENTS_NUM(counts); ++c)
+    {
+        char group[64];
+        std::snprintf(group, sizeof(group), "%u threads", (unsigned) counts[c]);
+        const std::size_t perThread = iterations / counts[c];
+        std::mutex stdMutex;
+        bench::report(group, "std::mutex", exclusive(stdMutex, counts[c], perThread));
+        pctk::Mutex mutex;
+        bench::report(group, "Mutex", exclusive(mutex, counts[c], perThread));
+        pctk::SpinLock spinLock;
+        bench::report(group, "SpinLock", exclusive(spinLock, counts[c], perThread));
+        SharedMutex sharedMutex;
+        bench::report(group, "std::shared_mutex 90% reads", shared(sharedMutex, counts[c], perThread));
+        pctk::ReadWriteLock readWriteLock;
+        bench::report(group, "ReadWriteLock 90% reads", shared(readWriteLock, counts[c], perThread));
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include "bench_common.h"
+
+#include <pctkFileTree.h>
+#include <pctkMappedFile.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+const std::size_t MiB = 1024 * 1024;
+
+pctk_uint64_t checksum(const char *data, std::size_t size)
+{
+    pctk_uint64_t sum = 0;
+    for (std::size_t i = 0; i < size; i += 64)
+    {
+        sum += (unsigned char) data[i];
+    }
+    return sum;
+}
+
+/* The asset loaders' way, fread() through a 64 KiB buffer, touching one byte per cache line. */
+double scanWithRead(const std::string &path, std::size_t size, std::size_t rounds)
+{
+    std::vector<char> buffer(64 * 1024);
+    return bench::nsPerOp(rounds, [&](std::size_t) {
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        std::size_t count;
+        while ((count = std::fread(buffer.data(), 1, buffer.size(), file)) > 0)
+        {
+            bench::doNotOptimize(checksum(buffer.data(), count));
+        }
+        std::fclose(file);
+    }) / double(size / MiB);
+}
+
+double scanMapped(const std::string &path, std::size_t size, std::size_t rounds, int options, bool advise)
+{
+    return bench::nsPerOp(rounds, [&](std::size_t) {
+        pctk::MappedFile file(path, pctk::MappedFile::ReadOnly, options);
+        if (advise)
+        {
+            file.advise(pctk::MappedFile::Sequential);
+        }
+        bench::doNotOptimize(checksum(file.data(), file.size()));
+    }) / double(size / MiB);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t size = (argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 64) * MiB;
+    const std::size_t rounds = 20;
+
+    char pattern[] = "/tmp/pctk_bench_mapped_XXXXXX";
+    const std::string root = ::mkdtemp(pattern);
+    const std::string path = root + "/data";
+    {
+        pctk::MappedFile file(path, pctk::MappedFile::ReadWrite, pctk::MappedFile::Create);
+        file.resize(size);
+        for (std::size_t i = 0; i < size; i += 512)
+        {
+            file.writableData()[i] = char(i);
+        }
+    }
+
+    /* the file stays in the page cache, both sides measure the copy and fault cost rather than the disk */
+    bench::report("sequential scan, per MiB", "fread 64 KiB buffer", scanWithRead(path, size, rounds));
+    bench::report("sequential scan, per MiB", "MappedFile", scanMapped(path, size, rounds, 0, false));
+    bench::report("sequential scan, per MiB", "MappedFile Sequential",
+                  scanMapped(path, size, rounds, 0, true));
+    bench::report("sequential scan, per MiB", "MappedFile Populate",
+                  scanMapped(path, size, rounds, pctk::MappedFile::Populate, false));
+    bench::report("sequential scan, per MiB", "MappedFile Populate|HugePages",
+                  scanMapped(path, size, rounds, pctk::MappedFile::Populate | pctk::MappedFile::HugePages, false));
+
+    const std::size_t lookups = 1000000;
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    std::size_t offset = 0;
+    bench::report("random 8 byte reads", "pread", bench::nsPerOp(lookups, [&](std::size_t) {
+                      offset = (offset * 6364136223846793005ull + 1442695040888963407ull) % (size - 8);
+                      char value[8];
+                      bench::doNotOptimize(::pread(fd, value, sizeof(value), (off_t) offset));
+                  }));
+    ::close(fd);
+    pctk::MappedFile file(path, pctk::MappedFile::ReadOnly, pctk::MappedFile::Populate);
+    file.advise(pctk::MappedFile::Random);
+    bench::report("random 8 byte reads", "MappedFile", bench::nsPerOp(lookups, [&](std::size_t) {
+                      offset = (offset * 6364136223846793005ull + 1442695040888963407ull) % (size - 8);
+                      bench::doNotOptimize(file.data()[offset]);
+                  }));
+    file.close();
+
+    pctk::FileTree::removeAll(root);
+    return 0;
+}
@@ -0,0 +1,138 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include "bench_common.h"
+
+#include <pctkRcu.h>
+
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+
+#if __cplusplus >= 201703L
+typedef std::shared_mutex SharedMutex;
+#else
+typedef std::shared_timed_mutex SharedMutex;
+#endif
+
+namespace
+{
+typedef std::map<int, int> Routes;
+
+Routes makeRoutes(int generation)
+{
+    Routes routes;
+    for (int i = 0; i < 64; ++i)
+    {
+        routes[i] = i + generation;
+    }
+    return routes;
+}
+
+/* The shared mutex protected table readers take today. */
+class LockedRoutes
+{
+public:
+    LockedRoutes() : m_routes(makeRoutes(0)) {}
+
+    int lookup(int key) const
+    {
+        std::shared_lock<SharedMutex> lock(m_mutex);
+        return m_routes.find(key)->second;
+    }
+
+    void replace(const Routes &routes)
+    {
+        std::unique_lock<SharedMutex> lock(m_mutex);
+        m_routes = routes;
+    }
+
+private:
+    mutable SharedMutex m_mutex;
+    Routes m_routes;
+};
+
+class RcuRoutes
+{
+public:
+    RcuRoutes() : m_routes(makeRoutes(0)) {}
+
+    int lookup(int key) const
+    {
+        pctk::Rcu<Routes>::ReadLock lock(m_routes);
+        return lock->find(key)->second;
+    }
+
+    void replace(const Routes &routes) { m_routes.store(routes); }
+
+private:
+    pctk::Rcu<Routes> m_routes;
+};
+
+/* Wall time per lookup with readers threads reading while one writer replaces the table every millisecond. */
+template<typename Table>
+double readers(Table &table, std::size_t threads, std::size_t lookups)
+{
+    pctk::AtomicInt reading(1);
+    std::thread writer([&]() {
+        int generation = 0;
+        while (reading.loadAcquire())
+        {
+            table.replace(makeRoutes(++generation));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    const double ns = bench::nsPerOpThreaded(threads, lookups, [&](std::size_t t, std::size_t count) {
+        int sum = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            sum += table.lookup((int) ((i + t) & 63));
+        }
+        bench::doNotOptimize(sum);
+    });
+    reading.storeRelease(0);
+    writer.join();
+    return ns;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t lookups = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 2000000;
+
+    const std::size_t counts[] = {1, 8, 64};
+    for (std::size_t c = 0; c < PCTK_ELEMENTS_NUM(counts); ++c)
+    {
+        char group[64];
+        std::snprintf(group, sizeof(group), "%u readers, 1 writer", (unsigned) counts[c]);
+        const std::size_t perThread = lookups / counts[c];
+        LockedRoutes locked;
+        bench::report(group, "std::shared_mutex", readers(locked, counts[c], perThread));
+        RcuRoutes rcu;
+        bench::report(group, "Rcu", readers(rcu, counts[c], perThread));
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include "bench_common.h"
+
+#include <pctkSeqLock.h>
+
+#include <cstdlib>
+#include <mutex>
+
+namespace
+{
+struct Stats
+{
+    pctk_int64_t timestamp;
+    pctk_int64_t count;
+    double mean;
+    double max;
+};
+
+/* The mutex protected snapshot the telemetry path used before. */
+class LockedStats
+{
+public:
+    LockedStats() : m_stats() {}
+
+    Stats load() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void store(const Stats &stats)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats = stats;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    Stats m_stats;
+};
+
+/* Wall time per read with readers threads polling while one writer publishes every few microseconds. */
+template<typename Cell>
+double poll(Cell &cell, std::size_t readers, std::size_t reads)
+{
+    pctk::AtomicInt running(1);
+    std::thread writer([&]() {
+        Stats stats = {};
+        while (running.loadAcquire())
+        {
+            ++stats.timestamp;
+            cell.store(stats);
+            std::this_thread::sleep_for(std::chrono::microseconds(10));
+        }
+    });
+    const double ns = bench::nsPerOpThreaded(readers, reads, [&](std::size_t, std::size_t count) {
+        pctk_int64_t sum = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            sum += cell.load().timestamp;
+        }
+        bench::doNotOptimize(sum);
+    });
+    running.storeRelease(0);
+    writer.join();
+    return ns;
+}
+} // namespace
+
+PCTK_BEGIN_NAMESPACE
+PCTK_DECL_TYPEINFO(Stats, PCTK_TYPEINFO_PRIMITIVE);
+PCTK_END_NAMESPACE
+
+int main(int argc, char **argv)
+{
+    const std::size_t reads = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 2000000;
+
+    const std::size_t counts[] = {1, 2, 4, 8};
+    for (std::size_t c = 0; c < PCTK_ELEMENTS_NUM(counts); ++c)
+    {
+        char group[64];
+        std::snprintf(group, sizeof(group), "%u readers, 1 writer", (unsigned) counts[c]);
+        LockedStats locked;
+        bench::report(group, "std::mutex", poll(locked, counts[c], reads / counts[c]));
+        pctk::SeqLock<Stats> seqLock;
+        bench::report(group, "SeqLock", poll(seqLock, counts[c], reads / counts[c]));
+    }
+    return 0;
+}
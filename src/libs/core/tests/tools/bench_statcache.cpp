@@ -0,0 +1,120 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include "bench_common.h"
+
+#include <pctkFileSystem.h>
+#include <pctkFileTree.h>
+#include <pctkStatCache.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+/* The bundle resolver's access pattern, exists(), isDirectory() and isFile() on every candidate, half missing. */
+void resolve(pctk::FileSystem &fileSystem, const std::vector<std::string> &paths, std::size_t i)
+{
+    const std::string &path = paths[i % paths.size()];
+    std::error_code error;
+    if (fileSystem.exists(path, error) && !fileSystem.isDirectory(path, error))
+    {
+        bench::doNotOptimize(fileSystem.isFile(path, error));
+    }
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t count = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 2000;
+
+    char pattern[] = "/tmp/pctk_bench_stat_XXXXXX";
+    if (!::mkdtemp(pattern))
+    {
+        return 1;
+    }
+    const std::string root(pattern);
+    const std::string directory = root + "/lib/pctk/plugins/bundles";
+    pctk::FileSystem fileSystem;
+    fileSystem.makePath(directory);
+    std::vector<std::string> paths;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "/libbundle_%05u.so", (unsigned) i);
+        paths.push_back(directory + name);
+        if (0 == i % 2)
+        {
+            const int fd = ::open(paths.back().c_str(), O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+    }
+
+    const std::size_t iterations = 200000;
+    bench::report("resolve", "FileSystem, stat per query", bench::nsPerOp(iterations, [&](std::size_t i) {
+        resolve(fileSystem, paths, i);
+    }));
+
+    pctk::StatCache timed;
+    fileSystem.setStatCache(&timed);
+    bench::report("resolve", "StatCache, time to live", bench::nsPerOp(iterations, [&](std::size_t i) {
+        resolve(fileSystem, paths, i);
+    }));
+
+    pctk::StatCache::Options options;
+    options.watch = true;
+    options.timeToLiveNSecs = 0;
+    pctk::StatCache watched(options);
+    fileSystem.setStatCache(&watched);
+    bench::report("resolve", "StatCache, inotify", bench::nsPerOp(iterations, [&](std::size_t i) {
+        resolve(fileSystem, paths, i);
+    }));
+    fileSystem.setStatCache(PCTK_NULLPTR);
+
+    bench::report("cold batch", "StatCache::status loop", bench::nsPerOp(20, [&](std::size_t) {
+        pctk::StatCache cache;
+        for (std::size_t i = 0; i < paths.size(); ++i)
+        {
+            bench::doNotOptimize(cache.status(paths[i]));
+        }
+    }) / double(paths.size()));
+    bench::report("cold batch", "StatCache::statMany", bench::nsPerOp(20, [&](std::size_t) {
+        pctk::StatCache cache;
+        bench::doNotOptimize(cache.statMany(paths));
+    }) / double(paths.size()));
+
+    pctk::FileTree::removeAll(root);
+    return 0;
+}
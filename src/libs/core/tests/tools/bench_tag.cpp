@@ -0,0 +1,52 @@
+/***********************************************************************************************************************
+**
+** Library: UTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include "bench_common.h"
+
+#include <pctkTag.h>
+
+#include <cstdlib>
+
+/* Comparing an incoming id against a tag built from its name each time, a PCTK_TAG literal and a plain integer. */
+int main(int argc, char **argv)
+{
+    const std::size_t iterations = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 4000000;
+    const pctk::Tag incoming("pctk.bench.tag.incoming");
+    const int incomingId = incoming.uniqueIdentifier();
+
+    bench::report("compare", "Tag(\"name\")", bench::nsPerOp(iterations, [&](std::size_t) {
+        bench::doNotOptimize(incoming == pctk::Tag("pctk.bench.tag.incoming"));
+    }));
+    bench::report("compare", "PCTK_TAG(\"name\")", bench::nsPerOp(iterations, [&](std::size_t) {
+        bench::doNotOptimize(incoming == PCTK_TAG("pctk.bench.tag.incoming"));
+    }));
+    bench::report("compare", "int", bench::nsPerOp(iterations, [&](std::size_t i) {
+        bench::doNotOptimize(incomingId == int(i));
+    }));
+    bench::report("lookup", "Tag::name()", bench::nsPerOp(iterations, [&](std::size_t) {
+        bench::doNotOptimize(incoming.name());
+    }));
+    return 0;
+}
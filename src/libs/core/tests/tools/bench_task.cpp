@@ -0,0 +1,113 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include "bench_common.h"
+
+#include <pctkTask.h>
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+/* Live frames per round, deep enough that a call chain of suspended coroutines is modelled. */
+const std::size_t FrameDepth = 16;
+
+double globalNew(std::size_t threads, std::size_t iterations, std::size_t size)
+{
+    return bench::nsPerOpThreaded(threads, iterations / FrameDepth, [size](std::size_t, std::size_t count) {
+        void *frames[FrameDepth];
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            for (std::size_t f = 0; f < FrameDepth; ++f)
+            {
+                frames[f] = ::operator new(size);
+                bench::doNotOptimize(frames[f]);
+            }
+            for (std::size_t f = 0; f < FrameDepth; ++f)
+            {
+                ::operator delete(frames[f]);
+            }
+        }
+    }) / double(FrameDepth);
+}
+
+double framePool(std::size_t threads, std::size_t iterations, std::size_t size)
+{
+    return bench::nsPerOpThreaded(threads, iterations / FrameDepth, [size](std::size_t, std::size_t count) {
+        void *frames[FrameDepth];
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            for (std::size_t f = 0; f < FrameDepth; ++f)
+            {
+                frames[f] = pctk::detail::taskFrameAllocate(size);
+                bench::doNotOptimize(frames[f]);
+            }
+            for (std::size_t f = 0; f < FrameDepth; ++f)
+            {
+                pctk::detail::taskFrameDeallocate(frames[f], size);
+            }
+        }
+    }) / double(FrameDepth);
+}
+
+#if PCTK_CC_FEATURE_COROUTINES
+pctk::Task<int> leaf(int value)
+{
+    co_return value + 1;
+}
+
+pctk::Task<int> chain(int value)
+{
+    const int first = co_await leaf(value);
+    const int second = co_await leaf(first);
+    co_return second;
+}
+#endif
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t iterations = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 4000000;
+
+    const std::size_t threads[] = {1, 4};
+    for (std::size_t t = 0; t < PCTK_ELEMENTS_NUM(threads); ++t)
+    {
+        char group[64];
+        std::snprintf(group, sizeof(group), "frame 256B, %u threads", (unsigned) threads[t]);
+        bench::report(group, "global new/delete", globalNew(threads[t], iterations, 256));
+        bench::report(group, "taskFrameAllocate/Deallocate", framePool(threads[t], iterations, 256));
+    }
+
+#if PCTK_CC_FEATURE_COROUTINES
+    int result = 0;
+    bench::report("coroutine", "Task<int> awaiting two tasks", bench::nsPerOp(iterations / 4, [&](std::size_t i) {
+        result += pctk::syncWait(chain((int) i));
+    }));
+    bench::doNotOptimize(result);
+#endif
+    return 0;
+}
@@ -0,0 +1,169 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include "bench_common.h"
+
+#include <pctkThreadPool.h>
+
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace
+{
+/* The mutex + condition variable pool components used to roll for themselves. */
+class NaivePool
+{
+public:
+    explicit NaivePool(int threads) : m_pending(0), m_stop(false)
+    {
+        for (int i = 0; i < threads; ++i)
+        {
+            m_threads.push_back(std::thread([this]() { this->run(); }));
+        }
+    }
+
+    ~NaivePool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (std::size_t i = 0; i < m_threads.size(); ++i)
+        {
+            m_threads[i].join();
+        }
+    }
+
+    void submit(std::function<void()> func)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(std::move(func));
+            ++m_pending;
+        }
+        m_wake.notify_one();
+    }
+
+    void waitForDone()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return 0 == m_pending; });
+    }
+
+private:
+    void run()
+    {
+        for (;;)
+        {
+            std::function<void()> func;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+                if (m_queue.empty())
+                {
+                    return;
+                }
+                func = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+            func();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (0 == --m_pending)
+            {
+                m_done.notify_all();
+            }
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::deque<std::function<void()> > m_queue;
+    std::vector<std::thread> m_threads;
+    std::size_t m_pending;
+    bool m_stop;
+};
+
+template<typename Pool>
+void fanOut(Pool *pool, pctk::AtomicInt *counter, int depth)
+{
+    counter->fetchAndAddRelaxed(1);
+    if (depth > 0)
+    {
+        pool->submit([=]() { fanOut(pool, counter, depth - 1); });
+        pool->submit([=]() { fanOut(pool, counter, depth - 1); });
+    }
+}
+
+template<typename Pool>
+double externalBurst(Pool &pool, std::size_t tasks)
+{
+    pctk::AtomicInt counter(0);
+    return bench::nsPerOp(1, [&](std::size_t) {
+        for (std::size_t i = 0; i < tasks; ++i)
+        {
+            pool.submit([&counter]() { counter.fetchAndAddRelaxed(1); });
+        }
+        pool.waitForDone();
+    }) / double(tasks);
+}
+
+template<typename Pool>
+double nestedFanOut(Pool &pool, int depth)
+{
+    pctk::AtomicInt counter(0);
+    return bench::nsPerOp(1, [&](std::size_t) {
+        pool.submit([&]() { fanOut(&pool, &counter, depth); });
+        pool.waitForDone();
+    }) / double((1 << (depth + 1)) - 1);
+}
+} // namespace
+
+/* Tiny tasks submitted from outside, then a recursive fan-out where every task submits two more. */
+int main(int argc, char **argv)
+{
+    const std::size_t tasks = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 200000;
+    const int depth = 17;
+
+    const int threadCounts[] = {1, 4, 16};
+    for (std::size_t t = 0; t < PCTK_ELEMENTS_NUM(threadCounts); ++t)
+    {
+        const int threads = threadCounts[t];
+        char group[64];
+        std::snprintf(group, sizeof(group), "%d workers", threads);
+
+        NaivePool naive(threads);
+        pctk::ThreadPool pool(threads);
+        bench::report(group, "external burst, mutex queue", externalBurst(naive, tasks));
+        bench::report(group, "external burst, ThreadPool", externalBurst(pool, tasks));
+        bench::report(group, "nested fan-out, mutex queue", nestedFanOut(naive, depth));
+        bench::report(group, "nested fan-out, ThreadPool", nestedFanOut(pool, depth));
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include "bench_common.h"
+
+#include <pctkTimerWheel.h>
+
+#include <cstdlib>
+#include <map>
+
+namespace
+{
+/* The std::multimap keyed by deadline that connection timeouts live in today. */
+class MultimapTimers
+{
+public:
+    typedef std::multimap<pctk_int64_t, int>::iterator TimerId;
+
+    TimerId start(pctk_int64_t delayNSecs, int value)
+    {
+        return m_timers.insert(std::make_pair(pctk::SteadyClock::nowNSecs() + delayNSecs, value));
+    }
+
+    void cancel(TimerId id) { m_timers.erase(id); }
+
+    TimerId restart(TimerId id, pctk_int64_t delayNSecs)
+    {
+        const int value = id->second;
+        m_timers.erase(id);
+        return this->start(delayNSecs, value);
+    }
+
+    std::size_t expire(pctk_int64_t now)
+    {
+        std::size_t fired = 0;
+        std::multimap<pctk_int64_t, int>::iterator it = m_timers.begin();
+        while (it != m_timers.end() && it->first <= now)
+        {
+            bench::doNotOptimize(it->second);
+            m_timers.erase(it++);
+            ++fired;
+        }
+        return fired;
+    }
+
+private:
+    std::multimap<pctk_int64_t, int> m_timers;
+};
+
+void noop(void *)
+{
+}
+
+std::vector<pctk_int64_t> makeDelays(std::size_t count)
+{
+    std::vector<pctk_int64_t> delays(count);
+    std::srand(1);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        /* idle timeouts between one and sixty seconds */
+        delays[i] = (pctk_int64_t) (1000 + std::rand() % 59000) * PCTK_NSECS_PER_MSEC;
+    }
+    return delays;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t count = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 1000000;
+    const std::vector<pctk_int64_t> delays = makeDelays(count);
+    const pctk::SteadyClock::time_point start = pctk::SteadyClock::now();
+
+    {
+        MultimapTimers timers;
+        std::vector<MultimapTimers::TimerId> ids(count);
+        bench::report("start", "std::multimap", bench::nsPerOp(count, [&](std::size_t i) {
+            ids[i] = timers.start(delays[i], (int) i);
+        }));
+        bench::report("restart", "std::multimap", bench::nsPerOp(count, [&](std::size_t i) {
+            ids[i] = timers.restart(ids[i], delays[count - 1 - i]);
+        }));
+        bench::report("expire all", "std::multimap", bench::nsPerOp(count, [&](std::size_t i) {
+            timers.expire((start + pctk::SteadyClock::duration((pctk_int64_t) i * 61 * PCTK_NSECS_PER_SEC / count))
+                              .time_since_epoch().count());
+        }));
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            ids[i] = timers.start(delays[i], (int) i);
+        }
+        bench::report("cancel", "std::multimap", bench::nsPerOp(count, [&](std::size_t i) {
+            timers.cancel(ids[i]);
+        }));
+    }
+
+    {
+        pctk::TimerWheel wheel;
+        std::vector<pctk::TimerWheel::TimerId> ids(count);
+        bench::report("start", "TimerWheel", bench::nsPerOp(count, [&](std::size_t i) {
+            ids[i] = wheel.start(delays[i], &noop, PCTK_NULLPTR);
+        }));
+        bench::report("restart", "TimerWheel", bench::nsPerOp(count, [&](std::size_t i) {
+            wheel.restart(ids[i], delays[count - 1 - i]);
+        }));
+        bench::report("expire all", "TimerWheel", bench::nsPerOp(count, [&](std::size_t i) {
+            wheel.expire(start + pctk::SteadyClock::duration((pctk_int64_t) i * 61 * PCTK_NSECS_PER_SEC / count));
+        }));
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            ids[i] = wheel.start(delays[i], &noop, PCTK_NULLPTR);
+        }
+        bench::report("cancel", "TimerWheel", bench::nsPerOp(count, [&](std::size_t i) {
+            wheel.cancel(ids[i]);
+        }));
+    }
+
+    pctk_int64_t sink = 0;
+    bench::report("clock read", "std::chrono::steady_clock", bench::nsPerOp(count, [&](std::size_t) {
+        sink += std::chrono::steady_clock::now().time_since_epoch().count();
+    }));
+    bench::report("clock read", pctk::SteadyClock::isTscBased() ? "SteadyClock::now (TSC)" : "SteadyClock::now",
+                  bench::nsPerOp(count, [&](std::size_t) { sink += pctk::SteadyClock::nowNSecs(); }));
+    bench::report("clock read", "SteadyClock::coarseNow", bench::nsPerOp(count, [&](std::size_t) {
+        sink += pctk::SteadyClock::coarseNow().time_since_epoch().count();
+    }));
+    bench::doNotOptimize(sink);
+    return 0;
+}
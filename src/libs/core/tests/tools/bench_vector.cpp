@@ -0,0 +1,129 @@
+/***********************************************************************************************************************
+**
+** Library: UTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+
+#include "bench_common.h"
+
+#include <pctkVector.h>
+
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+/* A relocatable element: copying allocates, but the bytes may be moved with memcpy. */
+struct Handle
+{
+    int *value;
+
+    Handle(int v = 0) : value(new int(v)) {}
+    Handle(const Handle &other) : value(new int(*other.value)) {}
+    Handle(Handle &&other) PCTK_NOEXCEPT : value(other.value) { other.value = PCTK_NULLPTR; }
+    Handle &operator=(const Handle &other)
+    {
+        *value = *other.value;
+        return *this;
+    }
+    Handle &operator=(Handle &&other) PCTK_NOEXCEPT
+    {
+        std::swap(value, other.value);
+        return *this;
+    }
+    ~Handle() { delete value; }
+};
+
+template<typename Container, typename Make>
+double fill(std::size_t rounds, std::size_t count, Make make)
+{
+    return bench::nsPerOp(rounds, [&](std::size_t) {
+        Container container;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            container.push_back(make(i));
+        }
+        bench::doNotOptimize(container.data());
+    }) / double(count);
+}
+
+template<typename Container, typename Make>
+double insertFront(std::size_t rounds, std::size_t count, Make make)
+{
+    return bench::nsPerOp(rounds, [&](std::size_t) {
+        Container container;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            container.insert(container.begin(), make(i));
+        }
+        bench::doNotOptimize(container.data());
+    }) / double(count);
+}
+
+template<typename Container, typename Make>
+double copy(std::size_t rounds, std::size_t count, Make make)
+{
+    Container source;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        source.push_back(make(i));
+    }
+    return bench::nsPerOp(rounds, [&](std::size_t) {
+        Container container(source);
+        bench::doNotOptimize(container.data());
+    }) / double(count);
+}
+
+template<typename T, typename Make>
+void run(const char *type, std::size_t rounds, Make make)
+{
+    const std::string push = std::string("push_back ") + type;
+    const std::string front = std::string("insert(begin) ") + type;
+    const std::string copied = std::string("copy ") + type;
+    bench::report(push.c_str(), "std::vector", fill<std::vector<T> >(rounds, 4096, make));
+    bench::report(push.c_str(), "pctk::Vector", fill<pctk::Vector<T> >(rounds, 4096, make));
+    bench::report(front.c_str(), "std::vector", insertFront<std::vector<T> >(rounds / 16 + 1, 512, make));
+    bench::report(front.c_str(), "pctk::Vector", insertFront<pctk::Vector<T> >(rounds / 16 + 1, 512, make));
+    bench::report(copied.c_str(), "std::vector", copy<std::vector<T> >(rounds, 4096, make));
+    bench::report(copied.c_str(), "pctk::Vector", copy<pctk::Vector<T> >(rounds, 4096, make));
+}
+} // namespace
+
+PCTK_BEGIN_NAMESPACE
+PCTK_DECL_TYPEINFO(Handle, PCTK_TYPEINFO_MOVABLE);
+PCTK_END_NAMESPACE
+
+/* Growth, front insertion and copy per element for a primitive, a relocatable and a complex element type. */
+int main(int argc, char **argv)
+{
+    const std::size_t rounds = argc > 1 ? (std::size_t) std::strtoul(argv[1], PCTK_NULLPTR, 10) : 200;
+
+    run<int>("int", rounds, [](std::size_t i) { return int(i); });
+    run<Handle>("Handle", rounds, [](std::size_t i) { return Handle(int(i)); });
+    run<std::string>("std::string", rounds, [](std::size_t i) {
+        return std::string("a string that does not fit sso ") + char('a' + i % 26);
+    });
+    return 0;
+}
@@ -251,9 +251,9 @@ TEST(pctkAnyTest, inplaceConstructFromLiteralValue)
     using pair_t = std::pair<char, int>;
 
 #if CF_USES_STD_ANY
-    pctk::Any a( in_place_type<pair_t>, 'a', 7 );
+    pctk::Any a( pctk::in_place_type<pair_t>, 'a', 7 );
 #else
-    pctk::Any a( CF_IN_PLACE_TYPE_T( pair_t ), 'a', 7 );
+    pctk::Any a( PCTK_IN_PLACE_TYPE( pair_t ), 'a', 7 );
 //  pctk::Any a( in_place<     pair_t>, 'a', 7 );
 #endif
     CHECK( pctk::any_cast<pair_t>( a ).first  == 'a' );
@@ -271,19 +271,15 @@ TEST(pctkAnyTest, inplaceCopyConstructFromLiteralValue)
     using pair_t = std::pair<char, V>;
 
 #if CF_USES_STD_ANY
-    pctk::Any a( in_place_type<pair_t>, c, v );
+    pctk::Any a( pctk::in_place_type<pair_t>, c, v );
 #else
-    pctk::Any a( in_place_type<pair_t>, c, v );
+    pctk::Any a( pctk::in_place_type<pair_t>, c, v );
 //  pctk::Any a( in_place<     pair_t>, c, v );
 #endif
 
     CHECK( pctk::any_cast<pair_t>( &a )->first        == 'a' );
     CHECK( pctk::any_cast<pair_t>( &a )->second.value ==  7  );
-#if CF_USES_STD_ANY
     CHECK( pctk::any_cast<pair_t>( &a )->second.state == copy_constructed );
-#else
-    CHECK( pctk::any_cast<pair_t>( &a )->second.state == move_constructed );
-#endif
     CHECK(                              v.state != moved_from       );
 #else
     CHECK(!!"pctk::Any: in-place construction is not available (no C++11)");
@@ -298,9 +294,9 @@ TEST(pctkAnyTest, inplaceMoveConstructFromValue)
     using pair_t = std::pair<char, V>;
 
 #if CF_USES_STD_ANY
-    pctk::Any a( in_place_type<pair_t>, c, std::move(v) );
+    pctk::Any a( pctk::in_place_type<pair_t>, c, std::move(v) );
 #else
-    pctk::Any a( in_place_type<pair_t>, c, std::move(v) );
+    pctk::Any a( pctk::in_place_type<pair_t>, c, std::move(v) );
 //  pctk::Any a( in_place<     pair_t>, c, std::move(v) );
 #endif
     CHECK( pctk::any_cast<pair_t>( &a )->first        == 'a' );
@@ -317,9 +313,9 @@ TEST(pctkAnyTest, inplaceCopyConstructFromInitializerList)
 #if PCTK_CC_STDCXX_11
     S s( 7 );
 #if CF_USES_STD_ANY
-    pctk::Any a( in_place_type<InitList>, { 7, 8, 9, }, 'a', s );
+    pctk::Any a( pctk::in_place_type<InitList>, { 7, 8, 9, }, 'a', s );
 #else
-    pctk::Any a( in_place_type<InitList>, { 7, 8, 9, }, 'a', s );
+    pctk::Any a( pctk::in_place_type<InitList>, { 7, 8, 9, }, 'a', s );
 //  pctk::Any a( in_place<     InitList>, { 7, 8, 9, }, 'a', s );
 #endif
 
@@ -328,11 +324,7 @@ TEST(pctkAnyTest, inplaceCopyConstructFromInitializerList)
     CHECK( pctk::any_cast<InitList>( &a )->vec[2]  ==  9  );
     CHECK( pctk::any_cast<InitList>( &a )->c       == 'a' );
     CHECK( pctk::any_cast<InitList>( &a )->s.value.value ==  7               );
-#if CF_USES_STD_ANY
     CHECK( pctk::any_cast<InitList>( &a )->s.state       == copy_constructed );
-#else
-    CHECK( pctk::any_cast<InitList>( &a )->s.state       == move_constructed );
-#endif
     CHECK(                           s.state       != moved_from       );
 #else
     CHECK(!!"pctk::Any: in-place construction is not available (no C++11)");
@@ -344,9 +336,9 @@ TEST(pctkAnyTest, inplaceMoveConstructFromInitializerList)
 #if PCTK_CC_STDCXX_11
     S s( 7 );
 #if CF_USES_STD_ANY
-    pctk::Any a( in_place_type<InitList>, { 7, 8, 9, }, 'a', std::move(s) );
+    pctk::Any a( pctk::in_place_type<InitList>, { 7, 8, 9, }, 'a', std::move(s) );
 #else
-    pctk::Any a( in_place_type<InitList>, { 7, 8, 9, }, 'a', std::move(s) );
+    pctk::Any a( pctk::in_place_type<InitList>, { 7, 8, 9, }, 'a', std::move(s) );
 //  pctk::Any a( in_place<     InitList>, { 7, 8, 9, }, 'a', std::move(s) );
 #endif
 
@@ -438,11 +430,7 @@ TEST(pctkAnyTest, copyEmplaceContent)
 
     CHECK( pctk::any_cast<pair_t>( &a )->first        == 'a'              );
     CHECK( pctk::any_cast<pair_t>( &a )->second.value ==  7               );
-#if CF_USES_STD_ANY
     CHECK( pctk::any_cast<pair_t>( &a )->second.state == copy_constructed );
-#else
-    CHECK( pctk::any_cast<pair_t>( &a )->second.state == move_constructed );
-#endif
     CHECK(                              v.state != moved_from       );
 #else
     CHECK(!!"pctk::Any: in-place construction is not available (no C++11)");
@@ -480,11 +468,7 @@ TEST(pctkAnyTest, copyEmplaceContentFromIntializerList)
     CHECK( pctk::any_cast<InitList>( &a )->vec[2]  ==  9  );
     CHECK( pctk::any_cast<InitList>( &a )->c       == 'a' );
     CHECK( pctk::any_cast<InitList>( &a )->s.value.value ==  7               );
-#if CF_USES_STD_ANY
     CHECK( pctk::any_cast<InitList>( &a )->s.state       == copy_constructed );
-#else
-    CHECK( pctk::any_cast<InitList>( &a )->s.state       == move_constructed );
-#endif
     CHECK(                           s.state       != moved_from       );
 #else
     CHECK(!!"pctk::Any: in-place construction is not available (no C++11)");
@@ -538,6 +522,7 @@ TEST(pctkAnyTest, inspectIfCFAnyContainsAValue)
     CHECK(a.hasValue());
 }
 
+#if PCTK_CC_FEATURE_RTTI
 TEST(pctkAnyTest, obtainTypeInfoOfCFAnysContent)
 {
     pctk::Any a = 7;
@@ -546,6 +531,7 @@ TEST(pctkAnyTest, obtainTypeInfoOfCFAnysContent)
     CHECK((a.type() == typeid(int)));
     CHECK((b.type() == typeid(double)));
 }
+#endif
 
 //
 // pctk::Any non-member functions:
@@ -568,15 +554,11 @@ TEST(pctkAnyTest, inplaceCopyConstructCFAnyFromArguments)
     using pair_t = std::pair<char, S>;
 
     S s( 7 );
-    pctk::Any a = make_any<pair_t>( 'a', s );
+    pctk::Any a = pctk::make_any<pair_t>( 'a', s );
 
     CHECK( pctk::any_cast<pair_t>( &a )->first              == 'a' );
     CHECK( pctk::any_cast<pair_t>( &a )->second.value.value ==  7  );
-#if CF_USES_STD_ANY
     CHECK( pctk::any_cast<pair_t>( &a )->second.state       == copy_constructed );
-#else
-    CHECK( pctk::any_cast<pair_t>( &a )->second.state       == move_constructed );
-#endif
     CHECK(                              s.state       != moved_from       );
 #else
     CHECK(!!"pctk::Any: in-place construction is not available (no C++11)");
@@ -589,7 +571,7 @@ TEST(pctkAnyTest, inplaceMoveConstructCFAnyFromArguments)
     using pair_t = std::pair<char, S>;
     S s( 7 );
 
-    pctk::Any a = make_any<pair_t>( 'a', std::move( s ) );
+    pctk::Any a = pctk::make_any<pair_t>( 'a', std::move( s ) );
 
     CHECK( pctk::any_cast<pair_t>( &a )->first              == 'a' );
     CHECK( pctk::any_cast<pair_t>( &a )->second.value.value ==  7  );
@@ -604,18 +586,14 @@ TEST(pctkAnyTest, inplaceCopyConstructCFAnyFromInitializerListAndArguments)
 {
 #if PCTK_CC_STDCXX_11
     S s( 7 );
-    pctk::Any a = make_any<InitList>( { 7, 8, 9, }, 'a', s );
+    pctk::Any a = pctk::make_any<InitList>( { 7, 8, 9, }, 'a', s );
 
     CHECK( pctk::any_cast<InitList>( &a )->vec[0]  ==  7  );
     CHECK( pctk::any_cast<InitList>( &a )->vec[1]  ==  8  );
     CHECK( pctk::any_cast<InitList>( &a )->vec[2]  ==  9  );
     CHECK( pctk::any_cast<InitList>( &a )->c       == 'a' );
     CHECK( pctk::any_cast<InitList>( &a )->s.value.value ==  7               );
-#if CF_USES_STD_ANY
     CHECK( pctk::any_cast<InitList>( &a )->s.state       == copy_constructed );
-#else
-    CHECK( pctk::any_cast<InitList>( &a )->s.state       == move_constructed );
-#endif
     CHECK(                           s.state       != moved_from       );
 #else
     CHECK(!!"pctk::Any: in-place construction is not available (no C++11)");
@@ -626,7 +604,7 @@ TEST(pctkAnyTest, inplaceMoveConstructCFAnyFromInitializerListAndArguments)
 {
 #if PCTK_CC_STDCXX_11
     S s( 7 );
-    pctk::Any a = make_any<InitList>( { 7, 8, 9, }, 'a', std::move( s ) );
+    pctk::Any a = pctk::make_any<InitList>( { 7, 8, 9, }, 'a', std::move( s ) );
 
     CHECK( pctk::any_cast<InitList>( &a )->vec[0]  ==  7  );
     CHECK( pctk::any_cast<InitList>( &a )->vec[1]  ==  8  );
@@ -792,6 +770,141 @@ TEST(pctkAnyTest, readsTweakHeaderIfSupported)
 #endif
 }
 
+TEST(pctkAnyTest, smallValuesAreStoredInline)
+{
+    struct Big
+    {
+        void *pointers[4];
+    };
+
+    CHECK(pctk::Any::isStoredInline<int>());
+    CHECK(pctk::Any::isStoredInline<void *>());
+    CHECK(pctk::Any::isStoredInline<double>());
+    CHECK((pctk::Any::isStoredInline<std::pair<char, int> >()));
+    CHECK_FALSE(pctk::Any::isStoredInline<Big>());
+    CHECK(sizeof(pctk::Any) == pctk::Any::InlineSize + sizeof(void *));
+}
+
+TEST(pctkAnyTest, moveLeavesSourceEmpty)
+{
+    pctk::Any a = std::string("inline or not");
+    pctk::Any b = 7;
+
+    pctk::Any c(std::move(a));
+    CHECK_FALSE(a.hasValue());
+    CHECK(pctk::any_cast<std::string>(c) == "inline or not");
+
+    c = std::move(b);
+    CHECK_FALSE(b.hasValue());
+    CHECK(pctk::any_cast<int>(c) == 7);
+}
+
+TEST(pctkAnyTest, copyKeepsHeapValuesIndependent)
+{
+    std::vector<int> values(16, 1);
+    pctk::Any a = values;
+    pctk::Any b = a;
+
+    pctk::any_cast<std::vector<int> >(&b)->push_back(2);
+
+    CHECK(pctk::any_cast<std::vector<int> >(&a)->size() == 16);
+    CHECK(pctk::any_cast<std::vector<int> >(&b)->size() == 17);
+}
+
+TEST(pctkAnyTest, swapMixedInlineAndHeapValues)
+{
+    pctk::Any a = 1;
+    pctk::Any b = std::vector<int>(3, 2);
+
+    a.swap(b);
+
+    CHECK(pctk::any_cast<std::vector<int> >(&a)->size() == 3);
+    CHECK(pctk::any_cast<int>(b) == 1);
+}
+
+TEST(pctkAnyTest, castToWrongTypeReturnsNull)
+{
+    pctk::Any a = 7;
+    const pctk::Any &c = a;
+
+    CHECK(pctk::any_cast<long>(&a) == PCTK_NULLPTR);
+    CHECK(pctk::any_cast<unsigned int>(&c) == PCTK_NULLPTR);
+    CHECK(pctk::any_cast<const int>(&c) != PCTK_NULLPTR);
+    CHECK(a.canConvert<int>());
+    CHECK_FALSE(a.canConvert<double>());
+}
+
+TEST(pctkAnyTest, compareValues)
+{
+    pctk::Any a = std::string("x");
+    pctk::Any b = std::string("x");
+    pctk::Any c = 1;
+    pctk::Any empty;
+
+    CHECK(a == b);
+    CHECK(a != c);
+    CHECK(empty == pctk::Any());
+    CHECK(empty != c);
+#if PCTK_CC_STDCXX_11
+    pctk::Any d = pctk::make_any<InitList>({1}, 'a', S(1));
+    /* InitList has no operator==, such values never compare equal, not even to themselves */
+    CHECK(d != d);
+    CHECK(d != pctk::Any(d));
+#endif
+}
+
+TEST(pctkAnyTest, emplaceReturnsReference)
+{
+    pctk::Any a = std::string("old");
+
+    std::pair<int, int> &pair = a.emplace<std::pair<int, int> >(1, 2);
+    pair.second = 3;
+
+    CHECK((pctk::any_cast<std::pair<int, int> >(a).second == 3));
+}
+
+namespace
+{
+template<std::size_t Size>
+struct Counted
+{
+    static int moves;
+    static int copies;
+
+    Counted(int first, int second) { data[0] = (char) first; data[Size - 1] = (char) second; }
+    Counted(const Counted &other) { ++copies; data[0] = other.data[0]; }
+    Counted(Counted &&other) PCTK_NOEXCEPT { ++moves; data[0] = other.data[0]; }
+
+    char data[Size];
+};
+template<std::size_t Size> int Counted<Size>::moves = 0;
+template<std::size_t Size> int Counted<Size>::copies = 0;
+} // namespace
+
+TEST(pctkAnyTest, inplaceConstructsWithoutMoves)
+{
+    typedef Counted<8> Small;
+    typedef Counted<256> Large;
+    CHECK(pctk::Any::isStoredInline<Small>());
+    CHECK_FALSE(pctk::Any::isStoredInline<Large>());
+
+    pctk::Any small(PCTK_IN_PLACE_TYPE(Small), 1, 2);
+    pctk::Any large(PCTK_IN_PLACE_TYPE(Large), 1, 2);
+    small.emplace<Small>(3, 4);
+    large.emplace<Large>(3, 4);
+    CHECK_EQUAL(0, Small::moves + Small::copies);
+    CHECK_EQUAL(0, Large::moves + Large::copies);
+    CHECK_EQUAL(3, pctk::any_cast<Small>(&small)->data[0]);
+    CHECK_EQUAL(3, pctk::any_cast<Large>(&large)->data[0]);
+}
+
+TEST(pctkAnyTest, moveValueOutOfRvalue)
+{
+    std::string value = pctk::any_cast<std::string>(pctk::Any(std::string("moved")));
+
+    CHECK(value == "moved");
+}
+
 int main(int ac, char **av)
 {
 #ifndef PCTK_TEST_ENABLE_MEMORYLEAK
@@ -27,9 +27,12 @@
 #include <CppUTest/TestHarness.h>
 #include <CppUTest/CommandLineTestRunner.h>
 
+#include <chrono>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 TEST_GROUP(pctkAtomicTest) {};
@@ -561,6 +564,193 @@ TEST(pctkAtomicTest, AtomicPointerFetchSubAdd)
     }
 }
 
+template<typename T>
+static void checkAtomicInteger()
+{
+    const T min = std::numeric_limits<T>::min();
+    const T max = std::numeric_limits<T>::max();
+    CHECK_EQUAL(PCTK_ATOMIC_BACKEND != PCTK_ATOMIC_BACKEND_POSIX, pctk::AtomicInteger<T>::isLockFree());
+    CHECK_EQUAL(sizeof(T), sizeof(pctk::AtomicInteger<T>));
+
+    pctk::AtomicInteger<T> atomic(max);
+    CHECK(max == atomic.loadAcquire());
+    CHECK(max == atomic.fetchAndAddRelaxed(1));
+    CHECK(min == atomic.load());
+    CHECK(min == atomic.fetchAndSubAcquire(1));
+    CHECK(max == atomic.loadAcquire());
+
+    CHECK(!atomic.testAndSetOrdered(min, T(0)));
+    CHECK(atomic.testAndSetRelease(max, T(0)));
+    CHECK(T(0) == atomic.fetchAndStoreOrdered(T(5)));
+    CHECK(T(5) == atomic.fetchAndOrRelaxed(T(2)));
+    CHECK(T(7) == atomic.fetchAndAndAcquire(T(6)));
+    CHECK(T(6) == atomic.fetchAndXorRelease(T(3)));
+    CHECK(T(5) == atomic.load());
+
+    CHECK(T(6) == ++atomic);
+    CHECK(T(6) == atomic--);
+    CHECK(T(9) == (atomic += T(4)));
+    CHECK(atomic.ref());
+    CHECK(atomic.deref());
+
+    pctk::AtomicInteger<T> copy = atomic;
+    CHECK(copy == atomic);
+}
+
+TEST(pctkAtomicTest, AtomicIntegerTypes)
+{
+    checkAtomicInteger<pctk_int8_t>();
+    checkAtomicInteger<pctk_uint8_t>();
+    checkAtomicInteger<pctk_int16_t>();
+    checkAtomicInteger<pctk_uint16_t>();
+    checkAtomicInteger<pctk_int32_t>();
+    checkAtomicInteger<pctk_uint32_t>();
+    checkAtomicInteger<pctk_int64_t>();
+    checkAtomicInteger<pctk_uint64_t>();
+    checkAtomicInteger<pctk_size_t>();
+}
+
+TEST(pctkAtomicTest, AtomicIntegerConcurrentAdd)
+{
+    const int threadCount = 4;
+    const int iterations = 100000;
+    pctk::AtomicInteger<pctk_uint64_t> counter;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i)
+    {
+        threads.push_back(std::thread([&counter]() {
+            for (int j = 0; j < iterations; ++j)
+            {
+                counter.fetchAndAddRelaxed(1);
+            }
+        }));
+    }
+    for (int i = 0; i < threadCount; ++i)
+    {
+        threads[i].join();
+    }
+    CHECK(pctk_uint64_t(threadCount * iterations) == counter.loadAcquire());
+}
+
+#if PCTK_ATOMIC_HAS_DOUBLE_WORD_CAS
+TEST(pctkAtomicTest, AtomicDoubleWord)
+{
+    typedef pctk::AtomicDoubleWord::Value Value;
+    const Value initial = pctk::AtomicDoubleWord::make(1, 2);
+    pctk::AtomicDoubleWord atomic(initial);
+    CHECK(pctk::AtomicDoubleWord::isLockFree());
+    CHECK(initial == atomic.loadAcquire());
+
+    const Value next = pctk::AtomicDoubleWord::make(3, 4);
+    CHECK(!atomic.testAndSetOrdered(next, initial));
+    Value current = 0;
+    CHECK(!atomic.testAndSetOrdered(next, next, current));
+    CHECK(initial == current);
+    CHECK(atomic.testAndSetAcquire(initial, next));
+    CHECK_EQUAL(3u, (unsigned) pctk::AtomicDoubleWord::low(atomic.load()));
+    CHECK_EQUAL(4u, (unsigned) pctk::AtomicDoubleWord::high(atomic.load()));
+    CHECK(next == atomic.fetchAndStoreOrdered(initial));
+    CHECK(initial == atomic.load());
+}
+
+TEST(pctkAtomicTest, AtomicDoubleWordConcurrentTag)
+{
+    /* pointer/tag style update: both halves must always move together */
+    const int threadCount = 4;
+    const int iterations = 20000;
+    pctk::AtomicDoubleWord atomic;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i)
+    {
+        threads.push_back(std::thread([&atomic]() {
+            for (int j = 0; j < iterations; ++j)
+            {
+                pctk::AtomicDoubleWord::Value current = atomic.loadAcquire();
+                pctk::AtomicDoubleWord::Value desired;
+                do
+                {
+                    desired = pctk::AtomicDoubleWord::make(pctk::AtomicDoubleWord::low(current) + 1,
+                                                           pctk::AtomicDoubleWord::high(current) + 2);
+                } while (!atomic.testAndSetOrdered(current, desired, current));
+            }
+        }));
+    }
+    for (int i = 0; i < threadCount; ++i)
+    {
+        threads[i].join();
+    }
+    const pctk::AtomicDoubleWord::Value result = atomic.loadAcquire();
+    CHECK(pctk_uint64_t(threadCount * iterations) == pctk::AtomicDoubleWord::low(result));
+    CHECK(pctk_uint64_t(2 * threadCount * iterations) == pctk::AtomicDoubleWord::high(result));
+}
+#endif
+
+TEST(pctkAtomicTest, AtomicIntWaitNotify)
+{
+    pctk::AtomicInt state(0);
+    pctk::AtomicInt woken(0);
+    const int threadCount = 4;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i)
+    {
+        threads.push_back(std::thread([&state, &woken]() {
+            state.wait(0);
+            woken.fetchAndAddOrdered(1);
+        }));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK_EQUAL(0, woken.loadAcquire());
+
+    state.storeRelease(1);
+    state.notifyAll();
+    for (int i = 0; i < threadCount; ++i)
+    {
+        threads[i].join();
+    }
+    CHECK_EQUAL(threadCount, woken.loadAcquire());
+}
+
+TEST(pctkAtomicTest, AtomicIntWaitNotifyOnePingPong)
+{
+    const int rounds = 1000;
+    pctk::AtomicInt turn(0);
+    std::thread peer([&turn]() {
+        for (int i = 0; i < rounds; ++i)
+        {
+            turn.wait(0);
+            turn.storeRelease(0);
+            turn.notifyOne();
+        }
+    });
+    for (int i = 0; i < rounds; ++i)
+    {
+        turn.storeRelease(1);
+        turn.notifyOne();
+        turn.wait(1);
+    }
+    peer.join();
+    CHECK_EQUAL(0, turn.loadAcquire());
+}
+
+TEST(pctkAtomicTest, AtomicIntWaitFor)
+{
+    pctk::AtomicInt state(7);
+    CHECK(state.waitFor(3, PCTK_NSECS_PER_SEC));
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    CHECK(!state.waitFor(7, 20 * PCTK_NSECS_PER_MSEC));
+    CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+
+    std::thread setter([&state]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        state.storeRelease(8);
+        state.notifyOne();
+    });
+    CHECK(state.waitFor(7, 10 * pctk_int64_t(PCTK_NSECS_PER_SEC)));
+    CHECK_EQUAL(8, state.loadAcquire());
+    setter.join();
+}
+
 int main(int ac, char **av)
 {
 #ifndef PCTK_TEST_ENABLE_MEMORYLEAK
@@ -0,0 +1,131 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkCacheLine.h>
+#include <pctkStripedCounter.h>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <thread>
+#include <vector>
+
+TEST_GROUP(pctkCacheLineTest) {};
+
+TEST(pctkCacheLineTest, CacheLineSize)
+{
+    CHECK_EQUAL(PCTK_CACHELINE_SIZE, pctk::CacheLine::size());
+    CHECK(0 == (PCTK_CACHELINE_SIZE & (PCTK_CACHELINE_SIZE - 1)));
+    const int runtime = pctk::CacheLine::runtimeSize();
+    CHECK(runtime >= 0);
+    CHECK_EQUAL(runtime, pctk::CacheLine::runtimeSize());
+    if (runtime > 0)
+    {
+        CHECK(pctk::CacheLine::checkRuntimeSize());
+    }
+}
+
+TEST(pctkCacheLineTest, CacheAligned)
+{
+    pctk::CacheAligned<int> values[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        *values[i] = i;
+        CHECK_EQUAL(0u, (unsigned) ((pctk_uintptr_t) &values[i].get() % PCTK_CACHELINE_SIZE));
+    }
+    for (int i = 1; i < 4; ++i)
+    {
+        CHECK(!pctk::CacheLine::isSameLine(&values[i - 1].get(), &values[i].get()));
+        CHECK_EQUAL(i, values[i].get());
+    }
+
+    pctk::CacheAligned<std::vector<int> > vector(std::vector<int>(3, 7));
+    CHECK_EQUAL(3u, (unsigned) vector->size());
+}
+
+TEST(pctkCacheLineTest, PaddedAtomic)
+{
+    pctk::AtomicInt packed[2];
+    CHECK(pctk::CacheLine::isSameLine(&packed[0], &packed[1]));
+
+    pctk::PaddedAtomic<int> padded[2];
+    CHECK_EQUAL(PCTK_CACHELINE_SIZE, (int) sizeof(padded[0]));
+    CHECK(!pctk::CacheLine::isSameLine(&padded[0], &padded[1]));
+
+    padded[0] = 5;
+    CHECK_EQUAL(5, padded[0].fetchAndAddOrdered(2));
+    CHECK_EQUAL(7, padded[0].loadAcquire());
+    padded[1] = padded[0];
+    CHECK_EQUAL(7, padded[1].load());
+}
+
+TEST(pctkCacheLineTest, StripedCounter)
+{
+    pctk::StripedCounter counter(3);
+    CHECK_EQUAL(4, counter.stripeCount());
+    CHECK_EQUAL(0, (int) counter.sum());
+    ++counter;
+    counter += 10;
+    counter -= 4;
+    --counter;
+    CHECK_EQUAL(6, (int) counter.sum());
+    counter.reset();
+    CHECK_EQUAL(0, (int) counter.sum());
+
+    pctk::StripedCounter perCpu;
+    CHECK(perCpu.stripeCount() >= 1);
+    CHECK_EQUAL(0, perCpu.stripeCount() & (perCpu.stripeCount() - 1));
+}
+
+TEST(pctkCacheLineTest, StripedCounterConcurrent)
+{
+    const int threadCount = 8;
+    const int iterations = 50000;
+    pctk::StripedCounter counter;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i)
+    {
+        threads.push_back(std::thread([&counter]() {
+            for (int j = 0; j < iterations; ++j)
+            {
+                counter.add(2);
+                counter.sub(1);
+            }
+        }));
+    }
+    for (int i = 0; i < threadCount; ++i)
+    {
+        threads[i].join();
+    }
+    CHECK_EQUAL(threadCount * iterations, (int) counter.sum());
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
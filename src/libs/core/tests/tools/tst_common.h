@@ -0,0 +1,81 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#ifndef _PCTKTSTCOMMON_H
+#define _PCTKTSTCOMMON_H
+
+#include <pctkGlobal.h>
+
+#include <string>
+
+#include <CppUTest/TestHarness.h>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Filesystem helpers shared by the tst_*.cpp programs that work on scratch directories. Include it after the standard
+ * headers, CppUTest redefines new. */
+namespace tst
+{
+inline void write(const std::string &path, const std::string &content, mode_t mode = 0644)
+{
+    const int fd = ::open(path.c_str(), O_CREAT | O_WRONLY | O_TRUNC | O_CLOEXEC, mode);
+    CHECK(fd >= 0);
+    CHECK_EQUAL((long) content.size(), (long) ::write(fd, content.data(), content.size()));
+    ::close(fd);
+}
+
+/* The content of path, "<missing>" if it cannot be opened. */
+inline std::string read(const std::string &path)
+{
+    std::string content;
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return "<missing>";
+    }
+    char buffer[4096];
+    ssize_t count;
+    while ((count = ::read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        content.append(buffer, (std::size_t) count);
+    }
+    ::close(fd);
+    return content;
+}
+
+/* A new directory /tmp/pctk_tst_<name>_XXXXXX, the test removes it. */
+inline std::string makeTemp(const char *name)
+{
+    std::string pattern = std::string("/tmp/pctk_tst_") + name + "_XXXXXX";
+    const char *root = ::mkdtemp(&pattern[0]);
+    CHECK(PCTK_NULLPTR != root);
+    return pattern;
+}
+} // namespace tst
+
+#endif //_PCTKTSTCOMMON_H
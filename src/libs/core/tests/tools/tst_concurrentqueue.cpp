@@ -0,0 +1,341 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkConcurrentQueue.h>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+/* Counts live instances and checks that every destroyed instance was constructed at that address. */
+struct Tracked
+{
+    static pctk::AtomicInt alive;
+
+    Tracked *self;
+    int value;
+
+    Tracked(int v = 0) : self(this), value(v) { alive.fetchAndAddRelaxed(1); }
+    Tracked(const Tracked &other) : self(this), value(other.value) { alive.fetchAndAddRelaxed(1); }
+    Tracked &operator=(const Tracked &other)
+    {
+        value = other.value;
+        return *this;
+    }
+    ~Tracked()
+    {
+        CHECK(self == this);
+        alive.fetchAndSubRelaxed(1);
+    }
+};
+pctk::AtomicInt Tracked::alive(0);
+
+/* Relocatable: owns heap memory but may be moved around with memcpy. */
+struct Handle
+{
+    int *value;
+
+    Handle(int v = 0) : value(new int(v)) {}
+    Handle(const Handle &other) : value(new int(*other.value)) {}
+    Handle &operator=(const Handle &other)
+    {
+        *value = *other.value;
+        return *this;
+    }
+    ~Handle() { delete value; }
+};
+
+template<typename Queue>
+void runProducersConsumers(Queue &queue, int producers, int consumers, int perProducer, bool batched)
+{
+    pctk::AtomicInteger<pctk_int64_t> sum(0);
+    pctk::AtomicInt received(0);
+    pctk::AtomicInt outOfOrder(0);
+    const int total = producers * perProducer;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.push_back(std::thread([&, p]() {
+            if (batched)
+            {
+                std::vector<int> batch;
+                for (int i = 0; i < perProducer; ++i)
+                {
+                    batch.push_back(p * perProducer + i);
+                }
+                for (int i = 0; i < perProducer; i += 7)
+                {
+                    const int count = perProducer - i < 7 ? perProducer - i : 7;
+                    queue.pushN(&batch[i], (std::size_t) count);
+                }
+            }
+            else
+            {
+                for (int i = 0; i < perProducer; ++i)
+                {
+                    queue.push(p * perProducer + i);
+                }
+            }
+        }));
+    }
+    for (int c = 0; c < consumers; ++c)
+    {
+        threads.push_back(std::thread([&]() {
+            std::vector<int> last(producers, -1);
+            int items[16];
+            while (received.loadAcquire() < total)
+            {
+                std::size_t count = 0;
+                if (batched)
+                {
+                    count = queue.tryPopN(items, 16);
+                }
+                else if (queue.tryPop(items[0]))
+                {
+                    count = 1;
+                }
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    /* every producer's items leave the queue in the order it pushed them */
+                    const int producer = items[i] / perProducer;
+                    if (items[i] <= last[producer])
+                    {
+                        outOfOrder.fetchAndAddRelaxed(1);
+                    }
+                    last[producer] = items[i];
+                    sum.fetchAndAddRelaxed(items[i]);
+                }
+                if (count > 0)
+                {
+                    received.fetchAndAddOrdered((int) count);
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+    for (std::size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i].join();
+    }
+    CHECK_EQUAL(total, received.loadAcquire());
+    CHECK_EQUAL((pctk_int64_t) total * (total - 1) / 2, sum.loadAcquire());
+    CHECK_EQUAL(0, outOfOrder.loadAcquire());
+    CHECK(queue.isEmpty());
+}
+} // namespace
+
+PCTK_BEGIN_NAMESPACE
+PCTK_DECL_TYPEINFO(Handle, PCTK_TYPEINFO_MOVABLE);
+PCTK_END_NAMESPACE
+
+TEST_GROUP(pctkConcurrentQueueTest) {};
+
+TEST(pctkConcurrentQueueTest, MpmcSingleThread)
+{
+    pctk::MpmcQueue<int> queue(5);
+    CHECK_EQUAL(8u, (unsigned) queue.capacity());
+    CHECK(queue.isEmpty());
+    int value = -1;
+    CHECK(!queue.tryPop(value));
+    for (int i = 0; i < 8; ++i)
+    {
+        CHECK(queue.tryPush(i));
+    }
+    CHECK(!queue.tryPush(8));
+    CHECK_EQUAL(8u, (unsigned) queue.size());
+    for (int round = 0; round < 100; ++round)
+    {
+        CHECK(queue.tryPop(value));
+        CHECK_EQUAL(round, value);
+        CHECK(queue.tryPush(round + 8));
+    }
+    for (int i = 0; i < 8; ++i)
+    {
+        CHECK(queue.tryPop(value));
+        CHECK_EQUAL(100 + i, value);
+    }
+    CHECK(queue.isEmpty());
+}
+
+TEST(pctkConcurrentQueueTest, MpmcBatches)
+{
+    pctk::MpmcQueue<int> queue(16);
+    int items[20];
+    for (int i = 0; i < 20; ++i)
+    {
+        items[i] = i;
+    }
+    CHECK_EQUAL(10u, (unsigned) queue.tryPushN(items, 10));
+    CHECK_EQUAL(6u, (unsigned) queue.tryPushN(items + 10, 10));
+    CHECK_EQUAL(0u, (unsigned) queue.tryPushN(items, 1));
+
+    int out[20] = {0};
+    CHECK_EQUAL(4u, (unsigned) queue.tryPopN(out, 4));
+    CHECK_EQUAL(12u, (unsigned) queue.tryPopN(out + 4, 20));
+    CHECK_EQUAL(0u, (unsigned) queue.tryPopN(out, 20));
+    for (int i = 0; i < 16; ++i)
+    {
+        CHECK_EQUAL(i, out[i]);
+    }
+}
+
+TEST(pctkConcurrentQueueTest, MpmcPayloads)
+{
+    {
+        pctk::MpmcQueue<Tracked> queue(4);
+        CHECK(queue.tryPush(Tracked(1)));
+        CHECK(queue.tryEmplace(2));
+        Tracked out;
+        CHECK(queue.tryPop(out));
+        CHECK_EQUAL(1, out.value);
+        CHECK(queue.tryEmplace(3));
+        CHECK(queue.tryEmplace(4));
+        CHECK_EQUAL(4, Tracked::alive.loadAcquire());
+    }
+    CHECK_EQUAL(0, Tracked::alive.loadAcquire());
+
+    pctk::MpmcQueue<Handle> handles(4);
+    Handle batch[3] = {Handle(7), Handle(8), Handle(9)};
+    CHECK_EQUAL(3u, (unsigned) handles.tryPushN(batch, 3));
+    Handle out[3];
+    CHECK_EQUAL(3u, (unsigned) handles.tryPopN(out, 3));
+    CHECK_EQUAL(7, *out[0].value);
+    CHECK_EQUAL(9, *out[2].value);
+    CHECK(out[0].value != batch[0].value);
+
+    pctk::MpmcQueue<std::string> strings(2);
+    strings.push(std::string(100, 'x'));
+    std::string text;
+    strings.pop(text);
+    CHECK_EQUAL(100u, (unsigned) text.size());
+}
+
+TEST(pctkConcurrentQueueTest, MpmcConcurrent)
+{
+    pctk::MpmcQueue<int> spinning(64);
+    runProducersConsumers(spinning, 4, 4, 20000, false);
+    pctk::MpmcQueue<int> blocking(64, pctk::QueueWaitBlock);
+    runProducersConsumers(blocking, 4, 4, 20000, true);
+}
+
+TEST(pctkConcurrentQueueTest, MpmcBlockingWaits)
+{
+    pctk::MpmcQueue<int> queue(2, pctk::QueueWaitBlock);
+    int value = 0;
+    std::thread consumer([&]() { queue.pop(value); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.push(42);
+    consumer.join();
+    CHECK_EQUAL(42, value);
+
+    queue.push(1);
+    queue.push(2);
+    std::thread producer([&]() { queue.push(3); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    int out[4];
+    std::size_t popped = queue.popN(out, 4);
+    producer.join();
+    while (popped < 3)
+    {
+        popped += queue.popN(out + popped, 4 - popped);
+    }
+    CHECK_EQUAL(1, out[0]);
+    CHECK_EQUAL(3, out[2]);
+}
+
+TEST(pctkConcurrentQueueTest, SpscSingleThread)
+{
+    pctk::SpscRing<int> ring(3);
+    CHECK_EQUAL(4u, (unsigned) ring.capacity());
+    CHECK(ring.front() == PCTK_NULLPTR);
+    int items[6] = {0, 1, 2, 3, 4, 5};
+    int out[6] = {0};
+    /* batches that wrap around the end of the buffer */
+    for (int round = 0; round < 50; ++round)
+    {
+        CHECK_EQUAL(3u, (unsigned) ring.tryPushN(items, 3));
+        CHECK_EQUAL(1u, (unsigned) ring.tryPushN(items + 3, 3));
+        CHECK(!ring.tryPush(9));
+        CHECK_EQUAL(4u, (unsigned) ring.tryPopN(out, 6));
+        for (int i = 0; i < 4; ++i)
+        {
+            CHECK_EQUAL(i, out[i]);
+        }
+    }
+    CHECK(ring.isEmpty());
+    CHECK(ring.tryPush(5));
+    CHECK_EQUAL(5, *ring.front());
+    ring.popFront();
+    CHECK(ring.isEmpty());
+}
+
+TEST(pctkConcurrentQueueTest, SpscPayloads)
+{
+    {
+        pctk::SpscRing<Tracked> ring(4);
+        Tracked batch[3] = {Tracked(1), Tracked(2), Tracked(3)};
+        CHECK_EQUAL(3u, (unsigned) ring.tryPushN(batch, 3));
+        Tracked out[2];
+        CHECK_EQUAL(2u, (unsigned) ring.tryPopN(out, 2));
+        CHECK_EQUAL(2, out[1].value);
+        CHECK_EQUAL(6, Tracked::alive.loadAcquire());
+    }
+    CHECK_EQUAL(0, Tracked::alive.loadAcquire());
+
+    pctk::SpscRing<Handle> handles(4);
+    for (int round = 0; round < 10; ++round)
+    {
+        Handle batch[3] = {Handle(round), Handle(round + 1), Handle(round + 2)};
+        CHECK_EQUAL(3u, (unsigned) handles.tryPushN(batch, 3));
+        Handle out[3];
+        CHECK_EQUAL(3u, (unsigned) handles.tryPopN(out, 3));
+        CHECK_EQUAL(round + 2, *out[2].value);
+    }
+}
+
+TEST(pctkConcurrentQueueTest, SpscConcurrent)
+{
+    pctk::SpscRing<int> spinning(64);
+    runProducersConsumers(spinning, 1, 1, 200000, false);
+    pctk::SpscRing<int> blocking(64, pctk::QueueWaitBlock);
+    runProducersConsumers(blocking, 1, 1, 200000, true);
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
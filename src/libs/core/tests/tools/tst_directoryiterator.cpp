@@ -0,0 +1,255 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkDirectoryIterator.h>
+#include <pctkFileSystem.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <system_error>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+void touch(const std::string &path)
+{
+    const int fd = ::open(path.c_str(), O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+    CHECK(fd >= 0);
+    ::close(fd);
+}
+
+/* root/{a.txt b.log .hidden sub/{c.txt deep/d.txt} skip/e.txt link->sub loop/back->..} */
+std::string makeTree()
+{
+    char pattern[] = "/tmp/pctk_tst_dir_XXXXXX";
+    const char *root = ::mkdtemp(pattern);
+    CHECK(PCTK_NULLPTR != root);
+    const std::string base(root);
+    touch(base + "/a.txt");
+    touch(base + "/b.log");
+    touch(base + "/.hidden");
+    CHECK_EQUAL(0, ::mkdir((base + "/sub").c_str(), 0755));
+    touch(base + "/sub/c.txt");
+    CHECK_EQUAL(0, ::mkdir((base + "/sub/deep").c_str(), 0755));
+    touch(base + "/sub/deep/d.txt");
+    CHECK_EQUAL(0, ::mkdir((base + "/skip").c_str(), 0755));
+    touch(base + "/skip/e.txt");
+    CHECK_EQUAL(0, ::symlink("sub", (base + "/link").c_str()));
+    CHECK_EQUAL(0, ::mkdir((base + "/loop").c_str(), 0755));
+    CHECK_EQUAL(0, ::symlink("..", (base + "/loop/back").c_str()));
+    return base;
+}
+
+void removeTree(const std::string &root)
+{
+    pctk::FileSystem fileSystem;
+    fileSystem.removeDirectoryRecursive(root);
+}
+
+std::set<std::string> walk(pctk::DirectoryIterator &iterator)
+{
+    std::set<std::string> paths;
+    while (iterator.next())
+    {
+        paths.insert(iterator.entry().relativePath());
+    }
+    return paths;
+}
+} // namespace
+
+TEST_GROUP(pctkDirectoryIteratorTest) {};
+
+TEST(pctkDirectoryIteratorTest, ListsOneDirectory)
+{
+    const std::string root = makeTree();
+    {
+        pctk::DirectoryIterator iterator(root);
+        std::set<std::string> names;
+        while (iterator.next())
+        {
+            const pctk::DirectoryEntry &entry = iterator.entry();
+            const std::string name(entry.name(), entry.nameLength());
+            names.insert(name);
+            CHECK_EQUAL(0, entry.depth());
+            CHECK(root + "/" + name == entry.path());
+            CHECK(0 != entry.inode());
+            if ("sub" == name)
+            {
+                CHECK(entry.isDirectory());
+            }
+            else if ("link" == name)
+            {
+                CHECK(entry.isSymlink());
+            }
+            else if ("a.txt" == name)
+            {
+                CHECK(entry.isFile());
+                struct stat buffer;
+                CHECK_EQUAL(0, ::fstatat(entry.directoryFd(), entry.name(), &buffer, 0));
+            }
+        }
+        const char *expected[] = {".hidden", "a.txt", "b.log", "link", "loop", "skip", "sub"};
+        CHECK(std::set<std::string>(expected, expected + PCTK_ELEMENTS_NUM(expected)) == names);
+        CHECK(!iterator.next());
+    }
+    {
+        pctk::DirectoryIterator iterator(root, pctk::DirectoryIterator::SkipHidden);
+        CHECK_EQUAL(6u, (unsigned) walk(iterator).size());
+    }
+    removeTree(root);
+}
+
+TEST(pctkDirectoryIteratorTest, RecursiveWalk)
+{
+    const std::string root = makeTree();
+    {
+        pctk::RecursiveDirectoryIterator iterator(root);
+        std::set<std::string> paths;
+        while (iterator.next())
+        {
+            const pctk::DirectoryEntry &entry = iterator.entry();
+            const std::string relative = entry.relativePath();
+            paths.insert(relative);
+            CHECK_EQUAL((int) std::count(relative.begin(), relative.end(), '/'), entry.depth());
+            CHECK(root + "/" + relative == entry.path());
+        }
+        const char *expected[] = {".hidden", "a.txt", "b.log", "link", "loop", "loop/back", "skip", "skip/e.txt",
+                                  "sub", "sub/c.txt", "sub/deep", "sub/deep/d.txt"};
+        CHECK(std::set<std::string>(expected, expected + PCTK_ELEMENTS_NUM(expected)) == paths);
+    }
+    {
+        pctk::RecursiveDirectoryIterator iterator(root);
+        iterator.setMaxDepth(0);
+        CHECK_EQUAL(7u, (unsigned) walk(iterator).size());
+    }
+    {
+        /* a directory is listed before its contents, which skipChildren() leaves out */
+        pctk::RecursiveDirectoryIterator iterator(root);
+        std::set<std::string> paths;
+        while (iterator.next())
+        {
+            const std::string relative = iterator.entry().relativePath();
+            CHECK(paths.end() == paths.find("sub") || "sub" != relative.substr(0, 3) || "sub" == relative);
+            paths.insert(relative);
+            if ("sub" == relative)
+            {
+                iterator.skipChildren();
+            }
+        }
+        CHECK(paths.end() != paths.find("sub"));
+        CHECK(paths.end() == paths.find("sub/c.txt"));
+        CHECK(paths.end() != paths.find("skip/e.txt"));
+    }
+    removeTree(root);
+}
+
+TEST(pctkDirectoryIteratorTest, Filters)
+{
+    const std::string root = makeTree();
+    {
+        pctk::RecursiveDirectoryIterator iterator(root, pctk::DirectoryIterator::SkipDirectories);
+        iterator.addIncludePattern("*.txt");
+        const char *expected[] = {"a.txt", "skip/e.txt", "sub/c.txt", "sub/deep/d.txt"};
+        CHECK(std::set<std::string>(expected, expected + PCTK_ELEMENTS_NUM(expected)) == walk(iterator));
+    }
+    {
+        pctk::RecursiveDirectoryIterator iterator(root, pctk::DirectoryIterator::SkipHidden);
+        iterator.addExcludePattern("skip");
+        iterator.addExcludePattern("*.log");
+        iterator.addExcludePattern("l*");
+        const char *expected[] = {"a.txt", "sub", "sub/c.txt", "sub/deep", "sub/deep/d.txt"};
+        CHECK(std::set<std::string>(expected, expected + PCTK_ELEMENTS_NUM(expected)) == walk(iterator));
+    }
+    removeTree(root);
+}
+
+TEST(pctkDirectoryIteratorTest, FollowSymlinksStopsAtLoops)
+{
+    const std::string root = makeTree();
+    {
+        pctk::RecursiveDirectoryIterator iterator(root, pctk::DirectoryIterator::FollowSymlinks);
+        const std::set<std::string> paths = walk(iterator);
+        CHECK(paths.end() != paths.find("link/c.txt"));
+        CHECK(paths.end() != paths.find("link/deep/d.txt"));
+        /* loop/back leads to the root, which is being walked */
+        CHECK(paths.end() != paths.find("loop/back"));
+        CHECK(paths.end() == paths.find("loop/back/a.txt"));
+        CHECK_EQUAL(15u, (unsigned) paths.size());
+    }
+    removeTree(root);
+}
+
+TEST(pctkDirectoryIteratorTest, LargeDirectoryAndErrors)
+{
+    const std::string root = makeTree();
+    const int files = 5000;
+    for (int i = 0; i < files; ++i)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "/sub/deep/file-with-a-longer-name-%05d", i);
+        touch(root + name);
+    }
+    {
+        pctk::RecursiveDirectoryIterator iterator(root, pctk::DirectoryIterator::SkipDirectories);
+        iterator.addIncludePattern("file-*");
+        std::size_t count = 0;
+        while (iterator.next())
+        {
+            CHECK_EQUAL(2, iterator.entry().depth());
+            ++count;
+        }
+        CHECK_EQUAL((std::size_t) files, count);
+    }
+    removeTree(root);
+
+    int error = 0;
+    try
+    {
+        pctk::DirectoryIterator iterator(root);
+    }
+    catch (const std::system_error &e)
+    {
+        error = e.code().value();
+    }
+    CHECK_EQUAL(ENOENT, error);
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
@@ -0,0 +1,439 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkEventLoop.h>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <chrono>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+const pctk_int64_t MSec = PCTK_NSECS_PER_MSEC;
+
+/* Every backend this machine can run, a test body runs once per backend. */
+std::vector<pctk::EventLoop::Backend> availableBackends()
+{
+    std::vector<pctk::EventLoop::Backend> backends;
+    const pctk::EventLoop::Backend candidates[] = {pctk::EventLoop::Epoll, pctk::EventLoop::IoUring,
+                                                   pctk::EventLoop::Libuv};
+    for (std::size_t i = 0; i < PCTK_ELEMENTS_NUM(candidates); ++i)
+    {
+        try
+        {
+            pctk::EventLoop loop(candidates[i]);
+            backends.push_back(candidates[i]);
+        }
+        catch (const std::system_error &)
+        {
+        }
+    }
+    return backends;
+}
+
+/* Runs iterations until done() holds, failing after a second. */
+template<typename F>
+bool processUntil(pctk::EventLoop &loop, F done)
+{
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (!done())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        loop.processEvents(10 * MSec);
+    }
+    return true;
+}
+
+struct Pipe
+{
+    Pipe() { CHECK_EQUAL(0, ::pipe(fds)); }
+    ~Pipe()
+    {
+        this->closeRead();
+        this->closeWrite();
+    }
+    void closeRead()
+    {
+        if (fds[0] >= 0)
+        {
+            ::close(fds[0]);
+            fds[0] = -1;
+        }
+    }
+    void closeWrite()
+    {
+        if (fds[1] >= 0)
+        {
+            ::close(fds[1]);
+            fds[1] = -1;
+        }
+    }
+
+    int fds[2];
+};
+} // namespace
+
+TEST_GROUP(pctkEventLoopTest) {};
+
+TEST(pctkEventLoopTest, Backends)
+{
+    const std::vector<pctk::EventLoop::Backend> backends = availableBackends();
+    CHECK(!backends.empty());
+    pctk::EventLoop loop;
+    CHECK(pctk::EventLoop::Auto != loop.backend());
+#if PCTK_FEATURE_LIBUV_BACKEND
+    CHECK_EQUAL(pctk::EventLoop::Libuv, loop.backend());
+#elif defined(PCTK_OS_LINUX)
+    CHECK_EQUAL(pctk::EventLoop::Epoll, loop.backend());
+#endif
+    STRCMP_EQUAL("epoll", pctk::EventLoop::backendName(pctk::EventLoop::Epoll));
+}
+
+TEST(pctkEventLoopTest, PipeIsLevelTriggered)
+{
+    const std::vector<pctk::EventLoop::Backend> backends = availableBackends();
+    for (std::size_t b = 0; b < backends.size(); ++b)
+    {
+        pctk::EventLoop loop(backends[b]);
+        Pipe pipe;
+        int calls = 0;
+        int seen = 0;
+        const pctk::EventLoop::WatchId id = loop.watch(pipe.fds[0], pctk::EventLoop::Readable, [&](int fd, int events) {
+            CHECK_EQUAL(pipe.fds[0], fd);
+            seen = events;
+            ++calls;
+        });
+        CHECK(0 != id);
+        loop.processEvents(0);
+        CHECK_EQUAL(0, calls);
+
+        CHECK_EQUAL(2, (int) ::write(pipe.fds[1], "ab", 2));
+        CHECK(processUntil(loop, [&]() { return calls > 0; }));
+        CHECK_EQUAL(pctk::EventLoop::Readable, seen);
+        /* unread data keeps the fd ready */
+        loop.processEvents(10 * MSec);
+        CHECK(calls >= 2);
+
+        char buffer[2];
+        CHECK_EQUAL(2, (int) ::read(pipe.fds[0], buffer, 2));
+        loop.processEvents(0);
+        const int drained = calls;
+        loop.processEvents(5 * MSec);
+        CHECK_EQUAL(drained, calls);
+
+        CHECK(loop.unwatch(id));
+        CHECK(!loop.unwatch(id));
+        CHECK(!loop.modify(id, pctk::EventLoop::Writable));
+    }
+}
+
+TEST(pctkEventLoopTest, ModifyAndHangUp)
+{
+    const std::vector<pctk::EventLoop::Backend> backends = availableBackends();
+    for (std::size_t b = 0; b < backends.size(); ++b)
+    {
+        pctk::EventLoop loop(backends[b]);
+        int pair[2];
+        CHECK_EQUAL(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, pair));
+        int seen = 0;
+        const pctk::EventLoop::WatchId id = loop.watch(pair[0], pctk::EventLoop::Writable, [&](int, int events) {
+            seen |= events;
+        });
+        CHECK(processUntil(loop, [&]() { return 0 != seen; }));
+        CHECK_EQUAL(pctk::EventLoop::Writable, seen);
+
+        CHECK(loop.modify(id, pctk::EventLoop::Readable));
+        seen = 0;
+        loop.processEvents(5 * MSec);
+        CHECK_EQUAL(0, seen);
+
+        ::close(pair[1]);
+        CHECK(processUntil(loop, [&]() { return 0 != seen; }));
+        CHECK(seen & pctk::EventLoop::Readable);
+        CHECK(0 == (seen & pctk::EventLoop::Writable));
+        CHECK(loop.unwatch(id));
+        ::close(pair[0]);
+    }
+}
+
+TEST(pctkEventLoopTest, UnwatchFromCallbacks)
+{
+    const std::vector<pctk::EventLoop::Backend> backends = availableBackends();
+    for (std::size_t b = 0; b < backends.size(); ++b)
+    {
+        pctk::EventLoop loop(backends[b]);
+        Pipe first;
+        Pipe second;
+        pctk::EventLoop::WatchId firstId = 0;
+        pctk::EventLoop::WatchId secondId = 0;
+        int firstCalls = 0;
+        int secondCalls = 0;
+        /* each callback removes both watches, whichever runs first the other must not run with a dead watcher */
+        std::vector<int> owned(1, 42);
+        firstId = loop.watch(first.fds[0], pctk::EventLoop::Readable, [&, owned](int, int) {
+            CHECK_EQUAL(42, owned[0]);
+            ++firstCalls;
+            loop.unwatch(firstId);
+            loop.unwatch(secondId);
+        });
+        secondId = loop.watch(second.fds[0], pctk::EventLoop::Readable, [&, owned](int, int) {
+            CHECK_EQUAL(42, owned[0]);
+            ++secondCalls;
+            loop.unwatch(secondId);
+            loop.unwatch(firstId);
+        });
+        CHECK_EQUAL(1, (int) ::write(first.fds[1], "x", 1));
+        CHECK_EQUAL(1, (int) ::write(second.fds[1], "x", 1));
+        CHECK(processUntil(loop, [&]() { return firstCalls + secondCalls > 0; }));
+        loop.processEvents(5 * MSec);
+        CHECK_EQUAL(1, firstCalls + secondCalls);
+
+        /* a freed slot is reused under a new id */
+        const pctk::EventLoop::WatchId again = loop.watch(first.fds[0], pctk::EventLoop::Readable, [](int, int) {});
+        CHECK(again != firstId && again != secondId);
+        CHECK(!loop.unwatch(firstId));
+        CHECK(loop.unwatch(again));
+    }
+}
+
+TEST(pctkEventLoopTest, MoreReadyWatchesThanRingEntries)
+{
+    const std::vector<pctk::EventLoop::Backend> backends = availableBackends();
+    for (std::size_t b = 0; b < backends.size(); ++b)
+    {
+        /* every write end is writable at once, re-arming them all overflows the io_uring queues each iteration */
+        const std::size_t count = 1000;
+        pctk::EventLoop loop(backends[b]);
+        std::vector<Pipe> pipes(count);
+        std::vector<int> calls(count, 0);
+        std::vector<pctk::EventLoop::WatchId> ids(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            ids[i] = loop.watch(pipes[i].fds[1], pctk::EventLoop::Writable, [&calls, i](int, int) { ++calls[i]; });
+        }
+        CHECK(processUntil(loop, [&]() {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (calls[i] < 3)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }));
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            CHECK(loop.unwatch(ids[i]));
+        }
+        const std::vector<int> seen = calls;
+        loop.processEvents(5 * MSec);
+        CHECK(seen == calls);
+    }
+}
+
+TEST(pctkEventLoopTest, PostFromManyThreads)
+{
+    const std::vector<pctk::EventLoop::Backend> backends = availableBackends();
+    for (std::size_t b = 0; b < backends.size(); ++b)
+    {
+        pctk::EventLoop loop(backends[b]);
+        const int producers = 4;
+        const int perProducer = 2000;
+        int received = 0;
+        bool ordered = true;
+        bool onLoop = true;
+        std::vector<int> last(producers, -1);
+        std::thread runner([&]() { loop.run(); });
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+        {
+            threads.push_back(std::thread([&, p]() {
+                for (int i = 0; i < perProducer; ++i)
+                {
+                    loop.post([&, p, i]() {
+                        onLoop = onLoop && loop.isInLoopThread() && &loop == pctk::EventLoop::current();
+                        ordered = ordered && last[p] == i - 1;
+                        last[p] = i;
+                        if (++received == producers * perProducer)
+                        {
+                            loop.quit();
+                        }
+                    });
+                }
+            }));
+        }
+        for (std::size_t t = 0; t < threads.size(); ++t)
+        {
+            threads[t].join();
+        }
+        runner.join();
+        CHECK_EQUAL(producers * perProducer, received);
+        CHECK(ordered);
+        CHECK(onLoop);
+        CHECK(!loop.isInLoopThread());
+    }
+}
+
+TEST(pctkEventLoopTest, Timers)
+{
+    const std::vector<pctk::EventLoop::Backend> backends = availableBackends();
+    for (std::size_t b = 0; b < backends.size(); ++b)
+    {
+        pctk::EventLoop loop(backends[b]);
+        int fired = 0;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        loop.startTimer(20 * MSec, [&]() { ++fired; });
+        const pctk::EventLoop::TimerId cancelled = loop.startTimer(10 * MSec, [&]() { fired += 100; });
+        CHECK(loop.cancelTimer(cancelled));
+        /* a blocking wait is cut short by the timer */
+        while (0 == fired)
+        {
+            loop.processEvents(-1);
+        }
+        CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+        CHECK_EQUAL(1, fired);
+
+        pctk::Future<void> future = loop.after(5 * MSec);
+        CHECK(processUntil(loop, [&]() { return future.isReady(); }));
+
+        /* a timer started from another thread wakes a loop blocked without timers */
+        std::thread runner([&]() { loop.run(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        const std::chrono::steady_clock::time_point posted = std::chrono::steady_clock::now();
+        loop.startTimer(MSec, [&]() { loop.quit(); });
+        runner.join();
+        CHECK(std::chrono::steady_clock::now() - posted < std::chrono::milliseconds(500));
+    }
+}
+
+TEST(pctkEventLoopTest, QuitBeforeRunAndDestroyRunsPosted)
+{
+    int ran = 0;
+    Pipe pipe;
+    {
+        pctk::EventLoop loop;
+        loop.quit();
+        loop.run();
+        loop.post([&]() { ++ran; });
+        loop.watch(pipe.fds[0], pctk::EventLoop::Readable, [](int, int) {});
+    }
+    CHECK_EQUAL(1, ran);
+}
+
+TEST(pctkEventLoopTest, GroupSharesReusePort)
+{
+    int listeners[2];
+    listeners[0] = pctk::EventLoopGroup::listenReusePort("127.0.0.1", 0);
+    struct sockaddr_in address;
+    socklen_t length = sizeof(address);
+    CHECK_EQUAL(0, ::getsockname(listeners[0], reinterpret_cast<struct sockaddr *>(&address), &length));
+    listeners[1] = pctk::EventLoopGroup::listenReusePort("127.0.0.1", ntohs(address.sin_port));
+
+    bool threw = false;
+    try
+    {
+        pctk::EventLoopGroup::listenReusePort("not an address", 0);
+    }
+    catch (const std::system_error &)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+
+    const int clients = 16;
+    pctk::AtomicInt accepted(0);
+    {
+        pctk::EventLoopGroup::Options options;
+        options.loopCount = 2;
+        options.name = "tstLoop";
+        pctk::EventLoopGroup group(options);
+        CHECK_EQUAL(2, group.loopCount());
+        CHECK(group.next() != group.next());
+
+        pctk::AtomicInt watching(0);
+        for (int i = 0; i < 2; ++i)
+        {
+            pctk::EventLoop *loop = group.loop(i);
+            const int listener = listeners[i];
+            loop->post([&, loop, listener]() {
+                loop->watch(listener, pctk::EventLoop::Readable, [&](int fd, int) {
+                    int client;
+                    while ((client = ::accept(fd, PCTK_NULLPTR, PCTK_NULLPTR)) >= 0)
+                    {
+                        ::close(client);
+                        accepted.fetchAndAddRelease(1);
+                    }
+                });
+                watching.fetchAndAddRelease(1);
+            });
+        }
+        while (watching.loadAcquire() < 2)
+        {
+            std::this_thread::yield();
+        }
+
+        std::vector<int> sockets;
+        for (int i = 0; i < clients; ++i)
+        {
+            const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            CHECK_EQUAL(0, ::connect(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)));
+            sockets.push_back(fd);
+        }
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now()
+                                                               + std::chrono::seconds(2);
+        while (accepted.loadAcquire() < clients && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        for (std::size_t i = 0; i < sockets.size(); ++i)
+        {
+            ::close(sockets[i]);
+        }
+    }
+    CHECK_EQUAL(clients, accepted.loadAcquire());
+    /* the group destroyed the loops and their watches, the listeners may go now */
+    ::close(listeners[0]);
+    ::close(listeners[1]);
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
@@ -0,0 +1,358 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkFile.h>
+#include <pctkFileTree.h>
+
+#include <algorithm>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include "tst_common.h"
+
+#if defined(PCTK_OS_LINUX)
+#   include <sys/syscall.h>
+#   include <unistd.h>
+
+/* counts the fdatasync() calls File makes, the executable's definition takes precedence over the C library's */
+static int fdatasyncCalls = 0;
+
+extern "C" int fdatasync(int fd)
+{
+    ++fdatasyncCalls;
+    return (int) ::syscall(SYS_fdatasync, fd);
+}
+#endif
+
+namespace
+{
+using tst::read;
+using tst::write;
+
+std::string pattern(std::size_t size, std::size_t seed = 0)
+{
+    std::string content(size, '\0');
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        content[i] = char('a' + (i * 7 + seed) % 26);
+    }
+    return content;
+}
+
+std::string toString(pctk::Span<const char> view)
+{
+    return std::string(view.begin(), view.end());
+}
+} // namespace
+
+TEST_GROUP(pctkFileTest) {};
+
+TEST(pctkFileTest, WritesAreCoalesced)
+{
+    const std::string root = tst::makeTemp("file");
+    const std::string path = root + "/log";
+    pctk::File file(path, pctk::File::WriteOnly, pctk::File::Create | pctk::File::Truncate);
+    CHECK(file.isOpen());
+    std::string expected;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const std::string record = "record " + std::to_string(i) + "\n";
+        file.write(record.data(), record.size());
+        expected += record;
+    }
+    /* everything still sits in the buffer */
+    CHECK_EQUAL(0, (int) file.size());
+    CHECK_EQUAL((long) expected.size(), (long) file.position());
+    file.flush();
+    CHECK(expected == read(path));
+
+    /* a write larger than the buffer goes out together with what is buffered */
+    file.write(pctk::Span<const char>("head", 4));
+    const std::string large = pattern(3 * pctk::File::DefaultBufferSize);
+    file.write(large.data(), large.size());
+    expected += "head" + large;
+    CHECK_EQUAL((long) expected.size(), (long) file.size());
+    file.close();
+    CHECK_FALSE(file.isOpen());
+    CHECK(expected == read(path));
+
+    pctk::File append(path, pctk::File::WriteOnly, pctk::File::Append);
+    append.write(pctk::Span<const char>("tail", 4));
+    append.close();
+    CHECK(expected + "tail" == read(path));
+    pctk::FileTree::removeAll(root);
+}
+
+TEST(pctkFileTest, GatheredWrites)
+{
+    const std::string root = tst::makeTemp("file");
+    const std::string path = root + "/gathered";
+    std::vector<std::string> parts;
+    for (int i = 0; i < 40; ++i)
+    {
+        parts.push_back(pattern(i % 3 ? 10 : 1000, (std::size_t) i));
+    }
+    std::vector<pctk::Span<const char> > pieces;
+    std::string expected = "prefix";
+    for (std::size_t i = 0; i < parts.size(); ++i)
+    {
+        pieces.push_back(pctk::Span<const char>(parts[i].data(), parts[i].size()));
+        expected += parts[i];
+    }
+    {
+        pctk::File file(path, pctk::File::WriteOnly, pctk::File::Create, 4096);
+        file.write(pctk::Span<const char>("prefix", 6));
+        file.write(pieces.data(), pieces.size());
+        file.write(pieces.data(), 2);
+        expected += parts[0] + parts[1];
+    }
+    CHECK(expected == read(path));
+    pctk::FileTree::removeAll(root);
+}
+
+TEST(pctkFileTest, ReadViews)
+{
+    const std::string root = tst::makeTemp("file");
+    const std::string path = root + "/lines";
+    const std::string longLine = pattern(10000) + "\n";
+    write(path, "first\nsecond\n" + longLine + "\nlast");
+
+    pctk::File file(path, pctk::File::ReadOnly, pctk::File::NoOption, 4096);
+    CHECK(file.advise(pctk::File::Sequential));
+    pctk::Span<const char> peeked = file.peek(3);
+    CHECK(peeked.size() >= 3);
+    CHECK("fir" == toString(peeked.first(3)));
+    file.consume(2);
+    CHECK("rst\n" == toString(file.readLine()));
+    CHECK("sec" == toString(file.read(3)));
+    CHECK("ond\n" == toString(file.readLine()));
+    CHECK(longLine == toString(file.readLine()));
+    CHECK("\n" == toString(file.readLine()));
+    CHECK("last" == toString(file.readLine()));
+    CHECK(file.readLine().empty());
+    CHECK(file.read(10).empty());
+    CHECK(file.peek(1).empty());
+    pctk::FileTree::removeAll(root);
+}
+
+TEST(pctkFileTest, CopyingReads)
+{
+    const std::string root = tst::makeTemp("file");
+    const std::string path = root + "/data";
+    const std::string content = pattern(100000);
+    write(path, content);
+
+    pctk::File file(path, pctk::File::ReadOnly, pctk::File::NoOption, 4096);
+    std::string copy(content.size(), '\0');
+    CHECK_EQUAL(10u, (unsigned) file.read(&copy[0], 10));
+    /* larger than the buffer, lands in the caller's memory directly */
+    CHECK_EQUAL(50000u, (unsigned) file.read(&copy[10], 50000));
+    CHECK_EQUAL(7u, (unsigned) file.read(&copy[50010], 7));
+    CHECK_EQUAL(50010 + 7, (int) file.position());
+    CHECK_EQUAL((unsigned) (content.size() - 50017),
+                (unsigned) file.read(&copy[50017], content.size()));
+    CHECK(content == copy);
+    CHECK_EQUAL(0u, (unsigned) file.read(&copy[0], 1));
+    pctk::FileTree::removeAll(root);
+}
+
+TEST(pctkFileTest, PositionalAndMixed)
+{
+    const std::string root = tst::makeTemp("file");
+    const std::string path = root + "/mixed";
+    write(path, "0123456789abcdef");
+
+    pctk::File file(path, pctk::File::ReadWrite);
+    char buffer[4];
+    CHECK_EQUAL(4u, (unsigned) file.readAt(10, buffer, 4));
+    CHECK("abcd" == std::string(buffer, 4));
+    CHECK_EQUAL(2u, (unsigned) file.readAt(14, buffer, 4));
+    CHECK_EQUAL(0, (int) file.position());
+
+    /* the buffer read ahead, the write still lands at the logical position */
+    CHECK("012" == toString(file.read(3)));
+    file.write(pctk::Span<const char>("XY", 2));
+    CHECK_EQUAL(5, (int) file.position());
+    CHECK("56" == toString(file.read(2)));
+    file.writeAt(0, "Z", 1);
+    CHECK("789" == toString(file.read(3)));
+    file.seek(1);
+    CHECK("12XY" == toString(file.read(4)));
+    file.seek(16);
+    file.write(pctk::Span<const char>("!", 1));
+    file.sync();
+    CHECK("Z12XY56789abcdef!" == read(path));
+    pctk::FileTree::removeAll(root);
+}
+
+TEST(pctkFileTest, Direct)
+{
+    const std::string root = tst::makeTemp("file");
+    const std::string path = root + "/direct";
+    const std::string content = pattern(5 * pctk::File::DirectAlignment + 100);
+    {
+        pctk::File file(path, pctk::File::WriteOnly, pctk::File::Create | pctk::File::Direct, 8192);
+        for (std::size_t i = 0; i < content.size(); i += 100)
+        {
+            file.write(content.data() + i, std::min<std::size_t>(100, content.size() - i));
+        }
+        file.close();
+    }
+    CHECK(content == read(path));
+
+    pctk::File file(path, pctk::File::ReadOnly, pctk::File::Direct, 8192);
+    file.seek(5000);
+    CHECK_EQUAL(5000, (int) file.position());
+    CHECK(content.substr(5000, 300) == toString(file.read(300)));
+    file.seek(0);
+    std::string copy(content.size(), '\0');
+    CHECK_EQUAL(content.size(), file.read(&copy[0], content.size()));
+    CHECK(content == copy);
+    pctk::FileTree::removeAll(root);
+}
+
+#if defined(PCTK_OS_LINUX)
+TEST(pctkFileTest, SyncCoversEarlierWrites)
+{
+    const std::string root = tst::makeTemp("file");
+    const std::string path = root + "/synced";
+    pctk::File file(path, pctk::File::WriteOnly, pctk::File::Create | pctk::File::Truncate);
+    file.write(pctk::Span<const char>("head", 4));
+    file.sync();
+
+    /* bytes flushed or written in place since the last sync() are outside the range of an RWF_DSYNC write */
+    file.write(pctk::Span<const char>("flushed", 7));
+    file.flush();
+    file.write(pctk::Span<const char>("tail", 4));
+    int calls = fdatasyncCalls;
+    file.sync();
+    CHECK_EQUAL(calls + 1, fdatasyncCalls);
+
+    file.writeAt(0, "HEAD", 4);
+    file.write(pctk::Span<const char>("more", 4));
+    calls = fdatasyncCalls;
+    file.sync();
+    CHECK_EQUAL(calls + 1, fdatasyncCalls);
+    file.close();
+    CHECK("HEADflushedtailmore" == read(path));
+    pctk::FileTree::removeAll(root);
+}
+#endif
+
+TEST(pctkFileTest, AppendIgnoresDirect)
+{
+    const std::string root = tst::makeTemp("file");
+    const std::string path = root + "/append";
+    const std::string head = pattern(100);
+    const std::string tail = pattern(192 * 1024, 3);
+    write(path, head);
+    pctk::File file(path, pctk::File::WriteOnly, pctk::File::Append | pctk::File::Direct);
+    /* the end of the file is not on a block boundary, O_DIRECT would refuse the first flush */
+    CHECK_FALSE(file.isDirect());
+    file.write(tail.data(), tail.size());
+    file.close();
+    CHECK(head + tail == read(path));
+    pctk::FileTree::removeAll(root);
+}
+
+TEST(pctkFileTest, FailedFlushKeepsBuffer)
+{
+    const std::string root = tst::makeTemp("file");
+    write(root + "/readonly", "content");
+    pctk::File file(root + "/readonly", pctk::File::ReadOnly, pctk::File::NoOption, 4096);
+    file.write(pctk::Span<const char>("0123456789", 10));
+    CHECK_EQUAL(10, (int) file.position());
+    CHECK_THROWS(std::system_error, file.flush());
+    CHECK_EQUAL(10, (int) file.position());
+
+    /* the buffer goes out together with writes that overflow it, it stays when they fail */
+    const std::string large = pattern(3 * 4096);
+    CHECK_THROWS(std::system_error, file.write(large.data(), large.size()));
+    CHECK_EQUAL(10, (int) file.position());
+    const pctk::Span<const char> pieces[2] = {pctk::Span<const char>(large.data(), 4096),
+                                              pctk::Span<const char>(large.data() + 4096, 4096)};
+    CHECK_THROWS(std::system_error, file.write(pieces, 2));
+    CHECK_EQUAL(10, (int) file.position());
+    CHECK_THROWS(std::system_error, file.sync());
+    CHECK_EQUAL(10, (int) file.position());
+
+    CHECK_THROWS(std::system_error, file.close());
+    CHECK_FALSE(file.isOpen());
+    CHECK("content" == read(root + "/readonly"));
+    pctk::FileTree::removeAll(root);
+}
+
+TEST(pctkFileTest, Errors)
+{
+    const std::string root = tst::makeTemp("file");
+    pctk::File file;
+    bool thrown = false;
+    try
+    {
+        file.open(root + "/missing");
+    }
+    catch (const std::system_error &error)
+    {
+        thrown = true;
+        CHECK(std::errc::no_such_file_or_directory == error.code());
+    }
+    CHECK(thrown);
+    CHECK_FALSE(file.isOpen());
+
+    write(root + "/readonly", "content");
+    file.open(root + "/readonly");
+    file.write(pctk::Span<const char>("x", 1));
+    thrown = false;
+    try
+    {
+        file.close();
+    }
+    catch (const std::system_error &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK_FALSE(file.isOpen());
+    CHECK("content" == read(root + "/readonly"));
+
+    pctk::File moved(root + "/readonly");
+    pctk::File other(std::move(moved));
+    CHECK_FALSE(moved.isOpen());
+    CHECK("content" == toString(other.read(100)));
+    pctk::FileTree::removeAll(root);
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
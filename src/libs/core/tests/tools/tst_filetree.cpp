@@ -0,0 +1,257 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkFileTree.h>
+#include <pctkThreadPool.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <system_error>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include "tst_common.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+using tst::read;
+using tst::write;
+
+bool exists(const std::string &path)
+{
+    struct stat status;
+    return 0 == ::lstat(path.c_str(), &status);
+}
+
+mode_t modeOf(const std::string &path)
+{
+    struct stat status;
+    CHECK_EQUAL(0, ::lstat(path.c_str(), &status));
+    return status.st_mode & 07777;
+}
+
+/* root/{top.txt sub/{a.bin(exec) deep/b.txt} ro(0555)/c.txt link->sub outside->"outside"} */
+std::string makeTree(const std::string &outside)
+{
+    const std::string root = tst::makeTemp("tree");
+    write(root + "/top.txt", "top");
+    CHECK_EQUAL(0, ::mkdir((root + "/sub").c_str(), 0750));
+    write(root + "/sub/a.bin", std::string(300000, 'x'), 0755);
+    CHECK_EQUAL(0, ::mkdir((root + "/sub/deep").c_str(), 0755));
+    write(root + "/sub/deep/b.txt", "deep");
+    CHECK_EQUAL(0, ::mkdir((root + "/ro").c_str(), 0755));
+    write(root + "/ro/c.txt", "read only");
+    CHECK_EQUAL(0, ::chmod((root + "/ro").c_str(), 0555));
+    CHECK_EQUAL(0, ::symlink("sub", (root + "/link").c_str()));
+    CHECK_EQUAL(0, ::symlink(outside.c_str(), (root + "/outside").c_str()));
+    return root;
+}
+
+/* a wide tree, directories fan out over the pool */
+std::string makeWideTree(int directories, int files)
+{
+    const std::string root = tst::makeTemp("tree");
+    for (int d = 0; d < directories; ++d)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "/d%03d", d);
+        const std::string directory = root + name;
+        CHECK_EQUAL(0, ::mkdir(directory.c_str(), 0755));
+        CHECK_EQUAL(0, ::mkdir((directory + "/nested").c_str(), 0755));
+        for (int f = 0; f < files; ++f)
+        {
+            std::snprintf(name, sizeof(name), "/f%04d", f);
+            write(directory + name, name);
+            write(directory + "/nested" + name, name);
+        }
+    }
+    return root;
+}
+} // namespace
+
+TEST_GROUP(pctkFileTreeTest) {};
+
+TEST(pctkFileTreeTest, RemoveAll)
+{
+    const std::string outside = tst::makeTemp("tree");
+    write(outside + "/keep.txt", "keep");
+    const std::string root = makeTree(outside);
+
+    pctk::FileTreeProgress progress;
+    pctk::FileTree::Options options;
+    options.progress = &progress;
+    const pctk::FileTreeResult result = pctk::FileTree::removeAll(root, options);
+    CHECK(result.ok());
+    CHECK_FALSE(exists(root));
+    /* 4 files, 2 links and 4 directories including the root */
+    CHECK_EQUAL(10u, (unsigned) result.entries);
+    CHECK_EQUAL(10u, (unsigned) progress.entries());
+    /* links are removed, not followed */
+    CHECK("keep" == read(outside + "/keep.txt"));
+
+    CHECK(pctk::FileTree::removeAll(root).ok());
+    CHECK_EQUAL(0u, (unsigned) pctk::FileTree::removeAll(root).entries);
+    const pctk::FileTreeResult file = pctk::FileTree::removeAll(outside + "/keep.txt");
+    CHECK(file.ok());
+    CHECK_EQUAL(1u, (unsigned) file.entries);
+    CHECK(pctk::FileTree::removeAll(outside).ok());
+    CHECK_FALSE(exists(outside));
+}
+
+TEST(pctkFileTreeTest, RemoveAllWideTree)
+{
+    pctk::ThreadPool pool(4);
+    pctk::FileTree::Options parallel;
+    parallel.pool = &pool;
+    pctk::FileTree::Options single;
+    single.flags = pctk::FileTree::SingleThreaded;
+
+    const pctk::FileTree::Options *modes[] = {&parallel, &single};
+    for (int m = 0; m < 2; ++m)
+    {
+        const std::string root = makeWideTree(40, 50);
+        const pctk::FileTreeResult result = pctk::FileTree::removeAll(root, *modes[m]);
+        CHECK(result.ok());
+        CHECK_EQUAL(40u * 2u * 50u + 40u * 2u + 1u, (unsigned) result.entries);
+        CHECK_FALSE(exists(root));
+    }
+}
+
+TEST(pctkFileTreeTest, CopyTree)
+{
+    const std::string outside = tst::makeTemp("tree");
+    const std::string source = makeTree(outside);
+    const std::string parent = tst::makeTemp("tree");
+    const std::string destination = parent + "/copy";
+
+    pctk::ThreadPool pool(3);
+    pctk::FileTree::Options options;
+    options.pool = &pool;
+    const pctk::FileTreeResult result = pctk::FileTree::copyTree(source, destination, options);
+    CHECK(result.ok());
+    CHECK_EQUAL(10u, (unsigned) result.entries);
+    CHECK_EQUAL(300000u + 3u + 4u + 9u, (unsigned) result.bytes);
+    CHECK("top" == read(destination + "/top.txt"));
+    CHECK(std::string(300000, 'x') == read(destination + "/sub/a.bin"));
+    CHECK("deep" == read(destination + "/sub/deep/b.txt"));
+    CHECK("read only" == read(destination + "/ro/c.txt"));
+    CHECK_EQUAL(0755u, (unsigned) modeOf(destination + "/sub/a.bin"));
+    CHECK_EQUAL(0750u, (unsigned) modeOf(destination + "/sub"));
+    CHECK_EQUAL(0555u, (unsigned) modeOf(destination + "/ro"));
+
+    char target[256];
+    const ssize_t length = ::readlink((destination + "/link").c_str(), target, sizeof(target));
+    CHECK(length > 0);
+    CHECK("sub" == std::string(target, (std::size_t) length));
+    struct stat status;
+    CHECK_EQUAL(0, ::lstat((destination + "/outside").c_str(), &status));
+    CHECK(S_ISLNK(status.st_mode));
+
+    /* copying again without Overwrite reports every file and link, directories are merged */
+    const pctk::FileTreeResult again = pctk::FileTree::copyTree(source, destination, options);
+    CHECK_FALSE(again.ok());
+    CHECK_EQUAL(6u, (unsigned) again.errorCount);
+    CHECK_EQUAL(6u, (unsigned) again.errors.size());
+    for (std::size_t i = 0; i < again.errors.size(); ++i)
+    {
+        CHECK(std::errc::file_exists == again.errors[i].error);
+        CHECK(!again.errors[i].path.empty() && '/' != again.errors[i].path[0]);
+    }
+
+    write(source + "/top.txt", "changed");
+    options.flags = pctk::FileTree::Overwrite | pctk::FileTree::NoReflink;
+    CHECK(pctk::FileTree::copyTree(source, destination, options).ok());
+    CHECK("changed" == read(destination + "/top.txt"));
+
+    /* a single file */
+    const pctk::FileTreeResult file = pctk::FileTree::copyTree(source + "/sub/deep/b.txt", destination + "/b.copy");
+    CHECK(file.ok());
+    CHECK_EQUAL(4u, (unsigned) file.bytes);
+    CHECK("deep" == read(destination + "/b.copy"));
+
+    CHECK(pctk::FileTree::removeAll(parent).ok());
+    CHECK(pctk::FileTree::removeAll(source).ok());
+    CHECK(pctk::FileTree::removeAll(outside).ok());
+}
+
+TEST(pctkFileTreeTest, CopyIntoItself)
+{
+    const std::string root = tst::makeTemp("tree");
+    write(root + "/a.txt", "a");
+    CHECK_EQUAL(0, ::mkdir((root + "/sub").c_str(), 0755));
+    write(root + "/sub/b.txt", "b");
+
+    const pctk::FileTreeResult result = pctk::FileTree::copyTree(root, root + "/sub/copy");
+    CHECK(result.ok());
+    CHECK("a" == read(root + "/sub/copy/a.txt"));
+    CHECK("b" == read(root + "/sub/copy/sub/b.txt"));
+    CHECK_FALSE(exists(root + "/sub/copy/sub/copy"));
+    CHECK(pctk::FileTree::removeAll(root).ok());
+}
+
+TEST(pctkFileTreeTest, ErrorsAndCancel)
+{
+    pctk::FileTreeResult missing = pctk::FileTree::copyTree("/nonexistent/pctk/source", "/tmp/pctk_never");
+    CHECK_FALSE(missing.ok());
+    CHECK_EQUAL(1u, (unsigned) missing.errors.size());
+    CHECK(std::errc::no_such_file_or_directory == missing.errors[0].error);
+    CHECK_FALSE(exists("/tmp/pctk_never"));
+
+    const std::string root = makeWideTree(4, 10);
+    pctk::FileTreeProgress progress;
+    progress.cancel();
+    pctk::FileTree::Options options;
+    options.progress = &progress;
+    const pctk::FileTreeResult cancelled = pctk::FileTree::removeAll(root, options);
+    CHECK(cancelled.cancelled);
+    CHECK_FALSE(cancelled.ok());
+    CHECK_EQUAL(0u, (unsigned) cancelled.errorCount);
+    CHECK(exists(root + "/d000/f0000"));
+
+    /* only the first maxErrors are kept */
+    const std::string copy = tst::makeTemp("tree");
+    CHECK(pctk::FileTree::copyTree(root, copy).ok());
+    options.progress = PCTK_NULLPTR;
+    options.maxErrors = 5;
+    const pctk::FileTreeResult capped = pctk::FileTree::copyTree(root, copy, options);
+    CHECK_EQUAL(80u, (unsigned) capped.errorCount);
+    CHECK_EQUAL(5u, (unsigned) capped.errors.size());
+
+    CHECK(pctk::FileTree::removeAll(copy).ok());
+    CHECK(pctk::FileTree::removeAll(root).ok());
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
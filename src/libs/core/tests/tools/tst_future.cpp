@@ -0,0 +1,223 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkFuture.h>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+TEST_GROUP(pctkFutureTest) {};
+
+TEST(pctkFutureTest, PromiseSetsValueOnce)
+{
+    pctk::Promise<int> promise;
+    pctk::Future<int> future = promise.future();
+    CHECK(future.isValid());
+    CHECK(!future.isReady());
+    CHECK(!future.waitFor(1000000));
+    CHECK(promise.setValue(5));
+    CHECK(!promise.setValue(6));
+    CHECK(future.isReady());
+    CHECK(!future.hasError());
+    CHECK_EQUAL(5, future.get());
+    CHECK(future.errorString().empty());
+}
+
+TEST(pctkFutureTest, BrokenPromise)
+{
+    pctk::Future<std::string> future;
+    {
+        pctk::Promise<std::string> promise;
+        future = promise.future();
+    }
+    CHECK(future.hasError());
+    CHECK(!future.errorString().empty());
+    bool thrown = false;
+    try
+    {
+        future.get();
+    }
+    catch (const std::future_error &error)
+    {
+        thrown = error.code() == std::future_errc::broken_promise;
+    }
+    CHECK(thrown);
+}
+
+TEST(pctkFutureTest, ReadyContinuationRunsInline)
+{
+    const std::thread::id caller = std::this_thread::get_id();
+    std::thread::id ranOn;
+    pctk::ThreadPool pool(1);
+    pctk::Future<int> future = pctk::makeReadyFuture(20).then(pool, [&](int value) {
+        ranOn = std::this_thread::get_id();
+        return value + 1;
+    });
+    CHECK(future.isReady());
+    CHECK(ranOn == caller);
+    CHECK_EQUAL(21, future.get());
+}
+
+TEST(pctkFutureTest, ChainOnThreadPool)
+{
+    pctk::ThreadPool pool(2);
+    pctk::Future<std::string> future = pctk::async(pool, []() { return 20; })
+        .then(pool, [](int value) { return value + 1; })
+        .then([](int value) { return std::to_string(value); });
+    CHECK("21" == future.get());
+
+    pctk::AtomicInt ran(0);
+    pctk::Future<int> fromVoid = pctk::async(pool, [&]() { ran.fetchAndAddRelaxed(1); })
+        .then(pool, [&]() { return ran.loadAcquire(); });
+    CHECK_EQUAL(1, fromVoid.get());
+}
+
+TEST(pctkFutureTest, ErrorsSkipContinuations)
+{
+    pctk::ThreadPool pool(2);
+    pctk::AtomicInt skipped(0);
+    pctk::Future<int> future = pctk::async(pool, []() -> int { throw std::runtime_error("boom"); })
+        .then([&](int value) {
+            skipped.fetchAndAddRelaxed(1);
+            return value;
+        })
+        .then(pool, [&](int value) {
+            skipped.fetchAndAddRelaxed(1);
+            return value;
+        });
+    future.wait();
+    CHECK(future.hasError());
+    CHECK("boom" == future.errorString());
+    CHECK_EQUAL(0, skipped.loadAcquire());
+    bool thrown = false;
+    try
+    {
+        future.get();
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+TEST(pctkFutureTest, CancellationSkipsWork)
+{
+    pctk::CancellationSource source;
+    pctk::CancellationToken token = source.token();
+    CHECK(token.canBeCancelled());
+    CHECK(!pctk::CancellationToken().canBeCancelled());
+
+    pctk::Promise<int> promise;
+    pctk::AtomicInt ran(0);
+    pctk::Future<int> future = promise.future().then(token, [&](int value) {
+        ran.fetchAndAddRelaxed(1);
+        return value;
+    });
+    source.cancel();
+    CHECK(token.isCancellationRequested());
+    promise.setValue(1);
+    CHECK(future.hasError());
+    CHECK_EQUAL(0, ran.loadAcquire());
+    bool canceled = false;
+    try
+    {
+        future.get();
+    }
+    catch (const std::system_error &error)
+    {
+        canceled = error.code() == std::errc::operation_canceled;
+    }
+    CHECK(canceled);
+
+    pctk::ThreadPool pool(1);
+    pctk::Future<int> task = pctk::async(pool, token, [&]() { return ran.fetchAndAddRelaxed(1); });
+    task.wait();
+    CHECK(task.hasError());
+    CHECK_EQUAL(0, ran.loadAcquire());
+}
+
+TEST(pctkFutureTest, WhenAllAndWhenAny)
+{
+    pctk::ThreadPool pool(4);
+    pctk::Vector<pctk::Future<int> > futures;
+    for (int i = 0; i < 16; ++i)
+    {
+        futures.push_back(pctk::async(pool, [i]() { return i * i; }));
+    }
+    const pctk::Vector<int> values = pctk::whenAll(futures).get();
+    CHECK_EQUAL(16u, (unsigned) values.size());
+    for (int i = 0; i < 16; ++i)
+    {
+        CHECK_EQUAL(i * i, values[i]);
+    }
+
+    pctk::Promise<int> pending;
+    futures.clear();
+    futures.push_back(pending.future());
+    futures.push_back(pctk::makeExceptionalFuture<int>(std::make_exception_ptr(std::runtime_error("first"))));
+    pctk::Future<pctk::Vector<int> > failed = pctk::whenAll(futures);
+    CHECK("first" == failed.errorString());
+    CHECK_EQUAL(1u, (unsigned) pctk::whenAny(futures).get());
+    pending.setValue(1);
+
+    pctk::Vector<pctk::Future<void> > voids;
+    voids.push_back(pctk::async(pool, []() {}));
+    voids.push_back(pctk::makeReadyFuture());
+    pctk::whenAll(voids).get();
+    CHECK(pctk::whenAll(pctk::Vector<pctk::Future<void> >()).isReady());
+    CHECK(pctk::whenAny(pctk::Vector<pctk::Future<void> >()).hasError());
+}
+
+TEST(pctkFutureTest, ContinuationRacesWithCompletion)
+{
+    pctk::AtomicInt ran(0);
+    const int rounds = 2000;
+    for (int i = 0; i < rounds; ++i)
+    {
+        pctk::Promise<int> promise;
+        pctk::Future<int> future = promise.future();
+        std::thread setter([&]() { promise.setValue(i); });
+        pctk::Future<int> next = future.then([&](int value) {
+            ran.fetchAndAddRelaxed(1);
+            return value;
+        });
+        setter.join();
+        CHECK_EQUAL(i, next.get());
+    }
+    CHECK_EQUAL(rounds, ran.loadAcquire());
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
@@ -0,0 +1,330 @@
+/***********************************************************************************************************************
+**
+** Library: UTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkHashMap.h>
+#include <pctkHashSet.h>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <memory>
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+/* Puts every key in the same probe sequence. */
+struct CollidingHash
+{
+    std::size_t operator()(int) const { return 42; }
+};
+
+/* Counts hash calls made with a const char *, to prove the lookup did not build a std::string. */
+struct CountingHash : public pctk::Hash<std::string>
+{
+    static int rawCalls;
+
+    using pctk::Hash<std::string>::operator();
+    std::size_t operator()(const char *value) const
+    {
+        ++rawCalls;
+        return pctk::Hash<std::string>::operator()(value);
+    }
+};
+int CountingHash::rawCalls = 0;
+
+/* A key whose copies throw once the budget is spent, live counts the constructed ones. */
+struct ThrowingKey
+{
+    static int copiesLeft;
+    static int live;
+
+    explicit ThrowingKey(int value) : value(value) { ++live; }
+    ThrowingKey(const ThrowingKey &other) : value(other.value)
+    {
+        if (0 == copiesLeft)
+        {
+            throw std::runtime_error("ThrowingKey: copy");
+        }
+        --copiesLeft;
+        ++live;
+    }
+    ~ThrowingKey() { --live; }
+
+    bool operator==(const ThrowingKey &other) const { return value == other.value; }
+
+    int value;
+};
+int ThrowingKey::copiesLeft = 0;
+int ThrowingKey::live = 0;
+
+struct ThrowingKeyHash
+{
+    std::size_t operator()(const ThrowingKey &key) const { return pctk::Hash<int>()(key.value); }
+};
+} // namespace
+
+TEST_GROUP(pctkHashMapTest) {};
+
+TEST(pctkHashMapTest, Empty)
+{
+    pctk::HashMap<int, int> map;
+    CHECK(map.empty());
+    CHECK(map.capacity() == 0);
+    CHECK(map.begin() == map.end());
+    CHECK(map.find(1) == map.end());
+    CHECK(map.erase(1) == 0);
+    CHECK_THROWS(std::out_of_range, map.at(1));
+}
+
+TEST(pctkHashMapTest, InsertFindErase)
+{
+    pctk::HashMap<int, int> map;
+    for (int i = 0; i < 10000; ++i)
+    {
+        CHECK(map.insert(std::make_pair(i, i * 2)).second);
+    }
+    CHECK(map.size() == 10000);
+    CHECK(map.load_factor() <= 0.875f);
+    CHECK_FALSE(map.insert(std::make_pair(5, 0)).second);
+    for (int i = 0; i < 10000; ++i)
+    {
+        CHECK(map.at(i) == i * 2);
+    }
+    CHECK(map.find(10000) == map.end());
+    for (int i = 0; i < 10000; i += 2)
+    {
+        CHECK(map.erase(i) == 1);
+    }
+    CHECK(map.size() == 5000);
+    CHECK_FALSE(map.contains(4));
+    CHECK(map.contains(5));
+    CHECK(map.value(4, -1) == -1);
+
+    std::size_t visited = 0;
+    for (pctk::HashMap<int, int>::const_iterator it = map.begin(); it != map.end(); ++it)
+    {
+        CHECK(it->first % 2 == 1);
+        ++visited;
+    }
+    CHECK(visited == 5000);
+}
+
+TEST(pctkHashMapTest, TombstonesAreReclaimed)
+{
+    pctk::HashMap<int, int> map;
+    map.reserve(100);
+    const std::size_t capacity = map.capacity();
+    for (int round = 0; round < 100; ++round)
+    {
+        for (int i = 0; i < 50; ++i)
+        {
+            map[round * 50 + i] = i;
+        }
+        for (int i = 0; i < 50; ++i)
+        {
+            map.erase(round * 50 + i);
+        }
+    }
+    CHECK(map.empty());
+    CHECK(map.capacity() == capacity);
+}
+
+TEST(pctkHashMapTest, Collisions)
+{
+    pctk::HashMap<int, std::string, CollidingHash> map;
+    for (int i = 0; i < 100; ++i)
+    {
+        map[i] = std::to_string(i);
+    }
+    for (int i = 0; i < 100; i += 3)
+    {
+        map.erase(i);
+    }
+    for (int i = 0; i < 100; ++i)
+    {
+        CHECK(map.contains(i) == (i % 3 != 0));
+        if (i % 3)
+        {
+            CHECK(map.at(i) == std::to_string(i));
+        }
+    }
+}
+
+TEST(pctkHashMapTest, ComplexValues)
+{
+    pctk::HashMap<std::string, std::vector<int> > map;
+    for (int i = 0; i < 500; ++i)
+    {
+        map[std::to_string(i)].push_back(i);
+        map[std::to_string(i)].push_back(-i);
+    }
+    CHECK(map.size() == 500);
+    CHECK(map.at("42").size() == 2);
+    CHECK(map.at("42")[1] == -42);
+
+    pctk::HashMap<std::string, std::vector<int> > copy(map);
+    CHECK(copy == map);
+    copy["42"].clear();
+    CHECK(copy != map);
+
+    pctk::HashMap<std::string, std::vector<int> > moved(std::move(copy));
+    CHECK(copy.empty());
+    CHECK(moved.size() == 500);
+    moved.clear();
+    CHECK(moved.empty());
+    moved.rehash(0);
+    CHECK(moved.capacity() == 0);
+
+    /* capacities that are not a power of two round up, probing masks with capacity - 1 */
+    pctk::HashMap<int, int> sized;
+    sized.rehash(100);
+    CHECK(sized.capacity() == 128);
+    for (int i = 0; i < 80; ++i)
+    {
+        sized.insert_or_assign(i, -i);
+    }
+    CHECK(sized.size() == 80);
+    for (int i = 0; i < 80; ++i)
+    {
+        CHECK(sized.find(i) != sized.end());
+        CHECK(sized.at(i) == -i);
+    }
+    sized.rehash(300);
+    CHECK(sized.capacity() == 512);
+    CHECK(sized.at(79) == -79);
+
+    pctk::HashMap<int, std::unique_ptr<int> > owners;
+    owners.try_emplace(1, new int(1));
+    for (int i = 2; i < 100; ++i)
+    {
+        owners.try_emplace(i, new int(i));
+    }
+    CHECK(*owners.at(1) == 1);
+    CHECK(*owners.at(99) == 99);
+}
+
+TEST(pctkHashMapTest, HeterogeneousLookup)
+{
+    pctk::HashMap<std::string, int, CountingHash> map;
+    map["service.log"] = 1;
+    map["service.net"] = 2;
+
+    CountingHash::rawCalls = 0;
+    CHECK(map.find("service.net")->second == 2);
+    CHECK(map.contains("service.log"));
+    CHECK_FALSE(map.contains("service.gui"));
+    CHECK(CountingHash::rawCalls == 3);
+    CHECK(pctk::Hash<std::string>()("abc") == pctk::Hash<std::string>()(std::string("abc")));
+}
+
+TEST(pctkHashMapTest, InsertOrAssign)
+{
+    pctk::HashMap<std::string, int> map = {{"a", 1}, {"b", 2}};
+    CHECK_FALSE(map.insert_or_assign("a", 3).second);
+    CHECK(map.insert_or_assign("c", 4).second);
+    CHECK(map.at("a") == 3);
+    CHECK(map.size() == 3);
+    pctk::HashMap<std::string, int>::iterator it = map.find("b");
+    it = map.erase(it);
+    CHECK(map.size() == 2);
+}
+
+TEST_GROUP(pctkHashSetTest) {};
+
+TEST(pctkHashSetTest, InsertContainsErase)
+{
+    pctk::HashSet<std::string> set = {"x", "y"};
+    CHECK(set.insert("z").second);
+    CHECK_FALSE(set.emplace("x").second);
+    CHECK(set.size() == 3);
+    CHECK(set.contains("y"));
+    CHECK(set.erase("y") == 1);
+    CHECK_FALSE(set.contains("y"));
+
+    pctk::HashSet<int> numbers;
+    for (int i = 0; i < 1000; ++i)
+    {
+        numbers.insert(i * 7);
+    }
+    pctk::HashSet<int> other(numbers);
+    CHECK(other == numbers);
+    other.erase(7);
+    CHECK(other != numbers);
+    swap(other, numbers);
+    CHECK(numbers.size() == 999);
+    CHECK(other.contains(7));
+}
+
+TEST(pctkHashSetTest, ThrowingConstructorLeavesNoSlot)
+{
+    {
+        pctk::HashSet<ThrowingKey, ThrowingKeyHash> set;
+        ThrowingKey::copiesLeft = 1000;
+        for (int i = 0; i < 20; ++i)
+        {
+            set.insert(ThrowingKey(i));
+        }
+        ThrowingKey::copiesLeft = 0;
+        const ThrowingKey key(100);
+        CHECK_THROWS(std::runtime_error, set.insert(key));
+        CHECK(set.size() == 20);
+        CHECK_FALSE(set.contains(key));
+        int count = 0;
+        for (pctk::HashSet<ThrowingKey, ThrowingKeyHash>::const_iterator it = set.begin(); it != set.end(); ++it)
+        {
+            CHECK(it->value < 20);
+            ++count;
+        }
+        CHECK_EQUAL(20, count);
+
+        ThrowingKey::copiesLeft = 1;
+        CHECK(set.insert(key).second);
+        CHECK(set.contains(key));
+    }
+    CHECK_EQUAL(0, ThrowingKey::live);
+}
+
+TEST(pctkHashSetTest, IteratorsAreConst)
+{
+    typedef pctk::HashSet<std::string> Set;
+    CHECK((std::is_same<const std::string &, Set::iterator::reference>::value));
+    CHECK((std::is_same<Set::iterator, Set::const_iterator>::value));
+    Set set = {"a"};
+    Set::iterator it = set.find("a");
+    CHECK(it != set.end());
+    CHECK(set.erase(it) == set.end());
+    CHECK(set.empty());
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
@@ -0,0 +1,215 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkSpinLock.h>
+#include <pctkMutex.h>
+#include <pctkReadWriteLock.h>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+/* Increments a plain counter under the lock, any lost update means two threads were inside at once. */
+template<typename Lock>
+int contend(Lock &lock, int threadCount, int iterations)
+{
+    int counter = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.push_back(std::thread([&]() {
+            for (int i = 0; i < iterations; ++i)
+            {
+                pctk::LockGuard<Lock> guard(lock);
+                ++counter;
+            }
+        }));
+    }
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads[t].join();
+    }
+    return counter;
+}
+} // namespace
+
+TEST_GROUP(pctkLockTest) {};
+
+TEST(pctkLockTest, FitInOneWord)
+{
+    CHECK_EQUAL(4u, (unsigned) sizeof(pctk::SpinLock));
+    CHECK_EQUAL(4u, (unsigned) sizeof(pctk::Mutex));
+    CHECK_EQUAL(4u, (unsigned) sizeof(pctk::ReadWriteLock));
+}
+
+TEST(pctkLockTest, SpinLock)
+{
+    pctk::SpinLock lock;
+    CHECK(lock.tryLock());
+    CHECK(lock.isLocked());
+    CHECK(!lock.tryLock());
+    lock.unlock();
+    CHECK(!lock.isLocked());
+    CHECK_EQUAL(4 * 20000, contend(lock, 4, 20000));
+}
+
+TEST(pctkLockTest, Mutex)
+{
+    pctk::Mutex mutex;
+    CHECK(mutex.tryLock());
+    CHECK(!mutex.tryLock());
+    mutex.unlock();
+    CHECK(!mutex.isLocked());
+    CHECK_EQUAL(8 * 20000, contend(mutex, 8, 20000));
+    CHECK(!mutex.isLocked());
+}
+
+TEST(pctkLockTest, MutexParksAndWakes)
+{
+    pctk::Mutex mutex;
+    pctk::AtomicInt entered(0);
+    mutex.lock();
+    std::thread waiter([&]() {
+        mutex.lock();
+        entered.storeRelease(1);
+        mutex.unlock();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK_EQUAL(0, entered.loadAcquire());
+    mutex.unlock();
+    waiter.join();
+    CHECK_EQUAL(1, entered.loadAcquire());
+}
+
+TEST(pctkLockTest, MutexTryLockFor)
+{
+    pctk::Mutex mutex;
+    CHECK(mutex.tryLockFor(1000000));
+    bool acquired = true;
+    std::thread([&]() { acquired = mutex.tryLockFor(5000000); }).join();
+    CHECK(!acquired);
+
+    std::thread holder([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        mutex.unlock();
+    });
+    /* unlocked by another thread than the locking one, fine for a futex word */
+    CHECK(mutex.tryLockFor(5000000000LL));
+    holder.join();
+    mutex.unlock();
+}
+
+TEST(pctkLockTest, ReadersShareWritersExclude)
+{
+    pctk::ReadWriteLock lock;
+    lock.lockForRead();
+    CHECK(lock.tryLockForRead());
+    CHECK_EQUAL(2, lock.readerCount());
+    CHECK(!lock.tryLockForWrite());
+    lock.unlock();
+    lock.unlock();
+    CHECK_EQUAL(0, lock.readerCount());
+
+    CHECK(lock.tryLockForWrite());
+    CHECK(lock.isLockedForWrite());
+    CHECK(!lock.tryLockForRead());
+    CHECK(!lock.tryLockForWrite());
+    lock.unlock();
+    CHECK(!lock.isLockedForWrite());
+}
+
+TEST(pctkLockTest, WaitingWriterBlocksNewReaders)
+{
+    pctk::ReadWriteLock lock;
+    pctk::AtomicInt written(0);
+    lock.lockForRead();
+    std::thread writer([&]() {
+        pctk::WriteLocker locker(lock);
+        written.storeRelease(1);
+    });
+    /* once the writer has flagged itself, a reader that arrives later must not get in */
+    while (lock.tryLockForRead())
+    {
+        lock.unlock();
+        std::this_thread::yield();
+    }
+    CHECK_EQUAL(0, written.loadAcquire());
+    lock.unlock();
+    writer.join();
+    CHECK_EQUAL(1, written.loadAcquire());
+    CHECK(lock.tryLockForRead());
+    lock.unlock();
+}
+
+TEST(pctkLockTest, ReadWriteLockStress)
+{
+    pctk::ReadWriteLock lock;
+    int first = 0;
+    int second = 0;
+    pctk::AtomicInt torn(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 6; ++t)
+    {
+        threads.push_back(std::thread([&, t]() {
+            for (int i = 0; i < 20000; ++i)
+            {
+                if (0 == t % 3)
+                {
+                    pctk::WriteLocker locker(lock);
+                    ++first;
+                    ++second;
+                }
+                else
+                {
+                    pctk::ReadLocker locker(lock);
+                    if (first != second)
+                    {
+                        torn.fetchAndAddRelaxed(1);
+                    }
+                }
+            }
+        }));
+    }
+    for (std::size_t t = 0; t < threads.size(); ++t)
+    {
+        threads[t].join();
+    }
+    CHECK_EQUAL(0, torn.loadAcquire());
+    CHECK_EQUAL(2 * 20000, first);
+    CHECK_EQUAL(0, lock.readerCount());
+    CHECK(!lock.isLockedForWrite());
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
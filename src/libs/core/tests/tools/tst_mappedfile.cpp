@@ -0,0 +1,234 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkMappedFile.h>
+#include <pctkFileTree.h>
+
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include "tst_common.h"
+
+using tst::read;
+using tst::write;
+
+TEST_GROUP(pctkMappedFileTest) {};
+
+TEST(pctkMappedFileTest, Span)
+{
+    const char text[] = "abcdef";
+    pctk::Span<const char> span(text, 6);
+    CHECK_EQUAL(6u, (unsigned) span.size());
+    CHECK_EQUAL('a', span.front());
+    CHECK_EQUAL('f', span.back());
+    CHECK("abc" == std::string(span.first(3).begin(), span.first(3).end()));
+    CHECK("ef" == std::string(span.last(2).begin(), span.last(2).end()));
+    CHECK("cd" == std::string(span.subspan(2, 2).begin(), span.subspan(2, 2).end()));
+    CHECK("cdef" == std::string(span.subspan(2).begin(), span.subspan(2).end()));
+    CHECK_EQUAL(6u, (unsigned) span.first(100).size());
+    CHECK(span.subspan(9).empty());
+
+    char buffer[4] = {'w', 'x', 'y', 'z'};
+    pctk::Span<char> writable(buffer);
+    writable[1] = 'X';
+    pctk::Span<const char> readable = writable;
+    CHECK_EQUAL('X', readable[1]);
+    CHECK_EQUAL(4u, (unsigned) readable.size_bytes());
+}
+
+TEST(pctkMappedFileTest, ReadOnly)
+{
+    const std::string root = tst::makeTemp("mapped");
+    std::string content;
+    for (int i = 0; i < 10000; ++i)
+    {
+        content += char('a' + i % 26);
+    }
+    write(root + "/file", content);
+
+    pctk::MappedFile file(root + "/file");
+    CHECK(file.isOpen());
+    CHECK_EQUAL(pctk::MappedFile::ReadOnly, file.mode());
+    CHECK_EQUAL(content.size(), file.size());
+    CHECK(PCTK_NULLPTR == file.writableData());
+    CHECK(file.writableView().empty());
+    CHECK(content == std::string(file.view().begin(), file.view().end()));
+    CHECK(file.advise(pctk::MappedFile::Sequential));
+    CHECK(file.advise(pctk::MappedFile::WillNeed, 5000, 100));
+    CHECK_FALSE(file.advise(pctk::MappedFile::Random, content.size()));
+    bool thrown = false;
+    try
+    {
+        file.resize(10);
+    }
+    catch (const std::system_error &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    file.close();
+    CHECK_FALSE(file.isOpen());
+    CHECK(PCTK_NULLPTR == file.data());
+    pctk::FileTree::removeAll(root);
+}
+
+TEST(pctkMappedFileTest, EmptyAndMissing)
+{
+    const std::string root = tst::makeTemp("mapped");
+    write(root + "/empty", "");
+    pctk::MappedFile empty(root + "/empty", pctk::MappedFile::ReadOnly, pctk::MappedFile::Populate);
+    CHECK(empty.isOpen());
+    CHECK_EQUAL(0u, (unsigned) empty.size());
+    CHECK(empty.view().empty());
+    CHECK_FALSE(empty.advise(pctk::MappedFile::Sequential));
+
+    pctk::MappedFile missing;
+    bool thrown = false;
+    try
+    {
+        missing.open(root + "/missing");
+    }
+    catch (const std::system_error &error)
+    {
+        thrown = true;
+        CHECK(std::errc::no_such_file_or_directory == error.code());
+    }
+    CHECK(thrown);
+    CHECK_FALSE(missing.isOpen());
+
+    thrown = false;
+    try
+    {
+        missing.open(root);
+    }
+    catch (const std::system_error &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    pctk::FileTree::removeAll(root);
+}
+
+TEST(pctkMappedFileTest, ReadWriteAndResize)
+{
+    const std::string root = tst::makeTemp("mapped");
+    const std::string path = root + "/file";
+    {
+        pctk::MappedFile file(path, pctk::MappedFile::ReadWrite, pctk::MappedFile::Create);
+        CHECK_EQUAL(0u, (unsigned) file.size());
+        file.resize(5);
+        std::memcpy(file.writableData(), "hello", 5);
+        file.sync();
+        CHECK("hello" == read(path));
+
+        file.resize(3 * 4096 + 7);
+        CHECK('h' == file.data()[0]);
+        CHECK(0 == file.data()[3 * 4096 + 6]);
+        file.writableView().back() = '!';
+        file.sync(true);
+        const std::string grown = read(path);
+        CHECK_EQUAL(3u * 4096 + 7, (unsigned) grown.size());
+        CHECK_EQUAL('!', grown[grown.size() - 1]);
+
+        file.resize(2);
+        CHECK("he" == std::string(file.view().begin(), file.view().end()));
+        CHECK("he" == read(path));
+        file.resize(0);
+        CHECK(PCTK_NULLPTR == file.data());
+        CHECK("" == read(path));
+    }
+
+    write(path, "previous");
+    {
+        pctk::MappedFile file(path, pctk::MappedFile::ReadWrite);
+        CHECK_EQUAL(8u, (unsigned) file.size());
+        file.writableData()[0] = 'P';
+    }
+    CHECK("Previous" == read(path));
+    {
+        pctk::MappedFile file(path, pctk::MappedFile::ReadWrite, pctk::MappedFile::Truncate);
+        CHECK_EQUAL(0u, (unsigned) file.size());
+    }
+    CHECK("" == read(path));
+    pctk::FileTree::removeAll(root);
+}
+
+TEST(pctkMappedFileTest, Move)
+{
+    const std::string root = tst::makeTemp("mapped");
+    write(root + "/first", "first");
+    write(root + "/second", "second!");
+
+    pctk::MappedFile first(root + "/first");
+    const char *data = first.data();
+    pctk::MappedFile moved(std::move(first));
+    CHECK_FALSE(first.isOpen());
+    CHECK(data == moved.data());
+    CHECK_EQUAL(5u, (unsigned) moved.size());
+
+    pctk::MappedFile second(root + "/second");
+    moved = std::move(second);
+    CHECK_EQUAL(7u, (unsigned) moved.size());
+    CHECK("second!" == std::string(moved.view().begin(), moved.view().end()));
+    pctk::FileTree::removeAll(root);
+}
+
+TEST(pctkMappedFileTest, HugePages)
+{
+    const std::string root = tst::makeTemp("mapped");
+    const std::string path = root + "/large";
+    const std::size_t size = 5 * 1024 * 1024;
+    {
+        pctk::MappedFile file(path, pctk::MappedFile::ReadWrite, pctk::MappedFile::Create);
+        file.resize(size);
+        for (std::size_t i = 0; i < size; i += 4096)
+        {
+            file.writableData()[i] = char(i / 4096);
+        }
+    }
+    pctk::MappedFile file(path, pctk::MappedFile::ReadOnly,
+                          pctk::MappedFile::HugePages | pctk::MappedFile::Populate);
+    CHECK_EQUAL(size, file.size());
+    CHECK_EQUAL(0u, (unsigned) (((pctk_uintptr_t) file.data()) & (2 * 1024 * 1024 - 1)));
+    for (std::size_t i = 0; i < size; i += 4096)
+    {
+        CHECK_EQUAL(char(i / 4096), file.data()[i]);
+    }
+    pctk::FileTree::removeAll(root);
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
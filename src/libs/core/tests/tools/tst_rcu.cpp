@@ -0,0 +1,185 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <pctkRcu.h>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct Table
+{
+    static pctk::AtomicInt alive;
+
+    Table() : first(0), second(0) { alive.fetchAndAddRelaxed(1); }
+    Table(const Table &other) : first(other.first), second(other.second) { alive.fetchAndAddRelaxed(1); }
+    ~Table() { alive.fetchAndSubRelaxed(1); }
+
+    int first;
+    int second;
+};
+pctk::AtomicInt Table::alive(0);
+} // namespace
+
+TEST_GROUP(pctkRcuTest) {};
+
+TEST(pctkRcuTest, LoadStore)
+{
+    pctk::Rcu<std::string> rcu("alpha");
+    CHECK("alpha" == rcu.load());
+    rcu.store("beta");
+    CHECK("beta" == rcu.load());
+    {
+        pctk::Rcu<std::string>::ReadLock lock(rcu);
+        CHECK_EQUAL(4u, (unsigned) lock->size());
+        CHECK("beta" == *lock);
+    }
+    rcu.update([](std::string &value) { value += "-1"; });
+    CHECK("beta-1" == rcu.load());
+}
+
+TEST(pctkRcuTest, ReaderKeepsSnapshot)
+{
+    pctk::EpochDomain domain;
+    {
+        pctk::Rcu<Table> rcu(Table(), &domain);
+        pctk::AtomicInt locked(0);
+        pctk::AtomicInt release(0);
+        pctk::AtomicInt seen(-1);
+        std::thread reader([&]() {
+            pctk::Rcu<Table>::ReadLock lock(rcu);
+            locked.storeRelease(1);
+            locked.notifyAll();
+            release.wait(0);
+            seen.storeRelease(lock->first);
+        });
+        locked.wait(0);
+
+        rcu.update([](Table &table) { table.first = 1; });
+        rcu.update([](Table &table) { table.first = 2; });
+        domain.reclaim();
+        CHECK_EQUAL(2, rcu.load().first);
+        /* the snapshot held by the reader and the one replaced after it are both still alive */
+        CHECK_EQUAL(3, Table::alive.loadAcquire());
+
+        release.storeRelease(1);
+        release.notifyAll();
+        reader.join();
+        CHECK_EQUAL(0, seen.loadAcquire());
+
+        rcu.synchronize();
+        CHECK_EQUAL(1, Table::alive.loadAcquire());
+    }
+    CHECK_EQUAL(0, Table::alive.loadAcquire());
+}
+
+TEST(pctkRcuTest, UpdateThatThrowsPublishesNothing)
+{
+    pctk::EpochDomain domain;
+    {
+        pctk::Rcu<Table> rcu(Table(), &domain);
+        bool thrown = false;
+        try
+        {
+            rcu.update([](Table &table) {
+                table.first = 7;
+                throw 1;
+            });
+        }
+        catch (int)
+        {
+            thrown = true;
+        }
+        CHECK(thrown);
+        CHECK_EQUAL(0, rcu.load().first);
+        CHECK_EQUAL(1, Table::alive.loadAcquire());
+        rcu.update([](Table &table) { table.first = 3; });
+        CHECK_EQUAL(3, rcu.load().first);
+    }
+    domain.synchronize();
+    CHECK_EQUAL(0, Table::alive.loadAcquire());
+}
+
+TEST(pctkRcuTest, ConcurrentReadersAndWriters)
+{
+    pctk::EpochDomain domain;
+    {
+        pctk::Rcu<Table> rcu(Table(), &domain);
+        pctk::AtomicInt torn(0);
+        pctk::AtomicInt writing(1);
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t)
+        {
+            readers.push_back(std::thread([&]() {
+                while (writing.loadAcquire())
+                {
+                    pctk::Rcu<Table>::ReadLock lock(rcu);
+                    if (lock->first != lock->second)
+                    {
+                        torn.fetchAndAddRelaxed(1);
+                    }
+                }
+            }));
+        }
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; ++t)
+        {
+            writers.push_back(std::thread([&]() {
+                for (int i = 0; i < 2000; ++i)
+                {
+                    rcu.update([](Table &table) {
+                        ++table.first;
+                        ++table.second;
+                    });
+                }
+            }));
+        }
+        for (std::size_t t = 0; t < writers.size(); ++t)
+        {
+            writers[t].join();
+        }
+        writing.storeRelease(0);
+        for (std::size_t t = 0; t < readers.size(); ++t)
+        {
+            readers[t].join();
+        }
+        CHECK_EQUAL(0, torn.loadAcquire());
+        CHECK_EQUAL(8000, rcu.load().first);
+        rcu.synchronize();
+    }
+    CHECK_EQUAL(0, Table::alive.loadAcquire());
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
@@ -0,0 +1,352 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkHazardPointer.h>
+#include <pctkEpochDomain.h>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct Node
+{
+    static pctk::AtomicInt alive;
+
+    explicit Node(int v = 0) : value(v), next(PCTK_NULLPTR) { alive.fetchAndAddRelaxed(1); }
+    ~Node() { alive.fetchAndSubRelaxed(1); }
+
+    int value;
+    Node *next;
+};
+pctk::AtomicInt Node::alive(0);
+
+/* Treiber stack, pop() dereferences the head while other threads may pop and free it. */
+class HazardStack
+{
+public:
+    HazardStack() : m_head(PCTK_NULLPTR) {}
+
+    ~HazardStack()
+    {
+        int value;
+        while (this->pop(value))
+        {
+        }
+    }
+
+    void push(int value)
+    {
+        Node *node = new Node(value);
+        do
+        {
+            node->next = m_head.loadAcquire();
+        } while (!m_head.testAndSetOrdered(node->next, node));
+    }
+
+    bool pop(int &value)
+    {
+        pctk::HazardPointer hazard;
+        for (;;)
+        {
+            Node *head = hazard.protect(m_head);
+            if (!head)
+            {
+                return false;
+            }
+            if (m_head.testAndSetOrdered(head, head->next))
+            {
+                value = head->value;
+                hazard.resetProtection();
+                pctk::HazardPointer::retire(head);
+                return true;
+            }
+        }
+    }
+
+private:
+    pctk::AtomicPointer<Node> m_head;
+};
+
+class EpochStack
+{
+public:
+    explicit EpochStack(pctk::EpochDomain *domain) : m_domain(domain), m_head(PCTK_NULLPTR) {}
+
+    ~EpochStack()
+    {
+        int value;
+        while (this->pop(value))
+        {
+        }
+    }
+
+    void push(int value)
+    {
+        Node *node = new Node(value);
+        do
+        {
+            node->next = m_head.loadAcquire();
+        } while (!m_head.testAndSetOrdered(node->next, node));
+    }
+
+    bool pop(int &value)
+    {
+        pctk::EpochDomain::Guard guard(m_domain);
+        for (;;)
+        {
+            Node *head = guard.protect(m_head);
+            if (!head)
+            {
+                return false;
+            }
+            if (m_head.testAndSetOrdered(head, head->next))
+            {
+                value = head->value;
+                m_domain->retire(head);
+                return true;
+            }
+        }
+    }
+
+private:
+    pctk::EpochDomain *m_domain;
+    pctk::AtomicPointer<Node> m_head;
+};
+
+template<typename Stack>
+void hammer(Stack &stack, int threadCount, int iterations)
+{
+    pctk::AtomicInt popped(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.push_back(std::thread([&, t]() {
+            int value;
+            for (int i = 0; i < iterations; ++i)
+            {
+                stack.push(t * iterations + i);
+                if (stack.pop(value))
+                {
+                    popped.fetchAndAddRelaxed(1);
+                }
+            }
+        }));
+    }
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads[t].join();
+    }
+    int value;
+    while (stack.pop(value))
+    {
+        popped.fetchAndAddRelaxed(1);
+    }
+    CHECK_EQUAL(threadCount * iterations, popped.loadAcquire());
+}
+} // namespace
+
+TEST_GROUP(pctkReclamationTest) {};
+
+TEST(pctkReclamationTest, HazardProtectsRetiredNode)
+{
+    pctk::AtomicPointer<Node> shared(new Node(1));
+    pctk::HazardPointer hazard;
+    Node *node = hazard.protect(shared);
+    CHECK(node == shared.load());
+
+    shared.storeRelease(PCTK_NULLPTR);
+    pctk::HazardPointer::retire(node);
+    pctk::HazardPointer::reclaim();
+    CHECK_EQUAL(1, Node::alive.loadAcquire());
+    CHECK_EQUAL(1, node->value);
+
+    hazard.resetProtection();
+    pctk::HazardPointer::reclaim();
+    CHECK_EQUAL(0, Node::alive.loadAcquire());
+    CHECK_EQUAL(0u, (unsigned) pctk::HazardPointer::retiredCount());
+}
+
+TEST(pctkReclamationTest, HazardTryProtectDetectsChange)
+{
+    Node *first = new Node(1);
+    Node *second = new Node(2);
+    pctk::AtomicPointer<Node> shared(first);
+    pctk::HazardPointer hazard;
+    Node *seen = first;
+    shared.storeRelease(second);
+    CHECK(!hazard.tryProtect(seen, shared));
+    CHECK(seen == second);
+    CHECK(hazard.tryProtect(seen, shared));
+
+    pctk::HazardPointer moved(std::move(hazard));
+    CHECK(hazard.isEmpty());
+    CHECK(!moved.isEmpty());
+    hazard.resetProtection();
+    hazard.resetProtection(first);
+    pctk::HazardPointer assigned;
+    assigned = std::move(moved);
+    CHECK(moved.isEmpty());
+    moved.resetProtection();
+    delete first;
+    delete second;
+}
+
+TEST(pctkReclamationTest, HazardRetireListStaysBounded)
+{
+    std::size_t peak = 0;
+    for (int i = 0; i < 10000; ++i)
+    {
+        pctk::HazardPointer::retire(new Node(i));
+        const std::size_t retired = pctk::HazardPointer::retiredCount();
+        peak = retired > peak ? retired : peak;
+    }
+    const std::size_t bound = 2 * (std::size_t) pctk::HazardPointer::recordCount();
+    CHECK(peak <= (bound > 64 ? bound : 64));
+    pctk::HazardPointer::reclaim();
+    CHECK_EQUAL(0, Node::alive.loadAcquire());
+}
+
+TEST(pctkReclamationTest, HazardOrphansOfExitedThreads)
+{
+    pctk::AtomicPointer<Node> shared(new Node(1));
+    pctk::HazardPointer hazard;
+    Node *node = hazard.protect(shared);
+    std::thread([&]() {
+        shared.storeRelease(PCTK_NULLPTR);
+        pctk::HazardPointer::retire(node);
+    }).join();
+    CHECK_EQUAL(1, Node::alive.loadAcquire());
+    hazard.resetProtection();
+    pctk::HazardPointer::reclaim();
+    CHECK_EQUAL(0, Node::alive.loadAcquire());
+}
+
+TEST(pctkReclamationTest, HazardConcurrentStack)
+{
+    {
+        HazardStack stack;
+        hammer(stack, 4, 20000);
+    }
+    pctk::HazardPointer::reclaim();
+    CHECK_EQUAL(0, Node::alive.loadAcquire());
+}
+
+TEST(pctkReclamationTest, EpochGuardsNest)
+{
+    pctk::EpochDomain domain;
+    CHECK(!domain.isPinned());
+    {
+        pctk::EpochDomain::Guard outer(&domain);
+        CHECK(domain.isPinned());
+        {
+            pctk::EpochDomain::Guard inner(&domain);
+            CHECK(inner.domain() == &domain);
+        }
+        CHECK(domain.isPinned());
+    }
+    CHECK(!domain.isPinned());
+}
+
+TEST(pctkReclamationTest, EpochGuardHoldsBackReclamation)
+{
+    pctk::EpochDomain domain;
+    pctk::AtomicInt pinned(0);
+    pctk::AtomicInt release(0);
+    std::thread reader([&]() {
+        pctk::EpochDomain::Guard guard(&domain);
+        pinned.storeRelease(1);
+        pinned.notifyAll();
+        release.wait(0);
+    });
+    pinned.wait(0);
+
+    domain.retire(new Node(1));
+    for (int i = 0; i < 10; ++i)
+    {
+        domain.reclaim();
+    }
+    CHECK_EQUAL(1, Node::alive.loadAcquire());
+    CHECK_EQUAL(1u, (unsigned) domain.retiredCount());
+
+    release.storeRelease(1);
+    release.notifyAll();
+    reader.join();
+    domain.synchronize();
+    CHECK_EQUAL(0, Node::alive.loadAcquire());
+    CHECK_EQUAL(0u, (unsigned) domain.retiredCount());
+}
+
+TEST(pctkReclamationTest, EpochConcurrentStack)
+{
+    pctk::EpochDomain domain;
+    {
+        EpochStack stack(&domain);
+        hammer(stack, 4, 20000);
+    }
+    domain.synchronize();
+    CHECK_EQUAL(0, Node::alive.loadAcquire());
+
+    {
+        EpochStack global(pctk::EpochDomain::globalInstance());
+        hammer(global, 2, 1000);
+    }
+    pctk::EpochDomain::globalInstance()->synchronize();
+    CHECK_EQUAL(0, Node::alive.loadAcquire());
+}
+
+TEST(pctkReclamationTest, EpochDomainDestroyedBeforeThreads)
+{
+    pctk::AtomicInt used(0);
+    pctk::AtomicInt destroyed(0);
+    pctk::EpochDomain *domain = new pctk::EpochDomain;
+    std::thread worker([&]() {
+        {
+            pctk::EpochDomain::Guard guard(domain);
+        }
+        domain->retire(new Node(1));
+        used.storeRelease(1);
+        used.notifyAll();
+        destroyed.wait(0);
+    });
+    used.wait(0);
+    /* the destructor frees what the worker retired, the worker exits after the domain is gone */
+    delete domain;
+    CHECK_EQUAL(0, Node::alive.loadAcquire());
+    destroyed.storeRelease(1);
+    destroyed.notifyAll();
+    worker.join();
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
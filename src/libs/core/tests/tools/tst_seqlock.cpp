@@ -0,0 +1,138 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkSeqLock.h>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+/* Odd sized on purpose, the payload does not end on a word boundary. */
+struct Sample
+{
+    pctk_int64_t timestamp;
+    double position[3];
+    int count;
+    char tag;
+};
+} // namespace
+
+PCTK_BEGIN_NAMESPACE
+PCTK_DECL_TYPEINFO(Sample, PCTK_TYPEINFO_PRIMITIVE);
+PCTK_END_NAMESPACE
+
+TEST_GROUP(pctkSeqLockTest) {};
+
+TEST(pctkSeqLockTest, LoadStore)
+{
+    pctk::SeqLock<int> value(5);
+    CHECK_EQUAL(5, value.load());
+    CHECK_EQUAL(0, value.sequence());
+    value.store(7);
+    CHECK_EQUAL(7, value.load());
+    CHECK_EQUAL(2, value.sequence());
+    value.update([](int &current) { current *= 3; });
+    CHECK_EQUAL(21, value.load());
+
+    int out = 0;
+    CHECK(value.tryLoad(out));
+    CHECK_EQUAL(21, out);
+}
+
+TEST(pctkSeqLockTest, StructPayload)
+{
+    Sample sample = {};
+    sample.timestamp = 42;
+    sample.position[2] = 1.5;
+    sample.count = 3;
+    sample.tag = 'x';
+    pctk::SeqLock<Sample> lock(sample);
+    const Sample copy = lock.load();
+    CHECK_EQUAL(42, (int) copy.timestamp);
+    CHECK_EQUAL(1.5, copy.position[2]);
+    CHECK_EQUAL(3, copy.count);
+    CHECK_EQUAL('x', copy.tag);
+}
+
+TEST(pctkSeqLockTest, ReadersNeverSeeTornValues)
+{
+    pctk::SeqLock<Sample> lock;
+    pctk::AtomicInt writing(1);
+    pctk::AtomicInt torn(0);
+    pctk::AtomicInt reads(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t)
+    {
+        readers.push_back(std::thread([&]() {
+            pctk_int64_t last = 0;
+            while (writing.loadAcquire())
+            {
+                const Sample sample = lock.load();
+                /* every field is derived from the timestamp, a mix of two stores shows up as a mismatch */
+                if (sample.position[0] != (double) sample.timestamp || sample.count != (int) sample.timestamp ||
+                    sample.tag != (char) sample.timestamp || sample.timestamp < last)
+                {
+                    torn.fetchAndAddRelaxed(1);
+                }
+                last = sample.timestamp;
+                reads.fetchAndAddRelaxed(1);
+            }
+        }));
+    }
+    for (pctk_int64_t i = 1; i <= 200000; ++i)
+    {
+        Sample sample = {};
+        sample.timestamp = i;
+        sample.position[0] = sample.position[1] = sample.position[2] = (double) i;
+        sample.count = (int) i;
+        sample.tag = (char) i;
+        lock.store(sample);
+        if (0 == i % 1000)
+        {
+            std::this_thread::yield();
+        }
+    }
+    writing.storeRelease(0);
+    for (std::size_t t = 0; t < readers.size(); ++t)
+    {
+        readers[t].join();
+    }
+    CHECK_EQUAL(0, torn.loadAcquire());
+    CHECK(reads.loadAcquire() > 0);
+    CHECK_EQUAL(200000, (int) lock.load().timestamp);
+    CHECK_EQUAL(400000, lock.sequence());
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
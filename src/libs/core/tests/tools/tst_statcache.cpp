@@ -0,0 +1,391 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkStatCache.h>
+#include <pctkFileSystem.h>
+#include <pctkFileTree.h>
+#include <pctkThreadPool.h>
+
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include "tst_common.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using tst::write;
+
+TEST_GROUP(pctkStatCacheTest) {};
+
+TEST(pctkStatCacheTest, Query)
+{
+    const std::string root = tst::makeTemp("stat");
+    write(root + "/file", "12345", 0640);
+
+    const pctk::FileStatus file = pctk::FileStatus::query(root + "/file");
+    CHECK(file.isFile());
+    CHECK_FALSE(file.error());
+    CHECK_EQUAL(5u, (unsigned) file.size());
+    CHECK_EQUAL(0640u, file.permissions());
+    struct stat buffer;
+    CHECK_EQUAL(0, ::stat((root + "/file").c_str(), &buffer));
+    CHECK_EQUAL((unsigned long) buffer.st_ino, (unsigned long) file.inode());
+    CHECK_EQUAL((unsigned long) buffer.st_dev, (unsigned long) file.device());
+    CHECK_EQUAL((long long) buffer.st_mtim.tv_sec, (long long) (file.modificationTime() / 1000000000));
+
+    CHECK(pctk::FileStatus::query(root).isDirectory());
+    const pctk::FileStatus missing = pctk::FileStatus::query(root + "/missing");
+    CHECK_FALSE(missing.exists());
+    CHECK_FALSE(missing.error());
+    /* a path running through a file is missing as well */
+    const pctk::FileStatus through = pctk::FileStatus::query(root + "/file/child");
+    CHECK_FALSE(through.exists());
+    CHECK_FALSE(through.error());
+    const pctk::FileStatus tooLong = pctk::FileStatus::query(root + "/" + std::string(5000, 'x'));
+    CHECK_FALSE(tooLong.exists());
+    CHECK(std::errc::filename_too_long == tooLong.error());
+
+    CHECK(pctk::FileTree::removeAll(root).ok());
+}
+
+TEST(pctkStatCacheTest, TimeToLive)
+{
+    const std::string root = tst::makeTemp("stat");
+    const std::string path = root + "/late";
+
+    pctk::StatCache::Options options;
+    options.timeToLiveNSecs = 0;
+    pctk::StatCache manual(options);
+    CHECK_FALSE(manual.status(path).exists());
+    write(path, "x");
+    /* a cached miss stays until it is invalidated */
+    CHECK_FALSE(manual.status(path).exists());
+    CHECK_EQUAL(1, (int) manual.missCount());
+    CHECK_EQUAL(1, (int) manual.hitCount());
+    manual.invalidate(path);
+    CHECK(manual.status(path).isFile());
+    CHECK_EQUAL(1u, (unsigned) manual.size());
+    manual.clear();
+    CHECK_EQUAL(0u, (unsigned) manual.size());
+
+    options.timeToLiveNSecs = 30 * 1000 * 1000;
+    pctk::StatCache expiring(options);
+    CHECK(expiring.status(path).isFile());
+    ::unlink(path.c_str());
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    CHECK_FALSE(expiring.status(path).exists());
+
+    /* failures other than a missing path are not cached */
+    const std::string tooLong = root + "/" + std::string(5000, 'x');
+    CHECK((bool) expiring.status(tooLong).error());
+    CHECK((bool) expiring.status(tooLong).error());
+    CHECK_EQUAL(0, (int) expiring.hitCount());
+
+    options.capacity = 4;
+    pctk::StatCache small(options);
+    for (int i = 0; i < 10; ++i)
+    {
+        small.status(root + "/" + std::to_string(i));
+        CHECK(small.size() <= 4u);
+    }
+
+    CHECK(pctk::FileTree::removeAll(root).ok());
+}
+
+TEST(pctkStatCacheTest, Watch)
+{
+    const std::string root = tst::makeTemp("stat");
+    pctk::StatCache::Options options;
+    options.timeToLiveNSecs = 0;
+    options.watch = true;
+    options.changeLatencyNSecs = 0;
+    pctk::StatCache cache(options);
+    if (!cache.isWatching())
+    {
+        pctk::FileTree::removeAll(root);
+        return;
+    }
+    const std::string path = root + "/a";
+    CHECK_FALSE(cache.status(path).exists());
+    CHECK_FALSE(cache.status(path).exists());
+    CHECK_EQUAL(1, (int) cache.hitCount());
+
+    write(path, "1");
+    CHECK(cache.status(path).isFile());
+    CHECK_EQUAL(1u, (unsigned) cache.status(path).size());
+    write(path, "123");
+    CHECK_EQUAL(3u, (unsigned) cache.status(path).size());
+    CHECK_EQUAL(0, ::chmod(path.c_str(), 0600));
+    CHECK_EQUAL(0600u, cache.status(path).permissions());
+
+    CHECK_EQUAL(0, ::rename(path.c_str(), (root + "/b").c_str()));
+    CHECK_FALSE(cache.status(path).exists());
+    CHECK(cache.status(root + "/b").isFile());
+    CHECK_EQUAL(0, ::mkdir(path.c_str(), 0755));
+    CHECK(cache.status(path).isDirectory());
+
+    /* a second spelling of the directory shares the watch */
+    const std::string other = root + "/a/../b";
+    CHECK(cache.status(other).isFile());
+    ::unlink((root + "/b").c_str());
+    CHECK_FALSE(cache.status(other).exists());
+    CHECK_FALSE(cache.status(root + "/b").exists());
+
+    /* spellings an event cannot be mapped back to are queried every time */
+    const pctk::FileStatus trailing = cache.status(path + "/");
+    CHECK(trailing.isDirectory());
+    const pctk_int64_t hits = cache.hitCount();
+    cache.status(path + "/");
+    CHECK_EQUAL(hits, cache.hitCount());
+
+    /* the watched directory going away drops everything below it */
+    CHECK(cache.status(path + "/inner").exists() == false);
+    CHECK(pctk::FileTree::removeAll(path).ok());
+    write(path, "file again");
+    CHECK(cache.status(path).isFile());
+    CHECK_FALSE(cache.status(path + "/inner").exists());
+
+    CHECK(pctk::FileTree::removeAll(root).ok());
+    CHECK_FALSE(cache.status(path).exists());
+}
+
+TEST(pctkStatCacheTest, ChangeLatency)
+{
+    const std::string root = tst::makeTemp("stat");
+    const std::string path = root + "/a";
+    write(path, "1");
+    pctk::StatCache::Options options;
+    options.timeToLiveNSecs = 0;
+    options.watch = true;
+    options.changeLatencyNSecs = PCTK_NSECS_PER_HOUR;
+    pctk::StatCache cache(options);
+    if (!cache.isWatching())
+    {
+        pctk::FileTree::removeAll(root);
+        return;
+    }
+
+    /* hits do not read the change until the interval is over */
+    CHECK_EQUAL(1u, (unsigned) cache.status(path).size());
+    write(path, "123");
+    CHECK_EQUAL(1u, (unsigned) cache.status(path).size());
+    CHECK_EQUAL(1, (int) cache.hitCount());
+    cache.invalidate(path);
+    CHECK_EQUAL(3u, (unsigned) cache.status(path).size());
+
+    CHECK(pctk::FileTree::removeAll(root).ok());
+}
+
+TEST(pctkStatCacheTest, StatMany)
+{
+    const std::string root = tst::makeTemp("stat");
+    std::vector<std::string> paths;
+    for (int i = 0; i < 300; ++i)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/entry%03d", i);
+        paths.push_back(root + name);
+        if (0 == i % 3)
+        {
+            write(paths.back(), std::string((std::size_t) i, 'x'));
+        }
+        else if (1 == i % 3)
+        {
+            CHECK_EQUAL(0, ::mkdir(paths.back().c_str(), 0755));
+        }
+    }
+
+    pctk::ThreadPool pool(4);
+    pctk::StatCache::Options options;
+    options.pool = &pool;
+    pctk::StatCache cache(options);
+    const std::vector<pctk::FileStatus> first = cache.statMany(paths);
+    CHECK_EQUAL(paths.size(), first.size());
+    for (std::size_t i = 0; i < paths.size(); ++i)
+    {
+        const pctk::FileStatus expected = pctk::FileStatus::query(paths[i]);
+        CHECK_EQUAL((int) expected.type(), (int) first[i].type());
+        CHECK_EQUAL((unsigned) expected.size(), (unsigned) first[i].size());
+        CHECK_EQUAL((unsigned long) expected.inode(), (unsigned long) first[i].inode());
+    }
+    CHECK_EQUAL(300, (int) cache.missCount());
+    CHECK_EQUAL(300u, (unsigned) cache.size());
+
+    const std::vector<pctk::FileStatus> second = cache.statMany(paths);
+    CHECK_EQUAL(300, (int) cache.hitCount());
+    for (std::size_t i = 0; i < paths.size(); ++i)
+    {
+        CHECK_EQUAL((int) first[i].type(), (int) second[i].type());
+    }
+    CHECK(cache.status(paths[0]).isFile());
+    CHECK_EQUAL(301, (int) cache.hitCount());
+
+    CHECK(pctk::FileTree::removeAll(root).ok());
+}
+
+TEST(pctkStatCacheTest, ChangesToOtherPathsKeepMisses)
+{
+    const std::string root = tst::makeTemp("stat");
+    std::vector<std::string> paths;
+    for (int i = 0; i < 300; ++i)
+    {
+        paths.push_back(root + "/" + std::to_string(i));
+        write(paths.back(), "x");
+    }
+    pctk::ThreadPool pool(4);
+    pctk::StatCache::Options options;
+    options.timeToLiveNSecs = 0;
+    options.watch = true;
+    options.pool = &pool;
+    pctk::StatCache cache(options);
+
+    /* a sibling changing all the time must not keep the misses of the same directory from being entered */
+    const std::string busy = root + "/busy";
+    pctk::AtomicInt stop(0);
+    std::thread churn([&]() {
+        while (0 == stop.loadAcquire())
+        {
+            write(busy, "y");
+            cache.status(busy);
+            cache.invalidate(busy);
+        }
+    });
+    cache.statMany(paths);
+    for (std::size_t i = 0; i < paths.size(); i += 10)
+    {
+        cache.status(paths[i]);
+    }
+    stop.storeRelease(1);
+    churn.join();
+
+    const pctk_int64_t hits = cache.hitCount();
+    cache.statMany(paths);
+    CHECK_EQUAL(300, (int) (cache.hitCount() - hits));
+    CHECK(pctk::FileTree::removeAll(root).ok());
+}
+
+TEST(pctkStatCacheTest, FileSystemQueries)
+{
+    const std::string root = tst::makeTemp("stat");
+    write(root + "/file", "x");
+    pctk::FileSystem fileSystem;
+    CHECK(PCTK_NULLPTR == fileSystem.statCache());
+
+    std::error_code error;
+    CHECK(fileSystem.isFile(root + "/file", error));
+    CHECK_FALSE(error);
+    CHECK(fileSystem.isDirectory(root, error));
+    CHECK_FALSE(fileSystem.exists(root + "/missing", error));
+    CHECK_FALSE(error);
+    CHECK_FALSE(fileSystem.isDirectory(root + "/file/child", error));
+    CHECK_FALSE(error);
+
+    const std::string tooLong = root + "/" + std::string(5000, 'x');
+    CHECK_FALSE(fileSystem.exists(tooLong, error));
+    CHECK((bool) error);
+    bool thrown = false;
+    try
+    {
+        fileSystem.exists(tooLong);
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    pctk::StatCache::Options options;
+    options.timeToLiveNSecs = 0;
+    pctk::StatCache cache(options);
+    fileSystem.setStatCache(&cache);
+    CHECK(&cache == fileSystem.statCache());
+    CHECK_FALSE(fileSystem.exists(root + "/later"));
+    write(root + "/later", "x");
+    CHECK_FALSE(fileSystem.isFile(root + "/later"));
+    CHECK(fileSystem.isFile(root + "/file"));
+    CHECK_FALSE(fileSystem.isDirectory(root + "/file"));
+    CHECK(cache.hitCount() >= 2);
+    fileSystem.setStatCache(PCTK_NULLPTR);
+    CHECK(fileSystem.isFile(root + "/later"));
+
+    CHECK(pctk::FileTree::removeAll(root).ok());
+}
+
+TEST(pctkStatCacheTest, ConcurrentQueries)
+{
+    const std::string root = tst::makeTemp("stat");
+    std::vector<std::string> paths;
+    for (int i = 0; i < 16; ++i)
+    {
+        paths.push_back(root + "/" + std::to_string(i));
+        write(paths.back(), "x");
+    }
+    pctk::StatCache::Options options;
+    options.watch = true;
+    pctk::StatCache cache(options);
+    pctk::AtomicInt wrong(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.push_back(std::thread([&, t]() {
+            for (int round = 0; round < 500; ++round)
+            {
+                const std::string &path = paths[(std::size_t) (round + t) % paths.size()];
+                if (!cache.status(path).isFile())
+                {
+                    wrong.fetchAndAddRelaxed(1);
+                }
+                if (0 == round % 50)
+                {
+                    cache.invalidate(path);
+                    write(path, "y");
+                }
+            }
+        }));
+    }
+    for (std::size_t t = 0; t < threads.size(); ++t)
+    {
+        threads[t].join();
+    }
+    CHECK_EQUAL(0, wrong.loadAcquire());
+    CHECK(pctk::FileTree::removeAll(root).ok());
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
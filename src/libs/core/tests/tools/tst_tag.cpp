@@ -0,0 +1,283 @@
+/***********************************************************************************************************************
+**
+** Library: UTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkTag.h>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_GROUP(pctkTagTest) {};
+
+TEST(pctkTagTest, Invalid)
+{
+    pctk::Tag tag;
+    CHECK(!tag.isValid());
+    CHECK(!pctk::Tag("").isValid());
+    CHECK(!pctk::Tag(std::string()).isValid());
+    STRCMP_EQUAL("", tag.name());
+    CHECK(tag.toString().empty());
+    CHECK(tag != "");
+}
+
+TEST(pctkTagTest, Intern)
+{
+    pctk::Tag first("pctk.tag.intern");
+    pctk::Tag second(std::string("pctk.tag.intern"));
+    CHECK(first.isValid());
+    CHECK(first == second);
+    CHECK(first.uniqueIdentifier() >= pctk::Tag::ReservedIdCount);
+    CHECK(first.name() == second.name());
+    STRCMP_EQUAL("pctk.tag.intern", first.name());
+    CHECK(first == "pctk.tag.intern");
+    CHECK(first != "pctk.tag.other");
+    CHECK(first != pctk::Tag("pctk.tag.other"));
+    CHECK(first == pctk::Tag::fromUniqueIdentifier(first.uniqueIdentifier()));
+    CHECK(first == pctk::Tag::fromString("pctk.tag.intern"));
+    CHECK_EQUAL(std::string("pctk.tag.intern"), first.toString());
+}
+
+TEST(pctkTagTest, LengthLimitedName)
+{
+    const std::string prefix = std::string("pctk.tag.prefix.tail").substr(0, 15);
+    pctk::Tag tag(prefix);
+    STRCMP_EQUAL("pctk.tag.prefix", tag.name());
+    CHECK(tag == pctk::Tag("pctk.tag.prefix"));
+}
+
+TEST(pctkTagTest, Affixes)
+{
+    pctk::Tag base("pctk.tag.base");
+    STRCMP_EQUAL("pctk.tag.base7", base.withSuffix(7).name());
+    STRCMP_EQUAL("pctk.tag.base.x", base.withSuffix(".x").name());
+    STRCMP_EQUAL("pctk.tag.base.y", base.withSuffix(std::string(".y")).name());
+    STRCMP_EQUAL("x.pctk.tag.base", base.withPrefix("x.").name());
+    CHECK(base.withSuffix(7) == pctk::Tag("pctk.tag.base7"));
+}
+
+TEST(pctkTagTest, RegisterId)
+{
+    pctk::Tag::registerId(42, "pctk.tag.registered");
+    pctk::Tag::registerId(42, "pctk.tag.registered");
+    CHECK_EQUAL(42, pctk::Tag("pctk.tag.registered").uniqueIdentifier());
+    STRCMP_EQUAL("pctk.tag.registered", pctk::Tag(42).name());
+
+    bool thrown = false;
+    try
+    {
+        pctk::Tag::registerId(43, "pctk.tag.registered");
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    thrown = false;
+    try
+    {
+        pctk::Tag::registerId(42, "pctk.tag.registered.other");
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    thrown = false;
+    try
+    {
+        pctk::Tag::registerId(pctk::Tag::ReservedIdCount, "pctk.tag.out.of.range");
+    }
+    catch (const std::out_of_range &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+PCTK_STATIC_ASSERT(pctk::detail::tagHash("", 0) == 0);
+PCTK_STATIC_ASSERT(pctk::detail::tagHash("a", 1) == 'a');
+
+static pctk::Tag readyTag()
+{
+    return PCTK_TAG("pctk.tag.literal.ready");
+}
+
+TEST(pctkTagTest, Literal)
+{
+    const pctk::Tag tag = PCTK_TAG("pctk.tag.literal");
+    CHECK(tag.isValid());
+    CHECK(tag == pctk::Tag("pctk.tag.literal"));
+    STRCMP_EQUAL("pctk.tag.literal", tag.name());
+    CHECK(PCTK_TAG("pctk.tag.literal") == tag);
+    CHECK(readyTag() == readyTag());
+    CHECK(readyTag() == pctk::Tag("pctk.tag.literal.ready"));
+    CHECK(readyTag() != tag);
+    CHECK(!PCTK_TAG("").isValid());
+
+    /* bytes above 0x7f take the sign extension path of the hash */
+    CHECK(PCTK_TAG("pctk.tag.\xc3\xa9") == pctk::Tag("pctk.tag.\xc3\xa9"));
+}
+
+TEST(pctkTagTest, RegisterIdBulk)
+{
+    static PCTK_CONSTEXPR pctk::TagRegistration tags[] = {
+        {100, "pctk.tag.bulk.a"},
+        {101, "pctk.tag.bulk.b"},
+        {102, "pctk.tag.bulk.c"},
+    };
+    PCTK_STATIC_ASSERT(tags[1].hash == pctk::detail::tagHash("pctk.tag.bulk.b", 15));
+    pctk::Tag::registerId(tags);
+    pctk::Tag::registerId(tags);
+    CHECK_EQUAL(100, pctk::Tag("pctk.tag.bulk.a").uniqueIdentifier());
+    CHECK_EQUAL(101, PCTK_TAG("pctk.tag.bulk.b").uniqueIdentifier());
+    STRCMP_EQUAL("pctk.tag.bulk.c", pctk::Tag(102).name());
+
+    static PCTK_CONSTEXPR pctk::TagRegistration clash[] = {{103, "pctk.tag.bulk.a"}};
+    bool thrown = false;
+    try
+    {
+        pctk::Tag::registerId(clash);
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    static PCTK_CONSTEXPR pctk::TagRegistration duplicate[] = {{104, "pctk.tag.bulk.d"}, {104, "pctk.tag.bulk.e"}};
+    thrown = false;
+    try
+    {
+        pctk::Tag::registerId(duplicate);
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    STRCMP_EQUAL("", pctk::Tag(104).name());
+
+    /* a conflict anywhere in the table leaves every shard untouched */
+    static PCTK_CONSTEXPR pctk::TagRegistration partial[] = {
+        {105, "pctk.tag.bulk.f"},
+        {106, "pctk.tag.bulk.g"},
+        {107, "pctk.tag.bulk.h"},
+        {101, "pctk.tag.bulk.i"},
+    };
+    thrown = false;
+    try
+    {
+        pctk::Tag::registerId(partial);
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    STRCMP_EQUAL("", pctk::Tag(105).name());
+    STRCMP_EQUAL("", pctk::Tag(106).name());
+    STRCMP_EQUAL("", pctk::Tag(107).name());
+
+    thrown = false;
+    try
+    {
+        pctk::Tag::registerId(tags, -1);
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+TEST(pctkTagTest, ManyNames)
+{
+    const int count = 20000;
+    std::vector<pctk::Tag> tags;
+    for (int i = 0; i < count; ++i)
+    {
+        std::stringstream name;
+        name << "pctk.tag.many." << i;
+        tags.push_back(pctk::Tag(name.str()));
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        std::stringstream name;
+        name << "pctk.tag.many." << i;
+        CHECK(tags[i] == pctk::Tag(name.str()));
+        CHECK_EQUAL(name.str(), tags[i].toString());
+    }
+}
+
+TEST(pctkTagTest, ConcurrentIntern)
+{
+    const int threadCount = 8;
+    const int count = 2000;
+    std::vector<std::vector<int> > ids(threadCount, std::vector<int>(count));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.push_back(std::thread([t, &ids]() {
+            for (int i = 0; i < count; ++i)
+            {
+                /* every thread walks the names in a different order so inserts race on the same shards */
+                const int index = (i + t * 97) % count;
+                std::stringstream name;
+                name << "pctk.tag.concurrent." << index;
+                ids[t][index] = pctk::Tag(name.str()).uniqueIdentifier();
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i].join();
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        std::stringstream name;
+        name << "pctk.tag.concurrent." << i;
+        for (int t = 1; t < threadCount; ++t)
+        {
+            CHECK_EQUAL(ids[0][i], ids[t][i]);
+        }
+        STRCMP_EQUAL(name.str().c_str(), pctk::Tag(ids[0][i]).name());
+    }
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
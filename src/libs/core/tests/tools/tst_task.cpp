@@ -0,0 +1,154 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkTask.h>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+TEST_GROUP(pctkTaskTest) {};
+
+TEST(pctkTaskTest, FrameAllocatorReusesBlocks)
+{
+    void *first = pctk::detail::taskFrameAllocate(100);
+    pctk::detail::taskFrameDeallocate(first, 100);
+    /* any size of the same 64 byte class gets the block back */
+    void *second = pctk::detail::taskFrameAllocate(120);
+    CHECK(first == second);
+    pctk::detail::taskFrameDeallocate(second, 120);
+
+    void *large = pctk::detail::taskFrameAllocate(64 * 1024);
+    CHECK(PCTK_NULLPTR != large);
+    pctk::detail::taskFrameDeallocate(large, 64 * 1024);
+}
+
+TEST(pctkTaskTest, FrameReleasedOnAnotherThread)
+{
+    void *frame = pctk::detail::taskFrameAllocate(200);
+    std::thread([frame]() {
+        pctk::detail::taskFrameDeallocate(frame, 200);
+        void *again = pctk::detail::taskFrameAllocate(200);
+        CHECK(frame == again);
+        pctk::detail::taskFrameDeallocate(again, 200);
+    }).join();
+}
+
+#if PCTK_CC_FEATURE_COROUTINES
+namespace
+{
+pctk::Task<int> answer()
+{
+    co_return 42;
+}
+
+pctk::Task<int> sum(int depth)
+{
+    if (0 == depth)
+    {
+        co_return 0;
+    }
+    const int rest = co_await sum(depth - 1);
+    co_return depth + rest;
+}
+
+pctk::Task<void> fail()
+{
+    throw std::runtime_error("task failed");
+    co_return;
+}
+
+pctk::Task<int> awaitEmpty()
+{
+    pctk::Task<int> empty;
+    co_return co_await empty;
+}
+
+pctk::Task<std::string> hop(pctk::ThreadPool &pool, std::thread::id *ranOn)
+{
+    co_await pctk::schedule(pool);
+    *ranOn = std::this_thread::get_id();
+    const int value = co_await answer();
+    co_return std::to_string(value);
+}
+
+pctk::Task<int> awaitFuture(pctk::Future<int> future)
+{
+    const int value = co_await future;
+    co_return value + 1;
+}
+} // namespace
+
+TEST(pctkTaskTest, LazyAndNested)
+{
+    pctk::Task<int> task = answer();
+    CHECK(task.isValid());
+    CHECK_FALSE(task.isReady());
+    CHECK_EQUAL(42, pctk::syncWait(std::move(task)));
+    /* symmetric transfer keeps a deep await chain off the stack */
+    CHECK_EQUAL(5000 * 5001 / 2, pctk::syncWait(sum(5000)));
+}
+
+TEST(pctkTaskTest, ErrorsPropagate)
+{
+    pctk::Future<void> future = pctk::toFuture(fail());
+    CHECK(future.isReady());
+    CHECK(future.hasError());
+    CHECK("task failed" == future.errorString());
+    CHECK_THROWS(std::runtime_error, pctk::syncWait(fail()));
+    CHECK_THROWS(std::logic_error, pctk::syncWait(awaitEmpty()));
+}
+
+TEST(pctkTaskTest, ScheduleOnThreadPool)
+{
+    pctk::ThreadPool pool(2);
+    std::thread::id ranOn;
+    CHECK("42" == pctk::syncWait(hop(pool, &ranOn)));
+    CHECK(ranOn != std::this_thread::get_id());
+    pool.waitForDone();
+}
+
+TEST(pctkTaskTest, AwaitFuture)
+{
+    CHECK_EQUAL(8, pctk::syncWait(awaitFuture(pctk::makeReadyFuture(7))));
+
+    pctk::Promise<int> promise;
+    pctk::Future<int> result = pctk::toFuture(awaitFuture(promise.future()));
+    CHECK_FALSE(result.isReady());
+    std::thread([&promise]() { promise.setValue(1); }).join();
+    CHECK_EQUAL(2, result.get());
+}
+#endif
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
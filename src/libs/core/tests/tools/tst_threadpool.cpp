@@ -0,0 +1,215 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkThreadPool.h>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#if defined(PCTK_OS_UNIX)
+#   include <pthread.h>
+#endif
+
+namespace
+{
+void fanOut(pctk::ThreadPool *pool, pctk::AtomicInt *counter, int depth)
+{
+    counter->fetchAndAddRelaxed(1);
+    if (depth > 0)
+    {
+        pool->submit([=]() { fanOut(pool, counter, depth - 1); });
+        pool->submit([=]() { fanOut(pool, counter, depth - 1); });
+    }
+}
+} // namespace
+
+TEST_GROUP(pctkThreadPoolTest) {};
+
+TEST(pctkThreadPoolTest, RunsExternalSubmissions)
+{
+    pctk::ThreadPool pool(4);
+    CHECK_EQUAL(4, pool.threadCount());
+    CHECK(!pool.isWorkerThread());
+    CHECK_EQUAL(-1, pctk::ThreadPool::currentThreadIndex());
+
+    pctk::AtomicInt counter(0);
+    for (int i = 0; i < 10000; ++i)
+    {
+        pool.submit([&counter]() { counter.fetchAndAddRelaxed(1); });
+    }
+    pool.waitForDone();
+    CHECK_EQUAL(10000, counter.loadAcquire());
+    CHECK_EQUAL(0, pool.pendingCount());
+
+    /* the pool stays usable after waitForDone() and after its workers went to sleep */
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    pool.submit([&counter]() { counter.fetchAndAddRelaxed(1); });
+    pool.waitForDone();
+    CHECK_EQUAL(10001, counter.loadAcquire());
+}
+
+TEST(pctkThreadPoolTest, RunsNestedSubmissions)
+{
+    pctk::ThreadPool pool(3);
+    pctk::AtomicInt counter(0);
+    pool.submit([&]() { fanOut(&pool, &counter, 12); });
+    pool.waitForDone();
+    CHECK_EQUAL((1 << 13) - 1, counter.loadAcquire());
+}
+
+TEST(pctkThreadPoolTest, TasksKnowTheirWorker)
+{
+    pctk::ThreadPool pool(2);
+    pctk::AtomicInt inside(0);
+    pctk::AtomicInt badIndex(0);
+    for (int i = 0; i < 100; ++i)
+    {
+        pool.submit([&]() {
+            const int index = pctk::ThreadPool::currentThreadIndex();
+            if (index < 0 || index >= 2)
+            {
+                badIndex.fetchAndAddRelaxed(1);
+            }
+            if (pool.isWorkerThread())
+            {
+                inside.fetchAndAddRelaxed(1);
+            }
+        });
+    }
+    pool.waitForDone();
+    CHECK_EQUAL(100, inside.loadAcquire());
+    CHECK_EQUAL(0, badIndex.loadAcquire());
+}
+
+TEST(pctkThreadPoolTest, IdleWorkersSteal)
+{
+    pctk::ThreadPool pool(4);
+    pctk::AtomicInt used(0);
+    pool.submit([&]() {
+        /* everything lands in the submitting worker's own deque, other workers only get it by stealing */
+        for (int i = 0; i < 64; ++i)
+        {
+            pool.submit([&]() {
+                used.fetchAndOrRelaxed(1 << pctk::ThreadPool::currentThreadIndex());
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    });
+    pool.waitForDone();
+    const int mask = used.loadAcquire();
+    CHECK(mask != 0);
+    CHECK(0 != (mask & (mask - 1)));
+}
+
+TEST(pctkThreadPoolTest, DestructorDrainsQueue)
+{
+    pctk::AtomicInt counter(0);
+    {
+        pctk::ThreadPool pool(2);
+        for (int i = 0; i < 5000; ++i)
+        {
+            pool.submit([&counter]() { counter.fetchAndAddRelaxed(1); });
+        }
+    }
+    CHECK_EQUAL(5000, counter.loadAcquire());
+
+    pctk::ThreadPool pool(2);
+    pool.submit([&counter]() { counter.fetchAndAddRelaxed(1); });
+    pool.shutdown();
+    pool.shutdown();
+    CHECK_EQUAL(5001, counter.loadAcquire());
+}
+
+TEST(pctkThreadPoolTest, Options)
+{
+    pctk::ThreadPool::Options options;
+    options.threadCount = 2;
+    options.stackSize = 256 * 1024;
+    options.name = "averylongpoolname";
+    pctk::ThreadPool pool(options);
+    CHECK_EQUAL(2, pool.threadCount());
+
+    pctk::AtomicInt stackOk(1);
+    pctk::AtomicInt nameOk(1);
+    for (int i = 0; i < 2; ++i)
+    {
+        pool.submit([&]() {
+#if defined(PCTK_OS_LINUX)
+            pthread_attr_t attr;
+            std::size_t stackSize = 0;
+            if (0 == pthread_getattr_np(pthread_self(), &attr))
+            {
+                pthread_attr_getstacksize(&attr, &stackSize);
+                pthread_attr_destroy(&attr);
+                if (stackSize < 256 * 1024 || stackSize >= 1024 * 1024)
+                {
+                    stackOk.store(0);
+                }
+            }
+#endif
+#if PCTK_HAS_PTHREAD_GETNAME_NP && PCTK_HAS_PTHREAD_SETNAME_NP
+            char name[64] = {0};
+            pthread_getname_np(pthread_self(), name, sizeof(name));
+            char expected[64];
+            std::snprintf(expected, sizeof(expected), "averylongpool-%d", pctk::ThreadPool::currentThreadIndex());
+            if (0 != std::strcmp(name, expected))
+            {
+                nameOk.store(0);
+            }
+#endif
+        });
+    }
+    pool.waitForDone();
+    CHECK_EQUAL(1, stackOk.loadAcquire());
+    CHECK_EQUAL(1, nameOk.loadAcquire());
+}
+
+TEST(pctkThreadPoolTest, GlobalInstance)
+{
+    pctk::ThreadPool *pool = pctk::ThreadPool::globalInstance();
+    CHECK(pool == pctk::ThreadPool::globalInstance());
+    CHECK(pool->threadCount() >= 1);
+    pctk::AtomicInt counter(0);
+    for (int i = 0; i < 100; ++i)
+    {
+        pool->submit([&counter]() { counter.fetchAndAddRelaxed(1); });
+    }
+    pool->waitForDone();
+    CHECK_EQUAL(100, counter.loadAcquire());
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
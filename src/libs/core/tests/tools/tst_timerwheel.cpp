@@ -0,0 +1,296 @@
+/***********************************************************************************************************************
+**
+** Library: PCTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkTimerWheel.h>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const pctk_int64_t MSec = PCTK_NSECS_PER_MSEC;
+const pctk_int64_t Sec = PCTK_NSECS_PER_SEC;
+
+pctk::SteadyClock::time_point later(pctk::SteadyClock::time_point start, pctk_int64_t nsecs)
+{
+    return start + pctk::SteadyClock::duration(nsecs);
+}
+
+struct Tracked
+{
+    static pctk::AtomicInt alive;
+
+    explicit Tracked(int *counter) : counter(counter) { alive.fetchAndAddRelaxed(1); }
+    Tracked(const Tracked &other) : counter(other.counter) { alive.fetchAndAddRelaxed(1); }
+    ~Tracked() { alive.fetchAndSubRelaxed(1); }
+
+    void operator()() const { ++*counter; }
+
+    int *counter;
+};
+pctk::AtomicInt Tracked::alive(0);
+} // namespace
+
+TEST_GROUP(pctkSteadyClockTest) {};
+
+TEST(pctkSteadyClockTest, MonotonicAndOnSystemEpoch)
+{
+    pctk::SteadyClock::time_point previous = pctk::SteadyClock::now();
+    for (int i = 0; i < 100000; ++i)
+    {
+        const pctk::SteadyClock::time_point current = pctk::SteadyClock::now();
+        CHECK(current >= previous);
+        previous = current;
+    }
+#if defined(PCTK_OS_LINUX)
+    /* libstdc++'s steady_clock is CLOCK_MONOTONIC, the same epoch */
+    const pctk_int64_t system = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    CHECK(std::llabs(pctk::SteadyClock::nowNSecs() - system) < 5 * MSec);
+#endif
+    const pctk_int64_t coarse = pctk::SteadyClock::coarseNow().time_since_epoch().count();
+    CHECK(std::llabs(pctk::SteadyClock::nowNSecs() - coarse) < 50 * MSec);
+}
+
+TEST(pctkSteadyClockTest, MeasuresSleep)
+{
+    const pctk::SteadyClock::time_point start = pctk::SteadyClock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const pctk_int64_t elapsed = (pctk::SteadyClock::now() - start).count();
+    CHECK(elapsed >= 19 * MSec);
+    CHECK(elapsed < 2 * Sec);
+}
+
+TEST(pctkSteadyClockTest, StaysOnSystemClock)
+{
+    /* calibration never stalls a caller */
+    const pctk_int64_t before = pctk::SteadyClock::coarseNow().time_since_epoch().count();
+    pctk::SteadyClock::now();
+    CHECK(pctk::SteadyClock::coarseNow().time_since_epoch().count() - before < 5 * MSec);
+#if defined(PCTK_OS_LINUX)
+    /* across a few re-anchoring intervals the counter conversion keeps following CLOCK_MONOTONIC */
+    const pctk::SteadyClock::time_point start = pctk::SteadyClock::now();
+    pctk::SteadyClock::time_point previous = start;
+    pctk_int64_t worst = 0;
+    while (pctk::SteadyClock::now() - start < pctk::SteadyClock::duration(2500 * MSec))
+    {
+        const pctk::SteadyClock::time_point current = pctk::SteadyClock::now();
+        CHECK(current >= previous);
+        previous = current;
+        const pctk_int64_t system = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        const pctk_int64_t offset = std::llabs(pctk::SteadyClock::nowNSecs() - system);
+        worst = offset > worst ? offset : worst;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(worst < MSec);
+#endif
+}
+
+TEST_GROUP(pctkTimerWheelTest) {};
+
+TEST(pctkTimerWheelTest, FiresInOrderAcrossLevels)
+{
+    pctk::TimerWheel wheel;
+    const pctk::SteadyClock::time_point start = pctk::SteadyClock::now();
+    std::vector<int> fired;
+    /* 100ms sits in the first level, the others need one to four cascades */
+    const pctk_int64_t delays[] = {100 * MSec, 2 * Sec, 70 * Sec, 5 * 3600 * Sec, 20 * Sec};
+    for (int i = 0; i < 5; ++i)
+    {
+        wheel.start(delays[i], [&fired, i]() { fired.push_back(i); });
+    }
+    CHECK_EQUAL(5, (int) wheel.size());
+    CHECK_EQUAL(0, (int) wheel.expire(later(start, 50 * MSec)));
+    CHECK_EQUAL(1, (int) wheel.expire(later(start, 200 * MSec)));
+    CHECK_EQUAL(0, (int) wheel.expire(later(start, 1900 * MSec)));
+    CHECK_EQUAL(1, (int) wheel.expire(later(start, 2100 * MSec)));
+    CHECK_EQUAL(1, (int) wheel.expire(later(start, 30 * Sec)));
+    CHECK_EQUAL(0, (int) wheel.expire(later(start, 69 * Sec)));
+    CHECK_EQUAL(1, (int) wheel.expire(later(start, 71 * Sec)));
+    CHECK_EQUAL(0, (int) wheel.expire(later(start, 5 * 3600 * Sec - Sec)));
+    CHECK_EQUAL(1, (int) wheel.expire(later(start, 5 * 3600 * Sec + Sec)));
+    CHECK_EQUAL(0, (int) wheel.size());
+    CHECK_EQUAL(5, (int) fired.size());
+    CHECK_EQUAL(0, fired[0]);
+    CHECK_EQUAL(1, fired[1]);
+    CHECK_EQUAL(4, fired[2]);
+    CHECK_EQUAL(2, fired[3]);
+    CHECK_EQUAL(3, fired[4]);
+}
+
+TEST(pctkTimerWheelTest, NeverEarlyNeverLost)
+{
+    pctk::TimerWheel wheel;
+    const pctk::SteadyClock::time_point start = pctk::SteadyClock::now();
+    const int count = 50000;
+    std::vector<pctk_int64_t> deadlines(count);
+    std::vector<int> hits(count, 0);
+    pctk_int64_t clock = 0;
+    int early = 0;
+    std::srand(7);
+    for (int i = 0; i < count; ++i)
+    {
+        const pctk_int64_t delay = (pctk_int64_t) (std::rand() % 600000) * MSec;
+        deadlines[i] = (pctk::SteadyClock::now() - start).count() + delay;
+        wheel.start(delay, [&, i]() {
+            ++hits[i];
+            early += clock < deadlines[i] ? 1 : 0;
+        });
+    }
+    while (clock < 601 * Sec)
+    {
+        clock += (pctk_int64_t) (std::rand() % 3000) * MSec;
+        wheel.expire(later(start, clock));
+    }
+    wheel.expire(later(start, 602 * Sec));
+    CHECK_EQUAL(0, early);
+    CHECK_EQUAL(0, (int) wheel.size());
+    for (int i = 0; i < count; ++i)
+    {
+        CHECK_EQUAL(1, hits[i]);
+    }
+}
+
+TEST(pctkTimerWheelTest, CancelAndRestart)
+{
+    pctk::TimerWheel wheel;
+    const pctk::SteadyClock::time_point start = pctk::SteadyClock::now();
+    int counter = 0;
+    {
+        const pctk::TimerWheel::TimerId canceled = wheel.start(Sec, Tracked(&counter));
+        const pctk::TimerWheel::TimerId pushed = wheel.start(Sec, Tracked(&counter));
+        CHECK(0 != canceled);
+        CHECK(canceled != pushed);
+        CHECK_EQUAL(2, Tracked::alive.loadAcquire());
+        CHECK(wheel.cancel(canceled));
+        CHECK_FALSE(wheel.cancel(canceled));
+        CHECK_FALSE(wheel.restart(canceled, Sec));
+        CHECK_EQUAL(1, Tracked::alive.loadAcquire());
+
+        CHECK(wheel.restart(pushed, 10 * Sec));
+        CHECK_EQUAL(0, (int) wheel.expire(later(start, 5 * Sec)));
+        CHECK_EQUAL(1, (int) wheel.expire(later(start, 11 * Sec)));
+        CHECK_EQUAL(1, counter);
+        CHECK_EQUAL(0, Tracked::alive.loadAcquire());
+        CHECK_FALSE(wheel.cancel(pushed));
+
+        /* a reused node must not answer to the identifier of its previous timer */
+        const pctk::TimerWheel::TimerId reused = wheel.start(Sec, Tracked(&counter));
+        CHECK_FALSE(wheel.cancel(pushed));
+        CHECK(wheel.cancel(reused));
+    }
+    CHECK_FALSE(wheel.cancel(0));
+    CHECK_EQUAL(0, Tracked::alive.loadAcquire());
+}
+
+TEST(pctkTimerWheelTest, CallbacksMayUseTheWheel)
+{
+    pctk::TimerWheel wheel;
+    const pctk::SteadyClock::time_point start = pctk::SteadyClock::now();
+    int rearmed = 0;
+    int canceledRan = 0;
+    pctk::TimerWheel::TimerId victim = 0;
+    wheel.start(Sec, [&]() {
+        CHECK(wheel.cancel(victim));
+        wheel.start(Sec, [&rearmed]() { ++rearmed; });
+    });
+    /* due in the same batch, cancelled by the first callback before it runs */
+    victim = wheel.start(Sec, [&canceledRan]() { ++canceledRan; });
+    CHECK_EQUAL(1, (int) wheel.expire(later(start, 2 * Sec)));
+    CHECK_EQUAL(0, canceledRan);
+    CHECK_EQUAL(1, (int) wheel.size());
+    CHECK_EQUAL(1, (int) wheel.expire(later(start, 4 * Sec)));
+    CHECK_EQUAL(1, rearmed);
+}
+
+TEST(pctkTimerWheelTest, NextTimeout)
+{
+    pctk::TimerWheel wheel;
+    const pctk::SteadyClock::time_point start = pctk::SteadyClock::now();
+    CHECK_EQUAL(-1, wheel.nextTimeout(start));
+    const pctk::TimerWheel::TimerId far = wheel.start(70 * Sec, [] {});
+    const pctk_int64_t coarse = wheel.nextTimeout(start);
+    CHECK(coarse > 0);
+    CHECK(coarse <= 70 * Sec + MSec);
+    /* within the first level the timeout is exact */
+    wheel.start(30 * MSec, [] {});
+    const pctk_int64_t near = wheel.nextTimeout(start);
+    CHECK(near >= 30 * MSec - MSec);
+    CHECK(near <= 30 * MSec + 2 * MSec);
+    CHECK_EQUAL(0, wheel.nextTimeout(later(start, Sec)));
+    wheel.expire(later(start, Sec));
+    CHECK(wheel.cancel(far));
+    CHECK_EQUAL(-1, wheel.nextTimeout(start));
+}
+
+TEST(pctkTimerWheelTest, ThreadDriven)
+{
+    pctk::TimerWheel wheel;
+    wheel.startThread();
+    pctk::AtomicInt fired(0);
+    const pctk::SteadyClock::time_point start = pctk::SteadyClock::now();
+    /* the thread sleeps for the far timer and has to be woken for the near one */
+    wheel.start(3600 * Sec, [&fired]() { fired.storeRelease(-1); });
+    pctk::Future<void> future = wheel.after(20 * MSec);
+    wheel.start(10 * MSec, [&fired]() {
+        fired.storeRelease(1);
+        fired.notifyAll();
+    });
+    fired.waitFor(0, 5 * Sec);
+    CHECK_EQUAL(1, fired.loadAcquire());
+    CHECK(future.waitFor(5 * Sec));
+    CHECK((pctk::SteadyClock::now() - start).count() >= 20 * MSec);
+    wheel.stopThread();
+    CHECK_EQUAL(1, (int) wheel.size());
+}
+
+TEST(pctkTimerWheelTest, DestructionDropsPendingTimers)
+{
+    int counter = 0;
+    pctk::Future<void> future;
+    {
+        pctk::TimerWheel wheel;
+        wheel.start(Sec, Tracked(&counter));
+        future = wheel.after(Sec);
+        CHECK_EQUAL(1, Tracked::alive.loadAcquire());
+    }
+    CHECK_EQUAL(0, counter);
+    CHECK_EQUAL(0, Tracked::alive.loadAcquire());
+    CHECK(future.hasError());
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
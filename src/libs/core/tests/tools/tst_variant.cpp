@@ -0,0 +1,208 @@
+/***********************************************************************************************************************
+**
+** Library: UTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkVariant.h>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+typedef pctk::Variant<int, double, std::string> Message;
+typedef pctk::Variant<int, char, void *> Primitive;
+
+struct Counted
+{
+    static int alive;
+
+    int value;
+
+    Counted(int v = 0) : value(v) { ++alive; }
+    Counted(const Counted &other) : value(other.value) { ++alive; }
+    ~Counted() { --alive; }
+
+    bool operator==(const Counted &other) const { return value == other.value; }
+};
+int Counted::alive = 0;
+
+struct ThrowsOnCopy
+{
+    ThrowsOnCopy() {}
+    ThrowsOnCopy(const ThrowsOnCopy &) { throw std::runtime_error("copy"); }
+};
+
+struct IsInt
+{
+    bool operator()(int) const { return true; }
+    bool operator()(const ThrowsOnCopy &) const { return false; }
+};
+
+struct Describe
+{
+    std::string operator()(int value) const { return "int:" + std::to_string(value); }
+    std::string operator()(double) const { return "double"; }
+    std::string operator()(const std::string &value) const { return "string:" + value; }
+};
+
+struct Grow
+{
+    void operator()(int &value) const { value += 1; }
+    void operator()(double &value) const { value *= 2; }
+    void operator()(std::string &value) const { value += "!"; }
+};
+} // namespace
+
+TEST_GROUP(pctkVariantTest) {};
+
+TEST(pctkVariantTest, DefaultConstructsFirstType)
+{
+    Message message;
+    CHECK(message.index() == 0);
+    CHECK(message.holds<int>());
+    CHECK(message.get<int>() == 0);
+    CHECK_FALSE(message.isValueless());
+}
+
+TEST(pctkVariantTest, ConstructAndGet)
+{
+    Message message(std::string("payload"));
+    CHECK(message.index() == 2);
+    CHECK(message.get<std::string>() == "payload");
+    CHECK(message.getIf<int>() == PCTK_NULLPTR);
+    CHECK(*message.getIf<std::string>() == "payload");
+    CHECK_THROWS(pctk::BadVariantAccess, message.get<double>());
+
+    Message inPlace(pctk::in_place_type<std::string>, 3, 'x');
+    CHECK(inPlace.get<std::string>() == "xxx");
+}
+
+TEST(pctkVariantTest, AssignChangesAlternative)
+{
+    Message message = 7;
+    message = 2.5;
+    CHECK(message.holds<double>());
+    message = std::string("text");
+    CHECK(message.get<std::string>() == "text");
+    message = std::string("other");
+    CHECK(message.get<std::string>() == "other");
+
+    std::string &value = message.emplace<std::string>("emplaced");
+    value += "!";
+    CHECK(message.get<std::string>() == "emplaced!");
+}
+
+TEST(pctkVariantTest, CopyMoveAndSwap)
+{
+    Message a = std::string("a");
+    Message b(a);
+    CHECK(a == b);
+
+    Message c(std::move(a));
+    CHECK(c.get<std::string>() == "a");
+
+    Message d = 4;
+    c.swap(d);
+    CHECK(c.get<int>() == 4);
+    CHECK(d.get<std::string>() == "a");
+    CHECK(c != d);
+
+    Primitive x = 'x';
+    Primitive y = 9;
+    swap(x, y);
+    CHECK(x.get<int>() == 9);
+    CHECK(y.get<char>() == 'x');
+    Primitive z(x);
+    CHECK(z == x);
+}
+
+TEST(pctkVariantTest, DestroysValues)
+{
+    {
+        pctk::Variant<int, Counted> variant = Counted(5);
+        pctk::Variant<int, Counted> copy(variant);
+        CHECK(Counted::alive == 2);
+        copy = 3;
+        CHECK(Counted::alive == 1);
+        variant.swap(copy);
+        CHECK(Counted::alive == 1);
+        CHECK(copy.get<Counted>().value == 5);
+    }
+    CHECK(Counted::alive == 0);
+}
+
+TEST(pctkVariantTest, Visit)
+{
+    Message message = 3;
+    CHECK(pctk::visit(Describe(), message) == "int:3");
+    message = std::string("s");
+    const Message &constMessage = message;
+    CHECK(constMessage.visit(Describe()) == "string:s");
+
+    message.visit(Grow());
+    CHECK(message.get<std::string>() == "s!");
+    message = 1.5;
+    pctk::visit(Grow(), message);
+    CHECK(message.get<double>() == 3.0);
+}
+
+TEST(pctkVariantTest, ThrowingEmplaceLeavesValueless)
+{
+    pctk::Variant<int, ThrowsOnCopy> variant = 1;
+    ThrowsOnCopy source;
+    CHECK_THROWS(std::runtime_error, variant.emplace<ThrowsOnCopy>(source));
+    CHECK(variant.isValueless());
+    CHECK_THROWS(pctk::BadVariantAccess, variant.visit(IsInt()));
+    CHECK_FALSE(variant.toAny().hasValue());
+    variant = 2;
+    CHECK(variant.visit(IsInt()));
+}
+
+TEST(pctkVariantTest, ConvertWithAny)
+{
+    Message message = std::string("any");
+    pctk::Any any = message.toAny();
+    CHECK(pctk::any_cast<std::string>(any) == "any");
+
+    Message back;
+    CHECK(back.fromAny(any));
+    CHECK(back.get<std::string>() == "any");
+    CHECK(back.fromAny(pctk::Any(2.0)));
+    CHECK(back.get<double>() == 2.0);
+    CHECK_FALSE(back.fromAny(pctk::Any(1.0f)));
+    CHECK_FALSE(back.fromAny(pctk::Any()));
+    CHECK(back.holds<double>());
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}
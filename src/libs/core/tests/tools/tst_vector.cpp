@@ -0,0 +1,298 @@
+/***********************************************************************************************************************
+**
+** Library: UTK
+**
+** Copyright (C) 2023 ChengXueWen. Contact: 1398831004@qq.com
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <pctkVector.h>
+
+#include <type_traits>
+#include <vector>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+#include <list>
+#include <string>
+#include <stdexcept>
+
+namespace
+{
+/* Counts live instances and checks that every destroyed instance was constructed at that address. */
+struct Tracked
+{
+    static int alive;
+
+    Tracked *self;
+    int value;
+
+    Tracked(int v = 0) : self(this), value(v) { ++alive; }
+    Tracked(const Tracked &other) : self(this), value(other.value) { ++alive; }
+    Tracked &operator=(const Tracked &other)
+    {
+        value = other.value;
+        return *this;
+    }
+    ~Tracked()
+    {
+        CHECK(self == this);
+        --alive;
+    }
+
+    bool operator==(const Tracked &other) const { return value == other.value; }
+};
+int Tracked::alive = 0;
+
+/* Relocatable: owns heap memory but may be moved around with memcpy. */
+struct Handle
+{
+    int *value;
+
+    Handle(int v = 0) : value(new int(v)) {}
+    Handle(const Handle &other) : value(new int(*other.value)) {}
+    Handle &operator=(const Handle &other)
+    {
+        *value = *other.value;
+        return *this;
+    }
+    ~Handle() { delete value; }
+};
+} // namespace
+
+PCTK_BEGIN_NAMESPACE
+PCTK_DECL_TYPEINFO(Handle, PCTK_TYPEINFO_MOVABLE);
+PCTK_END_NAMESPACE
+
+TEST_GROUP(pctkVectorTest) {};
+
+TEST(pctkVectorTest, Traits)
+{
+    CHECK(pctk::Vector<int>::isPrimitive);
+    CHECK(pctk::Vector<int>::isRelocatable);
+    CHECK(!pctk::Vector<Handle>::isPrimitive);
+    CHECK(pctk::Vector<Handle>::isRelocatable);
+    CHECK(!pctk::Vector<Tracked>::isRelocatable);
+    CHECK(pctk::TypeInfo<pctk::Vector<Tracked> >::isRelocatable);
+}
+
+TEST(pctkVectorTest, PushBackAndGrow)
+{
+    pctk::Vector<int> vector;
+    CHECK(vector.empty());
+    for (int i = 0; i < 1000; ++i)
+    {
+        vector.push_back(i);
+    }
+    CHECK(vector.size() == 1000);
+    CHECK(vector.capacity() >= 1000);
+    for (int i = 0; i < 1000; ++i)
+    {
+        CHECK(vector[i] == i);
+    }
+    CHECK(vector.front() == 0);
+    CHECK(vector.back() == 999);
+    CHECK_THROWS(std::out_of_range, vector.at(1000));
+
+    vector.push_back(vector[10]);
+    CHECK(vector.back() == 10);
+}
+
+TEST(pctkVectorTest, ResizeZeroesPrimitives)
+{
+    pctk::Vector<int> vector(3, 7);
+    vector.resize(6);
+    CHECK(vector[2] == 7);
+    CHECK(vector[5] == 0);
+    vector.resize(1);
+    CHECK(vector.size() == 1);
+}
+
+TEST(pctkVectorTest, ResizeGrowsGeometrically)
+{
+    pctk::Vector<int> vector;
+    int reallocations = 0;
+    for (int i = 0; i < 10000; ++i)
+    {
+        const int *before = vector.data();
+        vector.resize(vector.size() + 1);
+        reallocations += before != vector.data();
+    }
+    CHECK(vector.capacity() > vector.size() || 10000 == vector.size());
+    CHECK(reallocations < 40);
+
+    pctk::Vector<std::string> strings;
+    strings.resize(3, "x");
+    strings.resize(4, "y");
+    CHECK(strings.capacity() >= 4);
+    CHECK(strings[3] == "y");
+}
+
+TEST(pctkVectorTest, MoveIsNoexcept)
+{
+    PCTK_STATIC_ASSERT(std::is_nothrow_move_constructible<pctk::Vector<std::string> >::value);
+    PCTK_STATIC_ASSERT(std::is_nothrow_move_assignable<pctk::Vector<std::string> >::value);
+    PCTK_STATIC_ASSERT((std::is_nothrow_move_constructible<pctk::SmallVector<std::string, 4> >::value));
+    PCTK_STATIC_ASSERT((std::is_nothrow_move_assignable<pctk::SmallVector<int, 4> >::value));
+
+    /* std::vector moves, rather than copies, the elements it relocates */
+    std::vector<pctk::Vector<int> > outer(1, pctk::Vector<int>(100, 1));
+    const int *inner = outer[0].data();
+    for (int i = 0; i < 100; ++i)
+    {
+        outer.push_back(pctk::Vector<int>());
+    }
+    CHECK(inner == outer[0].data());
+}
+
+TEST(pctkVectorTest, ReserveAndShrink)
+{
+    pctk::Vector<std::string> vector;
+    vector.reserve(100);
+    CHECK(vector.capacity() == 100);
+    vector.push_back("a");
+    vector.push_back("b");
+    vector.shrink_to_fit();
+    CHECK(vector.capacity() == 2);
+    CHECK(vector[1] == "b");
+    vector.clear();
+    vector.shrink_to_fit();
+    CHECK(vector.capacity() == 0);
+    CHECK(vector.data() == PCTK_NULLPTR);
+}
+
+TEST(pctkVectorTest, InsertAndErase)
+{
+    pctk::Vector<std::string> strings = {"a", "c", "e"};
+    strings.insert(strings.begin() + 1, "b");
+    strings.insert(strings.begin() + 3, std::string("d"));
+    strings.insert(strings.begin(), strings[4]);
+    CHECK(strings == pctk::Vector<std::string>({"e", "a", "b", "c", "d", "e"}));
+    strings.erase(strings.begin());
+    strings.erase(strings.begin() + 1, strings.begin() + 3);
+    CHECK(strings == pctk::Vector<std::string>({"a", "d", "e"}));
+
+    pctk::Vector<Handle> handles;
+    for (int i = 0; i < 10; ++i)
+    {
+        handles.emplace_back(i);
+    }
+    handles.insert(handles.begin(), Handle(-1));
+    handles.erase(handles.begin() + 2, handles.begin() + 5);
+    CHECK(handles.size() == 8);
+    CHECK(*handles[0].value == -1);
+    CHECK(*handles[1].value == 0);
+    CHECK(*handles[2].value == 4);
+}
+
+TEST(pctkVectorTest, ComplexElementsAreConstructedInPlace)
+{
+    {
+        pctk::Vector<Tracked> vector;
+        for (int i = 0; i < 100; ++i)
+        {
+            vector.emplace_back(i);
+        }
+        vector.insert(vector.begin() + 50, Tracked(-1));
+        vector.erase(vector.begin(), vector.begin() + 10);
+        pctk::Vector<Tracked> copy(vector);
+        CHECK(copy == vector);
+        CHECK(Tracked::alive == 182);
+        vector.pop_back();
+        vector.shrink_to_fit();
+        CHECK(vector[40].value == -1);
+    }
+    CHECK(Tracked::alive == 0);
+}
+
+TEST(pctkVectorTest, CopyMoveAndSwap)
+{
+    pctk::Vector<int> a = {1, 2, 3};
+    pctk::Vector<int> b(a);
+    CHECK(a == b);
+    pctk::Vector<int> c(std::move(a));
+    CHECK(a.empty());
+    CHECK(c == b);
+    std::list<int> list(4, 9);
+    pctk::Vector<int> d(list.begin(), list.end());
+    swap(c, d);
+    CHECK(c.size() == 4);
+    CHECK(d == b);
+    d.append(d.begin(), d.end());
+    CHECK(d == pctk::Vector<int>({1, 2, 3, 1, 2, 3}));
+}
+
+TEST(pctkVectorTest, AppendOwnRangeWhileGrowing)
+{
+    pctk::Vector<int> ints({1, 2, 3, 4});
+    ints.shrink_to_fit();
+    ints.append(ints.begin() + 1, ints.begin() + 3);
+    CHECK(ints == pctk::Vector<int>({1, 2, 3, 4, 2, 3}));
+
+    pctk::Vector<std::string> strings;
+    strings.push_back(std::string(40, 'a'));
+    strings.push_back(std::string(40, 'b'));
+    strings.push_back(std::string(40, 'c'));
+    strings.shrink_to_fit();
+    strings.append(strings.begin() + 1, strings.end());
+    CHECK(strings.size() == 5);
+    CHECK(strings[3] == std::string(40, 'b'));
+    CHECK(strings[4] == std::string(40, 'c'));
+}
+
+TEST(pctkVectorTest, SmallVectorStaysInline)
+{
+    pctk::SmallVector<int, 4> small;
+    const int *inlineData = small.data();
+    CHECK(small.capacity() == 4);
+    small.push_back(1);
+    small.push_back(2);
+    small.push_back(3);
+    small.push_back(4);
+    CHECK(small.data() == inlineData);
+    small.push_back(5);
+    CHECK(small.data() != inlineData);
+    CHECK(small.size() == 5);
+    CHECK(small[4] == 5);
+
+    pctk::SmallVector<std::string, 2> strings;
+    strings.push_back("one");
+    strings.push_back("two");
+    pctk::SmallVector<std::string, 2> moved(std::move(strings));
+    CHECK(moved[1] == "two");
+    CHECK(strings.empty());
+    strings = moved;
+    strings.push_back("three");
+    moved.swap(strings);
+    CHECK(moved.size() == 3);
+    CHECK(strings.size() == 2);
+    pctk::Vector<std::string> heap(std::move(moved));
+    CHECK(heap.size() == 3);
+    CHECK(moved.empty());
+}
+
+int main(int ac, char **av)
+{
+#ifndef PCTK_TEST_ENABLE_MEMORYLEAK
+    MemoryLeakWarningPlugin::turnOffNewDeleteOverloads();
+#endif
+    return CommandLineTestRunner::RunAllTests(ac, av);
+}